@@ -27,78 +27,67 @@
 #include "apps.h"
 #include "games.h"
 #include "quests.h"
+#include "latency.h"
+#include "i2c_bus.h"
+#include "reg_cache.h"
+#include "i2c_trace.h"
+#include "scheduler.h"
+#include "boot.h"
 
 // Global system state
 SystemState system_state;
 unsigned long last_update = 0;
 unsigned long last_sensor_update = 0;
 unsigned long last_ui_update = 0;
+unsigned long last_bus_report = 0;
+unsigned long raise_wake_time = 0;  // sleep_timer when a wrist raise woke the screen
+unsigned long last_input = 0;       // Touch, gesture or button, keeps frames at the full rate
+unsigned long last_console = 0;     // Serial input, keeps the loop out of light sleep
+ScreenType drawn_screen = SCREEN_SPLASH;  // Screen of the last frame
+LoopScheduler loop_scheduler;
+BootPlan boot_plan;
+bool warm_boot = false;             // Woken from deep sleep with state in RTC memory
 
 void setup() {
   Serial.begin(115200);
-  Serial.println("ESP32-S3 Watch Starting...");
   
-  // Initialize hardware components
-  if (!initializePower()) {
-    Serial.println("Power management failed to initialize!");
-    return;
-  }
-  
-  if (!initializeDisplay()) {
-    Serial.println("Display failed to initialize!");
-    return;
+  // The hardware and the watch face come up here; the SD card, settings
+  // file, media and apps follow the first frame, one stage per loop pass
+  warm_boot = hasResumeState();
+  Serial.println(warm_boot ? "ESP32-S3 Watch Resuming..." : "ESP32-S3 Watch Starting...");
+  bootInit(boot_plan, millis());
+  latencyReset(touch_latency);
+  schedulerInit(loop_scheduler);
+  
+  int stage;
+  while ((stage = bootNext(boot_plan)) >= 0) {
+    runBootStage(stage);
   }
-  
-  if (!initializeTouch()) {
-    Serial.println("Touch controller failed to initialize!");
-    return;
-  }
-  
-  if (!initializeSensors()) {
-    Serial.println("Sensors failed to initialize!");
+  if (boot_plan.halted) {
+    Serial.println("ESP32-S3 Watch failed to start!");
     return;
   }
   
-  if (!initializeRTC()) {
-    Serial.println("RTC failed to initialize!");
-    return;
-  }
-  
-  if (!initializeFileSystem()) {
-    Serial.println("File system failed to initialize!");
-    return;
-  }
-  
-  // Initialize UI system
-  initializeUI();
-  
-  // Load user preferences
-  loadUserSettings();
-  
-  // Set default theme (Luffy Gear 5)
-  setTheme(THEME_LUFFY_GEAR5);
-  
-  // Show splash screen
-  showSplashScreen();
-  delay(2000);
-  
-  // Initialize apps
-  initializeApps();
-  
-  // Go to watch face
-  system_state.current_screen = SCREEN_WATCHFACE;
-  system_state.sleep_timer = millis();
-  
-  Serial.println("ESP32-S3 Watch initialized successfully!");
+  Serial.printf("ESP32-S3 Watch up in %lums, loading the rest in the background\n", millis());
 }
 
 void loop() {
+  // Nothing to drive without the bus, power or the panel
+  if (boot_plan.halted) {
+    delay(1000);
+    return;
+  }
+  
   unsigned long current_time = millis();
+  uint32_t loop_start = micros();
   
   // Handle power management
   handlePowerManagement();
+  if (schedulerDue(loop_scheduler, DEADLINE_TIME, current_time)) {
+    checkTimeBasedEvents();
+  }
   
-  // Update sensors (every 100ms)
+  // Pick up the sensor task's latest snapshot (every 100ms)
   if (current_time - last_sensor_update >= 100) {
     updateSensors();
     last_sensor_update = current_time;
@@ -106,38 +95,68 @@ void loop() {
   
   // Handle touch input
   TouchGesture gesture = handleTouchInput();
+  if (gesture.event == TOUCH_NONE && ENABLE_IMU_GESTURES) {
+    // Hands-free: wrist gestures drive the same handlers as the screen. In
+    // a game they are play, so they are taken and dropped rather than left
+    // to fire after it
+    IMUGestureType imu_gesture = takeIMUGesture();
+    if (imu_gesture != IMU_GESTURE_NONE && !isGameInPlay()) gesture = touchGestureFromIMU(imu_gesture);
+  }
+  if (gesture.event != TOUCH_NONE || isTouchPressed()) {
+    noteInput();
+  }
   if (gesture.event != TOUCH_NONE) {
-    handleUITouch(gesture);
+    latencyTouch(touch_latency, system_state.current_screen, gesture.sample_us, gesture.recognized_us);
+    if (gesture.event == TOUCH_BACK) {
+      navigateBack();
+    } else {
+      handleUITouch(gesture);
     
-    // Handle specific screen touches
-    switch (system_state.current_screen) {
-      case SCREEN_WATCHFACE:
-        if (gesture.event == TOUCH_SWIPE_UP) {
-          system_state.current_screen = SCREEN_APP_GRID;
-        }
-        break;
-      case SCREEN_APP_GRID:
-        handleAppGridTouch(gesture);
-        break;
-      case SCREEN_QUESTS:
-        // Quest touch handling would go here
-        break;
-      default:
-        // Handle game touches when in games
-        if (system_state.current_app == APP_GAMES) {
-          if (current_game_session.current_game == GAME_BATTLE_ARENA) {
-            handleBattleTouch(gesture);
-          } else if (current_game_session.current_game == GAME_SHADOW_DUNGEON) {
-            handleDungeonTouch(gesture);
-          } else if (current_game_session.current_game == GAME_MINI_SNAKE) {
-            handleSnakeTouch(gesture);
-          } else if (current_game_session.state == GAME_MENU) {
-            handleGameMenuTouch(gesture);
+      // Handle specific screen touches
+      switch (system_state.current_screen) {
+        case SCREEN_WATCHFACE:
+          if (gesture.event == TOUCH_SWIPE_UP) {
+            system_state.current_screen = SCREEN_APP_GRID;
+          } else if (gesture.event == TOUCH_SWIPE_LEFT) {
+            openActivityHistory();
+          } else if (gesture.event == TOUCH_SWIPE_RIGHT) {
+            openSleepReport();
           }
-        }
-        break;
+          break;
+        case SCREEN_APP_GRID:
+          handleAppGridTouch(gesture);
+          break;
+        case SCREEN_ACTIVITY:
+          handleActivityHistoryTouch(gesture);
+          break;
+        case SCREEN_SLEEP_REPORT:
+          handleSleepReportTouch(gesture);
+          break;
+        case SCREEN_ENERGY:
+          handleEnergyReportTouch(gesture);
+          break;
+        case SCREEN_QUESTS:
+          // Quest touch handling would go here
+          break;
+        default:
+          // Handle game touches when in games
+          if (system_state.current_app == APP_GAMES) {
+            if (current_game_session.current_game == GAME_BATTLE_ARENA) {
+              handleBattleTouch(gesture);
+            } else if (current_game_session.current_game == GAME_SHADOW_DUNGEON) {
+              handleDungeonTouch(gesture);
+            } else if (current_game_session.current_game == GAME_MINI_SNAKE) {
+              handleSnakeTouch(gesture);
+            } else if (current_game_session.state == GAME_MENU) {
+              handleGameMenuTouch(gesture);
+            }
+          }
+          break;
+      }
     }
     
+    markTouchDispatched();
+    
     // Reset sleep timer on any touch
     system_state.sleep_timer = millis();
   }
@@ -145,8 +164,16 @@ void loop() {
   // Handle button input
   handleButtonInput();
   
-  // Update UI (60 FPS target - every 16ms)
-  if (current_time - last_ui_update >= 16) {
+  // Update UI: at once on a new screen, every 16ms while something moves or
+  // input is recent, otherwise at the idle rate for the clock
+  if (system_state.current_screen != drawn_screen) {
+    schedulerArm(loop_scheduler, DEADLINE_FRAME, current_time);
+  }
+  if (schedulerDue(loop_scheduler, DEADLINE_FRAME, current_time) ||
+      schedulerDue(loop_scheduler, DEADLINE_ANIMATION, current_time)) {
+    uint32_t frame_start = micros();
+    markFrameStart();
+    beginHitFrame(); // Draw functions register this frame's touch regions
     switch (system_state.current_screen) {
       case SCREEN_WATCHFACE:
         drawWatchFace();
@@ -172,6 +199,18 @@ void loop() {
       case SCREEN_PDF_READER:
         drawPDFReaderApp();
         break;
+      case SCREEN_ACTIVITY:
+        drawActivityHistory();
+        break;
+      case SCREEN_SLEEP_REPORT:
+        drawSleepReport();
+        break;
+      case SCREEN_ENERGY:
+        drawEnergyReport();
+        break;
+      case SCREEN_SLEEP:
+        drawSleepWatchFace();
+        break;
       default:
         // Handle game drawing
         if (system_state.current_app == APP_GAMES) {
@@ -190,42 +229,222 @@ void loop() {
         }
         break;
     }
+    drawPerfHUD();
+    
+    // Screens that draw straight to the panel never call updateDisplay()
+    markFramePresented();
     last_ui_update = current_time;
+    drawn_screen = system_state.current_screen;
+    
+    // Clock for the next frame from this one's cost and what is moving
+    bool animating = isListScrolling() ||
+                     (system_state.current_app == APP_GAMES && current_game_session.state == GAME_PLAYING);
+    updateCpuGovernor(micros() - frame_start, animating);
+    bool redraw = updateDisplayLimiter();
+    
+    bool asleep = system_state.current_screen == SCREEN_SLEEP;
+    schedulerArm(loop_scheduler, DEADLINE_FRAME, redraw ? current_time :
+                 current_time + (asleep ? SLEEP_FACE_REFRESH : IDLE_FRAME_INTERVAL));
+    if (!asleep && (animating || millis() - last_input < ACTIVE_FRAME_WINDOW)) {
+      schedulerArm(loop_scheduler, DEADLINE_ANIMATION, current_time + UI_UPDATE_INTERVAL);
+    } else {
+      schedulerDisarm(loop_scheduler, DEADLINE_ANIMATION);
+    }
+    
+    bootNoteFirstFrame(boot_plan, millis());
+  }
+  
+  // Background boot stages, one per pass once the face is up
+  if (!bootComplete(boot_plan)) {
+    int stage = bootNext(boot_plan);
+    if (stage >= 0) runBootStage(stage);
+    if (bootComplete(boot_plan)) reportBoot();
+  }
+  
+  reportTouchLatency();
+  
+  // Per-device I2C bus time, once a minute
+  if (current_time - last_bus_report >= 60000) {
+    i2cReportStats();
+    reportRegisterCaches();
+    reportI2COccupancy();
+    reportSensors();
+    reportFuelGauge();
+    reportEnergy();
+    reportCpuGovernor();
+    reportDisplayLimiter();
+    reportLoopScheduler();
+    last_bus_report = current_time;
+  }
+  
+  // Serial 't' dumps the I2C trace for tools/i2c_trace_to_chrome.py,
+  // 'i' toggles the raw IMU stream for tools/train_activity.py,
+  // 'g' records a template for the next wrist gesture in turn,
+  // 'e' exports the energy ledger as CSV, 'b' the boot stage timings,
+  // 'h' toggles the touch latency HUD, 'c<index> <uA>' calibrates one
+  // coefficient of the energy model
+  if (Serial.available()) {
+    last_console = current_time;
+    char command = Serial.read();
+    if (command == 't') {
+      dumpI2CTrace();
+    } else if (command == 'i') {
+      setIMUStreaming(!isIMUStreaming());
+    } else if (command == 'g') {
+      recordNextIMUGesture();
+    } else if (command == 'e') {
+      exportEnergyCSV();
+    } else if (command == 'b') {
+      reportBoot();
+    } else if (command == 'h') {
+      setPerfHUDEnabled(!isPerfHUDEnabled());
+      schedulerArm(loop_scheduler, DEADLINE_FRAME, current_time);
+    } else if (command == 'c') {
+      int coefficient = Serial.parseInt();
+      long ua = Serial.parseInt();
+      if (ua < 0 || !calibrateEnergyModel(coefficient, ua)) Serial.println("Energy model: bad coefficient");
+    }
   }
   
   // Handle sleep mode
+  handleWristGestures();
   handleSleepMode();
   
+  // First look at the watch after a tracked night
+  if (system_state.current_screen == SCREEN_WATCHFACE && takeNewNight()) {
+    openSleepReport();
+  }
+  
+  // Nothing else is due: light-sleep until the earliest deadline, unless a
+  // motion wake is still being checked for a wrist raise, the sensor task
+  // has not acted on the last wake yet, boot stages are still waiting, or
+  // someone is at the console. With
+  // the screen asleep the IMU counts steps and the CPU always parks; with it
+  // on, interrupts bring the loop back for touch, buttons and the FIFO.
+  unsigned long now = millis();
+  schedulerArm(loop_scheduler, DEADLINE_SENSORS, now + sensorsDueIn());
+  schedulerArm(loop_scheduler, DEADLINE_POWER, now + powerDueIn());
+  unsigned long time_due = timeEventsDueIn();
+  if (time_due != TIME_EVENTS_NONE) {
+    schedulerArm(loop_scheduler, DEADLINE_TIME, now + time_due);
+  } else {
+    schedulerDisarm(loop_scheduler, DEADLINE_TIME);
+  }
+  
+  bool screen_asleep = system_state.current_screen == SCREEN_SLEEP;
+  bool console = now - last_console < CONSOLE_AWAKE_MS || isIMUStreaming();
+  bool may_sleep = screen_asleep ? isMotionSleepActive() : ENABLE_TICKLESS_IDLE && !console;
+  if (may_sleep && !isWatchingWrist() && sensorsCaughtUp() && bootComplete(boot_plan)) {
+    SleepPlan plan = schedulerPlanSleep(loop_scheduler, now, SLEEP_FACE_REFRESH);
+    if (plan.sleep_ms > 0) {
+      noteLoopBusy(micros() - loop_start);
+      pauseSensorTask();
+      unsigned long sleep_start = millis();
+      WakeCause cause = lightSleepUntilEvent(plan.sleep_ms);
+      resumeSensorTask();
+      schedulerNoteWake(loop_scheduler, plan, millis() - sleep_start);
+      if (cause == WAKE_MOTION && screen_asleep) {
+        watchForWristRaise();
+      }
+      return;
+    }
+  }
+  
   // Small delay to prevent watchdog issues
+  noteLoopBusy(micros() - loop_start);
   delay(1);
 }
 
-void showSplashScreen() {
-  clearDisplay();
-  
-  // Show animated logo with current theme colors
-  ThemeColors* theme = getCurrentTheme();
-  
-  // Draw centered logo
-  drawCenteredText("ESP32-S3", DISPLAY_WIDTH/2, DISPLAY_HEIGHT/2 - 40, theme->primary, 3);
-  drawCenteredText("WATCH", DISPLAY_WIDTH/2, DISPLAY_HEIGHT/2, theme->accent, 3);
-  drawCenteredText("Loading...", DISPLAY_WIDTH/2, DISPLAY_HEIGHT/2 + 40, theme->secondary, 1);
-  
-  // Animated loading bar
-  int bar_width = 200;
-  int bar_x = (DISPLAY_WIDTH - bar_width) / 2;
-  int bar_y = DISPLAY_HEIGHT/2 + 70;
-  
-  for (int i = 0; i <= bar_width; i += 5) {
-    drawRect(bar_x, bar_y, i, 4, theme->accent);
-    updateDisplay();
-    delay(20);
+static bool restoreState() {
+  // Settings, steps, quests and the music player's place come back with a
+  // warm resume, so the settings file, media scan and app setup are not needed
+  if (warm_boot && restoreResumeState()) {
+    bootSkip(boot_plan, BOOT_SETTINGS);
+    bootSkip(boot_plan, BOOT_MEDIA);
+    bootSkip(boot_plan, BOOT_APPS);
+  } else {
+    loadDefaultSettings();
+    system_state.current_screen = SCREEN_WATCHFACE;
+  }
+  system_state.sleep_timer = millis();
+  return true;
+}
+
+static void applySettings() {
+  setTheme(system_state.current_theme);
+  setDisplayBrightness(system_state.brightness);
+  schedulerArm(loop_scheduler, DEADLINE_FRAME, millis());
+}
+
+static bool startBootStage(int stage) {
+  switch (stage) {
+    case BOOT_I2C: return i2cBusInit();
+    case BOOT_POWER: return initializePower();
+    case BOOT_DISPLAY: return initializeDisplay();
+    case BOOT_TOUCH: return initializeTouch();
+    case BOOT_SENSORS: return initializeSensors();
+    case BOOT_RTC: return initializeRTC();
+    case BOOT_STATE: return restoreState();
+    case BOOT_SENSOR_TASK: return startSensorTask();
+    case BOOT_UI:
+      initializeUI();
+      applySettings();
+      return true;
+    case BOOT_STORAGE: return initializeFileSystem(false);  // Scanned by BOOT_MEDIA
+    case BOOT_SETTINGS:
+      loadSettingsFromFile();
+      applySettings();
+      return true;
+    case BOOT_ACTIVITY_LOG: return initializeActivityLog(sdActivityLogStorage());
+    case BOOT_MEDIA:
+      indexMediaFiles();
+      return true;
+    case BOOT_APPS:
+      initializeApps();
+      return true;
+  }
+  return false;
+}
+
+void runBootStage(int stage) {
+  bootBegin(boot_plan, stage, millis());
+  bool ok = startBootStage(stage);
+  bootEnd(boot_plan, stage, ok, millis());
+  if (!ok) Serial.printf("Boot: %s failed, carrying on without it\n", bootStageName(stage));
+}
+
+void reportBoot() {
+  // CSV like the energy export: stage, state, start and length in ms since reset
+  Serial.printf("boot,first_frame,%s,%lu,\n", boot_plan.first_frame ? "done" : "pending",
+                (unsigned long)boot_plan.first_frame_ms);
+  for (int stage = 0; stage < BOOT_STAGE_COUNT; stage++) {
+    const BootStage& current = boot_plan.stages[stage];
+    Serial.printf("boot,%s,%s,%lu,%lu\n", bootStageName(stage), bootStateName(current.state),
+                  (unsigned long)current.start_ms, (unsigned long)bootStageMs(boot_plan, stage));
+  }
+}
+
+void noteInput() {
+  // Frames go to the full rate straight away, not at the next idle redraw
+  last_input = millis();
+  if (!schedulerArmed(loop_scheduler, DEADLINE_ANIMATION)) {
+    schedulerArm(loop_scheduler, DEADLINE_ANIMATION, last_input);
   }
 }
 
+void reportLoopScheduler() {
+  const SchedulerStats& stats = loop_scheduler.stats;
+  Serial.printf("Loop: %d%% in light sleep, %lu sleeps (%lu cut short, %lu to a frame, %lu to sensors), %lu gaps idled\n",
+                (int)(stats.slept_ms * 100 / max(millis(), 1UL)), (unsigned long)stats.sleeps,
+                (unsigned long)stats.early_wakes,
+                (unsigned long)(stats.woken_by[DEADLINE_FRAME] + stats.woken_by[DEADLINE_ANIMATION]),
+                (unsigned long)stats.woken_by[DEADLINE_SENSORS], (unsigned long)stats.idles);
+}
+
 void handlePowerManagement() {
   // Check battery level
   updateBatteryStatus();
+  updateEnergyAccounting();
   
   // Handle low battery warning
   if (system_state.battery_percentage < 10 && !system_state.low_battery_warning) {
@@ -240,6 +459,18 @@ void handlePowerManagement() {
   }
 }
 
+void handleWristGestures() {
+  // A raise wakes the screen; lowering puts it back only if nothing was touched
+  WristEvent event = takeWristEvent();
+  if (event == WRIST_RAISE && system_state.current_screen == SCREEN_SLEEP) {
+    wakeFromSleep();
+    raise_wake_time = system_state.sleep_timer;
+  } else if (event == WRIST_LOWER && system_state.current_screen != SCREEN_SLEEP &&
+             raise_wake_time != 0 && system_state.sleep_timer == raise_wake_time) {
+    goToSleep();
+  }
+}
+
 void handleSleepMode() {
   // Auto sleep after inactivity
   if (millis() - system_state.sleep_timer > SLEEP_TIMEOUT && 
@@ -251,19 +482,21 @@ void handleSleepMode() {
 void goToSleep() {
   system_state.current_screen = SCREEN_SLEEP;
   system_state.sleep_timer = millis();
+  raise_wake_time = 0;
   
-  // Dim display but keep minimal watch face
+  // Dim display; the next frame draws the minimal watch face
   setDisplayBrightness(10);
-  drawSleepWatchFace();
   
-  // Reduce sensor polling
+  // Hand step counting to the IMU so the CPU can sleep
   system_state.low_power_mode = true;
+  enterMotionSleep();
 }
 
 void wakeFromSleep() {
   system_state.current_screen = SCREEN_WATCHFACE;
   system_state.sleep_timer = millis();
   system_state.low_power_mode = false;
+  exitMotionSleep();
   
   // Restore display brightness
   setDisplayBrightness(system_state.brightness);
@@ -272,17 +505,13 @@ void wakeFromSleep() {
   drawWatchFace();
 }
 
-void loadUserSettings() {
-  // Load settings from EEPROM or SD card
-  // Default values
+void loadDefaultSettings() {
+  // The settings file on SD, if any, is read over these by BOOT_SETTINGS
   system_state.brightness = 80;
   system_state.current_theme = THEME_LUFFY_GEAR5;
   system_state.step_goal = 10000;
   system_state.wake_time = 7 * 60; // 7:00 AM
   system_state.sleep_time = 22 * 60; // 10:00 PM
-  
-  // Try to load from file system
-  loadSettingsFromFile();
 }
 
 void saveUserSettings() {
@@ -308,20 +537,61 @@ void drawWatchFace() {
 }
 
 // Button handling
+struct ButtonState {
+  int pin;
+  bool pressed;
+  unsigned long press_time;
+};
+
+// A level counts once it has held for the debounce time since the button's
+// last edge. Press and release are timed from their edges, which a wake
+// from light sleep stamps too, so long presses measure the same asleep or
+// awake. Returns how long the button was held on release, otherwise 0.
+static unsigned long debounceButton(ButtonState& button) {
+  bool current = !digitalRead(button.pin); // Active low
+  if (current == button.pressed) return 0;
+  
+  unsigned long edge = buttonEdgeTime(button.pin);
+  if (millis() - edge < BUTTON_DEBOUNCE_MS) {
+    schedulerArm(loop_scheduler, DEADLINE_INPUT, edge + BUTTON_DEBOUNCE_MS);
+    return 0;
+  }
+  noteInput();
+  button.pressed = current;
+  if (current) {
+    button.press_time = edge;
+    return 0;
+  }
+  return max(edge - button.press_time, 1UL);
+}
+
+// One level up: reports return to where they were opened from, apps and
+// the app grid to the watch face
+void navigateBack() {
+  switch (system_state.current_screen) {
+    case SCREEN_WATCHFACE:
+      break;
+    case SCREEN_APP_GRID:
+    case SCREEN_ACTIVITY:
+    case SCREEN_SLEEP_REPORT:
+      system_state.current_screen = SCREEN_WATCHFACE;
+      break;
+    case SCREEN_ENERGY:
+      system_state.current_screen = SCREEN_SETTINGS;
+      break;
+    default:
+      exitCurrentApp();
+      break;
+  }
+}
+
 void handleButtonInput() {
-  static bool pwr_button_pressed = false;
-  static bool boot_button_pressed = false;
-  static unsigned long button_press_time = 0;
+  static ButtonState pwr_button = {BTN_PWR, false, 0};
+  static ButtonState boot_button = {BTN_BOOT, false, 0};
   
   // PWR button (GPIO 0)
-  bool pwr_current = !digitalRead(BTN_PWR); // Active low
-  if (pwr_current && !pwr_button_pressed) {
-    pwr_button_pressed = true;
-    button_press_time = millis();
-  } else if (!pwr_current && pwr_button_pressed) {
-    pwr_button_pressed = false;
-    unsigned long press_duration = millis() - button_press_time;
-    
+  unsigned long press_duration = debounceButton(pwr_button);
+  if (press_duration > 0) {
     if (press_duration < 300) {
       // Short press - wake/sleep
       if (system_state.current_screen == SCREEN_SLEEP) {
@@ -330,33 +600,27 @@ void handleButtonInput() {
         goToSleep();
       }
     } else if (press_duration > 2000) {
-      // Long press - power off
+      // Long press - power off, state kept for a warm boot
       Serial.println("Power off requested");
       goToSleep();
+      enterDeepSleepMode();
     }
   }
   
   // BOOT button (GPIO 46) - Menu/Back
-  bool boot_current = !digitalRead(BTN_BOOT); // Active low
-  if (boot_current && !boot_button_pressed) {
-    boot_button_pressed = true;
-    button_press_time = millis();
-  } else if (!boot_current && boot_button_pressed) {
-    boot_button_pressed = false;
-    unsigned long press_duration = millis() - button_press_time;
-    
-    if (press_duration < 300) {
-      // Short press - back/menu
-      if (system_state.current_screen == SCREEN_APP_GRID) {
-        system_state.current_screen = SCREEN_WATCHFACE;
-      } else if (system_state.current_screen != SCREEN_WATCHFACE) {
-        exitCurrentApp();
-      } else {
-        system_state.current_screen = SCREEN_APP_GRID;
-      }
+  bool boot_was_pressed = boot_button.pressed;
+  press_duration = debounceButton(boot_button);
+  if (press_duration > 0 && press_duration < 300) {
+    // Short press - back, or the menu from the watch face
+    if (system_state.current_screen == SCREEN_WATCHFACE) {
+      system_state.current_screen = SCREEN_APP_GRID;
+    } else {
+      navigateBack();
     }
-    
-    // Reset sleep timer on button press
+  }
+  
+  // Reset sleep timer on button release
+  if (boot_was_pressed && !boot_button.pressed) {
     system_state.sleep_timer = millis();
   }
 }
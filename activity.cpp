@@ -0,0 +1,142 @@
+/*
+ * Windowed Activity Classifier Implementation
+ * Integer features, Goertzel frequency scan and tree walk
+ */
+
+#include "activity.h"
+#include "activity_tree.h"
+#include "fixed_math.h"
+#include <string.h>
+
+// Goertzel coefficients 2cos(2*pi*f/fs) in Q14 for 0.5Hz + 0.25Hz * bin at 56.05Hz
+static const int32_t GOERTZEL_COEFF[ACTIVITY_FREQ_BINS] = {
+  32717, 32652, 32562, 32447, 32306, 32140, 31948, 31731,
+  31490, 31223, 30932, 30617, 30278, 29915, 29529
+};
+
+static const char* activity_names[ACTIVITY_CLASS_COUNT] = {
+  "Stationary", "Walking", "Running", "Cycling", "Other"
+};
+
+void activityExtractFeatures(const IMUSample* window, int count, int32_t* features) {
+  // Magnitudes and axis values in 1/1024 g, gyro rate in raw units
+  int32_t magnitude[ACTIVITY_WINDOW];
+  int64_t magnitude_sum = 0;
+  int64_t axis_sum[3] = {0, 0, 0};
+  int64_t axis_square[3] = {0, 0, 0};
+  uint32_t gyro_sum = 0;
+
+  for (int i = 0; i < count; i++) {
+    magnitude[i] = vectorLength3(window[i].accel) >> 3;
+    magnitude_sum += magnitude[i];
+    for (int axis = 0; axis < 3; axis++) {
+      int32_t a = window[i].accel[axis] >> 3;
+      axis_sum[axis] += a;
+      axis_square[axis] += a * a;
+    }
+    gyro_sum += vectorLength3(window[i].gyro);
+  }
+
+  int32_t mean = magnitude_sum / count;
+  int64_t variance_sum = 0;
+  for (int i = 0; i < count; i++) {
+    magnitude[i] -= mean;
+    variance_sum += (int64_t)magnitude[i] * magnitude[i];
+  }
+  features[FEATURE_MAGNITUDE_VARIANCE] = variance_sum / count;
+
+  int64_t axis_energy = 0;
+  for (int axis = 0; axis < 3; axis++) {
+    int64_t axis_mean = axis_sum[axis] / count;
+    axis_energy += axis_square[axis] / count - axis_mean * axis_mean;
+  }
+  features[FEATURE_AXIS_ENERGY] = axis_energy;
+
+  // Goertzel scan of the step band, the strongest bin wins
+  int best_bin = 0;
+  int64_t best_power = 0;
+  for (int bin = 0; bin < ACTIVITY_FREQ_BINS; bin++) {
+    int64_t s1 = 0, s2 = 0;
+    for (int i = 0; i < count; i++) {
+      int64_t s0 = magnitude[i] + ((GOERTZEL_COEFF[bin] * s1) >> 14) - s2;
+      s2 = s1;
+      s1 = s0;
+    }
+    int64_t power = s1 * s1 + s2 * s2 - ((GOERTZEL_COEFF[bin] * s1) >> 14) * s2;
+    if (power > best_power) {
+      best_power = power;
+      best_bin = bin;
+    }
+  }
+  features[FEATURE_DOMINANT_FREQ] = 50 + 25 * best_bin;
+
+  // A pure tone in one bin has power N^2 A^2 / 4 against N A^2 / 2 energy
+  int64_t periodicity = variance_sum > 0 ? best_power * 200 / ((int64_t)count * variance_sum) : 0;
+  features[FEATURE_PERIODICITY] = periodicity > 100 ? 100 : periodicity;
+
+  features[FEATURE_GYRO_MEAN] = gyro_sum / count / (uint32_t)IMU_GYRO_LSB_PER_DPS;
+}
+
+ActivityClass activityTreeClassify(const int32_t* features) {
+  int node = 0;
+  const int node_count = sizeof(ACTIVITY_TREE) / sizeof(ACTIVITY_TREE[0]);
+  while (node >= 0 && node < node_count) {
+    const ActivityTreeNode& n = ACTIVITY_TREE[node];
+    if (n.feature < 0) return (ActivityClass)n.threshold;
+    node = features[n.feature] < n.threshold ? n.left : n.right;
+  }
+  return ACTIVITY_OTHER;
+}
+
+void activityInit(ActivityClassifier& classifier) {
+  memset(&classifier, 0, sizeof(classifier));
+  classifier.raw = ACTIVITY_STATIONARY;
+  classifier.current = ACTIVITY_STATIONARY;
+  classifier.candidate = ACTIVITY_STATIONARY;
+}
+
+int activityProcess(ActivityClassifier& classifier, const IMUSample* samples, int count) {
+  int classified = 0;
+
+  for (int n = 0; n < count; n++) {
+    classifier.window[classifier.sample_count % ACTIVITY_WINDOW] = samples[n];
+    classifier.sample_count++;
+    if (classifier.sample_count < ACTIVITY_WINDOW || classifier.sample_count % ACTIVITY_HOP != 0) {
+      continue;
+    }
+
+    // Unroll the circular window oldest first
+    static IMUSample ordered[ACTIVITY_WINDOW];
+    for (int i = 0; i < ACTIVITY_WINDOW; i++) {
+      ordered[i] = classifier.window[(classifier.sample_count + i) % ACTIVITY_WINDOW];
+    }
+    activityExtractFeatures(ordered, ACTIVITY_WINDOW, classifier.features);
+    classifier.raw = activityTreeClassify(classifier.features);
+
+    // Hysteresis: a new class needs consecutive agreeing windows
+    if (classifier.raw == classifier.current) {
+      classifier.candidate_windows = 0;
+    } else if (classifier.raw == classifier.candidate) {
+      if (++classifier.candidate_windows >= ACTIVITY_CONFIRM_WINDOWS) {
+        classifier.current = classifier.raw;
+        classifier.candidate_windows = 0;
+      }
+    } else {
+      classifier.candidate = classifier.raw;
+      classifier.candidate_windows = 1;
+    }
+
+    classifier.class_seconds[classifier.current]++;  // One hop is a second
+    classifier.windows++;
+    classified++;
+  }
+  return classified;
+}
+
+const char* activityName(ActivityClass activity) {
+  return activity < ACTIVITY_CLASS_COUNT ? activity_names[activity] : "Unknown";
+}
+
+bool activityIsMoving(ActivityClass activity) {
+  return activity != ACTIVITY_STATIONARY && activity != ACTIVITY_OTHER;
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+/*
+ * Windowed Activity Classifier for ESP32-S3 Watch
+ * Sliding-window IMU features and a compiled-in decision tree
+ *
+ * Every second the last 3 seconds of IMU samples are reduced to a few
+ * integer features: accel magnitude variance, per-axis energy, dominant
+ * step-band frequency and how much of the signal it holds, and mean gyro
+ * rate. A small decision tree from activity_tree.h maps them to an
+ * activity, and a class only takes over once two windows in a row agree,
+ * so the reported activity no longer flickers per sample. The tree is
+ * trained offline by tools/train_activity.py, which mirrors the feature
+ * code below bit for bit.
+ */
+
+#ifndef ACTIVITY_H
+#define ACTIVITY_H
+
+#include <stdint.h>
+#include "imu_fifo.h"
+
+#define ACTIVITY_WINDOW 168         // 3s at 56Hz
+#define ACTIVITY_HOP 56             // Classify once a second
+#define ACTIVITY_CONFIRM_WINDOWS 2  // Agreeing windows before the class changes
+#define ACTIVITY_FREQ_BINS 15       // 0.5 - 4.0Hz in 0.25Hz steps
+
+enum ActivityClass {
+  ACTIVITY_STATIONARY,
+  ACTIVITY_WALKING,
+  ACTIVITY_RUNNING,
+  ACTIVITY_CYCLING,
+  ACTIVITY_OTHER,
+  ACTIVITY_CLASS_COUNT
+};
+
+enum ActivityFeature {
+  FEATURE_MAGNITUDE_VARIANCE,   // (1/1024 g)^2
+  FEATURE_AXIS_ENERGY,          // Sum of per-axis variances, (1/1024 g)^2
+  FEATURE_DOMINANT_FREQ,        // Centi-Hz
+  FEATURE_PERIODICITY,          // Percent of magnitude energy in the dominant bin
+  FEATURE_GYRO_MEAN,            // dps
+  FEATURE_COUNT
+};
+
+// Decision tree node: feature < threshold goes left. Leaves have
+// feature -1 and store their class in threshold.
+struct ActivityTreeNode {
+  int8_t feature;
+  int32_t threshold;
+  int16_t left, right;
+};
+
+struct ActivityClassifier {
+  IMUSample window[ACTIVITY_WINDOW];  // Circular
+  uint32_t sample_count;
+  int32_t features[FEATURE_COUNT];    // Last window's features
+  ActivityClass raw;                  // Last window's tree output
+  ActivityClass current;              // Smoothed class
+  ActivityClass candidate;
+  uint8_t candidate_windows;
+  uint32_t windows;
+  uint32_t class_seconds[ACTIVITY_CLASS_COUNT];
+};
+
+void activityInit(ActivityClassifier& classifier);
+int activityProcess(ActivityClassifier& classifier, const IMUSample* samples, int count);  // Returns windows classified
+void activityExtractFeatures(const IMUSample* window, int count, int32_t* features);
+ActivityClass activityTreeClassify(const int32_t* features);
+const char* activityName(ActivityClass activity);
+bool activityIsMoving(ActivityClass activity);
+
+#endif // ACTIVITY_H
\ No newline at end of file
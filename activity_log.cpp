@@ -0,0 +1,400 @@
+/*
+ * Activity History Store Implementation
+ * Delta/varint minute pages and incrementally maintained rollups
+ */
+
+#include "activity_log.h"
+#include <string.h>
+
+#define ROLLUP_HEADER 4
+#define ROLLUP_RECORD 12
+
+static const char* rollup_files[ROLLUP_LEVEL_COUNT] = {
+  ACTIVITY_LOG_HOURS_FILE, ACTIVITY_LOG_DAYS_FILE, ACTIVITY_LOG_WEEKS_FILE
+};
+
+// ==================== ENCODING ====================
+static void put32(uint8_t* data, uint32_t value) {
+  for (int i = 0; i < 4; i++) data[i] = value >> (8 * i);
+}
+
+static uint32_t get32(const uint8_t* data) {
+  return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static void put16(uint8_t* data, uint16_t value) {
+  data[0] = value;
+  data[1] = value >> 8;
+}
+
+static uint16_t get16(const uint8_t* data) {
+  return data[0] | (data[1] << 8);
+}
+
+static int putVarint(uint8_t* data, uint32_t value) {
+  int length = 0;
+  while (value >= 0x80) {
+    data[length++] = (value & 0x7F) | 0x80;
+    value >>= 7;
+  }
+  data[length++] = value;
+  return length;
+}
+
+static int getVarint(const uint8_t* data, int available, uint32_t& value) {
+  value = 0;
+  for (int i = 0; i < available && i < 5; i++) {
+    value |= (uint32_t)(data[i] & 0x7F) << (7 * i);
+    if (!(data[i] & 0x80)) return i + 1;
+  }
+  return -1;
+}
+
+static uint32_t zigzag(int32_t value) {
+  return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t unzigzag(uint32_t value) {
+  return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+static int encodeRecord(uint8_t* data, const ActivityMinute& ref, const ActivityMinute& minute) {
+  int length = putVarint(data, minute.minute - ref.minute);
+  length += putVarint(data + length, zigzag((int32_t)minute.steps - ref.steps));
+  length += putVarint(data + length, zigzag((int32_t)minute.active_seconds - ref.active_seconds));
+  length += putVarint(data + length, zigzag((int32_t)minute.energy_dcal - ref.energy_dcal));
+  return length;
+}
+
+static int decodeRecord(const uint8_t* data, int available, const ActivityMinute& ref, ActivityMinute& minute) {
+  uint32_t fields[4];
+  int length = 0;
+  for (int i = 0; i < 4; i++) {
+    int used = getVarint(data + length, available - length, fields[i]);
+    if (used < 0) return -1;
+    length += used;
+  }
+  minute.minute = ref.minute + fields[0];
+  minute.steps = ref.steps + unzigzag(fields[1]);
+  minute.active_seconds = ref.active_seconds + unzigzag(fields[2]);
+  minute.energy_dcal = ref.energy_dcal + unzigzag(fields[3]);
+  return length;
+}
+
+// Pages restart their deltas from the header's first minute
+static ActivityMinute pageReference(const uint8_t* page) {
+  ActivityMinute ref = {get32(page + 4), 0, 0, 0};
+  return ref;
+}
+
+static bool pageValid(const uint8_t* page) {
+  uint16_t used = get16(page + 2);
+  return get16(page) == ACTIVITY_LOG_PAGE_MAGIC && used >= ACTIVITY_LOG_PAGE_HEADER &&
+         used <= ACTIVITY_LOG_PAGE_SIZE;
+}
+
+// ==================== CALENDAR ====================
+uint32_t activityLogMinuteOf(int year, int month, int day, int hour, int minute) {
+  // Days since 2000-01-01 from the civil date, March-based years
+  int y = year - (month <= 2);
+  int era = y / 400;
+  int year_of_era = y - era * 400;
+  int day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  int day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+  int32_t days = era * 146097 + day_of_era - 730425;
+  if (days < 0) return 0;
+  return (uint32_t)days * 1440 + hour * 60 + minute;
+}
+
+uint32_t activityLogPeriod(RollupLevel level, uint32_t minute) {
+  switch (level) {
+    case ROLLUP_HOUR: return minute / 60;
+    case ROLLUP_DAY: return minute / 1440;
+    default: return (minute / 1440 + 5) / 7;  // 2000-01-03 was the first Monday
+  }
+}
+
+// ==================== STORAGE ====================
+static bool storageRead(ActivityLog& log, const char* path, uint32_t offset, uint8_t* data, size_t length) {
+  if (!log.storage->read(path, offset, data, length)) return false;
+  log.stats.bytes_read += length;
+  return true;
+}
+
+static bool storageWrite(ActivityLog& log, const char* path, uint32_t offset, const uint8_t* data, size_t length) {
+  if (!log.storage->write(path, offset, data, length)) return false;
+  log.stats.bytes_written += length;
+  return true;
+}
+
+static bool writePage(ActivityLog& log) {
+  put16(log.page, ACTIVITY_LOG_PAGE_MAGIC);
+  put16(log.page + 2, log.page_used);
+  put16(log.page + 8, log.page_records);
+  if (!storageWrite(log, ACTIVITY_LOG_MINUTES_FILE, log.page_number * ACTIVITY_LOG_PAGE_SIZE,
+                    log.page, ACTIVITY_LOG_PAGE_SIZE)) {
+    return false;
+  }
+  log.page_dirty = false;
+  log.stats.pages_written++;
+  return true;
+}
+
+static void startPage(ActivityLog& log, uint32_t first_minute) {
+  memset(log.page, 0, sizeof(log.page));
+  put32(log.page + 4, first_minute);
+  log.page_used = ACTIVITY_LOG_PAGE_HEADER;
+  log.page_records = 0;
+}
+
+static bool writeRollup(ActivityLog& log, RollupLevel level) {
+  ActivityRollup& rollup = log.rollups[level];
+  const char* path = rollup_files[level];
+
+  if (!rollup.has_base) {
+    uint8_t header[ROLLUP_HEADER];
+    put32(header, rollup.period);
+    if (!storageWrite(log, path, 0, header, sizeof(header))) return false;
+    rollup.base = rollup.period;
+    rollup.has_base = true;
+  }
+  if (rollup.period < rollup.base) {
+    rollup.dirty = false;  // Clock went back past the history, nowhere to put it
+    return false;
+  }
+
+  // Periods without activity are zero records, so every period is a direct seek
+  uint32_t offset = ROLLUP_HEADER + (rollup.period - rollup.base) * ROLLUP_RECORD;
+  int32_t size = log.storage->size(path);
+  if (size < ROLLUP_HEADER) return false;
+  static const uint8_t zeros[ROLLUP_RECORD * 16] = {};
+  while ((uint32_t)size < offset) {
+    uint32_t chunk = offset - size < sizeof(zeros) ? offset - size : sizeof(zeros);
+    if (!storageWrite(log, path, size, zeros, chunk)) return false;
+    size += chunk;
+  }
+
+  uint8_t record[ROLLUP_RECORD];
+  put32(record, rollup.open.steps);
+  put32(record + 4, rollup.open.energy_dcal);
+  put32(record + 8, rollup.open.active_seconds);
+  if (!storageWrite(log, path, offset, record, sizeof(record))) return false;
+  rollup.dirty = false;
+  log.stats.rollups_written++;
+  return true;
+}
+
+static bool readRollup(ActivityLog& log, RollupLevel level, uint32_t period, ActivityTotals& totals) {
+  const ActivityRollup& rollup = log.rollups[level];
+  memset(&totals, 0, sizeof(totals));
+  if (!rollup.has_base || period < rollup.base) return false;
+  uint32_t offset = ROLLUP_HEADER + (period - rollup.base) * ROLLUP_RECORD;
+  if (log.storage->size(rollup_files[level]) < (int32_t)(offset + ROLLUP_RECORD)) return false;
+
+  uint8_t record[ROLLUP_RECORD];
+  if (!storageRead(log, rollup_files[level], offset, record, sizeof(record))) return false;
+  totals.steps = get32(record);
+  totals.energy_dcal = get32(record + 4);
+  totals.active_seconds = get32(record + 8);
+  return true;
+}
+
+// ==================== LIFECYCLE ====================
+bool activityLogOpen(ActivityLog& log, const ActivityLogStorage& storage) {
+  memset(&log, 0, sizeof(log));
+  log.storage = &storage;
+
+  for (int level = 0; level < ROLLUP_LEVEL_COUNT; level++) {
+    uint8_t header[ROLLUP_HEADER];
+    if (storage.size(rollup_files[level]) >= ROLLUP_HEADER &&
+        storageRead(log, rollup_files[level], 0, header, sizeof(header))) {
+      log.rollups[level].base = get32(header);
+      log.rollups[level].has_base = true;
+    }
+  }
+
+  // Reload the last page and replay it to recover the delta reference
+  int32_t size = storage.size(ACTIVITY_LOG_MINUTES_FILE);
+  uint32_t pages = size > 0 ? size / ACTIVITY_LOG_PAGE_SIZE : 0;
+  startPage(log, 0);
+  if (pages > 0) {
+    log.page_number = pages - 1;
+    if (!storageRead(log, ACTIVITY_LOG_MINUTES_FILE, log.page_number * ACTIVITY_LOG_PAGE_SIZE,
+                     log.page, ACTIVITY_LOG_PAGE_SIZE) || !pageValid(log.page)) {
+      return false;
+    }
+    log.page_used = get16(log.page + 2);
+    ActivityMinute ref = pageReference(log.page);
+    int offset = ACTIVITY_LOG_PAGE_HEADER;
+    while (offset < log.page_used) {
+      ActivityMinute minute;
+      int length = decodeRecord(log.page + offset, log.page_used - offset, ref, minute);
+      if (length < 0) return false;
+      offset += length;
+      ref = minute;
+      log.page_records++;
+    }
+    log.last = ref;
+    log.has_last = log.page_records > 0;
+
+    if (log.page_used + ACTIVITY_LOG_MAX_RECORD > ACTIVITY_LOG_PAGE_SIZE) {
+      log.page_number = pages;
+      startPage(log, 0);
+    }
+  }
+
+  // The periods holding the last minute are still open
+  if (log.has_last) {
+    for (int level = 0; level < ROLLUP_LEVEL_COUNT; level++) {
+      ActivityRollup& rollup = log.rollups[level];
+      rollup.period = activityLogPeriod((RollupLevel)level, log.last.minute);
+      rollup.has_period = true;
+      readRollup(log, (RollupLevel)level, rollup.period, rollup.open);
+    }
+  }
+
+  log.open = true;
+  return true;
+}
+
+bool activityLogAppend(ActivityLog& log, const ActivityMinute& minute) {
+  if (!log.open) return false;
+  if (minute.steps == 0 && minute.active_seconds == 0 && minute.energy_dcal == 0) {
+    log.stats.idle++;
+    return true;
+  }
+  if (log.has_last && minute.minute <= log.last.minute) {
+    log.stats.rejected++;
+    return false;
+  }
+
+  // Close rollup periods this minute has moved past
+  for (int level = 0; level < ROLLUP_LEVEL_COUNT; level++) {
+    ActivityRollup& rollup = log.rollups[level];
+    uint32_t period = activityLogPeriod((RollupLevel)level, minute.minute);
+    if (rollup.has_period && period != rollup.period) {
+      if (rollup.dirty) writeRollup(log, (RollupLevel)level);
+      memset(&rollup.open, 0, sizeof(rollup.open));
+    }
+    rollup.period = period;
+    rollup.has_period = true;
+    rollup.open.steps += minute.steps;
+    rollup.open.energy_dcal += minute.energy_dcal;
+    rollup.open.active_seconds += minute.active_seconds;
+    rollup.dirty = true;
+  }
+
+  uint8_t record[ACTIVITY_LOG_MAX_RECORD];
+  if (log.page_records == 0) startPage(log, minute.minute);
+  int length = encodeRecord(record, log.page_records ? log.last : pageReference(log.page), minute);
+  if (log.page_used + length > ACTIVITY_LOG_PAGE_SIZE) {
+    if (!writePage(log)) return false;
+    log.page_number++;
+    startPage(log, minute.minute);
+    length = encodeRecord(record, pageReference(log.page), minute);
+  }
+
+  memcpy(log.page + log.page_used, record, length);
+  log.page_used += length;
+  log.page_records++;
+  log.page_dirty = true;
+  log.last = minute;
+  log.has_last = true;
+  log.stats.appended++;
+  return true;
+}
+
+bool activityLogFlush(ActivityLog& log) {
+  if (!log.open) return false;
+  bool ok = true;
+  if (log.page_dirty) ok &= writePage(log);
+  for (int level = 0; level < ROLLUP_LEVEL_COUNT; level++) {
+    if (log.rollups[level].dirty) ok &= writeRollup(log, (RollupLevel)level);
+  }
+  return ok;
+}
+
+// ==================== QUERIES ====================
+int activityLogTotals(ActivityLog& log, RollupLevel level, uint32_t first_period, int count,
+                      ActivityTotals* totals) {
+  if (!log.open || count <= 0) return 0;
+  memset(totals, 0, count * sizeof(ActivityTotals));
+  const ActivityRollup& rollup = log.rollups[level];
+
+  // One contiguous read covers every stored period in range
+  if (rollup.has_base) {
+    int32_t size = log.storage->size(rollup_files[level]);
+    uint32_t stored = size > ROLLUP_HEADER ? (size - ROLLUP_HEADER) / ROLLUP_RECORD : 0;
+    uint32_t first = first_period > rollup.base ? first_period : rollup.base;
+    uint32_t end = first_period + count < rollup.base + stored ? first_period + count : rollup.base + stored;
+    if (first < end) {
+      static uint8_t records[ROLLUP_RECORD * 32];
+      while (first < end) {
+        uint32_t batch = end - first < 32 ? end - first : 32;
+        if (!storageRead(log, rollup_files[level], ROLLUP_HEADER + (first - rollup.base) * ROLLUP_RECORD,
+                         records, batch * ROLLUP_RECORD)) {
+          break;
+        }
+        for (uint32_t i = 0; i < batch; i++) {
+          ActivityTotals& t = totals[first + i - first_period];
+          t.steps = get32(records + i * ROLLUP_RECORD);
+          t.energy_dcal = get32(records + i * ROLLUP_RECORD + 4);
+          t.active_seconds = get32(records + i * ROLLUP_RECORD + 8);
+        }
+        first += batch;
+      }
+    }
+  }
+
+  // The open period in RAM is newer than its record on disk
+  if (rollup.has_period && rollup.period >= first_period && rollup.period < first_period + count) {
+    totals[rollup.period - first_period] = rollup.open;
+  }
+  return count;
+}
+
+int activityLogMinutes(ActivityLog& log, uint32_t from_minute, uint32_t to_minute,
+                       ActivityMinute* minutes, int max_minutes) {
+  if (!log.open) return 0;
+
+  // Binary search the stored pages for the last one starting at or before from_minute
+  static uint8_t page[ACTIVITY_LOG_PAGE_SIZE];
+  uint32_t low = 0, high = log.page_number;
+  while (high - low > 1) {
+    uint32_t middle = (low + high) / 2;
+    uint8_t header[ACTIVITY_LOG_PAGE_HEADER];
+    if (!storageRead(log, ACTIVITY_LOG_MINUTES_FILE, middle * ACTIVITY_LOG_PAGE_SIZE, header, sizeof(header))) {
+      return 0;
+    }
+    if (get32(header + 4) <= from_minute) {
+      low = middle;
+    } else {
+      high = middle;
+    }
+  }
+
+  int found = 0;
+  for (uint32_t number = low; number <= log.page_number && found < max_minutes; number++) {
+    const uint8_t* data = log.page;
+    if (number < log.page_number) {
+      if (!storageRead(log, ACTIVITY_LOG_MINUTES_FILE, number * ACTIVITY_LOG_PAGE_SIZE, page, sizeof(page)) ||
+          !pageValid(page)) {
+        break;
+      }
+      data = page;
+    }
+    uint16_t used = number < log.page_number ? get16(data + 2) : log.page_used;
+    ActivityMinute ref = pageReference(data);
+    int offset = ACTIVITY_LOG_PAGE_HEADER;
+    while (offset < used && found < max_minutes) {
+      ActivityMinute minute;
+      int length = decodeRecord(data + offset, used - offset, ref, minute);
+      if (length < 0) break;
+      offset += length;
+      ref = minute;
+      if (minute.minute >= to_minute) return found;
+      if (minute.minute >= from_minute) minutes[found++] = minute;
+    }
+  }
+  return found;
+}
\ No newline at end of file
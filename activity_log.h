@@ -0,0 +1,104 @@
+/*
+ * Activity History Store for ESP32-S3 Watch
+ * Per-minute buckets with hourly, daily and weekly rollups on SD
+ *
+ * Minutes with any activity are appended to fixed 512-byte pages, one SD
+ * sector each. Every record is the zigzag varint delta of the previous
+ * one, so a steady walk costs a few bytes a minute and idle minutes cost
+ * nothing. Each page restarts its deltas from its header, so pages decode
+ * on their own and can be binary searched by their first minute.
+ *
+ * Rollups are flat files of fixed records indexed by period number. They
+ * are updated as minutes arrive, so a 30-day chart is a single 360-byte
+ * read and never touches the minute pages. Storage goes through an
+ * ActivityLogStorage: SD on the watch, a directory in sd_mock.h on host.
+ */
+
+#ifndef ACTIVITY_LOG_H
+#define ACTIVITY_LOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define ACTIVITY_LOG_PAGE_SIZE 512
+#define ACTIVITY_LOG_PAGE_HEADER 12
+#define ACTIVITY_LOG_PAGE_MAGIC 0xAC71
+#define ACTIVITY_LOG_MAX_RECORD 14     // Minute delta 5 bytes, three values 3 bytes each
+
+#define ACTIVITY_LOG_MINUTES_FILE "/activity/minutes.dat"
+#define ACTIVITY_LOG_HOURS_FILE "/activity/hours.dat"
+#define ACTIVITY_LOG_DAYS_FILE "/activity/days.dat"
+#define ACTIVITY_LOG_WEEKS_FILE "/activity/weeks.dat"
+
+// One minute of activity, minute counted from 2000-01-01 00:00 local time
+struct ActivityMinute {
+  uint32_t minute;
+  uint16_t steps;
+  uint8_t active_seconds;
+  uint16_t energy_dcal;     // Tenths of a kcal
+};
+
+struct ActivityTotals {
+  uint32_t steps;
+  uint32_t energy_dcal;
+  uint32_t active_seconds;
+};
+
+enum RollupLevel {
+  ROLLUP_HOUR,
+  ROLLUP_DAY,
+  ROLLUP_WEEK,              // Monday to Sunday
+  ROLLUP_LEVEL_COUNT
+};
+
+// Byte files that can be read and written at an offset, never past the end
+struct ActivityLogStorage {
+  int32_t (*size)(const char* path);  // -1 when missing
+  bool (*read)(const char* path, uint32_t offset, uint8_t* data, size_t length);
+  bool (*write)(const char* path, uint32_t offset, const uint8_t* data, size_t length);
+};
+
+// Open period of one rollup level, written back when it closes or on flush
+struct ActivityRollup {
+  uint32_t base;            // Period number of the file's first record
+  uint32_t period;
+  ActivityTotals open;
+  bool has_base, has_period, dirty;
+};
+
+struct ActivityLogStats {
+  uint32_t appended, idle, rejected;
+  uint32_t pages_written, rollups_written;
+  uint32_t bytes_written, bytes_read;
+};
+
+struct ActivityLog {
+  const ActivityLogStorage* storage;
+  bool open;
+  uint8_t page[ACTIVITY_LOG_PAGE_SIZE];
+  uint32_t page_number;     // Index of the page held in RAM
+  uint16_t page_used;
+  uint16_t page_records;
+  bool page_dirty;
+  ActivityMinute last;      // Delta reference within the page
+  bool has_last;
+  ActivityRollup rollups[ROLLUP_LEVEL_COUNT];
+  ActivityLogStats stats;
+};
+
+// Lifecycle
+bool activityLogOpen(ActivityLog& log, const ActivityLogStorage& storage);
+bool activityLogAppend(ActivityLog& log, const ActivityMinute& minute);
+bool activityLogFlush(ActivityLog& log);
+
+// Queries
+int activityLogTotals(ActivityLog& log, RollupLevel level, uint32_t first_period, int count,
+                      ActivityTotals* totals);
+int activityLogMinutes(ActivityLog& log, uint32_t from_minute, uint32_t to_minute,
+                       ActivityMinute* minutes, int max_minutes);
+
+// Calendar
+uint32_t activityLogMinuteOf(int year, int month, int day, int hour, int minute);
+uint32_t activityLogPeriod(RollupLevel level, uint32_t minute);
+
+#endif // ACTIVITY_LOG_H
\ No newline at end of file
@@ -0,0 +1,29 @@
+/*
+ * Activity Decision Tree
+ * Regenerate with: python3 tools/train_activity.py --output activity_tree.h ...
+ *
+ * Seed tree written from typical wrist signals until labelled captures
+ * are available: still hands are quiet, walking and running differ in
+ * step frequency and amplitude, cycling is periodic but gentle.
+ */
+
+#ifndef ACTIVITY_TREE_H
+#define ACTIVITY_TREE_H
+
+#include "activity.h"
+
+static constexpr ActivityTreeNode ACTIVITY_TREE[] = {
+  {FEATURE_MAGNITUDE_VARIANCE, 300, 1, 4},       // 0: std below ~0.017g?
+  {FEATURE_GYRO_MEAN, 15, 2, 3},                 // 1
+  {-1, ACTIVITY_STATIONARY, 0, 0},               // 2
+  {-1, ACTIVITY_OTHER, 0, 0},                    // 3
+  {FEATURE_PERIODICITY, 25, 3, 5},               // 4: no clear rhythm -> other
+  {FEATURE_DOMINANT_FREQ, 240, 6, 9},            // 5
+  {FEATURE_MAGNITUDE_VARIANCE, 14400, 7, 8},     // 6: std below ~0.12g?
+  {-1, ACTIVITY_CYCLING, 0, 0},                  // 7
+  {-1, ACTIVITY_WALKING, 0, 0},                  // 8
+  {FEATURE_MAGNITUDE_VARIANCE, 40000, 8, 10},    // 9: fast and strong -> running
+  {-1, ACTIVITY_RUNNING, 0, 0},                  // 10
+};
+
+#endif // ACTIVITY_TREE_H
\ No newline at end of file
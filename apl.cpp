@@ -0,0 +1,148 @@
+/*
+ * Picture Level and Display Power Limiter Implementation
+ * Tile map of painted luminance, and brightness against a current budget
+ */
+
+#include "apl.h"
+#include <string.h>
+
+// ==================== MAP ====================
+void aplInit(AplMap& map, uint16_t width, uint16_t height) {
+  memset(&map, 0, sizeof(map));
+  map.width = width;
+  map.height = height;
+  map.cols = (width + APL_TILE - 1) / APL_TILE;
+  map.rows = (height + APL_TILE - 1) / APL_TILE;
+  if (map.cols > APL_MAX_COLS) map.cols = APL_MAX_COLS;
+  if (map.rows > APL_MAX_ROWS) map.rows = APL_MAX_ROWS;
+}
+
+void aplClear(AplMap& map, uint16_t luminance) {
+  for (int row = 0; row < map.rows; row++) {
+    for (int col = 0; col < map.cols; col++) {
+      map.tile[row][col] = luminance;
+    }
+  }
+  map.sum = (uint32_t)luminance * map.rows * map.cols;
+}
+
+void aplPaint(AplMap& map, int x, int y, int w, int h, uint16_t luminance, uint16_t coverage) {
+  // Clip to the screen and to the map
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  int right = map.cols * APL_TILE < map.width ? map.cols * APL_TILE : map.width;
+  int bottom = map.rows * APL_TILE < map.height ? map.rows * APL_TILE : map.height;
+  if (x + w > right) w = right - x;
+  if (y + h > bottom) h = bottom - y;
+  if (w <= 0 || h <= 0 || coverage == 0) return;
+  if (coverage > 1000) coverage = 1000;
+  map.paints++;
+
+  for (int row = y / APL_TILE; row <= (y + h - 1) / APL_TILE; row++) {
+    int tile_y = row * APL_TILE;
+    int tile_h = tile_y + APL_TILE <= map.height ? APL_TILE : map.height - tile_y;
+    int top = y > tile_y ? y : tile_y;
+    int end_y = y + h < tile_y + tile_h ? y + h : tile_y + tile_h;
+    for (int col = x / APL_TILE; col <= (x + w - 1) / APL_TILE; col++) {
+      int tile_x = col * APL_TILE;
+      int tile_w = tile_x + APL_TILE <= map.width ? APL_TILE : map.width - tile_x;
+      int left = x > tile_x ? x : tile_x;
+      int end_x = x + w < tile_x + tile_w ? x + w : tile_x + tile_w;
+
+      // Blend by the share of the tile's pixels painted
+      int32_t painted = (end_x - left) * (end_y - top) * coverage;
+      int32_t area = tile_w * tile_h * 1000;
+      uint16_t& tile = map.tile[row][col];
+      int32_t updated = painted >= area ? luminance :
+                        tile + (int32_t)(((int64_t)luminance - tile) * painted / area);
+      map.sum += updated - tile;
+      tile = (uint16_t)updated;
+    }
+  }
+}
+
+uint16_t aplLevel(const AplMap& map) {
+  uint32_t tiles = (uint32_t)map.rows * map.cols;
+  return tiles ? (uint16_t)(map.sum / tiles) : 0;
+}
+
+void aplHistogram(const AplMap& map, uint16_t* bins) {
+  memset(bins, 0, APL_HISTOGRAM_BINS * sizeof(uint16_t));
+  for (int row = 0; row < map.rows; row++) {
+    for (int col = 0; col < map.cols; col++) {
+      int bin = map.tile[row][col] * APL_HISTOGRAM_BINS / 1001;
+      bins[bin]++;
+    }
+  }
+}
+
+// ==================== LIMITER ====================
+uint8_t aplAllowedBrightness(const EnergyModel& model, uint32_t budget_ua, uint16_t apl) {
+  // Inverse of energyDisplayCurrent() in brightness
+  uint32_t base = energyDisplayCurrent(model, 0, apl);
+  if (budget_ua <= base) return 0;
+  uint64_t per_point = (uint64_t)model.ua[ENERGY_COEFF_DISPLAY_WHITE] * apl;
+  if (per_point == 0) return 100;
+  uint64_t brightness = (uint64_t)(budget_ua - base) * 100000 / per_point;
+  return brightness > 100 ? 100 : (uint8_t)brightness;
+}
+
+void aplLimiterInit(AplLimiter& limiter, const AplLimiterProfile& profile) {
+  memset(&limiter, 0, sizeof(limiter));
+  limiter.profile = profile;
+}
+
+void aplLimiterScreenChanged(AplLimiter& limiter) {
+  limiter.screen_kept = false;
+  limiter.pending = false;
+}
+
+uint8_t aplLimiterUpdate(AplLimiter& limiter, const EnergyModel& model, const AplLimiterInput& input) {
+  const AplLimiterProfile& profile = limiter.profile;
+  uint32_t now = input.now_ms;
+  if (!limiter.started) {
+    limiter.started = true;
+    limiter.last_ms = now;
+    limiter.brightness = input.requested;
+  }
+  uint32_t elapsed = now - limiter.last_ms;
+  limiter.last_ms = now;
+  limiter.stats.updates++;
+  if (limiter.brightness < input.requested) limiter.stats.limited_ms += elapsed;
+  if (limiter.dark) limiter.stats.dark_ms += elapsed;
+
+  bool low_battery = !input.charging && input.battery_percent <= profile.low_battery_percent;
+  uint32_t budget = low_battery ? profile.low_battery_budget_ua : profile.budget_ua;
+
+  // Brightness within budget, down to the floor; a choice below the floor stands
+  uint8_t target = aplAllowedBrightness(model, budget, input.apl);
+  uint8_t floor = input.requested < profile.min_brightness ? input.requested : profile.min_brightness;
+  if (target < floor) target = floor;
+  if (target > input.requested) target = input.requested;
+
+  if (target >= limiter.brightness) {
+    limiter.brightness = target;
+  } else {
+    limiter.brightness = limiter.brightness - target > profile.step ? limiter.brightness - profile.step : target;
+  }
+
+  // At the floor and still over: only darker content brings it down
+  bool over = energyDisplayCurrent(model, target, input.apl) > budget;
+  if (limiter.dark) {
+    if (!low_battery && (limiter.for_battery || !limiter.screen_kept)) limiter.dark = false;
+  } else if (low_battery || over) {
+    if (!limiter.pending) {
+      limiter.pending = true;
+      limiter.pending_since_ms = now;
+    } else if (now - limiter.pending_since_ms >= profile.dark_hold_ms) {
+      limiter.dark = true;
+      limiter.screen_kept = true;
+      limiter.for_battery = low_battery;
+      limiter.pending = false;
+      limiter.stats.dark_switches++;
+    }
+  } else {
+    limiter.pending = false;
+  }
+  return limiter.brightness;
+}
\ No newline at end of file
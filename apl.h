@@ -0,0 +1,100 @@
+/*
+ * Picture Level and Display Power Limiter for ESP32-S3 Watch
+ * What the AMOLED is lighting, and how bright it can afford to be
+ *
+ * An AMOLED pays per lit pixel: a black frame costs only the panel's
+ * base current, a white one at full brightness tens of milliamps. Most
+ * drawing goes straight to the panel, so there is no full framebuffer
+ * to read back. Instead the drawing primitives report each area they
+ * paint, with its colour's luminance and how much of the area the shape
+ * covers, into a coarse map of tiles. A tile blends towards the new
+ * luminance by the share of its pixels that were painted, as if the paint
+ * landed anywhere in it; shapes drawn strip by strip, like gradients, are
+ * reported once as a whole so that adjacent strips add up. The average
+ * picture level (APL) is the mean over the tiles, kept as a running sum,
+ * so reading it is free and painting costs one update per tile touched.
+ *
+ * The limiter takes the APL after each frame and the brightness the user
+ * chose. From the energy model's panel terms it works out the brightness
+ * at which the display stays within its current budget, with a tighter
+ * budget on low battery. Brightness steps down gradually and comes back
+ * at once. If even the lowest brightness it will use is over budget, or
+ * the battery is low, it asks for the theme's dark variant after a hold
+ * time. A dark variant stays until the screen changes or the battery
+ * recovers, because the darker frames it draws would otherwise argue it
+ * straight back out. The panel current uses the same function as energy
+ * accounting, so per-screen display power reads the same on host.
+ */
+
+#ifndef APL_H
+#define APL_H
+
+#include <stdint.h>
+#include "energy.h"
+
+#define APL_TILE 16                  // Pixels per tile side
+#define APL_MAX_COLS 32
+#define APL_MAX_ROWS 32
+#define APL_HISTOGRAM_BINS 10        // Tenths of full white
+
+struct AplMap {
+  uint16_t width, height;
+  uint8_t cols, rows;
+  uint16_t tile[APL_MAX_ROWS][APL_MAX_COLS];  // Luminance, permille
+  uint32_t sum;                      // Of all tiles
+  uint32_t paints;
+};
+
+// Map
+void aplInit(AplMap& map, uint16_t width, uint16_t height);
+void aplClear(AplMap& map, uint16_t luminance);
+void aplPaint(AplMap& map, int x, int y, int w, int h, uint16_t luminance, uint16_t coverage);  // Coverage permille
+uint16_t aplLevel(const AplMap& map);  // Permille of full white
+void aplHistogram(const AplMap& map, uint16_t* bins);  // Tiles per tenth of luminance
+
+struct AplLimiterProfile {
+  uint32_t budget_ua;                // Display current allowed
+  uint32_t low_battery_budget_ua;
+  uint8_t low_battery_percent;       // At or below, unless charging
+  uint8_t min_brightness;            // Never dims a choice above this below it
+  uint8_t step;                      // Brightness points per update when dimming
+  uint32_t dark_hold_ms;             // Over budget this long before the dark variant
+};
+
+struct AplLimiterInput {
+  uint32_t now_ms;
+  uint16_t apl;                      // Permille
+  uint8_t requested;                 // Brightness the user chose, percent
+  uint8_t battery_percent;
+  bool charging;
+};
+
+struct AplLimiterStats {
+  uint32_t updates;
+  uint32_t limited_ms;               // Below the chosen brightness
+  uint32_t dark_ms;
+  uint32_t dark_switches;
+};
+
+struct AplLimiter {
+  AplLimiterProfile profile;
+  uint8_t brightness;                // To apply
+  bool dark;                         // Dark theme variant wanted
+  bool screen_kept;                  // Same screen since going dark
+  bool for_battery;                  // Went dark on low battery, not over budget
+  bool pending;
+  uint32_t pending_since_ms;
+  uint32_t last_ms;
+  bool started;
+  AplLimiterStats stats;
+};
+
+// Limiter
+void aplLimiterInit(AplLimiter& limiter, const AplLimiterProfile& profile);
+uint8_t aplLimiterUpdate(AplLimiter& limiter, const EnergyModel& model, const AplLimiterInput& input);
+void aplLimiterScreenChanged(AplLimiter& limiter);
+
+// Brightness at which the panel draws no more than budget_ua at this APL
+uint8_t aplAllowedBrightness(const EnergyModel& model, uint32_t budget_ua, uint16_t apl);
+
+#endif // APL_H
\ No newline at end of file
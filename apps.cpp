@@ -10,6 +10,9 @@
 #include "games.h"
 #include "music_app.cpp"
 #include "quests.h"
+#include "sensors.h"
+#include "power.h"
+#include "filesystem.h"
 
 // App registry
 WatchApp registered_apps[] = {
@@ -18,7 +21,7 @@ WatchApp registered_apps[] = {
   {APP_MUSIC, "Music", "", COLOR_BLUE, true, initMusicApp, drawMusicApp, handleMusicTouch, nullptr},
   {APP_GAMES, "Games", "", COLOR_GREEN, true, initializeGames, drawGameMenu, handleGameMenuTouch, nullptr},
   {APP_NOTES, "Notes", "", COLOR_YELLOW, true, initNotesApp, drawNotesApp, handleNotesTouch, nullptr},
-  {APP_FILES, "Files", "", COLOR_ORANGE, true, initFileBrowserApp, drawFileBrowserApp, handleFileBrowserTouch, nullptr},
+  {APP_FILES, "Files", "", COLOR_ORANGE, true, initFileBrowserApp, drawFileBrowserApp, nullptr, nullptr},
   {APP_PDF_READER, "PDF", "", COLOR_RED, true, initPDFReaderApp, drawPDFReaderApp, handlePDFReaderTouch, nullptr},
   {APP_SETTINGS, "Settings", "", COLOR_PURPLE, true, initSettingsApp, drawSettingsApp, handleSettingsTouch, nullptr},
   {APP_WEATHER, "Weather", "", COLOR_CYAN, true, initWeatherApp, drawWeatherApp, handleWeatherTouch, nullptr}
@@ -98,6 +101,9 @@ void drawAppGrid() {
     
     // App name
     drawCenteredText(registered_apps[i].name.c_str(), x + app_size/2, y + app_size + 10, theme->text, 1);
+    
+    // Icon and its label launch the app
+    addHitRegion(x, y, app_size, app_size + 20, i);
   }
   
   // Instructions
@@ -183,26 +189,9 @@ void handleAppGridTouch(TouchGesture& gesture) {
   if (gesture.event != TOUCH_TAP) return;
   
   // Calculate which app was tapped
-  int apps_per_row = 3;
-  int app_size = 60;
-  int spacing = 20;
-  int grid_width = apps_per_row * app_size + (apps_per_row - 1) * spacing;
-  int start_x = (DISPLAY_WIDTH - grid_width) / 2;
-  int start_y = 80;
-  
-  for (int i = 0; i < num_registered_apps && i < 9; i++) {
-    int row = i / apps_per_row;
-    int col = i % apps_per_row;
-    
-    int x = start_x + col * (app_size + spacing);
-    int y = start_y + row * (app_size + spacing + 20);
-    
-    if (gesture.x >= x && gesture.x <= x + app_size &&
-        gesture.y >= y && gesture.y <= y + app_size) {
-      
-      launchApp(registered_apps[i].type);
-      return;
-    }
+  const HitRegion* region = findHitRegion(gesture);
+  if (region != nullptr && region->tag < num_registered_apps) {
+    launchApp(registered_apps[region->tag].type);
   }
 }
 
@@ -211,6 +200,12 @@ void switchToApp(AppType app) {
 }
 
 // ==================== NOTES APP ====================
+enum NotesHitTag {
+  NOTES_HIT_NEW,
+  NOTES_HIT_SAVE,
+  NOTES_HIT_LOAD
+};
+
 void initNotesApp() {
   Serial.println("Notes app initialized");
 }
@@ -239,6 +234,9 @@ void drawNotesApp() {
   drawGameButton(20, 280, DISPLAY_WIDTH - 40, 40, "New Note", false);
   drawGameButton(20, 330, DISPLAY_WIDTH - 40, 40, "Save Note", false);
   drawGameButton(20, 380, DISPLAY_WIDTH - 40, 40, "Load Note", false);
+  addHitRegion(20, 280, DISPLAY_WIDTH - 40, 40, NOTES_HIT_NEW);
+  addHitRegion(20, 330, DISPLAY_WIDTH - 40, 40, NOTES_HIT_SAVE);
+  addHitRegion(20, 380, DISPLAY_WIDTH - 40, 40, NOTES_HIT_LOAD);
   
   updateDisplay();
 }
@@ -246,13 +244,20 @@ void drawNotesApp() {
 void handleNotesTouch(TouchGesture& gesture) {
   if (gesture.event != TOUCH_TAP) return;
   
+  const HitRegion* region = findHitRegion(gesture);
+  if (region == nullptr) return;
+  
   // Simple note handling - in a real implementation this would have text input
-  if (gesture.y >= 280 && gesture.y <= 320) {
-    system_state.current_note = "Sample note created at " + String(millis());
-  } else if (gesture.y >= 330 && gesture.y <= 370) {
-    saveNote();
-  } else if (gesture.y >= 380 && gesture.y <= 420) {
-    loadNote();
+  switch (region->tag) {
+    case NOTES_HIT_NEW:
+      system_state.current_note = "Sample note created at " + String(millis());
+      break;
+    case NOTES_HIT_SAVE:
+      saveNote();
+      break;
+    case NOTES_HIT_LOAD:
+      loadNote();
+      break;
   }
 }
 
@@ -268,6 +273,7 @@ void loadNote() {
 
 // ==================== FILE BROWSER APP ====================
 void initFileBrowserApp() {
+  ensureMediaIndex();
   Serial.println("File browser app initialized");
 }
 
@@ -297,24 +303,102 @@ void drawFileBrowserApp() {
     drawText("📄 " + pdf_files[0].title, 20, 170, theme->accent, 1);
   }
   
+  // Carries its action, handleUITouch() runs it on a tap
   drawGameButton(20, 300, DISPLAY_WIDTH - 40, 40, "Refresh Files", false);
+  addHitRegion(20, 300, DISPLAY_WIDTH - 40, 40, 0, indexMediaFiles);
   
   updateDisplay();
 }
 
-void handleFileBrowserTouch(TouchGesture& gesture) {
-  if (gesture.event != TOUCH_TAP && gesture.y >= 300 && gesture.y <= 340) {
-    // Refresh file list
-    total_music_files = scanMusicFiles(music_files, 100);
-    total_pdf_files = scanPDFFiles(pdf_files, 50);
-  }
-}
-
 // ==================== PDF READER APP ====================
+// Page viewport, matches the content area drawn below
+#define PDF_VIEW_X 20
+#define PDF_VIEW_Y 180
+#define PDF_VIEW_W (DISPLAY_WIDTH - 40)
+#define PDF_VIEW_H 120
+#define PDF_RENDER_SCALE 2.0  // Page is rendered once at 2x for sharp zoom
+#define PDF_MIN_ZOOM 1.0
+#define PDF_MAX_ZOOM 4.0
+
+static ZoomCache pdf_page_cache;
+static int pdf_cached_page = -1;
+static int pdf_current_page = 0;
+static float pdf_zoom = 1.0;
+static float pdf_pinch_base_zoom = 1.0;
+static bool pdf_pinch_active = false;
+static float pdf_origin_x = 0;  // Viewport top-left in page coordinates
+static float pdf_origin_y = 0;
+
 void initPDFReaderApp() {
+  ensureMediaIndex();
+  // launchApp() runs this on every launch: drop the last page's levels
+  zoomCacheFree(pdf_page_cache);
+  pdf_cached_page = -1;
+  pdf_current_page = 0;
+  pdf_zoom = 1.0;
+  pdf_origin_x = 0;
+  pdf_origin_y = 0;
   Serial.println("PDF reader app initialized");
 }
 
+static void renderPDFPage() {
+  int w = PDF_VIEW_W * PDF_RENDER_SCALE;
+  int h = PDF_VIEW_H * PDF_RENDER_SCALE;
+  TFT_eSprite* canvas = createCanvas(w, h);
+  if (!canvas) {
+    Serial.println("PDF page canvas allocation failed!");
+    return;
+  }
+  
+  // Page content (placeholder until a PDF renderer is wired in)
+  canvas->fillSprite(COLOR_WHITE);
+  canvas->setTextColor(COLOR_BLACK);
+  canvas->setTextSize(2);
+  canvas->setCursor(16, 16);
+  canvas->print(pdf_files[0].title);
+  canvas->setCursor(16, 56);
+  canvas->printf("Page %d of %d", pdf_current_page + 1, pdf_files[0].pages);
+  canvas->setCursor(16, 120);
+  canvas->print("PDF content would");
+  canvas->setCursor(16, 150);
+  canvas->print("be displayed here");
+  
+  // Sprite memory is in pushSprite() byte order
+  if (zoomCacheBuild(pdf_page_cache, (uint16_t*)canvas->getPointer(), w, h, PDF_RENDER_SCALE, 3, true)) {
+    pdf_cached_page = pdf_current_page;
+  }
+  
+  deleteCanvas(canvas);
+}
+
+static void clampPDFView() {
+  if (pdf_zoom < PDF_MIN_ZOOM) pdf_zoom = PDF_MIN_ZOOM;
+  if (pdf_zoom > PDF_MAX_ZOOM) pdf_zoom = PDF_MAX_ZOOM;
+  
+  float max_x = PDF_VIEW_W - PDF_VIEW_W / pdf_zoom;
+  float max_y = PDF_VIEW_H - PDF_VIEW_H / pdf_zoom;
+  pdf_origin_x = constrain(pdf_origin_x, 0, max_x);
+  pdf_origin_y = constrain(pdf_origin_y, 0, max_y);
+}
+
+// Change zoom while keeping the page point under (screen_x, screen_y) fixed
+static void zoomPDFAt(float new_zoom, int screen_x, int screen_y) {
+  float anchor_x = pdf_origin_x + (screen_x - PDF_VIEW_X) / pdf_zoom;
+  float anchor_y = pdf_origin_y + (screen_y - PDF_VIEW_Y) / pdf_zoom;
+  
+  pdf_zoom = constrain(new_zoom, PDF_MIN_ZOOM, PDF_MAX_ZOOM);
+  pdf_origin_x = anchor_x - (screen_x - PDF_VIEW_X) / pdf_zoom;
+  pdf_origin_y = anchor_y - (screen_y - PDF_VIEW_Y) / pdf_zoom;
+  clampPDFView();
+}
+
+// Touch regions registered by drawPDFReaderApp()
+enum PDFHitTag {
+  PDF_HIT_PREV,
+  PDF_HIT_NEXT,
+  PDF_HIT_ZOOM
+};
+
 void drawPDFReaderApp() {
   clearDisplay();
   ThemeColors* theme = getCurrentTheme();
@@ -328,15 +412,20 @@ void drawPDFReaderApp() {
     drawCenteredText("Current PDF:", DISPLAY_WIDTH/2, 140, theme->secondary, 1);
     drawCenteredText(pdf_files[0].title, DISPLAY_WIDTH/2, 160, theme->text, 1);
     
-    // PDF content area (placeholder)
-    fillRoundRect(20, 180, DISPLAY_WIDTH - 40, 120, 8, COLOR_WHITE);
-    drawRoundRect(20, 180, DISPLAY_WIDTH - 40, 120, 8, theme->secondary);
-    drawCenteredText("PDF content would", DISPLAY_WIDTH/2, 220, COLOR_BLACK, 1);
-    drawCenteredText("be displayed here", DISPLAY_WIDTH/2, 240, COLOR_BLACK, 1);
+    // PDF content area, sampled from the zoom cache
+    if (pdf_cached_page != pdf_current_page) {
+      renderPDFPage();
+    }
+    drawZoomedImage(PDF_VIEW_X, PDF_VIEW_Y, PDF_VIEW_W, PDF_VIEW_H, pdf_page_cache,
+                    pdf_zoom, pdf_origin_x, pdf_origin_y, COLOR_WHITE);
+    drawRoundRect(PDF_VIEW_X, PDF_VIEW_Y, PDF_VIEW_W, PDF_VIEW_H, 8, theme->secondary);
     
     drawGameButton(20, 320, 80, 30, "Prev", false);
     drawGameButton(120, 320, 80, 30, "Next", false);
-    drawGameButton(220, 320, 80, 30, "Zoom", false);
+    drawGameButton(220, 320, 80, 30, "Zoom", pdf_zoom > PDF_MIN_ZOOM);
+    addHitRegion(20, 320, 80, 30, PDF_HIT_PREV);
+    addHitRegion(120, 320, 80, 30, PDF_HIT_NEXT);
+    addHitRegion(220, 320, 80, 30, PDF_HIT_ZOOM);
   } else {
     drawCenteredText("No PDF files found", DISPLAY_WIDTH/2, 200, theme->secondary, 1);
     drawCenteredText("Add PDF files to SD card", DISPLAY_WIDTH/2, 220, theme->secondary, 1);
@@ -346,7 +435,55 @@ void drawPDFReaderApp() {
 }
 
 void handlePDFReaderTouch(TouchGesture& gesture) {
-  // Basic PDF navigation would be implemented here
+  if (total_pdf_files == 0) return;
+  
+  switch (gesture.event) {
+    case TOUCH_PINCH:
+    case TOUCH_ROTATE:
+      // Scale is relative to where the pinch started
+      if (!pdf_pinch_active) {
+        pdf_pinch_active = true;
+        pdf_pinch_base_zoom = pdf_zoom;
+      }
+      zoomPDFAt(pdf_pinch_base_zoom * gesture.scale, gesture.x, gesture.y);
+      break;
+      
+    case TOUCH_RELEASE:
+      pdf_pinch_active = false;
+      break;
+      
+    case TOUCH_MOVE:
+      // Pan the zoomed page with the finger
+      if (pdf_zoom > PDF_MIN_ZOOM) {
+        pdf_origin_x -= (gesture.end_x - gesture.start_x) / pdf_zoom;
+        pdf_origin_y -= (gesture.end_y - gesture.start_y) / pdf_zoom;
+        clampPDFView();
+      }
+      break;
+      
+    case TOUCH_DOUBLE_TAP:
+      zoomPDFAt(pdf_zoom > PDF_MIN_ZOOM ? PDF_MIN_ZOOM : 2.0, gesture.x, gesture.y);
+      break;
+      
+    case TOUCH_TAP: {
+      const HitRegion* region = findHitRegion(gesture);
+      if (region == nullptr) break;
+      
+      if (region->tag == PDF_HIT_PREV) {
+        if (pdf_current_page > 0) pdf_current_page--;
+      } else if (region->tag == PDF_HIT_NEXT) {
+        if (pdf_current_page < pdf_files[0].pages - 1) pdf_current_page++;
+      } else if (region->tag == PDF_HIT_ZOOM) {
+        // Zoom button steps 1x -> 2x -> 4x -> 1x around the page center
+        float next_zoom = pdf_zoom < 2.0 ? 2.0 : (pdf_zoom < PDF_MAX_ZOOM ? PDF_MAX_ZOOM : PDF_MIN_ZOOM);
+        zoomPDFAt(next_zoom, PDF_VIEW_X + PDF_VIEW_W / 2, PDF_VIEW_Y + PDF_VIEW_H / 2);
+      }
+      break;
+    }
+      
+    default:
+      break;
+  }
 }
 
 // ==================== SETTINGS APP ====================
@@ -354,6 +491,18 @@ void initSettingsApp() {
   Serial.println("Settings app initialized");
 }
 
+// Touch regions registered by drawSettingsApp()
+enum SettingsHitTag {
+  SETTINGS_HIT_THEME_LUFFY,
+  SETTINGS_HIT_THEME_JINWOO,
+  SETTINGS_HIT_THEME_YUGO,
+  SETTINGS_HIT_BRIGHTNESS,
+  SETTINGS_HIT_GOAL_5000,
+  SETTINGS_HIT_GOAL_10000,
+  SETTINGS_HIT_GOAL_15000,
+  SETTINGS_HIT_BATTERY_USE
+};
+
 void drawSettingsApp() {
   clearDisplay();
   ThemeColors* theme = getCurrentTheme();
@@ -366,57 +515,76 @@ void drawSettingsApp() {
   drawGameButton(20, 100, 100, 30, "Luffy", system_state.current_theme == THEME_LUFFY_GEAR5);
   drawGameButton(130, 100, 100, 30, "Jin Woo", system_state.current_theme == THEME_SUNG_JINWOO);
   drawGameButton(240, 100, 100, 30, "Yugo", system_state.current_theme == THEME_YUGO_WAKFU);
+  addHitRegion(20, 100, 100, 30, SETTINGS_HIT_THEME_LUFFY);
+  addHitRegion(130, 100, 100, 30, SETTINGS_HIT_THEME_JINWOO);
+  addHitRegion(240, 100, 100, 30, SETTINGS_HIT_THEME_YUGO);
   
   // Brightness
   drawText("Brightness: " + String(system_state.brightness) + "%", 20, 160, theme->text, 1);
   drawRect(20, 180, DISPLAY_WIDTH - 40, 20, theme->secondary);
   fillRect(20, 180, (DISPLAY_WIDTH - 40) * system_state.brightness / 100, 20, theme->accent);
+  addHitRegion(20, 180, DISPLAY_WIDTH - 40, 20, SETTINGS_HIT_BRIGHTNESS);
   
   // Step goal
   drawText("Step Goal: " + String(system_state.step_goal), 20, 220, theme->text, 1);
   drawGameButton(20, 240, 80, 30, "5000", system_state.step_goal == 5000);
   drawGameButton(110, 240, 80, 30, "10000", system_state.step_goal == 10000);
   drawGameButton(200, 240, 80, 30, "15000", system_state.step_goal == 15000);
+  addHitRegion(20, 240, 80, 30, SETTINGS_HIT_GOAL_5000);
+  addHitRegion(110, 240, 80, 30, SETTINGS_HIT_GOAL_10000);
+  addHitRegion(200, 240, 80, 30, SETTINGS_HIT_GOAL_15000);
   
   // System info
   drawText("Battery: " + String(system_state.battery_percentage) + "%", 20, 300, theme->text, 1);
   drawText("Steps Today: " + String(system_state.steps_today), 20, 320, theme->text, 1);
   
+  drawGameButton(20, 350, DISPLAY_WIDTH - 40, 30, "Battery use", false);
+  addHitRegion(20, 350, DISPLAY_WIDTH - 40, 30, SETTINGS_HIT_BATTERY_USE);
+  
   updateDisplay();
 }
 
 void handleSettingsTouch(TouchGesture& gesture) {
   if (gesture.event != TOUCH_TAP) return;
   
-  // Theme selection
-  if (gesture.y >= 100 && gesture.y <= 130) {
-    if (gesture.x >= 20 && gesture.x <= 120) {
+  const HitRegion* region = findHitRegion(gesture);
+  if (region == nullptr) return;
+  
+  switch (region->tag) {
+    // Theme selection
+    case SETTINGS_HIT_THEME_LUFFY:
       setTheme(THEME_LUFFY_GEAR5);
       system_state.current_theme = THEME_LUFFY_GEAR5;
-    } else if (gesture.x >= 130 && gesture.x <= 230) {
+      break;
+    case SETTINGS_HIT_THEME_JINWOO:
       setTheme(THEME_SUNG_JINWOO);
       system_state.current_theme = THEME_SUNG_JINWOO;
-    } else if (gesture.x >= 240 && gesture.x <= 340) {
+      break;
+    case SETTINGS_HIT_THEME_YUGO:
       setTheme(THEME_YUGO_WAKFU);
       system_state.current_theme = THEME_YUGO_WAKFU;
-    }
-  }
-  
-  // Brightness control
-  if (gesture.y >= 180 && gesture.y <= 200) {
-    system_state.brightness = map(gesture.x, 20, DISPLAY_WIDTH - 20, 10, 100);
-    setDisplayBrightness(system_state.brightness);
-  }
-  
-  // Step goal selection
-  if (gesture.y >= 240 && gesture.y <= 270) {
-    if (gesture.x >= 20 && gesture.x <= 100) {
+      break;
+      
+    // Brightness control
+    case SETTINGS_HIT_BRIGHTNESS:
+      system_state.brightness = map(gesture.x - region->x, 0, region->width, 10, 100);
+      setDisplayBrightness(system_state.brightness);
+      break;
+      
+    // Step goal selection
+    case SETTINGS_HIT_GOAL_5000:
       system_state.step_goal = 5000;
-    } else if (gesture.x >= 110 && gesture.x <= 190) {
+      break;
+    case SETTINGS_HIT_GOAL_10000:
       system_state.step_goal = 10000;
-    } else if (gesture.x >= 200 && gesture.x <= 280) {
+      break;
+    case SETTINGS_HIT_GOAL_15000:
       system_state.step_goal = 15000;
-    }
+      break;
+      
+    case SETTINGS_HIT_BATTERY_USE:
+      openEnergyReport();
+      break;
   }
 }
 
@@ -462,4 +630,301 @@ void drawWeatherApp() {
 void handleWeatherTouch(TouchGesture& gesture) {
   // Weather refresh would be implemented here
   // Could connect to WiFi and fetch real weather data
+}
+
+// ==================== ACTIVITY HISTORY ====================
+enum HistoryHitTag {
+  HISTORY_HIT_BACK,
+  HISTORY_HIT_WEEK,
+  HISTORY_HIT_MONTH
+};
+
+// Daily rollups for the chart, reloaded at most once a minute
+static ActivityTotals history_days[30];
+static int history_count = 0;
+static int history_span = 7;
+static unsigned long history_loaded = 0;
+
+static void loadActivityHistory() {
+  history_count = getActivityHistory(ROLLUP_DAY, history_span, history_days);
+  history_loaded = millis();
+}
+
+void openActivityHistory() {
+  system_state.current_screen = SCREEN_ACTIVITY;
+  loadActivityHistory();
+}
+
+void drawActivityHistory() {
+  if (millis() - history_loaded > 60000) loadActivityHistory();
+  
+  clearDisplay();
+  ThemeColors* theme = getCurrentTheme();
+  
+  fillRect(0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT, theme->background);
+  drawNavigationBar("Activity", true);
+  addHitRegion(0, 0, 60, 40, HISTORY_HIT_BACK);
+  
+  drawGameButton(20, 60, 100, 30, "7 days", history_span == 7);
+  drawGameButton(130, 60, 100, 30, "30 days", history_span == 30);
+  addHitRegion(20, 60, 100, 30, HISTORY_HIT_WEEK);
+  addHitRegion(130, 60, 100, 30, HISTORY_HIT_MONTH);
+  
+  if (history_count == 0) {
+    drawCenteredText("No history yet", DISPLAY_WIDTH/2, 200, theme->secondary, 1);
+    updateDisplay();
+    return;
+  }
+  
+  // Bars scale to the best day or the goal, whichever is higher
+  uint32_t scale = system_state.step_goal > 0 ? system_state.step_goal : 1;
+  uint32_t total_steps = 0, total_active = 0, total_energy = 0;
+  for (int i = 0; i < history_count; i++) {
+    scale = max(scale, history_days[i].steps);
+    total_steps += history_days[i].steps;
+    total_active += history_days[i].active_seconds;
+    total_energy += history_days[i].energy_dcal;
+  }
+  
+  int chart_x = 20, chart_y = 110, chart_w = DISPLAY_WIDTH - 40, chart_h = 200;
+  int slot = chart_w / history_span;
+  int gap = history_span > 7 ? 2 : 8;
+  int first_slot = history_span - history_count;  // Days before the history began stay empty
+  for (int i = 0; i < history_count; i++) {
+    int height = (int)((uint64_t)history_days[i].steps * chart_h / scale);
+    uint16_t color = history_days[i].steps >= (uint32_t)system_state.step_goal ? theme->accent : theme->primary;
+    fillRect(chart_x + (first_slot + i) * slot + gap / 2, chart_y + chart_h - height, slot - gap, height, color);
+  }
+  int goal_y = chart_y + chart_h - (int)((uint64_t)system_state.step_goal * chart_h / scale);
+  drawLine(chart_x, goal_y, chart_x + chart_w, goal_y, theme->secondary);
+  drawLine(chart_x, chart_y + chart_h, chart_x + chart_w, chart_y + chart_h, theme->secondary);
+  
+  drawText("Steps: " + String(total_steps) + " (" + String(total_steps / history_count) + "/day)", 20, 330, theme->text, 1);
+  drawText("Active: " + String(total_active / 60) + " min", 20, 350, theme->text, 1);
+  drawText("Energy: " + String(total_energy / 10) + " kcal", 20, 370, theme->text, 1);
+  
+  updateDisplay();
+}
+
+void handleActivityHistoryTouch(TouchGesture& gesture) {
+  if (gesture.event == TOUCH_SWIPE_RIGHT) {
+    system_state.current_screen = SCREEN_WATCHFACE;
+    return;
+  }
+  if (gesture.event != TOUCH_TAP) return;
+  
+  const HitRegion* region = findHitRegion(gesture);
+  if (region == nullptr) return;
+  
+  switch (region->tag) {
+    case HISTORY_HIT_BACK:
+      system_state.current_screen = SCREEN_WATCHFACE;
+      break;
+    case HISTORY_HIT_WEEK:
+      history_span = 7;
+      loadActivityHistory();
+      break;
+    case HISTORY_HIT_MONTH:
+      history_span = 30;
+      loadActivityHistory();
+      break;
+  }
+}
+
+// ==================== SLEEP REPORT ====================
+enum SleepReportHitTag {
+  SLEEP_HIT_BACK
+};
+
+static SleepNight report_night;
+static bool report_loaded = false;
+
+static String clockText(uint32_t minute) {
+  char text[6];
+  sprintf(text, "%02d:%02d", (int)(minute % (24 * 60) / 60), (int)(minute % 60));
+  return String(text);
+}
+
+static String durationText(int minutes) {
+  return String(minutes / 60) + "h " + String(minutes % 60) + "m";
+}
+
+void openSleepReport() {
+  system_state.current_screen = SCREEN_SLEEP_REPORT;
+  report_loaded = getLastNight(report_night);
+}
+
+void drawSleepReport() {
+  clearDisplay();
+  ThemeColors* theme = getCurrentTheme();
+  
+  fillRect(0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT, theme->background);
+  drawNavigationBar("Sleep", true);
+  addHitRegion(0, 0, 60, 40, SLEEP_HIT_BACK);
+  
+  if (!report_loaded) {
+    drawCenteredText("No night recorded yet", DISPLAY_WIDTH/2, 200, theme->secondary, 1);
+    updateDisplay();
+    return;
+  }
+  
+  const SleepSummary& night = report_night.summary;
+  drawCenteredText(durationText(night.asleep_minutes), DISPLAY_WIDTH/2, 80, theme->accent, 3);
+  drawCenteredText("asleep", DISPLAY_WIDTH/2, 115, theme->secondary, 1);
+  
+  // Wake on the top row, sleep on the bottom, one run of epochs per rectangle
+  int chart_x = 20, chart_y = 150, chart_w = DISPLAY_WIDTH - 40, band_h = 40;
+  int run_start = 0;
+  for (int epoch = 1; epoch <= night.epochs; epoch++) {
+    bool asleep = sleepNightAsleep(report_night, run_start);
+    if (epoch < night.epochs && sleepNightAsleep(report_night, epoch) == asleep) continue;
+    int x0 = chart_x + run_start * chart_w / night.epochs;
+    int x1 = chart_x + epoch * chart_w / night.epochs;
+    fillRect(x0, asleep ? chart_y + band_h : chart_y, max(x1 - x0, 1), band_h,
+             asleep ? theme->primary : theme->secondary);
+    run_start = epoch;
+  }
+  drawText(clockText(night.start_minute), chart_x, chart_y + 2 * band_h + 6, theme->text, 1);
+  drawText(clockText(night.start_minute + night.epochs), chart_x + chart_w - 30, chart_y + 2 * band_h + 6, theme->text, 1);
+  
+  drawText("Fell asleep: " + clockText(night.start_minute + night.onset_epoch) +
+           " (" + String(night.onset_epoch) + " min)", 20, 270, theme->text, 1);
+  drawText("Woke up: " + clockText(night.start_minute + night.final_wake_epoch), 20, 290, theme->text, 1);
+  drawText("Awake in the night: " + String(night.waso_minutes) + " min, " +
+           String(night.awakenings) + " times", 20, 310, theme->text, 1);
+  drawText("Efficiency: " + String(night.efficiency) + "%", 20, 330, theme->text, 1);
+  
+  updateDisplay();
+}
+
+void handleSleepReportTouch(TouchGesture& gesture) {
+  if (gesture.event == TOUCH_SWIPE_LEFT) {
+    system_state.current_screen = SCREEN_WATCHFACE;
+    return;
+  }
+  if (gesture.event != TOUCH_TAP) return;
+  
+  const HitRegion* region = findHitRegion(gesture);
+  if (region != nullptr && region->tag == SLEEP_HIT_BACK) {
+    system_state.current_screen = SCREEN_WATCHFACE;
+  }
+}
+
+// ==================== BATTERY USE ====================
+enum EnergyReportHitTag {
+  ENERGY_HIT_BACK,
+  ENERGY_HIT_APPS,
+  ENERGY_HIT_SCREENS,
+  ENERGY_HIT_PARTS,
+  ENERGY_HIT_RESET
+};
+
+enum EnergyReportView {
+  ENERGY_VIEW_APPS,
+  ENERGY_VIEW_SCREENS,
+  ENERGY_VIEW_PARTS
+};
+
+#define ENERGY_REPORT_ROWS 7
+
+static EnergyReportView energy_view = ENERGY_VIEW_APPS;
+
+void openEnergyReport() {
+  system_state.current_screen = SCREEN_ENERGY;
+}
+
+void drawEnergyReport() {
+  clearDisplay();
+  ThemeColors* theme = getCurrentTheme();
+  
+  fillRect(0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT, theme->background);
+  drawNavigationBar("Battery Use", true);
+  addHitRegion(0, 0, 60, 40, ENERGY_HIT_BACK);
+  
+  const EnergyLedger& ledger = getEnergyLedger();
+  uint64_t total = energyLedgerTotal(ledger);
+  drawCenteredText(String(energyMilliampHours(total), 1) + " mAh", DISPLAY_WIDTH/2, 70, theme->accent, 3);
+  drawCenteredText(String(ledger.total_us / 3600000000.0, 1) + " h, " +
+                   String(energyAverageCurrent(ledger) / 1000.0, 1) + " mA mean", DISPLAY_WIDTH/2, 105, theme->secondary, 1);
+  
+  drawGameButton(20, 125, 100, 30, "Apps", energy_view == ENERGY_VIEW_APPS);
+  drawGameButton(130, 125, 100, 30, "Screens", energy_view == ENERGY_VIEW_SCREENS);
+  drawGameButton(240, 125, 100, 30, "Parts", energy_view == ENERGY_VIEW_PARTS);
+  addHitRegion(20, 125, 100, 30, ENERGY_HIT_APPS);
+  addHitRegion(130, 125, 100, 30, ENERGY_HIT_SCREENS);
+  addHitRegion(240, 125, 100, 30, ENERGY_HIT_PARTS);
+  
+  // Biggest consumers first
+  const char* names[ENERGY_MAX_SCREENS];
+  uint64_t charge[ENERGY_MAX_SCREENS];
+  int count = 0;
+  for (int i = 0; i < ENERGY_MAX_SCREENS; i++) {
+    uint64_t uams;
+    const char* name;
+    if (energy_view == ENERGY_VIEW_APPS) {
+      uams = ledger.app_uams[i];
+      name = getAppName(i);
+    } else if (energy_view == ENERGY_VIEW_SCREENS) {
+      uams = ledger.screen_uams[i];
+      name = getScreenName(i);
+    } else {
+      if (i >= ENERGY_SUBSYSTEM_COUNT) break;
+      uams = ledger.subsystem_uams[i];
+      name = energySubsystemName(i);
+    }
+    if (uams == 0) continue;
+    int slot = count++;
+    while (slot > 0 && charge[slot - 1] < uams) {
+      charge[slot] = charge[slot - 1];
+      names[slot] = names[slot - 1];
+      slot--;
+    }
+    charge[slot] = uams;
+    names[slot] = name;
+  }
+  
+  if (count == 0) {
+    drawCenteredText("Nothing measured yet", DISPLAY_WIDTH/2, 250, theme->secondary, 1);
+  }
+  int bar_x = 130, bar_w = 150;
+  for (int row = 0; row < count && row < ENERGY_REPORT_ROWS; row++) {
+    int y = 175 + row * 30;
+    drawText(names[row], 20, y + 4, theme->text, 1);
+    fillRect(bar_x, y, max((int)(charge[row] * bar_w / charge[0]), 1), 16, row == 0 ? theme->accent : theme->primary);
+    drawText(String(energyMilliampHours(charge[row]), 2), bar_x + bar_w + 10, y + 4, theme->text, 1);
+  }
+  
+  drawGameButton(DISPLAY_WIDTH/2 - 50, 395, 100, 30, "Reset", false);
+  addHitRegion(DISPLAY_WIDTH/2 - 50, 395, 100, 30, ENERGY_HIT_RESET);
+  
+  updateDisplay();
+}
+
+void handleEnergyReportTouch(TouchGesture& gesture) {
+  if (gesture.event == TOUCH_SWIPE_RIGHT) {
+    system_state.current_screen = SCREEN_SETTINGS;
+    return;
+  }
+  if (gesture.event != TOUCH_TAP) return;
+  
+  const HitRegion* region = findHitRegion(gesture);
+  if (region == nullptr) return;
+  
+  switch (region->tag) {
+    case ENERGY_HIT_BACK:
+      system_state.current_screen = SCREEN_SETTINGS;
+      break;
+    case ENERGY_HIT_APPS:
+      energy_view = ENERGY_VIEW_APPS;
+      break;
+    case ENERGY_HIT_SCREENS:
+      energy_view = ENERGY_VIEW_SCREENS;
+      break;
+    case ENERGY_HIT_PARTS:
+      energy_view = ENERGY_VIEW_PARTS;
+      break;
+    case ENERGY_HIT_RESET:
+      resetEnergyLedger();
+      break;
+  }
 }
\ No newline at end of file
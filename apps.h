@@ -7,6 +7,7 @@
 #define APPS_H
 
 #include "config.h"
+#include "resume.h"
 
 // App structure
 struct WatchApp {
@@ -42,6 +43,8 @@ void playMusic();
 void pauseMusic();
 void nextTrack();
 void previousTrack();
+void saveMusicResume(ResumeMedia& media);
+void restoreMusicResume(const ResumeMedia& media);
 
 // Notes App  
 void initNotesApp();
@@ -53,7 +56,6 @@ void loadNote();
 // File Browser App
 void initFileBrowserApp();
 void drawFileBrowserApp();
-void handleFileBrowserTouch(TouchGesture& gesture);
 
 // PDF Reader App
 void initPDFReaderApp();
@@ -70,6 +72,21 @@ void initWeatherApp();
 void drawWeatherApp();
 void handleWeatherTouch(TouchGesture& gesture);
 
+// Activity history, swiped to from the watch face
+void openActivityHistory();
+void drawActivityHistory();
+void handleActivityHistoryTouch(TouchGesture& gesture);
+
+// Last night's sleep, swiped to from the watch face and shown after waking
+void openSleepReport();
+void drawSleepReport();
+void handleSleepReportTouch(TouchGesture& gesture);
+
+// Charge per app, screen and subsystem, opened from Settings
+void openEnergyReport();
+void drawEnergyReport();
+void handleEnergyReportTouch(TouchGesture& gesture);
+
 // App registry
 extern WatchApp registered_apps[];
 extern int num_registered_apps;
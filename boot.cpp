@@ -0,0 +1,126 @@
+/*
+ * Staged Boot Implementation
+ * Stage ordering, skipping and timings
+ */
+
+#include "boot.h"
+#include <string.h>
+
+#define BIT(stage) (1u << (stage))
+
+struct BootStageSpec {
+  const char* name;
+  uint32_t needs;              // Skipped unless these are done
+  uint32_t after;              // Waits for these to finish either way
+  bool background;             // Waits for the first frame
+  bool required;               // Failure halts the boot
+};
+
+static const BootStageSpec stage_specs[BOOT_STAGE_COUNT] = {
+  {"i2c", 0, 0, false, true},
+  {"power", BIT(BOOT_I2C), 0, false, true},
+  {"display", 0, BIT(BOOT_POWER), false, true},            // Panel rail is on the PMIC
+  {"touch", BIT(BOOT_I2C), 0, false, false},
+  {"sensors", BIT(BOOT_I2C), 0, false, false},
+  {"rtc", BIT(BOOT_I2C), 0, false, false},
+  {"state", 0, BIT(BOOT_RTC), false, false},               // Resume ages from the RTC
+  {"sensor_task", BIT(BOOT_SENSORS), BIT(BOOT_STATE), false, false},
+  {"ui", BIT(BOOT_DISPLAY), BIT(BOOT_STATE), false, false},
+  {"storage", 0, 0, true, false},
+  {"settings", BIT(BOOT_STORAGE), 0, true, false},
+  {"activity_log", BIT(BOOT_STORAGE) | BIT(BOOT_SENSORS), 0, true, false},
+  {"media", BIT(BOOT_STORAGE), 0, true, false},
+  {"apps", 0, BIT(BOOT_SETTINGS) | BIT(BOOT_MEDIA), true, false}
+};
+
+static const char* const state_names[] = {"pending", "running", "done", "failed", "skipped"};
+
+static bool finished(const BootStage& stage) {
+  return stage.state != BOOT_PENDING && stage.state != BOOT_RUNNING;
+}
+
+void bootInit(BootPlan& plan, uint32_t now_ms) {
+  memset(&plan, 0, sizeof(plan));
+  plan.begin_ms = now_ms;
+}
+
+void bootSkip(BootPlan& plan, int stage) {
+  if (stage < 0 || stage >= BOOT_STAGE_COUNT) return;
+  if (plan.stages[stage].state == BOOT_PENDING) plan.stages[stage].state = BOOT_SKIPPED;
+}
+
+int bootNext(BootPlan& plan) {
+  if (plan.halted) return -1;
+  for (int stage = 0; stage < BOOT_STAGE_COUNT; stage++) {
+    BootStage& current = plan.stages[stage];
+    if (current.state != BOOT_PENDING) continue;
+    const BootStageSpec& spec = stage_specs[stage];
+
+    // Dependencies come earlier in the list, so one pass settles a chain
+    bool ready = !spec.background || plan.first_frame;
+    bool skip = false;
+    for (int other = 0; other < stage; other++) {
+      const BootStage& dependency = plan.stages[other];
+      if (spec.needs & BIT(other)) {
+        if (dependency.state == BOOT_FAILED || dependency.state == BOOT_SKIPPED) skip = true;
+        else if (dependency.state != BOOT_DONE) ready = false;
+      }
+      if ((spec.after & BIT(other)) && !finished(dependency)) ready = false;
+    }
+    if (skip) {
+      current.state = BOOT_SKIPPED;
+      continue;
+    }
+    if (ready) return stage;
+  }
+  return -1;
+}
+
+void bootBegin(BootPlan& plan, int stage, uint32_t now_ms) {
+  if (stage < 0 || stage >= BOOT_STAGE_COUNT) return;
+  plan.stages[stage].state = BOOT_RUNNING;
+  plan.stages[stage].start_ms = now_ms;
+}
+
+void bootEnd(BootPlan& plan, int stage, bool ok, uint32_t now_ms) {
+  if (stage < 0 || stage >= BOOT_STAGE_COUNT) return;
+  plan.stages[stage].state = ok ? BOOT_DONE : BOOT_FAILED;
+  plan.stages[stage].end_ms = now_ms;
+  if (!ok && stage_specs[stage].required) plan.halted = true;
+}
+
+void bootNoteFirstFrame(BootPlan& plan, uint32_t now_ms) {
+  if (plan.first_frame) return;
+  plan.first_frame = true;
+  plan.first_frame_ms = now_ms;
+}
+
+bool bootComplete(const BootPlan& plan) {
+  if (plan.halted) return true;
+  for (int stage = 0; stage < BOOT_STAGE_COUNT; stage++) {
+    if (!finished(plan.stages[stage])) return false;
+  }
+  return true;
+}
+
+const char* bootStageName(int stage) {
+  if (stage < 0 || stage >= BOOT_STAGE_COUNT) return "?";
+  return stage_specs[stage].name;
+}
+
+const char* bootStateName(int state) {
+  if (state < 0 || state > BOOT_SKIPPED) return "?";
+  return state_names[state];
+}
+
+bool bootIsBackground(int stage) {
+  if (stage < 0 || stage >= BOOT_STAGE_COUNT) return false;
+  return stage_specs[stage].background;
+}
+
+uint32_t bootStageMs(const BootPlan& plan, int stage) {
+  if (stage < 0 || stage >= BOOT_STAGE_COUNT) return 0;
+  const BootStage& current = plan.stages[stage];
+  if (current.state != BOOT_DONE && current.state != BOOT_FAILED) return 0;
+  return current.end_ms - current.start_ms;
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+/*
+ * Staged Boot for ESP32-S3 Watch
+ * What comes up before the first frame, and what follows it
+ *
+ * Boot is a fixed list of stages, each naming the stages it needs and the
+ * ones it merely runs after. Foreground stages bring up the buses, power,
+ * display, touch, sensors and the clock, then put the watch face on the
+ * screen. Background stages wait for that first frame and run one per loop
+ * pass: mounting the SD card, loading settings from it, opening the
+ * activity history, indexing media and setting up the apps.
+ *
+ * A stage whose need failed or was skipped is skipped in turn, so a
+ * missing SD card costs the settings file, history and media but not the
+ * watch. Only a required stage failing halts the boot. A warm resume skips
+ * the stages whose results came back from RTC memory.
+ *
+ * Every stage records when it started and ended in millis(), along with
+ * the first frame, so time-to-first-frame can be tracked. Plain C++ on
+ * stdint with the caller running the stages, so ordering, skipping and the
+ * timings are checked on host with stand-in stages.
+ */
+
+#ifndef BOOT_H
+#define BOOT_H
+
+#include <stdint.h>
+
+// In dependency order: a stage only needs or follows earlier ones
+enum BootStageId {
+  BOOT_I2C,
+  BOOT_POWER,
+  BOOT_DISPLAY,
+  BOOT_TOUCH,
+  BOOT_SENSORS,
+  BOOT_RTC,
+  BOOT_STATE,                  // Settings defaults, or the warm resume
+  BOOT_SENSOR_TASK,
+  BOOT_UI,
+  // Background, after the first frame
+  BOOT_STORAGE,
+  BOOT_SETTINGS,
+  BOOT_ACTIVITY_LOG,
+  BOOT_MEDIA,
+  BOOT_APPS,
+  BOOT_STAGE_COUNT
+};
+
+enum BootStageState {
+  BOOT_PENDING,
+  BOOT_RUNNING,
+  BOOT_DONE,
+  BOOT_FAILED,
+  BOOT_SKIPPED
+};
+
+struct BootStage {
+  uint8_t state;
+  uint32_t start_ms;
+  uint32_t end_ms;
+};
+
+struct BootPlan {
+  BootStage stages[BOOT_STAGE_COUNT];
+  uint32_t begin_ms;
+  uint32_t first_frame_ms;
+  bool first_frame;
+  bool halted;                 // A required stage failed
+};
+
+void bootInit(BootPlan& plan, uint32_t now_ms);
+void bootSkip(BootPlan& plan, int stage);  // Not needed on this boot
+
+// Running stages: next returns -1 when nothing can run yet
+int bootNext(BootPlan& plan);
+void bootBegin(BootPlan& plan, int stage, uint32_t now_ms);
+void bootEnd(BootPlan& plan, int stage, bool ok, uint32_t now_ms);
+void bootNoteFirstFrame(BootPlan& plan, uint32_t now_ms);
+bool bootComplete(const BootPlan& plan);
+
+// Reporting
+const char* bootStageName(int stage);
+const char* bootStateName(int state);
+bool bootIsBackground(int stage);
+uint32_t bootStageMs(const BootPlan& plan, int stage);
+
+#endif // BOOT_H
\ No newline at end of file
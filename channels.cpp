@@ -0,0 +1,100 @@
+/*
+ * Lock-Free Channels Implementation
+ * Ring indices with acquire/release ordering and the seqlock protocol
+ */
+
+#include "channels.h"
+#include <string.h>
+
+// ==================== SPSC QUEUE ====================
+void spscInit(SPSCQueue& queue, void* storage, size_t slot_size, uint32_t capacity) {
+  queue.slots = (uint8_t*)storage;
+  queue.slot_size = slot_size;
+  queue.capacity = capacity;
+  queue.head.store(0, std::memory_order_relaxed);
+  queue.tail.store(0, std::memory_order_relaxed);
+  queue.dropped = 0;
+}
+
+bool spscPush(SPSCQueue& queue, const void* item) {
+  // Free-running indices: tail - head is the fill level even across wraps
+  uint32_t tail = queue.tail.load(std::memory_order_relaxed);
+  uint32_t head = queue.head.load(std::memory_order_acquire);
+  if (tail - head >= queue.capacity) {
+    queue.dropped++;
+    return false;
+  }
+
+  memcpy(queue.slots + (tail & (queue.capacity - 1)) * queue.slot_size, item, queue.slot_size);
+  // Publishes the slot: the consumer's acquire of tail sees the bytes above
+  queue.tail.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+bool spscPop(SPSCQueue& queue, void* item) {
+  uint32_t head = queue.head.load(std::memory_order_relaxed);
+  uint32_t tail = queue.tail.load(std::memory_order_acquire);
+  if (head == tail) return false;
+
+  memcpy(item, queue.slots + (head & (queue.capacity - 1)) * queue.slot_size, queue.slot_size);
+  // Hands the slot back only after it has been copied out
+  queue.head.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+uint32_t spscCount(const SPSCQueue& queue) {
+  return queue.tail.load(std::memory_order_acquire) - queue.head.load(std::memory_order_acquire);
+}
+
+// ==================== SEQLOCK ====================
+static size_t wordCount(size_t size) {
+  return (size + 3) / 4;
+}
+
+void seqlockInit(Seqlock& lock, size_t size) {
+  lock.sequence.store(0, std::memory_order_relaxed);
+  for (int i = 0; i < SEQLOCK_MAX_WORDS; i++) {
+    lock.words[i].store(0, std::memory_order_relaxed);
+  }
+  lock.size = size <= SEQLOCK_MAX_WORDS * 4 ? size : SEQLOCK_MAX_WORDS * 4;
+  lock.writes = 0;
+}
+
+void seqlockWrite(Seqlock& lock, const void* data) {
+  uint32_t words[SEQLOCK_MAX_WORDS] = {};
+  memcpy(words, data, lock.size);
+
+  uint32_t sequence = lock.sequence.load(std::memory_order_relaxed);
+  lock.sequence.store(sequence + 1, std::memory_order_relaxed);
+  // Keeps the payload stores below from moving above the odd sequence
+  std::atomic_thread_fence(std::memory_order_release);
+  for (size_t i = 0; i < wordCount(lock.size); i++) {
+    lock.words[i].store(words[i], std::memory_order_relaxed);
+  }
+  lock.sequence.store(sequence + 2, std::memory_order_release);
+  lock.writes++;
+}
+
+bool seqlockRead(const Seqlock& lock, void* data, uint32_t* sequence) {
+  uint32_t words[SEQLOCK_MAX_WORDS];
+  for (int attempt = 0; attempt < SEQLOCK_READ_ATTEMPTS; attempt++) {
+    uint32_t before = lock.sequence.load(std::memory_order_acquire);
+    if (before & 1) continue;  // Write in progress
+
+    for (size_t i = 0; i < wordCount(lock.size); i++) {
+      words[i] = lock.words[i].load(std::memory_order_relaxed);
+    }
+    // Keeps the payload loads above from moving below the second check
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (lock.sequence.load(std::memory_order_relaxed) != before) continue;
+
+    memcpy(data, words, lock.size);
+    if (sequence != nullptr) *sequence = before;
+    return true;
+  }
+  return false;
+}
+
+uint32_t seqlockSequence(const Seqlock& lock) {
+  return lock.sequence.load(std::memory_order_acquire);
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+/*
+ * Lock-Free Channels for ESP32-S3 Watch
+ * Single-producer queues and seqlocked snapshots between the two cores
+ *
+ * The sensor task on core 0 and the UI loop on core 1 never wait on each
+ * other. Discrete events and commands go through an SPSCQueue: a ring of
+ * fixed-size slots where only the producer moves the tail and only the
+ * consumer moves the head, so a full queue drops at the producer and an
+ * empty one returns at once. State that only matters at its latest value
+ * goes through a Seqlock: the writer bumps a sequence to odd, stores the
+ * payload and bumps it to even; a reader retries whenever the sequence
+ * was odd or changed under it. Payloads are copied as relaxed atomic
+ * words, so neither side ever reads a torn value. Plain C++11 atomics,
+ * the same code runs under threads on host.
+ */
+
+#ifndef CHANNELS_H
+#define CHANNELS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+#define SEQLOCK_MAX_WORDS 32           // 128-byte payloads
+#define SEQLOCK_READ_ATTEMPTS 64       // A writer is never preempted for long, give up after this
+
+struct SPSCQueue {
+  uint8_t* slots;
+  size_t slot_size;
+  uint32_t capacity;                   // Power of two
+  std::atomic<uint32_t> head;          // Next slot to pop, moved by the consumer
+  std::atomic<uint32_t> tail;          // Next slot to push, moved by the producer
+  uint32_t dropped;                    // Producer side
+};
+
+struct Seqlock {
+  std::atomic<uint32_t> sequence;      // Odd while a write is in progress
+  std::atomic<uint32_t> words[SEQLOCK_MAX_WORDS];
+  size_t size;
+  uint32_t writes;                     // Writer side
+};
+
+// Queue: storage holds capacity * slot_size bytes and outlives the queue
+void spscInit(SPSCQueue& queue, void* storage, size_t slot_size, uint32_t capacity);
+bool spscPush(SPSCQueue& queue, const void* item);   // Producer only, false when full
+bool spscPop(SPSCQueue& queue, void* item);          // Consumer only, false when empty
+uint32_t spscCount(const SPSCQueue& queue);
+
+// Snapshot: one writer, any number of readers
+void seqlockInit(Seqlock& lock, size_t size);
+void seqlockWrite(Seqlock& lock, const void* data);
+bool seqlockRead(const Seqlock& lock, void* data, uint32_t* sequence = nullptr);  // False if never consistent
+uint32_t seqlockSequence(const Seqlock& lock);
+
+#endif // CHANNELS_H
\ No newline at end of file
@@ -7,6 +7,7 @@
 #define CONFIG_H
 
 #include <Arduino.h>
+#include "screens.h"
 
 // ==================== DISPLAY CONFIGURATION ====================
 #define DISPLAY_WIDTH 368
@@ -46,6 +47,18 @@
 #define PWR_SCL 42  // Shared I2C bus
 #define PWR_INT 45
 
+// ==================== I2C CONFIGURATION ====================
+// Touch has its own controller, IMU, RTC and PMIC share pins 41/42.
+// The bus manager switches to each device's clock before its transfers.
+#define TOUCH_I2C_ADDRESS 0x38
+#define IMU_I2C_ADDRESS 0x6A      // 0x6B when SA0 is pulled high
+#define RTC_I2C_ADDRESS 0x51
+#define PWR_I2C_ADDRESS 0x34
+#define TOUCH_I2C_CLOCK 400000
+#define IMU_I2C_CLOCK 400000
+#define RTC_I2C_CLOCK 100000
+#define PWR_I2C_CLOCK 400000
+
 // ==================== BUTTON CONFIGURATION ====================
 #define BTN_PWR 0   // Power/Wake button
 #define BTN_BOOT 46 // Boot/Menu button
@@ -66,31 +79,63 @@
 // ==================== SYSTEM CONSTANTS ====================
 #define SLEEP_TIMEOUT 30000    // 30 seconds
 #define DEEP_SLEEP_TIMEOUT 300000  // 5 minutes
+#define SLEEP_FACE_REFRESH 60000   // Light sleep wakes at least this often to redraw the clock
+#define WRIST_WATCH_MS 2000        // After a motion wake, stay up this long looking for a raise
 #define SENSOR_UPDATE_INTERVAL 100  // 100ms
 #define UI_UPDATE_INTERVAL 16       // ~60 FPS
+#define IDLE_FRAME_INTERVAL 1000    // Redraw rate once nothing moves, for the clock
+#define ACTIVE_FRAME_WINDOW 2000    // Full frame rate this long after input or a screen change
+#define BATTERY_UPDATE_INTERVAL 30000
+#define BUTTON_DEBOUNCE_MS 25       // A button level must hold this long to count
+#define ENABLE_TICKLESS_IDLE true   // Light-sleep between deadlines while the screen is on
+#define CONSOLE_AWAKE_MS 60000      // ...except this long after Serial input, so commands work
+#define ENABLE_PERF_HUD false       // Touch latency overlay at the bottom edge, 'h' on Serial toggles it
+#define ENABLE_IMU_GESTURES true    // Wrist flicks, taps and shakes act as touch swipes
 
 // Battery levels
 #define BATTERY_LOW_THRESHOLD 15
 #define BATTERY_CRITICAL_THRESHOLD 5
 
-// Step counter
-#define MIN_STEP_THRESHOLD 1.2     // G-force threshold
-#define STEP_TIME_WINDOW 500       // 500ms between steps
-
-// ==================== SCREEN DEFINITIONS ====================
-enum ScreenType {
-  SCREEN_SPLASH,
-  SCREEN_WATCHFACE,
-  SCREEN_APP_GRID,
-  SCREEN_MUSIC,
-  SCREEN_NOTES,
-  SCREEN_QUESTS,
-  SCREEN_SETTINGS,
-  SCREEN_PDF_READER,
-  SCREEN_FILE_BROWSER,
-  SCREEN_SLEEP,
-  SCREEN_CHARGING
-};
+// Fuel gauge: cell, charger setting and first guesses for the load model,
+// which learns the real currents from rested OCV readings
+#define BATTERY_CAPACITY_MAH 300
+#define BATTERY_CHARGE_MA 200
+#define BATTERY_ACTIVE_UA 60000     // Screen on
+#define BATTERY_SLEEP_UA 2500       // Screen asleep, IMU counting steps
+
+// Energy attribution books the time in each power state this often, and
+// whenever the screen or app changes
+#define ENERGY_SAMPLE_MS 1000
+
+// CPU governor: frames may load a clock to this percent of the frame time,
+// steps down wait for the demand to stay low and for the last change to age
+#define GOVERNOR_TARGET_LOAD 70
+#define GOVERNOR_DOWN_HOLD_MS 1000
+#define GOVERNOR_DWELL_MS 250
+#define GOVERNOR_SD_LINGER_MS 500   // SD work counts as pending this long after a transfer
+
+// Display power limiter: brightness is held to what keeps the panel under
+// this current at the frame's picture level, tighter on low battery, and a
+// frame still over at the floor switches the theme to its dark variant
+#define ENABLE_DISPLAY_LIMITER true
+#define DISPLAY_POWER_BUDGET_UA 30000
+#define DISPLAY_LOW_BATTERY_BUDGET_UA 12000
+#define DISPLAY_LOW_BATTERY_PERCENT 20
+#define DISPLAY_MIN_BRIGHTNESS 30   // Never dims a brighter choice below this
+#define DISPLAY_DIM_STEP 4          // Brightness points per frame when dimming
+#define DISPLAY_DARK_HOLD_MS 3000
+
+// Step counter, stride length and energy scale with the wearer
+#define USER_HEIGHT_CM 170
+#define USER_WEIGHT_KG 70
+
+// Activity history on SD, written back at least this often
+#define ACTIVITY_LOG_FLUSH_MINUTES 15
+
+// Sleep tracking runs from sleep_time until wake_time plus a lie-in, the
+// motion FIFO is fetched this often (it holds ~4.1s)
+#define SLEEP_TRACK_DRAIN_MS 3500
+#define SLEEP_TRACK_LATE_MINUTES 90
 
 // ==================== THEME DEFINITIONS ====================
 enum ThemeType {
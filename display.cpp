@@ -4,6 +4,8 @@
  */
 
 #include "display.h"
+#include "latency.h"
+#include "apl.h"
 #include <math.h>
 
 // TFT_eSPI instance
@@ -13,6 +15,45 @@ TFT_eSPI tft = TFT_eSPI();
 uint16_t* display_buffer = nullptr;
 uint16_t* screen_capture = nullptr;
 
+// Last level set, for energy accounting, and the user's choice under any limit
+static int display_brightness = 0;
+static int brightness_setting = 0;
+static int brightness_limit = 100;
+
+// What the primitives have lit, for the picture level. Blending assumes
+// paints land anywhere in a tile, so a shape built from adjacent strips is
+// reported once as a whole while its strips are muted
+static AplMap frame_apl;
+static bool apl_muted = false;
+
+static uint16_t colorLuminance(uint16_t color) {
+  // Frames repeat a handful of colours; remember the last one
+  static uint16_t last_color = 0;
+  static uint16_t last_luminance = 0;
+  if (color != last_color) {
+    last_color = color;
+    last_luminance = energyLuminanceFromRGB565(color);
+  }
+  return last_luminance;
+}
+
+static void notePaint(int x, int y, int w, int h, uint16_t color, uint16_t coverage) {
+  if (apl_muted) return;
+  aplPaint(frame_apl, x, y, w, h, colorLuminance(color), coverage);
+}
+
+static uint16_t imageLuminance(const uint16_t* pixels, int count, bool swapped) {
+  // Every 7th pixel is plenty for a mean and misses regular patterns
+  uint32_t sum = 0, samples = 0;
+  for (int i = 0; i < count; i += 7) {
+    uint16_t pixel = pixels[i];
+    if (swapped) pixel = (pixel >> 8) | (pixel << 8);
+    sum += energyLuminanceFromRGB565(pixel);
+    samples++;
+  }
+  return samples ? (uint16_t)(sum / samples) : 0;
+}
+
 bool initializeDisplay() {
   Serial.println("Initializing AMOLED display...");
   
@@ -29,6 +70,7 @@ bool initializeDisplay() {
   tft.init();
   tft.setRotation(DISPLAY_ROTATION);
   tft.fillScreen(COLOR_BLACK);
+  aplInit(frame_apl, DISPLAY_WIDTH, DISPLAY_HEIGHT);
   
   // Set default brightness
   setDisplayBrightness(80);
@@ -39,6 +81,7 @@ bool initializeDisplay() {
 
 void clearDisplay() {
   tft.fillScreen(COLOR_BLACK);
+  aplClear(frame_apl, 0);
   if (display_buffer) {
     memset(display_buffer, 0, DISPLAY_WIDTH * DISPLAY_HEIGHT * 2);
   }
@@ -49,17 +92,51 @@ void updateDisplay() {
   if (display_buffer) {
     tft.pushImage(0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT, display_buffer);
   }
+  
+  // Frame is on the panel: close any touch latency measurement
+  markFramePresented();
 }
 
-void setDisplayBrightness(int brightness) {
+static void applyBrightness() {
   // Control backlight via PWM
+  int brightness = min(brightness_setting, brightness_limit);
+  if (brightness == display_brightness) return;
   int pwm_value = map(brightness, 0, 100, 0, 255);
   analogWrite(TFT_BL, pwm_value);
+  display_brightness = brightness;
+}
+
+void setDisplayBrightness(int brightness) {
+  brightness_setting = brightness;
+  display_brightness = -1;
+  applyBrightness();
+}
+
+void setDisplayBrightnessLimit(int limit) {
+  brightness_limit = limit;
+  applyBrightness();
+}
+
+int getDisplayBrightness() {
+  return display_brightness;
+}
+
+int getDisplayBrightnessSetting() {
+  return brightness_setting;
+}
+
+uint16_t getFrameAPL() {
+  return aplLevel(frame_apl);
+}
+
+void getFrameAPLHistogram(uint16_t* bins) {
+  aplHistogram(frame_apl, bins);
 }
 
 void drawPixel(int x, int y, uint16_t color) {
   if (x >= 0 && x < DISPLAY_WIDTH && y >= 0 && y < DISPLAY_HEIGHT) {
     tft.drawPixel(x, y, color);
+    notePaint(x, y, 1, 1, color, 1000);
     if (display_buffer) {
       display_buffer[y * DISPLAY_WIDTH + x] = color;
     }
@@ -68,37 +145,60 @@ void drawPixel(int x, int y, uint16_t color) {
 
 void drawLine(int x0, int y0, int x1, int y1, uint16_t color) {
   tft.drawLine(x0, y0, x1, y1, color);
+  // A line lights its length out of its bounding box
+  int w = abs(x1 - x0) + 1, h = abs(y1 - y0) + 1;
+  notePaint(min(x0, x1), min(y0, y1), w, h, color, (uint32_t)max(w, h) * 1000 / ((uint32_t)w * h));
+}
+
+static void noteOutline(int x, int y, int w, int h, uint16_t color) {
+  notePaint(x, y, w, 1, color, 1000);
+  notePaint(x, y + h - 1, w, 1, color, 1000);
+  notePaint(x, y + 1, 1, h - 2, color, 1000);
+  notePaint(x + w - 1, y + 1, 1, h - 2, color, 1000);
 }
 
 void drawRect(int x, int y, int w, int h, uint16_t color) {
   tft.drawRect(x, y, w, h, color);
+  noteOutline(x, y, w, h, color);
 }
 
 void fillRect(int x, int y, int w, int h, uint16_t color) {
   tft.fillRect(x, y, w, h, color);
+  notePaint(x, y, w, h, color, 1000);
 }
 
 void drawCircle(int x, int y, int radius, uint16_t color) {
   tft.drawCircle(x, y, radius, color);
+  // Circumference over the bounding square: pi/2r permille of it
+  int side = 2 * radius + 1;
+  notePaint(x - radius, y - radius, side, side, color, (uint16_t)min(1000, 1571 / max(radius, 1)));
 }
 
 void fillCircle(int x, int y, int radius, uint16_t color) {
   tft.fillCircle(x, y, radius, color);
+  int side = 2 * radius + 1;
+  notePaint(x - radius, y - radius, side, side, color, 785);  // pi/4
 }
 
 void drawRoundRect(int x, int y, int w, int h, int radius, uint16_t color) {
   tft.drawRoundRect(x, y, w, h, radius, color);
+  noteOutline(x, y, w, h, color);
 }
 
 void fillRoundRect(int x, int y, int w, int h, int radius, uint16_t color) {
   tft.fillRoundRect(x, y, w, h, radius, color);
+  notePaint(x, y, w, h, color, 1000);
 }
 
+// Glyphs light roughly a third of their cells
+#define TEXT_COVERAGE 300
+
 void drawText(const char* text, int x, int y, uint16_t color, int size) {
   tft.setTextColor(color);
   tft.setTextSize(size);
   tft.setCursor(x, y);
   tft.print(text);
+  notePaint(x, y, tft.textWidth(text), getTextHeight(size), color, TEXT_COVERAGE);
 }
 
 void drawCenteredText(const char* text, int x, int y, uint16_t color, int size) {
@@ -110,6 +210,7 @@ void drawCenteredText(const char* text, int x, int y, uint16_t color, int size)
   
   tft.setCursor(x - text_width/2, y - text_height/2);
   tft.print(text);
+  notePaint(x - text_width/2, y - text_height/2, text_width, text_height, color, TEXT_COVERAGE);
 }
 
 int getTextWidth(const char* text, int size) {
@@ -123,21 +224,30 @@ int getTextHeight(int size) {
 
 void drawBitmap(int x, int y, int w, int h, const uint16_t* bitmap) {
   tft.pushImage(x, y, w, h, bitmap);
+  aplPaint(frame_apl, x, y, w, h, imageLuminance(bitmap, w * h, !tft.getSwapBytes()), 1000);
 }
 
 void drawSprite(int x, int y, int w, int h, const uint16_t* sprite) {
   // Draw sprite with transparency support
+  uint32_t sum = 0, opaque = 0;
+  apl_muted = true;
   for (int py = 0; py < h; py++) {
     for (int px = 0; px < w; px++) {
       uint16_t pixel = sprite[py * w + px];
       if (pixel != 0x0000) { // 0x0000 is transparent
         drawPixel(x + px, y + py, pixel);
+        sum += colorLuminance(pixel);
+        opaque++;
       }
     }
   }
+  apl_muted = false;
+  if (opaque) aplPaint(frame_apl, x, y, w, h, sum / opaque, opaque * 1000 / (w * h));
 }
 
 void drawGradient(int x, int y, int w, int h, uint16_t color1, uint16_t color2, bool vertical) {
+  // Luminance is linear in the channels, so the mean is that of the ends
+  apl_muted = true;
   for (int i = 0; i < (vertical ? h : w); i++) {
     float ratio = (float)i / (vertical ? h : w);
     
@@ -162,6 +272,45 @@ void drawGradient(int x, int y, int w, int h, uint16_t color1, uint16_t color2,
       drawLine(x + i, y, x + i, y + h - 1, color);
     }
   }
+  apl_muted = false;
+  aplPaint(frame_apl, x, y, w, h, (colorLuminance(color1) + colorLuminance(color2)) / 2, 1000);
+}
+
+void drawZoomedImage(int x, int y, int w, int h, const ZoomCache& cache, float zoom, float origin_x, float origin_y, uint16_t fill) {
+  static uint16_t line_buffer[DISPLAY_WIDTH];
+  if (w > DISPLAY_WIDTH) w = DISPLAY_WIDTH;
+  
+  int level = zoomCacheSelectLevel(cache, zoom);
+  
+  // Cache pixels are in sprite byte order, same as pushSprite()
+  bool swap = tft.getSwapBytes();
+  tft.setSwapBytes(!cache.byte_swapped);
+  tft.startWrite();
+  for (int row = 0; row < h; row++) {
+    zoomCacheSampleRow(cache, level, zoom, origin_x, origin_y, row, line_buffer, w, fill);
+    tft.pushImage(x, y + row, w, 1, line_buffer);
+    aplPaint(frame_apl, x, y + row, w, 1, imageLuminance(line_buffer, w, cache.byte_swapped), 1000);
+  }
+  tft.endWrite();
+  tft.setSwapBytes(swap);
+}
+
+TFT_eSprite* createCanvas(int w, int h) {
+  TFT_eSprite* canvas = new TFT_eSprite(&tft);
+  canvas->setColorDepth(16);
+  canvas->setAttribute(PSRAM_ENABLE, true);
+  if (canvas->createSprite(w, h) == nullptr) {
+    delete canvas;
+    return nullptr;
+  }
+  return canvas;
+}
+
+void deleteCanvas(TFT_eSprite* canvas) {
+  if (canvas) {
+    canvas->deleteSprite();
+    delete canvas;
+  }
 }
 
 void drawProgressRing(int centerX, int centerY, int radius, float progress, uint16_t color, int thickness) {
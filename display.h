@@ -9,6 +9,7 @@
 #include "config.h"
 #include <TFT_eSPI.h>
 #include <SPI.h>
+#include "zoom_cache.h"
 
 // Display buffer for smooth animations
 extern uint16_t* display_buffer;
@@ -19,7 +20,14 @@ bool initializeDisplay();
 // Basic display operations
 void clearDisplay();
 void updateDisplay();
-void setDisplayBrightness(int brightness);
+void setDisplayBrightness(int brightness);      // The user's choice
+void setDisplayBrightnessLimit(int limit);       // Power limiter's ceiling
+int getDisplayBrightness();                      // As applied
+int getDisplayBrightnessSetting();
+
+// Average picture level of what was drawn, permille of full white
+uint16_t getFrameAPL();
+void getFrameAPLHistogram(uint16_t* bins);
 
 // Drawing primitives
 void drawPixel(int x, int y, uint16_t color);
@@ -41,6 +49,11 @@ int getTextHeight(int size);
 void drawBitmap(int x, int y, int w, int h, const uint16_t* bitmap);
 void drawSprite(int x, int y, int w, int h, const uint16_t* sprite);
 void drawGradient(int x, int y, int w, int h, uint16_t color1, uint16_t color2, bool vertical);
+void drawZoomedImage(int x, int y, int w, int h, const ZoomCache& cache, float zoom, float origin_x, float origin_y, uint16_t fill);
+
+// Offscreen canvases for content that is rendered once and cached
+TFT_eSprite* createCanvas(int w, int h);
+void deleteCanvas(TFT_eSprite* canvas);
 
 // Apple Watch style elements
 void drawProgressRing(int centerX, int centerY, int radius, float progress, uint16_t color, int thickness);
@@ -0,0 +1,199 @@
+/*
+ * Energy Attribution Implementation
+ * Current model, per-interval costing and the ledger
+ */
+
+#include "energy.h"
+#include <string.h>
+
+// Bench figures for this board; the panel terms dominate with the screen on,
+// light sleep and the base load with it off
+static const uint32_t default_model[ENERGY_COEFF_COUNT] = {
+  1500,    // Display on, black
+  90000,   // Full white at full brightness
+  19000, 24000, 31000,   // CPU awake and idle at 80/160/240MHz
+  6000, 10000, 15000,    // Each busy core on top
+  800,     // Light sleep
+  25000,   // SD transfer
+  15000,   // Audio
+  550,     // IMU 6-axis at 56Hz
+  30,      // IMU motion mode
+  800,     // I2C pull-ups while driven
+  150      // Base
+};
+
+static const char* const coefficient_names[ENERGY_COEFF_COUNT] = {
+  "display_on", "display_white",
+  "cpu_idle_80", "cpu_idle_160", "cpu_idle_240",
+  "cpu_busy_80", "cpu_busy_160", "cpu_busy_240",
+  "cpu_sleep", "sd", "audio", "imu_full", "imu_low", "i2c", "base"
+};
+
+static const char* const subsystem_names[ENERGY_SUBSYSTEM_COUNT] = {
+  "display", "cpu", "sd", "audio", "imu", "i2c", "base"
+};
+
+// ==================== MODEL ====================
+void energyModelDefaults(EnergyModel& model) {
+  memcpy(model.ua, default_model, sizeof(model.ua));
+}
+
+bool energyModelSet(EnergyModel& model, int coefficient, uint32_t ua) {
+  if (coefficient < 0 || coefficient >= ENERGY_COEFF_COUNT) return false;
+  model.ua[coefficient] = ua;
+  return true;
+}
+
+const char* energyCoefficientName(int coefficient) {
+  if (coefficient < 0 || coefficient >= ENERGY_COEFF_COUNT) return "";
+  return coefficient_names[coefficient];
+}
+
+// ==================== ACCOUNTING ====================
+static int clockIndex(uint16_t cpu_mhz) {
+  if (cpu_mhz <= 100) return 0;
+  if (cpu_mhz <= 200) return 1;
+  return 2;
+}
+
+static uint32_t clampTo(uint32_t value, uint32_t limit) {
+  return value < limit ? value : limit;
+}
+
+uint32_t energyDisplayCurrent(const EnergyModel& model, uint8_t brightness, uint16_t luminance) {
+  // Emission scales with brightness and with how much of the frame is lit
+  uint64_t lit_ua = (uint64_t)model.ua[ENERGY_COEFF_DISPLAY_WHITE] * brightness * luminance / 100000;
+  return model.ua[ENERGY_COEFF_DISPLAY_ON] + (uint32_t)lit_ua;
+}
+
+void energyLedgerReset(EnergyLedger& ledger) {
+  memset(&ledger, 0, sizeof(ledger));
+}
+
+uint32_t energySampleCurrent(const EnergyModel& model, const EnergySample& sample, uint64_t* subsystem_uams) {
+  const uint32_t* ua = model.ua;
+  uint64_t interval = sample.interval_us;
+  if (interval == 0) return 0;
+  uint32_t sleep = clampTo(sample.sleep_us, sample.interval_us);
+  uint64_t awake = interval - sleep;
+  int clock = clockIndex(sample.cpu_mhz);
+
+  // Charge per subsystem in uA*us
+  uint64_t charge[ENERGY_SUBSYSTEM_COUNT] = {};
+  if (sample.display_on) {
+    charge[ENERGY_DISPLAY] = (uint64_t)energyDisplayCurrent(model, sample.brightness, sample.luminance) * interval;
+  }
+
+  charge[ENERGY_CPU] = (uint64_t)ua[ENERGY_COEFF_CPU_IDLE_80 + clock] * awake +
+                       (uint64_t)ua[ENERGY_COEFF_CPU_SLEEP] * sleep;
+  for (int core = 0; core < ENERGY_CORES; core++) {
+    charge[ENERGY_CPU] += (uint64_t)ua[ENERGY_COEFF_CPU_BUSY_80 + clock] * clampTo(sample.busy_us[core], awake);
+  }
+
+  charge[ENERGY_SD] = (uint64_t)ua[ENERGY_COEFF_SD] * clampTo(sample.sd_us, sample.interval_us);
+  if (sample.audio_on) charge[ENERGY_AUDIO] = (uint64_t)ua[ENERGY_COEFF_AUDIO] * interval;
+  if (sample.imu_mode == ENERGY_IMU_FULL) charge[ENERGY_IMU] = (uint64_t)ua[ENERGY_COEFF_IMU_FULL] * interval;
+  if (sample.imu_mode == ENERGY_IMU_LOW) charge[ENERGY_IMU] = (uint64_t)ua[ENERGY_COEFF_IMU_LOW] * interval;
+  charge[ENERGY_I2C] = (uint64_t)ua[ENERGY_COEFF_I2C] * clampTo(sample.i2c_us, sample.interval_us);
+  charge[ENERGY_BASE] = (uint64_t)ua[ENERGY_COEFF_BASE] * interval;
+
+  uint64_t total = 0;
+  for (int subsystem = 0; subsystem < ENERGY_SUBSYSTEM_COUNT; subsystem++) {
+    total += charge[subsystem];
+    if (subsystem_uams != nullptr) subsystem_uams[subsystem] = charge[subsystem] / 1000;
+  }
+  return (uint32_t)(total / interval);
+}
+
+void energyAccount(EnergyLedger& ledger, const EnergyModel& model, const EnergySample& sample) {
+  if (sample.interval_us == 0) return;
+
+  uint64_t charge[ENERGY_SUBSYSTEM_COUNT];
+  energySampleCurrent(model, sample, charge);
+  uint64_t total = 0;
+  for (int subsystem = 0; subsystem < ENERGY_SUBSYSTEM_COUNT; subsystem++) {
+    ledger.subsystem_uams[subsystem] += charge[subsystem];
+    total += charge[subsystem];
+  }
+  if (sample.screen < ENERGY_MAX_SCREENS) {
+    ledger.screen_uams[sample.screen] += total;
+    ledger.screen_us[sample.screen] += sample.interval_us;
+    ledger.screen_display_uams[sample.screen] += charge[ENERGY_DISPLAY];
+    if (sample.display_on) {
+      ledger.screen_luminance_sum[sample.screen] += (uint64_t)sample.luminance * sample.interval_us;
+    }
+  }
+  if (sample.app < ENERGY_MAX_APPS) {
+    ledger.app_uams[sample.app] += total;
+    ledger.app_us[sample.app] += sample.interval_us;
+  }
+
+  // Residency
+  uint32_t sleep = clampTo(sample.sleep_us, sample.interval_us);
+  uint32_t awake = sample.interval_us - sleep;
+  uint64_t* state = ledger.state_us;
+  if (sample.display_on) {
+    state[ENERGY_STATE_DISPLAY_ON] += sample.interval_us;
+    ledger.brightness_sum += (uint64_t)sample.brightness * sample.interval_us;
+    ledger.luminance_sum += (uint64_t)sample.luminance * sample.interval_us;
+  }
+  for (int core = 0; core < ENERGY_CORES; core++) {
+    state[ENERGY_STATE_CPU_BUSY] += clampTo(sample.busy_us[core], awake);
+  }
+  state[ENERGY_STATE_CPU_80 + clockIndex(sample.cpu_mhz)] += awake;
+  state[ENERGY_STATE_CPU_SLEEP] += sleep;
+  state[ENERGY_STATE_SD] += clampTo(sample.sd_us, sample.interval_us);
+  if (sample.audio_on) state[ENERGY_STATE_AUDIO] += sample.interval_us;
+  if (sample.imu_mode == ENERGY_IMU_FULL) state[ENERGY_STATE_IMU_FULL] += sample.interval_us;
+  if (sample.imu_mode == ENERGY_IMU_LOW) state[ENERGY_STATE_IMU_LOW] += sample.interval_us;
+  state[ENERGY_STATE_I2C] += clampTo(sample.i2c_us, sample.interval_us);
+
+  ledger.total_us += sample.interval_us;
+  ledger.samples++;
+}
+
+// ==================== READINGS ====================
+const char* energySubsystemName(int subsystem) {
+  if (subsystem < 0 || subsystem >= ENERGY_SUBSYSTEM_COUNT) return "";
+  return subsystem_names[subsystem];
+}
+
+uint64_t energyLedgerTotal(const EnergyLedger& ledger) {
+  uint64_t total = 0;
+  for (int subsystem = 0; subsystem < ENERGY_SUBSYSTEM_COUNT; subsystem++) {
+    total += ledger.subsystem_uams[subsystem];
+  }
+  return total;
+}
+
+uint32_t energyAverageCurrent(const EnergyLedger& ledger) {
+  if (ledger.total_us == 0) return 0;
+  return (uint32_t)(energyLedgerTotal(ledger) * 1000 / ledger.total_us);
+}
+
+uint32_t energyScreenCurrent(const EnergyLedger& ledger, int screen) {
+  if (screen < 0 || screen >= ENERGY_MAX_SCREENS || ledger.screen_us[screen] == 0) return 0;
+  return (uint32_t)(ledger.screen_uams[screen] * 1000 / ledger.screen_us[screen]);
+}
+
+uint32_t energyScreenDisplayCurrent(const EnergyLedger& ledger, int screen) {
+  if (screen < 0 || screen >= ENERGY_MAX_SCREENS || ledger.screen_us[screen] == 0) return 0;
+  return (uint32_t)(ledger.screen_display_uams[screen] * 1000 / ledger.screen_us[screen]);
+}
+
+uint16_t energyScreenLuminance(const EnergyLedger& ledger, int screen) {
+  if (screen < 0 || screen >= ENERGY_MAX_SCREENS || ledger.screen_us[screen] == 0) return 0;
+  return (uint16_t)(ledger.screen_luminance_sum[screen] / ledger.screen_us[screen]);
+}
+
+uint16_t energyLuminanceFromRGB565(uint16_t color) {
+  // Rec. 601 weights on the expanded channels, in permille
+  uint32_t r = (color >> 11) & 0x1F;
+  uint32_t g = (color >> 5) & 0x3F;
+  uint32_t b = color & 0x1F;
+  return (uint16_t)((r * 299 * 1000 / 31 + g * 587 * 1000 / 63 + b * 114 * 1000 / 31) / 1000);
+}
+
+float energyMilliampHours(uint64_t uams) {
+  return uams / 3600000000.0f;
+}
\ No newline at end of file
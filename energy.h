@@ -0,0 +1,138 @@
+/*
+ * Energy Attribution for ESP32-S3 Watch
+ * Where the battery's charge goes, per subsystem, screen and app
+ *
+ * Every accounting interval the watch reports how long it spent in each
+ * power-relevant state: the display on, at what brightness and average
+ * picture level; each core busy at the current clock, awake but idle, or
+ * in light sleep; SD transfers, audio, the IMU's mode and I2C bus time.
+ * Each state's time is multiplied by its current from a calibratable
+ * model, the charge is booked to its subsystem, and the interval's total
+ * to the screen and app that were showing. Residency is kept alongside,
+ * so a corrected coefficient can re-cost the day without re-measuring it.
+ * Integer uA*ms charge, plain C++, so recorded days replay on host.
+ */
+
+#ifndef ENERGY_H
+#define ENERGY_H
+
+#include <stdint.h>
+
+#define ENERGY_MAX_SCREENS 16
+#define ENERGY_MAX_APPS 16
+#define ENERGY_CORES 2
+#define ENERGY_NO_APP 0xFF
+
+// Per-state currents in uA; the model is one flat array so each entry can
+// be calibrated by index over Serial
+enum EnergyCoefficient {
+  ENERGY_COEFF_DISPLAY_ON,       // Panel powered, every pixel black
+  ENERGY_COEFF_DISPLAY_WHITE,    // Added by a full-white frame at 100% brightness
+  ENERGY_COEFF_CPU_IDLE_80,      // Awake, both cores waiting
+  ENERGY_COEFF_CPU_IDLE_160,
+  ENERGY_COEFF_CPU_IDLE_240,
+  ENERGY_COEFF_CPU_BUSY_80,      // Added per busy core
+  ENERGY_COEFF_CPU_BUSY_160,
+  ENERGY_COEFF_CPU_BUSY_240,
+  ENERGY_COEFF_CPU_SLEEP,        // Light sleep, RAM and PSRAM retained
+  ENERGY_COEFF_SD,               // While a transfer is in progress
+  ENERGY_COEFF_AUDIO,            // Codec and amplifier while playing
+  ENERGY_COEFF_IMU_FULL,         // Accel and gyro streaming to the FIFO
+  ENERGY_COEFF_IMU_LOW,          // Accel-only motion mode
+  ENERGY_COEFF_I2C,              // While the bus is driven
+  ENERGY_COEFF_BASE,             // PMIC, RTC and regulators, always
+  ENERGY_COEFF_COUNT
+};
+
+enum EnergySubsystem {
+  ENERGY_DISPLAY,
+  ENERGY_CPU,
+  ENERGY_SD,
+  ENERGY_AUDIO,
+  ENERGY_IMU,
+  ENERGY_I2C,
+  ENERGY_BASE,
+  ENERGY_SUBSYSTEM_COUNT
+};
+
+enum EnergyIMUMode {
+  ENERGY_IMU_OFF,
+  ENERGY_IMU_FULL,
+  ENERGY_IMU_LOW
+};
+
+// Time-in-state counters
+enum EnergyState {
+  ENERGY_STATE_DISPLAY_ON,
+  ENERGY_STATE_CPU_BUSY,         // Core time, so up to twice the wall time
+  ENERGY_STATE_CPU_80,           // Awake at each clock
+  ENERGY_STATE_CPU_160,
+  ENERGY_STATE_CPU_240,
+  ENERGY_STATE_CPU_SLEEP,
+  ENERGY_STATE_SD,
+  ENERGY_STATE_AUDIO,
+  ENERGY_STATE_IMU_FULL,
+  ENERGY_STATE_IMU_LOW,
+  ENERGY_STATE_I2C,
+  ENERGY_STATE_COUNT
+};
+
+struct EnergyModel {
+  uint32_t ua[ENERGY_COEFF_COUNT];
+};
+
+// One accounting interval, as measured by the caller
+struct EnergySample {
+  uint32_t interval_us;
+  uint32_t sleep_us;                     // Light sleep within the interval
+  uint32_t busy_us[ENERGY_CORES];        // Per core, while awake
+  uint16_t cpu_mhz;
+  bool display_on;
+  uint8_t brightness;                    // Percent
+  uint16_t luminance;                    // Average picture level, permille of full white
+  uint32_t sd_us;
+  bool audio_on;
+  uint8_t imu_mode;                      // EnergyIMUMode
+  uint32_t i2c_us;
+  uint8_t screen;                        // ScreenType
+  uint8_t app;                           // AppType, or ENERGY_NO_APP
+};
+
+struct EnergyLedger {
+  uint64_t subsystem_uams[ENERGY_SUBSYSTEM_COUNT];  // Charge in uA*ms
+  uint64_t screen_uams[ENERGY_MAX_SCREENS];
+  uint64_t app_uams[ENERGY_MAX_APPS];
+  uint64_t screen_us[ENERGY_MAX_SCREENS];
+  uint64_t screen_display_uams[ENERGY_MAX_SCREENS];    // Display share of screen_uams
+  uint64_t screen_luminance_sum[ENERGY_MAX_SCREENS];   // Permille * us with the display on
+  uint64_t app_us[ENERGY_MAX_APPS];
+  uint64_t state_us[ENERGY_STATE_COUNT];
+  uint64_t brightness_sum;               // Percent * us with the display on
+  uint64_t luminance_sum;                // Permille * us with the display on
+  uint64_t total_us;
+  uint32_t samples;
+};
+
+// Model
+void energyModelDefaults(EnergyModel& model);
+bool energyModelSet(EnergyModel& model, int coefficient, uint32_t ua);
+const char* energyCoefficientName(int coefficient);
+
+// Accounting
+void energyLedgerReset(EnergyLedger& ledger);
+uint32_t energyDisplayCurrent(const EnergyModel& model, uint8_t brightness, uint16_t luminance);  // uA
+uint32_t energySampleCurrent(const EnergyModel& model, const EnergySample& sample,
+                             uint64_t* subsystem_uams = nullptr);  // Mean uA over the interval
+void energyAccount(EnergyLedger& ledger, const EnergyModel& model, const EnergySample& sample);
+
+// Readings
+const char* energySubsystemName(int subsystem);
+uint64_t energyLedgerTotal(const EnergyLedger& ledger);           // uA*ms
+uint32_t energyAverageCurrent(const EnergyLedger& ledger);        // uA
+uint32_t energyScreenCurrent(const EnergyLedger& ledger, int screen);  // uA while it showed
+uint32_t energyScreenDisplayCurrent(const EnergyLedger& ledger, int screen);  // Display alone
+uint16_t energyScreenLuminance(const EnergyLedger& ledger, int screen);  // Mean APL, permille
+uint16_t energyLuminanceFromRGB565(uint16_t color);
+float energyMilliampHours(uint64_t uams);
+
+#endif // ENERGY_H
\ No newline at end of file
@@ -4,14 +4,29 @@
  */
 
 #include "filesystem.h"
+#include <atomic>
 
 // Global file arrays in PSRAM
 MusicFile* music_files = nullptr;
 PDFFile* pdf_files = nullptr;
 int total_music_files = 0;
 int total_pdf_files = 0;
+static bool media_indexed = false;
 
-bool initializeFileSystem() {
+// Time spent in SD transfers, for energy accounting; the sensor task writes
+// the activity log from the other core
+static std::atomic<uint32_t> sd_busy_us(0);
+
+struct SDBusy {
+  uint32_t start = micros();
+  ~SDBusy() { sd_busy_us += micros() - start; }
+};
+
+uint32_t getSDBusyMicros() {
+  return sd_busy_us.load();
+}
+
+bool initializeFileSystem(bool index_media) {
   Serial.println("Initializing file system...");
   
   // Initialize SD card
@@ -55,20 +70,32 @@ bool initializeFileSystem() {
   initializeCache();
   
   // Scan for files
-  total_music_files = scanMusicFiles(music_files, 100);
-  total_pdf_files = scanPDFFiles(pdf_files, 50);
+  if (index_media) indexMediaFiles();
   
   Serial.println("File system initialized successfully");
-  Serial.printf("Found %d music files and %d PDF files\n", total_music_files, total_pdf_files);
-  
   return true;
 }
 
+void indexMediaFiles() {
+  total_music_files = scanMusicFiles(music_files, 100);
+  total_pdf_files = scanPDFFiles(pdf_files, 50);
+  media_indexed = true;
+  Serial.printf("Found %d music files and %d PDF files\n", total_music_files, total_pdf_files);
+}
+
+bool ensureMediaIndex() {
+  // A warm boot mounts the card without scanning; the first app to need
+  // the lists pays for them
+  if (!media_indexed && music_files && pdf_files) indexMediaFiles();
+  return media_indexed;
+}
+
 bool fileExists(const char* path) {
   return SD.exists(path);
 }
 
 size_t getFileSize(const char* path) {
+  SDBusy busy;
   File file = SD.open(path);
   if (!file) return 0;
   
@@ -78,6 +105,7 @@ size_t getFileSize(const char* path) {
 }
 
 String readTextFile(const char* path) {
+  SDBusy busy;
   File file = SD.open(path);
   if (!file) return "";
   
@@ -87,6 +115,7 @@ String readTextFile(const char* path) {
 }
 
 bool writeTextFile(const char* path, const String& content) {
+  SDBusy busy;
   File file = SD.open(path, FILE_WRITE);
   if (!file) return false;
   
@@ -100,6 +129,7 @@ bool deleteFile(const char* path) {
 }
 
 bool listDirectory(const char* path, FileInfo files[], int max_files, int& count) {
+  SDBusy busy;
   File root = SD.open(path);
   if (!root || !root.isDirectory()) {
     return false;
@@ -123,7 +153,48 @@ bool listDirectory(const char* path, FileInfo files[], int max_files, int& count
   return true;
 }
 
+// ==================== ACTIVITY LOG STORAGE ====================
+static int32_t sdLogSize(const char* path) {
+  SDBusy busy;
+  if (!SD.exists(path)) return -1;
+  File file = SD.open(path);
+  if (!file) return -1;
+  int32_t size = file.size();
+  file.close();
+  return size;
+}
+
+static bool sdLogRead(const char* path, uint32_t offset, uint8_t* data, size_t length) {
+  SDBusy busy;
+  File file = SD.open(path);
+  if (!file) return false;
+  bool ok = file.seek(offset) && file.read(data, length) == length;
+  file.close();
+  return ok;
+}
+
+static bool sdLogWrite(const char* path, uint32_t offset, const uint8_t* data, size_t length) {
+  SDBusy busy;
+  // "r+" keeps the contents, FILE_WRITE would truncate them
+  File file = SD.exists(path) ? SD.open(path, "r+") : File();
+  if (!file) {
+    String parent = String(path).substring(0, String(path).lastIndexOf('/'));
+    if (parent.length() > 0 && !SD.exists(parent)) SD.mkdir(parent);
+    file = SD.open(path, FILE_WRITE);
+    if (!file) return false;
+  }
+  bool ok = offset <= file.size() && file.seek(offset) && file.write(data, length) == length;
+  file.close();
+  return ok;
+}
+
+const ActivityLogStorage& sdActivityLogStorage() {
+  static const ActivityLogStorage storage = {sdLogSize, sdLogRead, sdLogWrite};
+  return storage;
+}
+
 int scanMusicFiles(MusicFile music_files[], int max_files) {
+  SDBusy busy;
   File root = SD.open("/");
   if (!root) return 0;
   
@@ -172,6 +243,7 @@ int scanMusicFiles(MusicFile music_files[], int max_files) {
 }
 
 int scanPDFFiles(PDFFile pdf_files[], int max_files) {
+  SDBusy busy;
   File root = SD.open("/");
   if (!root) return 0;
   
@@ -291,6 +363,7 @@ String formatFileSize(size_t bytes) {
 }
 
 void saveSettingsToFile() {
+  SDBusy busy;
   File settingsFile = SD.open("/settings.cfg", FILE_WRITE);
   if (!settingsFile) return;
   
@@ -9,6 +9,7 @@
 #include "config.h"
 #include <SD.h>
 #include <FS.h>
+#include "activity_log.h"
 
 // File types
 enum FileType {
@@ -52,7 +53,11 @@ struct PDFFile {
 };
 
 // Initialize file system
-bool initializeFileSystem();
+bool initializeFileSystem(bool index_media = true);
+
+// Music and PDF lists, scanned at a cold boot or on first use after a warm one
+void indexMediaFiles();
+bool ensureMediaIndex();
 
 // File operations
 bool fileExists(const char* path);
@@ -82,6 +87,12 @@ void loadSettingsFromFile();
 void saveUserPreferences();
 void loadUserPreferences();
 
+// Positioned file access for the activity history store
+const ActivityLogStorage& sdActivityLogStorage();
+
+// Microseconds spent in SD transfers since boot, wraps
+uint32_t getSDBusyMicros();
+
 // Cache management
 void initializeCache();
 void clearCache();
@@ -0,0 +1,38 @@
+/*
+ * Fixed-Point Helpers for ESP32-S3 Watch
+ * Integer routines shared by the motion algorithms
+ */
+
+#ifndef FIXED_MATH_H
+#define FIXED_MATH_H
+
+#include <stdint.h>
+
+// Integer square root, bit by bit, no FPU or division
+inline uint32_t isqrt32(uint32_t value) {
+  uint32_t result = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > value) bit >>= 2;
+  while (bit != 0) {
+    if (value >= result + bit) {
+      value -= result + bit;
+      result = (result >> 1) + bit;
+    } else {
+      result >>= 1;
+    }
+    bit >>= 2;
+  }
+  return result;
+}
+
+// Length of a raw int16 sensor vector
+inline uint32_t vectorLength3(const int16_t* v) {
+  uint32_t square = 0;
+  for (int axis = 0; axis < 3; axis++) {
+    int32_t c = v[axis];
+    square += (uint32_t)(c * c);
+  }
+  return isqrt32(square);
+}
+
+#endif // FIXED_MATH_H
\ No newline at end of file
@@ -0,0 +1,265 @@
+/*
+ * Battery Fuel Gauge Implementation
+ * OCV lookup, rest detection, charge counting and model checkpoints
+ */
+
+#include "fuel_gauge.h"
+#include <string.h>
+
+// Single LiPo cell at 25C after a long rest, 0% to 100% in 5% steps
+static const int16_t ocv_table[FUEL_OCV_POINTS] = {
+  3300, 3550, 3630, 3680, 3710, 3730, 3750, 3770, 3790, 3800, 3820,
+  3840, 3860, 3890, 3920, 3950, 3980, 4020, 4060, 4110, 4180
+};
+
+// ==================== OCV CURVE ====================
+int fuelOcvToPermille(int ocv_mv) {
+  if (ocv_mv <= ocv_table[0]) return 0;
+  if (ocv_mv >= ocv_table[FUEL_OCV_POINTS - 1]) return 1000;
+  int i = 1;
+  while (ocv_mv >= ocv_table[i]) i++;
+  return (i - 1) * 50 + (ocv_mv - ocv_table[i - 1]) * 50 / (ocv_table[i] - ocv_table[i - 1]);
+}
+
+int fuelPermilleToOcv(int permille) {
+  if (permille <= 0) return ocv_table[0];
+  if (permille >= 1000) return ocv_table[FUEL_OCV_POINTS - 1];
+  int i = permille / 50;
+  return ocv_table[i] + (ocv_table[i + 1] - ocv_table[i]) * (permille - i * 50) / 50;
+}
+
+int fuelResistanceMohm(int temperature_c10) {
+  // Roughly 3% more per degree below room temperature
+  if (temperature_c10 >= 250) return FUEL_RESISTANCE_MOHM;
+  return FUEL_RESISTANCE_MOHM + FUEL_RESISTANCE_MOHM * (250 - temperature_c10) * 3 / 1000;
+}
+
+int fuelStrandedPermille(int temperature_c10) {
+  // The loaded voltage reaches cutoff early in the cold, ~0.6% per degree
+  if (temperature_c10 >= 250) return 0;
+  int stranded = (250 - temperature_c10) * 6 / 10;
+  return stranded < 400 ? stranded : 400;
+}
+
+// How far to trust an OCV reading: a few mV of error is a few percent on
+// the plateau, but well under one on the steep ends
+static int ocvWeight(int permille) {
+  int i = permille / 50;
+  if (i >= FUEL_OCV_POINTS - 1) i = FUEL_OCV_POINTS - 2;
+  int weight = (ocv_table[i + 1] - ocv_table[i]) * 100 / 40;
+  if (weight < FUEL_MIN_WEIGHT) return FUEL_MIN_WEIGHT;
+  return weight < 100 ? weight : 100;
+}
+
+// ==================== COUNTING ====================
+static float chargeCurrent(const FuelGauge& gauge) {
+  // Constant current, then tapering to a tenth over the last 15%
+  int permille = (int)((int64_t)gauge.remaining_uah * 1000 / gauge.design_uah);
+  if (permille < 850) return gauge.profile.charge_ma;
+  return gauge.profile.charge_ma * (0.1f + 0.9f * (1000 - permille) / 150.0f);
+}
+
+static float modelCurrent(const FuelGauge& gauge) {
+  if (gauge.charging) return -chargeCurrent(gauge);
+  return gauge.load_ua[gauge.load] / 1000.0f;
+}
+
+static void advance(FuelGauge& gauge, uint32_t now_ms, float current_ma) {
+  uint32_t dt = now_ms - gauge.last_ms;
+  gauge.last_ms = now_ms;
+  if (dt == 0) return;
+
+  // Whole uAh leave the count, the rest waits in the residue
+  int64_t charge = (int64_t)gauge.residue + (int64_t)(current_ma * dt);
+  int32_t used_uah = (int32_t)(charge / 3600);
+  gauge.residue = (int32_t)(charge - (int64_t)used_uah * 3600);
+  gauge.remaining_uah -= used_uah;
+  if (gauge.remaining_uah < 0) gauge.remaining_uah = 0;
+  if (gauge.remaining_uah > gauge.design_uah) gauge.remaining_uah = gauge.design_uah;
+  if (gauge.charging) return;
+
+  // What the model would have said, and how the time splits between loads
+  gauge.predicted_uah[gauge.load] += gauge.load_ua[gauge.load] * dt / 3600000.0f;
+  float step = dt < FUEL_SHARE_WINDOW_MS ? (float)dt / FUEL_SHARE_WINDOW_MS : 1.0f;
+  for (int load = 0; load < FUEL_LOAD_COUNT; load++) {
+    float target = load == gauge.load ? 1.0f : 0.0f;
+    gauge.share[load] += (target - gauge.share[load]) * step;
+  }
+}
+
+static void forgetCheckpoint(FuelGauge& gauge, int32_t checkpoint_uah) {
+  gauge.checkpoint_uah = checkpoint_uah;
+  memset(gauge.predicted_uah, 0, sizeof(gauge.predicted_uah));
+}
+
+static void learnFromCheckpoint(FuelGauge& gauge, int32_t ocv_uah) {
+  if (gauge.checkpoint_uah < 0) {
+    forgetCheckpoint(gauge, ocv_uah);
+    return;
+  }
+  int32_t used = gauge.checkpoint_uah - ocv_uah;
+  if (used < gauge.design_uah / 1000 * FUEL_LEARN_MIN_PERMILLE) return;  // Keep accumulating
+
+  float predicted = 0;
+  for (int load = 0; load < FUEL_LOAD_COUNT; load++) predicted += gauge.predicted_uah[load];
+  if (predicted > 0) {
+    // Each load takes the error in proportion to the charge it accounted for
+    float ratio = used / predicted;
+    if (ratio < 0.5f) ratio = 0.5f;
+    if (ratio > 2.0f) ratio = 2.0f;
+    for (int load = 0; load < FUEL_LOAD_COUNT; load++) {
+      float part = gauge.predicted_uah[load] / predicted;
+      gauge.load_ua[load] *= 1.0f + (ratio - 1.0f) * part * FUEL_LEARN_RATE / 100.0f;
+    }
+    gauge.model_changed = true;
+    gauge.stats.checkpoints++;
+  }
+  forgetCheckpoint(gauge, ocv_uah);
+}
+
+static void applyOCV(FuelGauge& gauge, int ocv_mv) {
+  int permille = fuelOcvToPermille(ocv_mv);
+  int32_t ocv_uah = (int32_t)((int64_t)gauge.design_uah * permille / 1000);
+  int32_t correction = (int32_t)((int64_t)(ocv_uah - gauge.remaining_uah) * ocvWeight(permille) / 100);
+  gauge.remaining_uah += correction;
+  gauge.stats.corrections++;
+  gauge.stats.last_correction_uah = correction;
+  if (!gauge.measured) learnFromCheckpoint(gauge, ocv_uah);
+}
+
+static void trackRest(FuelGauge& gauge, const FuelGaugeInput& input, int ocv_mv) {
+  float magnitude = gauge.current_ma < 0 ? -gauge.current_ma : gauge.current_ma;
+  if (input.plugged || magnitude >= FUEL_RELAX_CURRENT_MA) {
+    gauge.resting = false;
+    return;
+  }
+  if (!gauge.resting) {
+    gauge.resting = true;
+    gauge.rest_since_ms = input.now_ms;
+    gauge.settled_since_ms = input.now_ms;
+    gauge.settled_mv = input.voltage_mv;
+    return;
+  }
+
+  // Still relaxing while the voltage keeps creeping
+  int drift = input.voltage_mv - gauge.settled_mv;
+  if (drift > FUEL_SETTLE_MV || drift < -FUEL_SETTLE_MV) {
+    gauge.settled_mv = input.voltage_mv;
+    gauge.settled_since_ms = input.now_ms;
+    return;
+  }
+  if (input.now_ms - gauge.rest_since_ms >= FUEL_RELAX_MS &&
+      input.now_ms - gauge.settled_since_ms >= FUEL_SETTLE_MS) {
+    applyOCV(gauge, ocv_mv);
+    gauge.rest_since_ms = input.now_ms;
+  }
+}
+
+// ==================== GAUGE ====================
+void fuelGaugeInit(FuelGauge& gauge, const FuelGaugeProfile& profile) {
+  memset(&gauge, 0, sizeof(gauge));
+  gauge.profile = profile;
+  gauge.design_uah = (int32_t)profile.capacity_mah * 1000;
+  gauge.temperature_c10 = 250;
+  gauge.load = FUEL_LOAD_ACTIVE;
+  gauge.checkpoint_uah = -1;
+  for (int load = 0; load < FUEL_LOAD_COUNT; load++) gauge.load_ua[load] = profile.load_ua[load];
+
+  // A watch spends most of the day with the screen off
+  gauge.share[FUEL_LOAD_ACTIVE] = 0.1f;
+  gauge.share[FUEL_LOAD_SLEEP] = 0.9f;
+}
+
+void fuelGaugeSetModel(FuelGauge& gauge, const uint32_t* load_ua) {
+  for (int load = 0; load < FUEL_LOAD_COUNT; load++) {
+    if (load_ua[load] > 0) gauge.load_ua[load] = load_ua[load];
+  }
+}
+
+void fuelGaugeSetLoad(FuelGauge& gauge, FuelLoad load, uint32_t now_ms) {
+  if (load == gauge.load) return;
+  if (gauge.started) {
+    advance(gauge, now_ms, gauge.measured ? gauge.current_ma : modelCurrent(gauge));
+  }
+  gauge.load = load;
+  gauge.resting = false;
+}
+
+void fuelGaugeUpdate(FuelGauge& gauge, const FuelGaugeInput& input) {
+  gauge.stats.updates++;
+  gauge.temperature_c10 = input.temperature_c10;
+  gauge.stranded_uah = (int32_t)((int64_t)gauge.design_uah * fuelStrandedPermille(input.temperature_c10) / 1000);
+
+  if (!gauge.started) {
+    // First look, under load: the best guess until the cell rests
+    gauge.charging = input.charging;
+    gauge.measured = input.current_valid;
+    gauge.current_ma = input.current_valid ? input.current_ma : modelCurrent(gauge);
+    int ocv_mv = input.voltage_mv + (int)(gauge.current_ma * fuelResistanceMohm(input.temperature_c10) / 1000);
+    gauge.remaining_uah = (int32_t)((int64_t)gauge.design_uah * fuelOcvToPermille(ocv_mv) / 1000);
+    gauge.last_ms = input.now_ms;
+    gauge.started = true;
+    return;
+  }
+
+  // The interval since the last update ran at the state it started in
+  float current_ma = input.current_valid ? input.current_ma : modelCurrent(gauge);
+  advance(gauge, input.now_ms, current_ma);
+
+  if (input.charging != gauge.charging) {
+    // Charge the model never saw breaks the checkpoint chain
+    forgetCheckpoint(gauge, -1);
+    gauge.resting = false;
+  }
+  if (gauge.charging && !input.charging && input.plugged) {
+    // The charger finished: a full cell is the best anchor there is
+    gauge.remaining_uah = gauge.design_uah;
+    gauge.residue = 0;
+    forgetCheckpoint(gauge, gauge.design_uah);
+  }
+  gauge.charging = input.charging;
+
+  gauge.measured = input.current_valid;
+  gauge.current_ma = input.current_valid ? input.current_ma : modelCurrent(gauge);
+  if (gauge.measured && !gauge.charging && gauge.current_ma > 0) {
+    // A real reading teaches the model directly, over about ten minutes
+    float& load_ua = gauge.load_ua[gauge.load];
+    load_ua += (gauge.current_ma * 1000.0f - load_ua) * 0.05f;
+  }
+
+  int ocv_mv = input.voltage_mv + (int)(gauge.current_ma * fuelResistanceMohm(input.temperature_c10) / 1000);
+  trackRest(gauge, input, ocv_mv);
+}
+
+// ==================== READINGS ====================
+int fuelGaugePercent(const FuelGauge& gauge) {
+  int32_t usable = gauge.remaining_uah - gauge.stranded_uah;
+  int32_t full = gauge.design_uah - gauge.stranded_uah;
+  if (usable <= 0 || full <= 0) return 0;
+  int percent = (int)(((int64_t)usable * 100 + full / 2) / full);
+  return percent < 100 ? percent : 100;
+}
+
+uint32_t fuelGaugeLoadCurrent(const FuelGauge& gauge, FuelLoad load) {
+  return (uint32_t)gauge.load_ua[load];
+}
+
+uint32_t fuelGaugeRuntimeMinutes(const FuelGauge& gauge) {
+  int32_t usable = gauge.remaining_uah - gauge.stranded_uah;
+  if (usable <= 0) return 0;
+  float mean_ua = 0;
+  for (int load = 0; load < FUEL_LOAD_COUNT; load++) mean_ua += gauge.share[load] * gauge.load_ua[load];
+  if (mean_ua <= 0) return 0;
+  return (uint32_t)(usable / mean_ua * 60.0f);
+}
+
+uint32_t fuelGaugeChargeMinutes(const FuelGauge& gauge) {
+  if (!gauge.charging || gauge.profile.charge_ma == 0) return 0;
+
+  // Constant current up to 85%, then the taper averages about half of it
+  int32_t knee = gauge.design_uah / 100 * 85;
+  int32_t constant = gauge.remaining_uah < knee ? knee - gauge.remaining_uah : 0;
+  int32_t tapered = gauge.design_uah - (gauge.remaining_uah > knee ? gauge.remaining_uah : knee);
+  float minutes = (constant + tapered / 0.55f) / 1000.0f / gauge.profile.charge_ma * 60.0f;
+  return (uint32_t)(minutes + 0.5f);
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+/*
+ * Battery Fuel Gauge for ESP32-S3 Watch
+ * Coulomb counting anchored to the OCV curve, with a learned load model
+ *
+ * Charge is counted continuously: from a measured current when the PMIC
+ * provides one, otherwise from the learned mean current of whatever the
+ * watch is doing (screen on, or asleep with the IMU counting). Counting
+ * drifts, so whenever the cell has rested long enough for its terminal
+ * voltage to settle, the open-circuit voltage is looked up in the OCV
+ * table and pulls the count back, weighted by how steep the curve is
+ * there. Each rested reading is also a checkpoint: the charge the OCV
+ * says was used since the previous one, against what the model predicted,
+ * rescales the per-load currents. Runtime is the usable charge over the
+ * model's current at the recent mix of loads.
+ *
+ * Cold raises the cell's resistance, so the OCV is recovered from the
+ * loaded voltage with a temperature-scaled IR term, and cold also strands
+ * charge below the cutoff, so it no longer counts as usable. Integer charge
+ * in uAh, plain C++, so discharge curves can be simulated on host.
+ */
+
+#ifndef FUEL_GAUGE_H
+#define FUEL_GAUGE_H
+
+#include <stdint.h>
+
+#define FUEL_OCV_POINTS 21               // 0-100% in 5% steps
+#define FUEL_RESISTANCE_MOHM 180         // Cell plus protection at 25C
+#define FUEL_RELAX_CURRENT_MA 10         // Below this the cell counts as resting
+#define FUEL_RELAX_MS 1200000            // Rest before the voltage is trusted, and between corrections
+#define FUEL_SETTLE_MV 3                 // ...and with no move larger than this
+#define FUEL_SETTLE_MS 600000            // ...for this long
+#define FUEL_MIN_WEIGHT 20               // Percent of an OCV correction on the flat plateau
+#define FUEL_LEARN_MIN_PERMILLE 40       // Checkpoints closer than 4% teach the model nothing
+#define FUEL_LEARN_RATE 50               // Percent of a checkpoint's error taken into the model
+#define FUEL_SHARE_WINDOW_MS 86400000    // Load mix averaged over about a day
+
+enum FuelLoad {
+  FUEL_LOAD_ACTIVE,     // Screen on
+  FUEL_LOAD_SLEEP,      // Screen asleep, CPU in light sleep
+  FUEL_LOAD_COUNT
+};
+
+struct FuelGaugeProfile {
+  uint16_t capacity_mah;
+  uint16_t charge_ma;                    // Charger constant-current setting
+  uint32_t load_ua[FUEL_LOAD_COUNT];     // Starting guess per load
+};
+
+struct FuelGaugeInput {
+  uint32_t now_ms;
+  int16_t voltage_mv;
+  int16_t current_ma;                    // Discharge positive
+  bool current_valid;                    // False: the load model stands in
+  int16_t temperature_c10;               // Tenths of a degree
+  bool charging;
+  bool plugged;
+};
+
+struct FuelGaugeStats {
+  uint32_t updates;
+  uint32_t corrections;                  // OCV readings applied
+  int32_t last_correction_uah;
+  uint32_t checkpoints;                  // Of those, used to rescale the model
+};
+
+struct FuelGauge {
+  FuelGaugeProfile profile;
+  int32_t design_uah;
+  int32_t remaining_uah;                 // Above the 0% point at 25C
+  int32_t residue;                       // Uncounted charge in mA*ms
+  int32_t stranded_uah;                  // Unusable at the current temperature
+  int16_t temperature_c10;
+  uint32_t last_ms;
+  bool started;
+  bool charging;
+
+  // Load model
+  FuelLoad load;
+  float load_ua[FUEL_LOAD_COUNT];
+  float share[FUEL_LOAD_COUNT];          // Recent time share of each load
+  float predicted_uah[FUEL_LOAD_COUNT];  // Model charge since the last checkpoint
+  int32_t checkpoint_uah;                // OCV charge at the last checkpoint, -1 for none
+  bool model_changed;                    // Set when worth persisting, cleared by the caller
+
+  // Rest detection
+  float current_ma;                      // Last measured or modelled current
+  bool measured;
+  uint32_t rest_since_ms;                // Also restarted by each correction
+  uint32_t settled_since_ms;
+  int16_t settled_mv;
+  bool resting;
+
+  FuelGaugeStats stats;
+};
+
+// Gauge
+void fuelGaugeInit(FuelGauge& gauge, const FuelGaugeProfile& profile);
+void fuelGaugeSetLoad(FuelGauge& gauge, FuelLoad load, uint32_t now_ms);  // Counts the old load up to now
+void fuelGaugeUpdate(FuelGauge& gauge, const FuelGaugeInput& input);
+void fuelGaugeSetModel(FuelGauge& gauge, const uint32_t* load_ua);
+
+// Readings
+int fuelGaugePercent(const FuelGauge& gauge);
+uint32_t fuelGaugeRuntimeMinutes(const FuelGauge& gauge);  // At the recent load mix
+uint32_t fuelGaugeChargeMinutes(const FuelGauge& gauge);   // To full, 0 when not charging
+uint32_t fuelGaugeLoadCurrent(const FuelGauge& gauge, FuelLoad load);  // uA
+
+// OCV curve, exposed for the simulated battery and host checks
+int fuelOcvToPermille(int ocv_mv);
+int fuelPermilleToOcv(int permille);
+int fuelResistanceMohm(int temperature_c10);
+int fuelStrandedPermille(int temperature_c10);
+
+#endif // FUEL_GAUGE_H
\ No newline at end of file
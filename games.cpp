@@ -51,6 +51,11 @@ void initializeGames() {
   Serial.println("Games system initialized");
 }
 
+// A game owns the wrist while it is on screen, only the menu navigates
+bool isGameInPlay() {
+  return system_state.current_app == APP_GAMES && current_game_session.state != GAME_MENU;
+}
+
 void launchGame(GameType game) {
   current_game_session.current_game = game;
   current_game_session.start_time = millis();
@@ -77,6 +82,12 @@ void launchGame(GameType game) {
   }
 }
 
+// Menu button that is also registered as a touch region for its game
+static void drawGameMenuButton(int x, int y, int w, int h, String text, GameType game) {
+  drawGameButton(x, y, w, h, text, current_game_session.current_game == game);
+  addHitRegion(x, y, w, h, (int)game);
+}
+
 void drawGameMenu() {
   clearDisplay();
   ThemeColors* theme = getCurrentTheme();
@@ -93,16 +104,16 @@ void drawGameMenu() {
   int start_y = 80;
   
   // Row 1
-  drawGameButton(10, start_y, button_w, button_h, "Battle Arena", current_game_session.current_game == GAME_BATTLE_ARENA);
-  drawGameButton(20 + button_w, start_y, button_w, button_h, "Shadow Dungeon", current_game_session.current_game == GAME_SHADOW_DUNGEON);
+  drawGameMenuButton(10, start_y, button_w, button_h, "Battle Arena", GAME_BATTLE_ARENA);
+  drawGameMenuButton(20 + button_w, start_y, button_w, button_h, "Shadow Dungeon", GAME_SHADOW_DUNGEON);
   
   // Row 2  
-  drawGameButton(10, start_y + 60, button_w, button_h, "Pirate Adventure", current_game_session.current_game == GAME_PIRATE_ADVENTURE);
-  drawGameButton(20 + button_w, start_y + 60, button_w, button_h, "Wakfu Quest", current_game_session.current_game == GAME_WAKFU_QUEST);
+  drawGameMenuButton(10, start_y + 60, button_w, button_h, "Pirate Adventure", GAME_PIRATE_ADVENTURE);
+  drawGameMenuButton(20 + button_w, start_y + 60, button_w, button_h, "Wakfu Quest", GAME_WAKFU_QUEST);
   
   // Row 3
-  drawGameButton(10, start_y + 120, button_w, button_h, "Snake Game", current_game_session.current_game == GAME_MINI_SNAKE);
-  drawGameButton(20 + button_w, start_y + 120, button_w, button_h, "Memory Match", current_game_session.current_game == GAME_MEMORY_MATCH);
+  drawGameMenuButton(10, start_y + 120, button_w, button_h, "Snake Game", GAME_MINI_SNAKE);
+  drawGameMenuButton(20 + button_w, start_y + 120, button_w, button_h, "Memory Match", GAME_MEMORY_MATCH);
   
   // Game stats
   char stats_str[100];
@@ -120,29 +131,10 @@ void drawGameMenu() {
 void handleGameMenuTouch(TouchGesture& gesture) {
   if (gesture.event != TOUCH_TAP) return;
   
-  int button_w = (DISPLAY_WIDTH - 30) / 2;
-  int button_h = 50;
-  int start_y = 80;
-  
   // Check which game button was tapped
-  if (gesture.y >= start_y && gesture.y <= start_y + button_h) {
-    if (gesture.x >= 10 && gesture.x <= 10 + button_w) {
-      launchGame(GAME_BATTLE_ARENA);
-    } else if (gesture.x >= 20 + button_w && gesture.x <= 20 + 2 * button_w) {
-      launchGame(GAME_SHADOW_DUNGEON);
-    }
-  } else if (gesture.y >= start_y + 60 && gesture.y <= start_y + 60 + button_h) {
-    if (gesture.x >= 10 && gesture.x <= 10 + button_w) {
-      launchGame(GAME_PIRATE_ADVENTURE);
-    } else if (gesture.x >= 20 + button_w && gesture.x <= 20 + 2 * button_w) {
-      launchGame(GAME_WAKFU_QUEST);
-    }
-  } else if (gesture.y >= start_y + 120 && gesture.y <= start_y + 120 + button_h) {
-    if (gesture.x >= 10 && gesture.x <= 10 + button_w) {
-      launchGame(GAME_MINI_SNAKE);
-    } else if (gesture.x >= 20 + button_w && gesture.x <= 20 + 2 * button_w) {
-      launchGame(GAME_MEMORY_MATCH);
-    }
+  const HitRegion* region = findHitRegion(gesture);
+  if (region != nullptr) {
+    launchGame((GameType)region->tag);
   }
 }
 
@@ -170,6 +162,15 @@ void initBattleArena() {
   addBattleLog("A wild " + current_game_session.enemy_creature.name + " appeared!");
 }
 
+// Touch regions registered by drawBattleArena(), fighters and moves add
+// their slot to the base tag
+enum BattleHitTag {
+  BATTLE_HIT_FIGHTER = 0,
+  BATTLE_HIT_MOVE = 10,
+  BATTLE_HIT_AGAIN = 20,
+  BATTLE_HIT_MENU
+};
+
 void drawBattleArena() {
   clearDisplay();
   ThemeColors* theme = getCurrentTheme();
@@ -193,6 +194,7 @@ void drawBattleArena() {
       int y = 100 + i * 60;
       
       drawGameButton(20, y, DISPLAY_WIDTH - 40, 50, creature.name + " Lvl." + String(creature.level), false);
+      addHitRegion(20, y, DISPLAY_WIDTH - 40, 50, BATTLE_HIT_FIGHTER + i);
       
       // Stats preview
       char stats[50];
@@ -247,6 +249,7 @@ void drawBattleArena() {
         drawGameButton(x, y, DISPLAY_WIDTH / 2 - 20, 30, 
                       current_game_session.player_creature.moves[i], 
                       i == current_game_session.selected_move);
+        addHitRegion(x, y, DISPLAY_WIDTH / 2 - 20, 30, BATTLE_HIT_MOVE + i);
         
         // Power indicator
         char power_str[10];
@@ -274,6 +277,8 @@ void drawBattleArena() {
     
     drawGameButton(50, 300, DISPLAY_WIDTH - 100, 40, "Battle Again", false);
     drawGameButton(50, 350, DISPLAY_WIDTH - 100, 40, "Back to Menu", false);
+    addHitRegion(50, 300, DISPLAY_WIDTH - 100, 40, BATTLE_HIT_AGAIN);
+    addHitRegion(50, 350, DISPLAY_WIDTH - 100, 40, BATTLE_HIT_MENU);
   }
   
   updateDisplay();
@@ -282,6 +287,10 @@ void drawBattleArena() {
 void handleBattleTouch(TouchGesture& gesture) {
   if (gesture.event != TOUCH_TAP) return;
   
+  const HitRegion* region = findHitRegion(gesture);
+  if (region == nullptr) return;
+  int tag = region->tag;
+  
   if (current_game_session.state == GAME_BATTLE_SELECT) {
     // Handle creature selection
     int start_index = 0;
@@ -291,45 +300,29 @@ void handleBattleTouch(TouchGesture& gesture) {
       case THEME_YUGO_WAKFU: start_index = 6; break;
     }
     
-    for (int i = 0; i < 3; i++) {
-      int y = 100 + i * 60;
-      if (gesture.y >= y && gesture.y <= y + 50) {
-        current_game_session.player_creature = battle_creatures[start_index + i];
-        current_game_session.player_creature.is_player = true;
-        current_game_session.state = GAME_BATTLE_FIGHT;
-        addBattleLog("Go, " + current_game_session.player_creature.name + "!");
-        break;
-      }
+    if (tag >= BATTLE_HIT_FIGHTER && tag < BATTLE_HIT_FIGHTER + 3) {
+      current_game_session.player_creature = battle_creatures[start_index + tag - BATTLE_HIT_FIGHTER];
+      current_game_session.player_creature.is_player = true;
+      current_game_session.state = GAME_BATTLE_FIGHT;
+      addBattleLog("Go, " + current_game_session.player_creature.name + "!");
     }
     
   } else if (current_game_session.state == GAME_BATTLE_FIGHT) {
-    // Handle move selection
-    int move_y = 280;
-    for (int i = 0; i < 4; i++) {
-      if (current_game_session.player_creature.moves[i] != "") {
-        int x = (i % 2) * (DISPLAY_WIDTH / 2) + 10;
-        int y = move_y + (i / 2) * 35;
-        
-        if (gesture.x >= x && gesture.x <= x + DISPLAY_WIDTH / 2 - 20 &&
-            gesture.y >= y && gesture.y <= y + 30) {
-          selectMove(i);
-          break;
-        }
-      }
+    // Handle move selection, only moves the creature has were registered
+    if (tag >= BATTLE_HIT_MOVE && tag < BATTLE_HIT_MOVE + 4) {
+      selectMove(tag - BATTLE_HIT_MOVE);
     }
     
   } else if (current_game_session.state == GAME_BATTLE_RESULT) {
     // Handle result screen
-    if (gesture.y >= 300 && gesture.y <= 340) {
-      // Battle Again
+    if (tag == BATTLE_HIT_AGAIN) {
       generateRandomEnemy();
       current_game_session.player_creature.hp = current_game_session.player_creature.max_hp;
       current_game_session.state = GAME_BATTLE_FIGHT;
       current_game_session.log_count = 0;
       addBattleLog("A new challenger approaches!");
       
-    } else if (gesture.y >= 350 && gesture.y <= 390) {
-      // Back to Menu
+    } else if (tag == BATTLE_HIT_MENU) {
       current_game_session.state = GAME_MENU;
     }
   }
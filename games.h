@@ -92,6 +92,7 @@ void initializeGames();
 
 // Game launcher
 void launchGame(GameType game);
+bool isGameInPlay();
 void drawGameMenu();
 void handleGameMenuTouch(TouchGesture& gesture);
 
@@ -0,0 +1,493 @@
+/*
+ * Gesture Recognition Engine Implementation
+ * Sample history, least-squares velocity, pinch math and kinetic scrolling
+ */
+
+#include "gestures.h"
+#include <math.h>
+#include <string.h>
+
+static GestureEventData makeGestureEvent(GestureTracker& tracker, GestureEventType type, int x, int y, uint32_t now) {
+  GestureEventData event;
+  event.type = type;
+  event.x = x;
+  event.y = y;
+  event.start_x = tracker.start_x;
+  event.start_y = tracker.start_y;
+  event.dx = x - tracker.last_x;
+  event.dy = y - tracker.last_y;
+  event.vx = 0;
+  event.vy = 0;
+  event.scale = 1.0f;
+  event.rotation = 0;
+  event.timestamp = now;
+  event.duration = now - tracker.down_time;
+  return event;
+}
+
+static void pushGestureSample(GestureTracker& tracker, int x, int y, uint32_t now) {
+  GestureSample& sample = tracker.history[tracker.history_head];
+  sample.x = x;
+  sample.y = y;
+  sample.time = now;
+
+  tracker.history_head = (tracker.history_head + 1) % GESTURE_HISTORY_SIZE;
+  if (tracker.history_count < GESTURE_HISTORY_SIZE) {
+    tracker.history_count++;
+  }
+}
+
+static const GestureSample& newestGestureSample(const GestureTracker& tracker) {
+  int index = (tracker.history_head + GESTURE_HISTORY_SIZE - 1) % GESTURE_HISTORY_SIZE;
+  return tracker.history[index];
+}
+
+void gestureReset(GestureTracker& tracker) {
+  memset(&tracker, 0, sizeof(tracker));
+  tracker.state = GESTURE_STATE_IDLE;
+}
+
+GestureEventData gestureTouchDown(GestureTracker& tracker, int x, int y, uint32_t now) {
+  if (tracker.state == GESTURE_STATE_IDLE) {
+    // New touch started
+    tracker.history_head = 0;
+    tracker.history_count = 0;
+    tracker.start_x = x;
+    tracker.start_y = y;
+    tracker.last_x = x;
+    tracker.last_y = y;
+    tracker.down_time = now;
+    tracker.state = GESTURE_STATE_PRESSED;
+    pushGestureSample(tracker, x, y, now);
+
+    return makeGestureEvent(tracker, GESTURE_PRESS, x, y, now);
+  }
+
+  pushGestureSample(tracker, x, y, now);
+
+  // Promote to a drag once the finger leaves the touch slop
+  if (tracker.state == GESTURE_STATE_PRESSED) {
+    int dx = x - tracker.start_x;
+    int dy = y - tracker.start_y;
+    if (dx * dx + dy * dy <= GESTURE_TOUCH_SLOP * GESTURE_TOUCH_SLOP) {
+      return makeGestureEvent(tracker, GESTURE_NONE, x, y, now);
+    }
+    tracker.state = GESTURE_STATE_DRAGGING;
+  }
+
+  if (x == tracker.last_x && y == tracker.last_y) {
+    return makeGestureEvent(tracker, GESTURE_NONE, x, y, now);
+  }
+
+  GestureEventData event = makeGestureEvent(tracker, GESTURE_DRAG, x, y, now);
+  gestureEstimateVelocity(tracker, event.vx, event.vy);
+
+  tracker.last_x = x;
+  tracker.last_y = y;
+  return event;
+}
+
+GestureEventData gestureTouchUp(GestureTracker& tracker, uint32_t now) {
+  GestureEventData event = makeGestureEvent(tracker, GESTURE_NONE, tracker.last_x, tracker.last_y, now);
+
+  switch (tracker.state) {
+    case GESTURE_STATE_IDLE:
+      return event;
+
+    case GESTURE_STATE_PRESSED:
+      if (event.duration > GESTURE_TAP_TIMEOUT) {
+        event.type = GESTURE_RELEASE;
+        break;
+      }
+
+      event.type = GESTURE_TAP;
+      if (tracker.tap_armed && now - tracker.last_tap_time <= GESTURE_DOUBLE_TAP_TIMEOUT) {
+        int dx = tracker.start_x - tracker.last_tap_x;
+        int dy = tracker.start_y - tracker.last_tap_y;
+        if (dx * dx + dy * dy <= GESTURE_DOUBLE_TAP_SLOP * GESTURE_DOUBLE_TAP_SLOP) {
+          event.type = GESTURE_DOUBLE_TAP;
+        }
+      }
+
+      // A double tap consumes the armed tap, a single tap arms the next one
+      tracker.tap_armed = (event.type == GESTURE_TAP);
+      tracker.last_tap_x = tracker.start_x;
+      tracker.last_tap_y = tracker.start_y;
+      tracker.last_tap_time = now;
+      break;
+
+    case GESTURE_STATE_DRAGGING: {
+      event.type = GESTURE_RELEASE;
+
+      // A finger that stopped before lifting does not fling
+      if (tracker.history_count > 0 && now - newestGestureSample(tracker).time > GESTURE_VELOCITY_STALE) {
+        break;
+      }
+
+      float vx, vy;
+      if (gestureEstimateVelocity(tracker, vx, vy)) {
+        float speed = sqrtf(vx * vx + vy * vy);
+        if (speed >= GESTURE_FLING_MIN_VELOCITY) {
+          if (speed > GESTURE_FLING_MAX_VELOCITY) {
+            vx *= GESTURE_FLING_MAX_VELOCITY / speed;
+            vy *= GESTURE_FLING_MAX_VELOCITY / speed;
+          }
+          event.type = GESTURE_FLING;
+          event.vx = vx;
+          event.vy = vy;
+        }
+      }
+      break;
+    }
+
+    case GESTURE_STATE_LONG_PRESSED:
+      event.type = GESTURE_RELEASE;
+      break;
+  }
+
+  tracker.state = GESTURE_STATE_IDLE;
+  return event;
+}
+
+GestureEventData gestureTick(GestureTracker& tracker, uint32_t now) {
+  // Forget a pending first tap once the double tap window closes
+  if (tracker.tap_armed && now - tracker.last_tap_time > GESTURE_DOUBLE_TAP_TIMEOUT) {
+    tracker.tap_armed = false;
+  }
+
+  if (tracker.state == GESTURE_STATE_PRESSED && now - tracker.down_time >= GESTURE_LONG_PRESS_TIME) {
+    tracker.state = GESTURE_STATE_LONG_PRESSED;
+    tracker.tap_armed = false;
+    return makeGestureEvent(tracker, GESTURE_LONG_PRESS, tracker.last_x, tracker.last_y, now);
+  }
+
+  return makeGestureEvent(tracker, GESTURE_NONE, tracker.last_x, tracker.last_y, now);
+}
+
+void gestureCancel(GestureTracker& tracker) {
+  // Drop the touch without emitting tap, fling or release
+  tracker.state = GESTURE_STATE_IDLE;
+  tracker.tap_armed = false;
+}
+
+bool gestureEstimateVelocity(const GestureTracker& tracker, float& vx, float& vy) {
+  vx = 0;
+  vy = 0;
+  if (tracker.history_count < 2) return false;
+
+  // Collect samples inside the fit window, newest first
+  uint32_t newest_time = newestGestureSample(tracker).time;
+  float sum_t = 0, sum_x = 0, sum_y = 0;
+  int count = 0;
+
+  for (int i = 0; i < tracker.history_count; i++) {
+    int index = (tracker.history_head + GESTURE_HISTORY_SIZE - 1 - i) % GESTURE_HISTORY_SIZE;
+    const GestureSample& sample = tracker.history[index];
+    if (newest_time - sample.time > GESTURE_VELOCITY_WINDOW) break;
+
+    sum_t += -(float)(newest_time - sample.time);
+    sum_x += sample.x;
+    sum_y += sample.y;
+    count++;
+  }
+
+  if (count < 2) return false;
+
+  // Least-squares slope of position against time
+  float mean_t = sum_t / count;
+  float mean_x = sum_x / count;
+  float mean_y = sum_y / count;
+  float var_t = 0, cov_x = 0, cov_y = 0;
+
+  for (int i = 0; i < count; i++) {
+    int index = (tracker.history_head + GESTURE_HISTORY_SIZE - 1 - i) % GESTURE_HISTORY_SIZE;
+    const GestureSample& sample = tracker.history[index];
+    float t = -(float)(newest_time - sample.time) - mean_t;
+
+    var_t += t * t;
+    cov_x += t * (sample.x - mean_x);
+    cov_y += t * (sample.y - mean_y);
+  }
+
+  if (var_t <= 0) return false;
+
+  vx = cov_x / var_t;
+  vy = cov_y / var_t;
+  return true;
+}
+
+// ==================== MULTI-TOUCH ====================
+int trackTouchPoints(TouchPoint tracked[], int tracked_count, const TouchPoint raw[], int raw_count, int& next_id) {
+  TouchPoint result[GESTURE_MAX_POINTS];
+  bool used[GESTURE_MAX_POINTS] = {false};
+  if (raw_count > GESTURE_MAX_POINTS) raw_count = GESTURE_MAX_POINTS;
+
+  for (int i = 0; i < raw_count; i++) {
+    result[i] = raw[i];
+    result[i].id = -1;
+
+    // Prefer the controller's ID, fall back to the nearest previous point
+    int match = -1;
+    int best_distance = GESTURE_POINT_MATCH_DISTANCE * GESTURE_POINT_MATCH_DISTANCE;
+    for (int j = 0; j < tracked_count; j++) {
+      if (used[j]) continue;
+      if (raw[i].hw_id >= 0 && raw[i].hw_id == tracked[j].hw_id) {
+        match = j;
+        break;
+      }
+      int dx = raw[i].x - tracked[j].x;
+      int dy = raw[i].y - tracked[j].y;
+      if (dx * dx + dy * dy <= best_distance) {
+        best_distance = dx * dx + dy * dy;
+        match = j;
+      }
+    }
+
+    if (match >= 0) {
+      used[match] = true;
+      result[i].id = tracked[match].id;
+    } else {
+      result[i].id = next_id++;
+    }
+  }
+
+  // Keep points ordered by ID so callers see a stable first/second finger
+  if (raw_count == 2 && result[0].id > result[1].id) {
+    TouchPoint swap = result[0];
+    result[0] = result[1];
+    result[1] = swap;
+  }
+
+  for (int i = 0; i < raw_count; i++) {
+    tracked[i] = result[i];
+  }
+  return raw_count;
+}
+
+static GestureEventData makePinchEvent(PinchTracker& pinch, GestureEventType type, int x, int y, uint32_t now) {
+  GestureEventData event;
+  event.type = type;
+  event.x = x;
+  event.y = y;
+  event.start_x = x;
+  event.start_y = y;
+  event.dx = x - pinch.last_x;
+  event.dy = y - pinch.last_y;
+  event.vx = 0;
+  event.vy = 0;
+  event.scale = pinch.last_scale;
+  event.rotation = pinch.last_rotation;
+  event.timestamp = now;
+  event.duration = now - pinch.start_time;
+  return event;
+}
+
+void pinchReset(PinchTracker& pinch) {
+  memset(&pinch, 0, sizeof(pinch));
+  pinch.last_scale = 1.0f;
+}
+
+GestureEventData pinchUpdate(PinchTracker& pinch, const TouchPoint& a, const TouchPoint& b, uint32_t now) {
+  float dx = (float)(b.x - a.x);
+  float dy = (float)(b.y - a.y);
+  float distance = sqrtf(dx * dx + dy * dy);
+  float angle = atan2f(dy, dx) * 180.0f / (float)M_PI;
+  int center_x = (a.x + b.x) / 2;
+  int center_y = (a.y + b.y) / 2;
+
+  // (Re)start when a new pair of fingers lands
+  if (!pinch.active || pinch.id_a != a.id || pinch.id_b != b.id) {
+    pinch.active = true;
+    pinch.id_a = a.id;
+    pinch.id_b = b.id;
+    pinch.start_distance = distance < GESTURE_PINCH_MIN_DISTANCE ? GESTURE_PINCH_MIN_DISTANCE : distance;
+    pinch.start_angle = angle;
+    pinch.last_scale = 1.0f;
+    pinch.last_rotation = 0;
+    pinch.last_x = center_x;
+    pinch.last_y = center_y;
+    pinch.start_time = now;
+    return makePinchEvent(pinch, GESTURE_NONE, center_x, center_y, now);
+  }
+
+  float scale = distance / pinch.start_distance;
+  float rotation = angle - pinch.start_angle;
+  if (rotation > 180.0f) rotation -= 360.0f;
+  if (rotation < -180.0f) rotation += 360.0f;
+
+  GestureEventType type = GESTURE_NONE;
+  if (fabsf(scale - pinch.last_scale) >= GESTURE_PINCH_STEP) {
+    type = GESTURE_PINCH;
+  } else if (fabsf(rotation - pinch.last_rotation) >= GESTURE_ROTATE_STEP) {
+    type = GESTURE_ROTATE;
+  }
+
+  if (type == GESTURE_NONE) {
+    return makePinchEvent(pinch, GESTURE_NONE, center_x, center_y, now);
+  }
+
+  pinch.last_scale = scale;
+  pinch.last_rotation = rotation;
+  GestureEventData event = makePinchEvent(pinch, type, center_x, center_y, now);
+  pinch.last_x = center_x;
+  pinch.last_y = center_y;
+  return event;
+}
+
+GestureEventData pinchEnd(PinchTracker& pinch, uint32_t now) {
+  if (!pinch.active) {
+    return makePinchEvent(pinch, GESTURE_NONE, pinch.last_x, pinch.last_y, now);
+  }
+
+  GestureEventData event = makePinchEvent(pinch, GESTURE_RELEASE, pinch.last_x, pinch.last_y, now);
+  pinch.active = false;
+  return event;
+}
+
+// ==================== TOUCH SESSION ====================
+void touchSessionReset(TouchSession& session) {
+  session.count = 0;
+  session.next_id = 0;
+  gestureReset(session.tracker);
+  pinchReset(session.pinch);
+}
+
+bool touchSessionContacts(TouchSession& session, const TouchPoint raw[], int raw_count, uint32_t now,
+                          GestureEventData& event) {
+  session.count = trackTouchPoints(session.points, session.count, raw, raw_count, session.next_id);
+
+  if (session.count >= 2) {
+    // Second finger: hand over from single-touch to pinch recognition
+    gestureCancel(session.tracker);
+    event = pinchUpdate(session.pinch, session.points[0], session.points[1], now);
+    return false;
+  }
+
+  if (session.pinch.active) {
+    // One finger left after a pinch: wait for it to lift
+    event = gestureTick(session.tracker, now);
+    return false;
+  }
+  return true;
+}
+
+GestureEventData touchSessionRelease(TouchSession& session, uint32_t now) {
+  // Fingers can land together and start a pinch without any press, so the
+  // contacts and the pinch decide whether something is still down
+  bool down = session.count > 0 || session.pinch.active || session.tracker.state != GESTURE_STATE_IDLE;
+  session.count = 0;
+  if (session.pinch.active) {
+    // Fingers lifted after a pinch: no tap or fling from the leftovers
+    return pinchEnd(session.pinch, now);
+  }
+  return down ? gestureTouchUp(session.tracker, now) : gestureTick(session.tracker, now);
+}
+
+// ==================== KINETIC SCROLLER ====================
+void scrollerInit(KineticScroller& scroller, float min_position, float max_position) {
+  scroller.position = min_position;
+  scroller.velocity = 0;
+  scroller.min_position = min_position;
+  scroller.max_position = max_position;
+  scroller.dragging = false;
+  scroller.animating = false;
+  scroller.last_update = 0;
+}
+
+void scrollerSetBounds(KineticScroller& scroller, float min_position, float max_position) {
+  if (max_position < min_position) max_position = min_position;
+  scroller.min_position = min_position;
+  scroller.max_position = max_position;
+
+  // Let the spring pull content back if the bounds shrank under it
+  if (!scroller.dragging &&
+      (scroller.position < min_position || scroller.position > max_position)) {
+    scroller.animating = true;
+  }
+}
+
+void scrollerBeginDrag(KineticScroller& scroller, uint32_t now) {
+  scroller.dragging = true;
+  scroller.animating = false;
+  scroller.velocity = 0;
+  scroller.last_update = now;
+}
+
+void scrollerDrag(KineticScroller& scroller, float delta) {
+  float overshoot = 0;
+  if (scroller.position < scroller.min_position && delta < 0) {
+    overshoot = scroller.min_position - scroller.position;
+  } else if (scroller.position > scroller.max_position && delta > 0) {
+    overshoot = scroller.position - scroller.max_position;
+  }
+
+  // Rubber band: resistance grows as content is pulled past its edge
+  if (overshoot > 0) {
+    float resistance = 1.0f - overshoot / SCROLL_OVERSCROLL_LIMIT;
+    if (resistance < 0) resistance = 0;
+    delta *= 0.5f * resistance;
+  }
+
+  scroller.position += delta;
+}
+
+void scrollerRelease(KineticScroller& scroller, float velocity, uint32_t now) {
+  if (velocity > GESTURE_FLING_MAX_VELOCITY) velocity = GESTURE_FLING_MAX_VELOCITY;
+  if (velocity < -GESTURE_FLING_MAX_VELOCITY) velocity = -GESTURE_FLING_MAX_VELOCITY;
+
+  scroller.dragging = false;
+  scroller.velocity = velocity;
+  scroller.animating = true;
+  scroller.last_update = now;
+}
+
+bool scrollerUpdate(KineticScroller& scroller, uint32_t now) {
+  if (!scroller.animating || scroller.dragging) return false;
+
+  uint32_t elapsed = now - scroller.last_update;
+  scroller.last_update = now;
+  if (elapsed > 50) elapsed = 50; // Don't jump after a stalled frame
+
+  const float damping = 2.0f * sqrtf(SCROLL_SPRING_STIFFNESS); // Critically damped
+
+  // Integrate in small steps so the spring stays stable
+  while (elapsed > 0) {
+    float h = elapsed > 4 ? 4.0f : (float)elapsed;
+    elapsed -= (uint32_t)h;
+
+    float target = scroller.position;
+    if (scroller.position < scroller.min_position) target = scroller.min_position;
+    if (scroller.position > scroller.max_position) target = scroller.max_position;
+
+    if (target != scroller.position) {
+      // Overscroll: spring back to the edge
+      float offset = scroller.position - target;
+      float accel = -SCROLL_SPRING_STIFFNESS * offset - damping * scroller.velocity;
+      scroller.velocity += accel * h;
+      scroller.position += scroller.velocity * h;
+    } else {
+      // In bounds: coast with friction
+      scroller.position += scroller.velocity * h;
+      scroller.velocity *= powf(SCROLL_FRICTION, h);
+    }
+  }
+
+  bool in_bounds = scroller.position >= scroller.min_position &&
+                   scroller.position <= scroller.max_position;
+
+  if (fabsf(scroller.velocity) < SCROLL_STOP_VELOCITY) {
+    if (in_bounds) {
+      scroller.velocity = 0;
+      scroller.animating = false;
+    } else {
+      float edge = scroller.position < scroller.min_position ? scroller.min_position : scroller.max_position;
+      if (fabsf(scroller.position - edge) < 0.5f) {
+        scroller.position = edge;
+        scroller.velocity = 0;
+        scroller.animating = false;
+      }
+    }
+  }
+
+  return scroller.animating;
+}
\ No newline at end of file
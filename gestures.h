@@ -0,0 +1,166 @@
+/*
+ * Gesture Recognition Engine for ESP32-S3 Watch
+ * Velocity tracking, fling detection, pinch/rotate and kinetic scrolling
+ *
+ * This module has no Arduino dependencies: it only sees positions and
+ * millisecond timestamps, so recorded touch traces can be replayed
+ * through it on a host build.
+ */
+
+#ifndef GESTURES_H
+#define GESTURES_H
+
+#include <stdint.h>
+
+// ==================== GESTURE TUNING ====================
+#define GESTURE_HISTORY_SIZE 16          // Samples kept for velocity fitting
+#define GESTURE_VELOCITY_WINDOW 100      // ms of history used for the fit
+#define GESTURE_VELOCITY_STALE 40        // ms without motion before velocity drops to 0
+#define GESTURE_TOUCH_SLOP 12            // px before a press becomes a drag
+#define GESTURE_TAP_TIMEOUT 300          // ms, longest press still counted as tap
+#define GESTURE_LONG_PRESS_TIME 800      // ms held in place for long press
+#define GESTURE_DOUBLE_TAP_TIMEOUT 300   // ms between taps for double tap
+#define GESTURE_DOUBLE_TAP_SLOP 40       // px between taps for double tap
+#define GESTURE_FLING_MIN_VELOCITY 0.3f  // px/ms (300 px/s)
+#define GESTURE_FLING_MAX_VELOCITY 8.0f  // px/ms, clamps sensor glitches
+#define GESTURE_MAX_POINTS 2             // FT3168 reports up to two contacts
+#define GESTURE_POINT_MATCH_DISTANCE 60  // px, re-associates points without a hardware ID
+#define GESTURE_PINCH_MIN_DISTANCE 10.0f // px, floor for the pinch reference span
+#define GESTURE_PINCH_STEP 0.01f         // Scale change that emits a pinch event
+#define GESTURE_ROTATE_STEP 2.0f         // Degrees that emit a rotate event
+
+// Kinetic scroller physics
+#define SCROLL_FRICTION 0.998f           // Velocity retained per ms of coasting
+#define SCROLL_STOP_VELOCITY 0.02f       // px/ms below which coasting stops
+#define SCROLL_SPRING_STIFFNESS 0.0004f  // Overscroll spring (1/ms^2)
+#define SCROLL_OVERSCROLL_LIMIT 80.0f    // px, rubber band saturation during drag
+
+// Gesture events emitted by the recognizer
+enum GestureEventType {
+  GESTURE_NONE,
+  GESTURE_PRESS,
+  GESTURE_DRAG,
+  GESTURE_RELEASE,
+  GESTURE_FLING,
+  GESTURE_TAP,
+  GESTURE_DOUBLE_TAP,
+  GESTURE_LONG_PRESS,
+  GESTURE_PINCH,
+  GESTURE_ROTATE
+};
+
+// Recognizer states
+enum GestureState {
+  GESTURE_STATE_IDLE,
+  GESTURE_STATE_PRESSED,
+  GESTURE_STATE_DRAGGING,
+  GESTURE_STATE_LONG_PRESSED
+};
+
+// Single touch sample
+struct GestureSample {
+  int16_t x, y;
+  uint32_t time;
+};
+
+// One contact point; id stays stable for the life of the contact
+struct TouchPoint {
+  int id;
+  int hw_id;            // Controller-reported ID, or -1 if unknown
+  int x, y;
+};
+
+// Recognized gesture event
+struct GestureEventData {
+  GestureEventType type;
+  int x, y;
+  int start_x, start_y;
+  int dx, dy;           // Movement since previous event
+  float vx, vy;         // Fitted velocity in px/ms
+  float scale;          // Pinch span relative to its start (1.0 = unchanged)
+  float rotation;       // Pinch rotation since its start, degrees
+  uint32_t timestamp;
+  uint32_t duration;
+};
+
+// Recognizer state for one touch stream
+struct GestureTracker {
+  GestureState state;
+  GestureSample history[GESTURE_HISTORY_SIZE];
+  int history_head;
+  int history_count;
+
+  int start_x, start_y;
+  int last_x, last_y;
+  uint32_t down_time;
+
+  // Double tap tracking
+  bool tap_armed;
+  int last_tap_x, last_tap_y;
+  uint32_t last_tap_time;
+};
+
+// Two-finger pinch/rotate state
+struct PinchTracker {
+  bool active;
+  int id_a, id_b;
+  float start_distance;
+  float start_angle;
+  float last_scale;
+  float last_rotation;
+  int last_x, last_y;
+  uint32_t start_time;
+};
+
+// Everything on the panel for one touch stream: the contacts, the
+// single-finger recognizer and the pinch that takes over from it
+struct TouchSession {
+  TouchPoint points[GESTURE_MAX_POINTS];
+  int count;
+  int next_id;
+  GestureTracker tracker;
+  PinchTracker pinch;
+};
+
+// Kinetic scroller for list screens
+struct KineticScroller {
+  float position;
+  float velocity;       // px/ms
+  float min_position;
+  float max_position;
+  bool dragging;
+  bool animating;
+  uint32_t last_update;
+};
+
+// Gesture recognizer
+void gestureReset(GestureTracker& tracker);
+GestureEventData gestureTouchDown(GestureTracker& tracker, int x, int y, uint32_t now);
+GestureEventData gestureTouchUp(GestureTracker& tracker, uint32_t now);
+GestureEventData gestureTick(GestureTracker& tracker, uint32_t now);
+void gestureCancel(GestureTracker& tracker);
+bool gestureEstimateVelocity(const GestureTracker& tracker, float& vx, float& vy);
+
+// Multi-touch
+int trackTouchPoints(TouchPoint tracked[], int tracked_count, const TouchPoint raw[], int raw_count, int& next_id);
+void pinchReset(PinchTracker& pinch);
+GestureEventData pinchUpdate(PinchTracker& pinch, const TouchPoint& a, const TouchPoint& b, uint32_t now);
+GestureEventData pinchEnd(PinchTracker& pinch, uint32_t now);
+
+// Touch session: one controller poll at a time. With a single finger down,
+// contacts returns true and leaves the recognizer to the caller, which
+// feeds the (smoothed) position of points[0] to gestureTouchDown
+void touchSessionReset(TouchSession& session);
+bool touchSessionContacts(TouchSession& session, const TouchPoint raw[], int raw_count, uint32_t now,
+                          GestureEventData& event);
+GestureEventData touchSessionRelease(TouchSession& session, uint32_t now);  // Panel empty
+
+// Kinetic scrolling
+void scrollerInit(KineticScroller& scroller, float min_position, float max_position);
+void scrollerSetBounds(KineticScroller& scroller, float min_position, float max_position);
+void scrollerBeginDrag(KineticScroller& scroller, uint32_t now);
+void scrollerDrag(KineticScroller& scroller, float delta);
+void scrollerRelease(KineticScroller& scroller, float velocity, uint32_t now);
+bool scrollerUpdate(KineticScroller& scroller, uint32_t now);
+
+#endif // GESTURES_H
\ No newline at end of file
@@ -0,0 +1,98 @@
+/*
+ * CPU Frequency Governor Implementation
+ * Demand from frame work and floors, stepped with hysteresis
+ */
+
+#include "governor.h"
+#include <string.h>
+
+static const uint16_t level_mhz[GOVERNOR_LEVELS] = {80, 160, 240};
+
+uint16_t governorLevelMhz(int level) {
+  if (level < 0) level = 0;
+  if (level >= GOVERNOR_LEVELS) level = GOVERNOR_LEVELS - 1;
+  return level_mhz[level];
+}
+
+// ==================== DECISION ====================
+int governorDemand(const GovernorProfile& profile, const GovernorInput& input, uint32_t work_us) {
+  // Slowest clock at which the frame's work stays under the target load
+  uint64_t allowed_us = (uint64_t)profile.frame_budget_us * profile.target_percent / 100;
+  int level = GOVERNOR_240MHZ;
+  for (int candidate = GOVERNOR_80MHZ; candidate < GOVERNOR_240MHZ; candidate++) {
+    if ((uint64_t)work_us * level_mhz[GOVERNOR_240MHZ] / level_mhz[candidate] <= allowed_us) {
+      level = candidate;
+      break;
+    }
+  }
+
+  // Work that runs between frames
+  if ((input.audio || input.sd_busy) && level < GOVERNOR_160MHZ) level = GOVERNOR_160MHZ;
+  if (input.animating || input.touching) level = GOVERNOR_240MHZ;
+  return level;
+}
+
+// ==================== GOVERNOR ====================
+void governorInit(Governor& governor, const GovernorProfile& profile, int level) {
+  memset(&governor, 0, sizeof(governor));
+  governor.profile = profile;
+  governor.level = level;
+  governor.ceiling = GOVERNOR_240MHZ;
+}
+
+void governorSetCeiling(Governor& governor, int level) {
+  governor.ceiling = level;
+}
+
+static void changeLevel(Governor& governor, int level, uint32_t now_ms) {
+  governor.level = level;
+  governor.changed_ms = now_ms;
+  governor.below = false;
+  governor.stats.switches++;
+}
+
+int governorUpdate(Governor& governor, const GovernorInput& input) {
+  const GovernorProfile& profile = governor.profile;
+  uint32_t now = input.now_ms;
+  if (!governor.started) {
+    governor.started = true;
+    governor.last_ms = now;
+    governor.changed_ms = now;
+  }
+  governor.stats.residency_ms[governor.level] += now - governor.last_ms;
+  governor.last_ms = now;
+
+  // A frame's time scales inversely with the clock it ran at
+  uint32_t work_us = governor.work_us;
+  if (input.frame_us > 0) {
+    uint32_t frame_work = (uint32_t)((uint64_t)input.frame_us * level_mhz[governor.level] / level_mhz[GOVERNOR_240MHZ]);
+    int32_t delta = (int32_t)frame_work - (int32_t)governor.work_us;
+    governor.work_us += delta / (1 << profile.smoothing_shift);
+    work_us = frame_work > governor.work_us ? frame_work : governor.work_us;
+    governor.stats.frames++;
+    if (input.frame_us > profile.frame_budget_us) governor.stats.over_budget++;
+  }
+
+  int want = governorDemand(profile, input, work_us);
+  if (want > governor.ceiling) want = governor.ceiling;
+
+  if (governor.level > governor.ceiling) {
+    changeLevel(governor, governor.ceiling, now);
+  } else if (want > governor.level) {
+    changeLevel(governor, want, now);
+  } else if (want < governor.level) {
+    if (!governor.below) {
+      governor.below = true;
+      governor.below_since_ms = now;
+    } else if (now - governor.below_since_ms >= profile.down_hold_ms &&
+               now - governor.changed_ms >= profile.dwell_ms) {
+      // One step, then the hold starts again for the next
+      changeLevel(governor, governor.level - 1, now);
+      governor.below = true;
+      governor.below_since_ms = now;
+    }
+  } else {
+    governor.below = false;
+  }
+  return governor.level;
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+/*
+ * CPU Frequency Governor for ESP32-S3 Watch
+ * Picks 80, 160 or 240MHz from frame pressure and pending work
+ *
+ * Each frame's drawing time is scaled to what the same work would take at
+ * 240MHz, and the governor wants the slowest clock at which it still fits
+ * in the target share of the frame budget. Work that needs the CPU whether
+ * or not frames are late sets a floor: audio decoding and SD indexing want
+ * 160MHz, animation and a finger on the glass 240MHz.
+ *
+ * Raising the clock happens at once, because a missed frame is visible.
+ * Lowering goes one step at a time, only after the demand has stayed below
+ * the current level for a hold time and never sooner than a dwell after
+ * the last change, so bursty work cannot make it thrash. The governor is
+ * plain C++ driven by explicit timestamps, so recorded workload traces
+ * replay on host and the residency it reports can be checked there.
+ */
+
+#ifndef GOVERNOR_H
+#define GOVERNOR_H
+
+#include <stdint.h>
+
+#define GOVERNOR_LEVELS 3
+
+enum GovernorLevel {
+  GOVERNOR_80MHZ,
+  GOVERNOR_160MHZ,
+  GOVERNOR_240MHZ
+};
+
+struct GovernorProfile {
+  uint32_t frame_budget_us;    // One frame at the UI rate
+  uint8_t target_percent;      // Share of the budget a level may be loaded to
+  uint32_t down_hold_ms;       // Demand below the level this long before a step down
+  uint32_t dwell_ms;           // No step down sooner than this after any change
+  uint8_t smoothing_shift;     // Frame work average over about 2^shift frames
+};
+
+struct GovernorInput {
+  uint32_t now_ms;
+  uint32_t frame_us;           // Drawing time of the frame just finished, 0 for none
+  bool animating;              // Scrolling, a transition or a game in play
+  bool touching;
+  bool audio;                  // Decoding
+  bool sd_busy;                // Indexing or bulk transfers
+};
+
+struct GovernorStats {
+  uint64_t residency_ms[GOVERNOR_LEVELS];
+  uint32_t switches;
+  uint32_t frames;
+  uint32_t over_budget;        // Frames that missed the budget at the clock they ran at
+};
+
+struct Governor {
+  GovernorProfile profile;
+  int level;
+  int ceiling;                 // Low power mode caps the clock
+  uint32_t work_us;            // Smoothed frame work at 240MHz
+  uint32_t changed_ms;
+  uint32_t below_since_ms;
+  bool below;                  // Demand has been under the level since below_since_ms
+  uint32_t last_ms;
+  bool started;
+  GovernorStats stats;
+};
+
+// Governor
+void governorInit(Governor& governor, const GovernorProfile& profile, int level);
+int governorUpdate(Governor& governor, const GovernorInput& input);  // Returns the level to run at
+void governorSetCeiling(Governor& governor, int level);
+
+// Decision, without hysteresis: the slowest level for this work and these floors
+int governorDemand(const GovernorProfile& profile, const GovernorInput& input, uint32_t work_us);
+
+uint16_t governorLevelMhz(int level);
+
+#endif // GOVERNOR_H
\ No newline at end of file
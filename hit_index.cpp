@@ -0,0 +1,85 @@
+/*
+ * Spatial Hit-Testing Index Implementation
+ * Grid bucketing of touch regions with top-most lookup
+ */
+
+#include "hit_index.h"
+#include <string.h>
+
+void hitIndexInit(HitIndex& index, int screen_width, int screen_height) {
+  index.screen_width = screen_width;
+  index.screen_height = screen_height;
+  index.cell_width = (screen_width + HIT_GRID_COLS - 1) / HIT_GRID_COLS;
+  index.cell_height = (screen_height + HIT_GRID_ROWS - 1) / HIT_GRID_ROWS;
+  hitIndexClear(index, -1);
+}
+
+void hitIndexClear(HitIndex& index, int owner) {
+  index.owner = owner;
+  index.region_count = 0;
+  index.dropped = 0;
+  memset(index.cell_counts, 0, sizeof(index.cell_counts));
+}
+
+bool hitIndexAdd(HitIndex& index, int x, int y, int width, int height,
+                 int tag, void (*callback)(void)) {
+  // Clip to the screen, off-screen parts can never be touched
+  int x0 = x < 0 ? 0 : x;
+  int y0 = y < 0 ? 0 : y;
+  int x1 = x + width < index.screen_width ? x + width : index.screen_width;
+  int y1 = y + height < index.screen_height ? y + height : index.screen_height;
+  if (x1 <= x0 || y1 <= y0) return false;
+
+  if (index.region_count >= HIT_MAX_REGIONS) {
+    index.dropped++;
+    return false;
+  }
+
+  int id = index.region_count++;
+  HitRegion& region = index.regions[id];
+  region.x = x;
+  region.y = y;
+  region.width = width;
+  region.height = height;
+  region.tag = tag;
+  region.callback = callback;
+
+  // Add to every cell the clipped rectangle overlaps
+  int col0 = x0 / index.cell_width;
+  int col1 = (x1 - 1) / index.cell_width;
+  int row0 = y0 / index.cell_height;
+  int row1 = (y1 - 1) / index.cell_height;
+
+  bool complete = true;
+  for (int row = row0; row <= row1; row++) {
+    for (int col = col0; col <= col1; col++) {
+      int cell = row * HIT_GRID_COLS + col;
+      if (index.cell_counts[cell] >= HIT_MAX_PER_CELL) {
+        complete = false;
+        continue;
+      }
+      index.cells[cell][index.cell_counts[cell]++] = (uint8_t)id;
+    }
+  }
+
+  if (!complete) index.dropped++;
+  return complete;
+}
+
+const HitRegion* hitIndexFind(const HitIndex& index, int x, int y) {
+  if (x < 0 || y < 0 || x >= index.screen_width || y >= index.screen_height) {
+    return nullptr;
+  }
+
+  int cell = (y / index.cell_height) * HIT_GRID_COLS + (x / index.cell_width);
+
+  // Newest registration is drawn last, so it wins
+  for (int i = index.cell_counts[cell] - 1; i >= 0; i--) {
+    const HitRegion& region = index.regions[index.cells[cell][i]];
+    if (x >= region.x && x < region.x + region.width &&
+        y >= region.y && y < region.y + region.height) {
+      return &region;
+    }
+  }
+  return nullptr;
+}
\ No newline at end of file
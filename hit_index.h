@@ -0,0 +1,52 @@
+/*
+ * Spatial Hit-Testing Index for ESP32-S3 Watch
+ * Uniform grid of touch regions registered by draw code each frame
+ *
+ * Draw functions register the rectangles they actually drew, so touch
+ * handlers resolve taps against the same geometry instead of repeating
+ * the layout math. Each grid cell keeps the regions overlapping it in
+ * draw order, so a lookup checks at most HIT_MAX_PER_CELL candidates and
+ * returns the top-most one. No Arduino dependencies, so it runs headless.
+ */
+
+#ifndef HIT_INDEX_H
+#define HIT_INDEX_H
+
+#include <stdint.h>
+
+#define HIT_GRID_COLS 8
+#define HIT_GRID_ROWS 8
+#define HIT_MAX_REGIONS 48
+#define HIT_MAX_PER_CELL 8
+
+// One touchable rectangle
+struct HitRegion {
+  int x, y, width, height;
+  int tag;                  // Screen-defined identifier
+  void (*callback)(void);   // Optional action, e.g. UIComponent::callback
+};
+
+// Per-cell lists of region indices
+struct HitIndex {
+  int screen_width, screen_height;
+  int cell_width, cell_height;
+  int owner;                // Screen the regions were drawn for
+  HitRegion regions[HIT_MAX_REGIONS];
+  int region_count;
+  uint8_t cells[HIT_GRID_ROWS * HIT_GRID_COLS][HIT_MAX_PER_CELL];
+  uint8_t cell_counts[HIT_GRID_ROWS * HIT_GRID_COLS];
+  int dropped;              // Registrations that did not fit
+};
+
+// Index management
+void hitIndexInit(HitIndex& index, int screen_width, int screen_height);
+void hitIndexClear(HitIndex& index, int owner);
+
+// Registration, later regions sit on top of earlier ones
+bool hitIndexAdd(HitIndex& index, int x, int y, int width, int height,
+                 int tag, void (*callback)(void));
+
+// Top-most region containing the point, or nullptr
+const HitRegion* hitIndexFind(const HitIndex& index, int x, int y);
+
+#endif // HIT_INDEX_H
\ No newline at end of file
@@ -0,0 +1,361 @@
+/*
+ * Shared I2C Bus Manager Implementation
+ * Locked register transfers, clock switching and the bus task
+ */
+
+#include "i2c_bus.h"
+#include "i2c_trace.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include "config.h"
+#include <Wire.h>
+#endif
+
+static I2CDeviceInfo i2c_devices[I2C_DEV_COUNT];
+static I2CBackend i2c_backend;
+static bool i2c_started = false;
+static uint32_t bus_clock[I2C_BUS_COUNT];
+static uint32_t clock_switches = 0;
+
+#ifdef ARDUINO
+// One lock per controller, the queue feeds the bus task
+static SemaphoreHandle_t bus_locks[I2C_BUS_COUNT];
+static QueueHandle_t transaction_queue = nullptr;
+
+// Traffic counters span both buses and are read by the reports, so they
+// take one short critical section of their own, like the trace
+static portMUX_TYPE stats_mux = portMUX_INITIALIZER_UNLOCKED;
+#define STATS_LOCK() portENTER_CRITICAL(&stats_mux)
+#define STATS_UNLOCK() portEXIT_CRITICAL(&stats_mux)
+
+static void lockBus(I2CBusId bus) {
+  xSemaphoreTake(bus_locks[bus], portMAX_DELAY);
+}
+
+static void unlockBus(I2CBusId bus) {
+  xSemaphoreGive(bus_locks[bus]);
+}
+#else
+// Host builds are single threaded, queued work runs in i2cServiceQueue()
+static I2CTransaction pending_transactions[I2C_QUEUE_LENGTH];
+static int pending_head = 0;
+static int pending_count = 0;
+
+static void lockBus(I2CBusId bus) { (void)bus; }
+static void unlockBus(I2CBusId bus) { (void)bus; }
+#define STATS_LOCK()
+#define STATS_UNLOCK()
+#endif
+
+void i2cConfigureDevice(I2CDeviceId device, const char* name, I2CBusId bus,
+                        uint8_t address, uint32_t clock_hz) {
+  I2CDeviceInfo& info = i2c_devices[device];
+  memset(&info, 0, sizeof(info));
+  info.name = name;
+  info.bus = bus;
+  info.address = address;
+  info.clock_hz = clock_hz;
+}
+
+void i2cSetDeviceAddress(I2CDeviceId device, uint8_t address) {
+  i2c_devices[device].address = address;
+}
+
+// Run one transfer for a device, with the bus already locked
+static bool runTransfer(I2CDeviceId device, const uint8_t* tx, size_t tx_length,
+                        uint8_t* rx, size_t rx_length, uint8_t caller) {
+  I2CDeviceInfo& info = i2c_devices[device];
+
+  // Only touch the clock when the previous device ran at another speed
+  bool switched = bus_clock[info.bus] != info.clock_hz;
+  if (switched) {
+    i2c_backend.set_clock(info.bus, info.clock_hz);
+    bus_clock[info.bus] = info.clock_hz;
+  }
+
+  uint32_t start = i2c_backend.micros();
+  bool ok = i2c_backend.transfer(info.bus, info.address, tx, tx_length, rx, rx_length);
+  uint32_t elapsed = i2c_backend.micros() - start;
+
+  STATS_LOCK();
+  if (switched) clock_switches++;
+  info.transactions++;
+  info.bytes += tx_length + rx_length;
+  info.bus_time_us += elapsed;
+  if (!ok) info.errors++;
+  STATS_UNLOCK();
+  
+  I2CTraceRecord record;
+  record.start_us = start;
+  record.duration_us = elapsed > 0xFFFF ? 0xFFFF : elapsed;
+  record.device = device;
+  record.address = info.address;
+  record.reg = tx_length > 0 ? tx[0] : 0;
+  size_t payload = (tx_length > 1 ? tx_length - 1 : 0) + rx_length;
+  record.length = payload > 0xFF ? 0xFF : payload;
+  record.caller = caller;
+  record.flags = (rx_length == 0 && tx_length > 1 ? I2C_TRACE_WRITE : 0) |
+                 (tx_length == 0 && rx_length == 0 ? I2C_TRACE_PROBE : 0) |
+                 (ok ? 0 : I2C_TRACE_ERROR);
+  i2cTraceRecord(record);
+  return ok;
+}
+
+bool i2cProbe(I2CDeviceId device) {
+  if (!i2c_started) return false;
+  I2CDeviceInfo& info = i2c_devices[device];
+
+  lockBus(info.bus);
+  bool ok = runTransfer(device, nullptr, 0, nullptr, 0, i2cTraceGetCaller());
+  unlockBus(info.bus);
+  return ok;
+}
+
+static bool readRegs(I2CDeviceId device, uint8_t reg, uint8_t* data, size_t length, uint8_t caller) {
+  if (!i2c_started || length == 0) return false;
+  I2CDeviceInfo& info = i2c_devices[device];
+
+  lockBus(info.bus);
+  bool ok = runTransfer(device, &reg, 1, data, length, caller);
+  unlockBus(info.bus);
+  return ok;
+}
+
+static bool writeRegs(I2CDeviceId device, uint8_t reg, const uint8_t* data, size_t length, uint8_t caller) {
+  if (!i2c_started || length > I2C_MAX_TRANSFER) return false;
+  I2CDeviceInfo& info = i2c_devices[device];
+
+  // Register address and payload go out in one burst
+  uint8_t tx[1 + I2C_MAX_TRANSFER];
+  tx[0] = reg;
+  memcpy(tx + 1, data, length);
+
+  lockBus(info.bus);
+  bool ok = runTransfer(device, tx, 1 + length, nullptr, 0, caller);
+  unlockBus(info.bus);
+  return ok;
+}
+
+bool i2cReadRegs(I2CDeviceId device, uint8_t reg, uint8_t* data, size_t length) {
+  return readRegs(device, reg, data, length, i2cTraceGetCaller());
+}
+
+bool i2cWriteRegs(I2CDeviceId device, uint8_t reg, const uint8_t* data, size_t length) {
+  return writeRegs(device, reg, data, length, i2cTraceGetCaller());
+}
+
+bool i2cWriteReg(I2CDeviceId device, uint8_t reg, uint8_t value) {
+  return i2cWriteRegs(device, reg, &value, 1);
+}
+
+// Execute a queued transaction and report back to its owner
+static void runQueuedTransaction(I2CTransaction& transaction) {
+  bool ok;
+  if (transaction.write) {
+    ok = writeRegs(transaction.device, transaction.reg, transaction.data, transaction.length, transaction.caller);
+  } else {
+    ok = readRegs(transaction.device, transaction.reg, transaction.data, transaction.length, transaction.caller);
+  }
+
+  if (transaction.callback != nullptr) {
+    transaction.callback(transaction, ok);
+  }
+}
+
+#ifdef ARDUINO
+static void i2cBusTask(void* parameter) {
+  I2CTransaction transaction;
+  for (;;) {
+    if (xQueueReceive(transaction_queue, &transaction, portMAX_DELAY) == pdTRUE) {
+      runQueuedTransaction(transaction);
+    }
+  }
+}
+#endif
+
+bool i2cBusStart(const I2CBackend& backend) {
+  i2c_backend = backend;
+  clock_switches = 0;
+
+  for (int bus = 0; bus < I2C_BUS_COUNT; bus++) {
+    if (!i2c_backend.begin((I2CBusId)bus)) return false;
+    bus_clock[bus] = 0; // Unknown until the first transfer
+  }
+
+#ifdef ARDUINO
+  if (transaction_queue == nullptr) {
+    for (int bus = 0; bus < I2C_BUS_COUNT; bus++) {
+      bus_locks[bus] = xSemaphoreCreateMutex();
+    }
+    transaction_queue = xQueueCreate(I2C_QUEUE_LENGTH, sizeof(I2CTransaction));
+    if (transaction_queue == nullptr) return false;
+    xTaskCreate(i2cBusTask, "i2c_bus", I2C_TASK_STACK, nullptr, I2C_TASK_PRIORITY, nullptr);
+  }
+#else
+  pending_head = 0;
+  pending_count = 0;
+#endif
+
+  i2c_started = true;
+  return true;
+}
+
+bool i2cSubmit(const I2CTransaction& transaction) {
+  if (!i2c_started || transaction.length == 0 || transaction.length > I2C_MAX_TRANSFER) {
+    return false;
+  }
+
+#ifdef ARDUINO
+  // Never block the caller, a full queue is reported as a failure
+  return xQueueSend(transaction_queue, &transaction, 0) == pdTRUE;
+#else
+  if (pending_count >= I2C_QUEUE_LENGTH) return false;
+  pending_transactions[(pending_head + pending_count) % I2C_QUEUE_LENGTH] = transaction;
+  pending_count++;
+  return true;
+#endif
+}
+
+int i2cServiceQueue(int max_transactions) {
+#ifdef ARDUINO
+  (void)max_transactions;
+  return 0;
+#else
+  int serviced = 0;
+  while (pending_count > 0 && serviced < max_transactions) {
+    I2CTransaction transaction = pending_transactions[pending_head];
+    pending_head = (pending_head + 1) % I2C_QUEUE_LENGTH;
+    pending_count--;
+    runQueuedTransaction(transaction);
+    serviced++;
+  }
+  return serviced;
+#endif
+}
+
+I2CDeviceInfo i2cGetDeviceInfo(I2CDeviceId device) {
+  STATS_LOCK();
+  I2CDeviceInfo info = i2c_devices[device];
+  STATS_UNLOCK();
+  return info;
+}
+
+uint32_t i2cGetClockSwitches() {
+  STATS_LOCK();
+  uint32_t switches = clock_switches;
+  STATS_UNLOCK();
+  return switches;
+}
+
+void i2cResetStats() {
+  STATS_LOCK();
+  for (int i = 0; i < I2C_DEV_COUNT; i++) {
+    i2c_devices[i].transactions = 0;
+    i2c_devices[i].errors = 0;
+    i2c_devices[i].bytes = 0;
+    i2c_devices[i].bus_time_us = 0;
+  }
+  clock_switches = 0;
+  STATS_UNLOCK();
+}
+
+int i2cFormatStats(char* buffer, size_t size) {
+  if (size == 0) return 0;
+  buffer[0] = '\0';
+
+  // One consistent copy, formatted outside the critical section
+  I2CDeviceInfo devices[I2C_DEV_COUNT];
+  STATS_LOCK();
+  memcpy(devices, i2c_devices, sizeof(devices));
+  uint32_t switches = clock_switches;
+  STATS_UNLOCK();
+
+  int written = 0;
+  for (int i = 0; i < I2C_DEV_COUNT && written < (int)size; i++) {
+    const I2CDeviceInfo& info = devices[i];
+    if (info.name == nullptr) continue;
+    written += snprintf(buffer + written, size - written,
+                        "%-6s 0x%02X %3lu kHz  %6lu xfers %7lu bytes %8.1f ms bus  %lu errors\n",
+                        info.name, info.address, (unsigned long)(info.clock_hz / 1000),
+                        (unsigned long)info.transactions, (unsigned long)info.bytes,
+                        info.bus_time_us / 1000.0, (unsigned long)info.errors);
+  }
+  if (written < (int)size) {
+    written += snprintf(buffer + written, size - written, "clock switches: %lu\n",
+                        (unsigned long)switches);
+  }
+  return written;
+}
+
+#ifdef ARDUINO
+// ==================== WIRE BACKEND ====================
+#define I2C_WIRE_CHUNK 256  // Wire buffer size, one IMU FIFO batch fits in a single read
+
+static TwoWire& wireForBus(I2CBusId bus) {
+  return bus == I2C_BUS_TOUCH ? Wire : Wire1;
+}
+
+static bool wireBegin(I2CBusId bus) {
+  // The buffer can only be resized before begin()
+  wireForBus(bus).setBufferSize(I2C_WIRE_CHUNK);
+  if (bus == I2C_BUS_TOUCH) {
+    return Wire.begin(TOUCH_SDA, TOUCH_SCL);
+  }
+  return Wire1.begin(IMU_SDA, IMU_SCL);
+}
+
+static void wireSetClock(I2CBusId bus, uint32_t clock_hz) {
+  wireForBus(bus).setClock(clock_hz);
+}
+
+static bool wireTransfer(I2CBusId bus, uint8_t address, const uint8_t* tx, size_t tx_length,
+                         uint8_t* rx, size_t rx_length) {
+  TwoWire& wire = wireForBus(bus);
+
+  // Repeated start between the register write and the read
+  wire.beginTransmission(address);
+  if (tx_length > 0) wire.write(tx, tx_length);
+  if (wire.endTransmission(rx_length == 0) != 0) return false;
+
+  size_t received = 0;
+  while (received < rx_length) {
+    size_t chunk = rx_length - received;
+    if (chunk > I2C_WIRE_CHUNK) chunk = I2C_WIRE_CHUNK;
+    if (wire.requestFrom(address, chunk) != chunk) return false;
+    while (wire.available() && received < rx_length) {
+      rx[received++] = wire.read();
+    }
+  }
+  return true;
+}
+
+static uint32_t wireMicros() {
+  return micros();
+}
+
+bool i2cBusInit() {
+  Serial.println("Initializing I2C bus manager...");
+
+  i2cConfigureDevice(I2C_DEV_TOUCH, "touch", I2C_BUS_TOUCH, TOUCH_I2C_ADDRESS, TOUCH_I2C_CLOCK);
+  i2cConfigureDevice(I2C_DEV_IMU, "imu", I2C_BUS_SHARED, IMU_I2C_ADDRESS, IMU_I2C_CLOCK);
+  i2cConfigureDevice(I2C_DEV_RTC, "rtc", I2C_BUS_SHARED, RTC_I2C_ADDRESS, RTC_I2C_CLOCK);
+  i2cConfigureDevice(I2C_DEV_PMIC, "pmic", I2C_BUS_SHARED, PWR_I2C_ADDRESS, PWR_I2C_CLOCK);
+
+  static const I2CBackend wire_backend = {wireBegin, wireSetClock, wireTransfer, wireMicros};
+  if (!i2cBusStart(wire_backend)) {
+    Serial.println("I2C bus manager failed to start!");
+    return false;
+  }
+
+  Serial.println("I2C bus manager initialized");
+  return true;
+}
+
+void i2cReportStats() {
+  char report[512];
+  i2cFormatStats(report, sizeof(report));
+  Serial.print(report);
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,104 @@
+/*
+ * Shared I2C Bus Manager for ESP32-S3 Watch
+ * Owns both I2C controllers, per-device clocks and a transaction queue
+ *
+ * Touch sits alone on its controller, while IMU, RTC and PMIC share pins
+ * 41/42. All traffic goes through this module: synchronous register reads
+ * and writes run under the bus lock, and queued transactions run from the
+ * bus task, with completion callbacks. Before each transfer the bus is
+ * switched to that device's clock, so one slow device no longer slows
+ * everyone else. Transfers go through an I2CBackend: Wire on the watch,
+ * or the register simulator in i2c_mock.h on host.
+ */
+
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define I2C_QUEUE_LENGTH 16
+#define I2C_MAX_TRANSFER 32       // Payload limit of queued transactions
+#define I2C_TASK_STACK 3072
+#define I2C_TASK_PRIORITY 3
+
+enum I2CBusId {
+  I2C_BUS_TOUCH,    // Wire, FT3168 only
+  I2C_BUS_SHARED,   // Wire1, IMU + RTC + PMIC
+  I2C_BUS_COUNT
+};
+
+enum I2CDeviceId {
+  I2C_DEV_TOUCH,
+  I2C_DEV_IMU,
+  I2C_DEV_RTC,
+  I2C_DEV_PMIC,
+  I2C_DEV_COUNT
+};
+
+// Device table entry plus its traffic statistics
+struct I2CDeviceInfo {
+  const char* name;
+  I2CBusId bus;
+  uint8_t address;
+  uint32_t clock_hz;
+  uint32_t transactions;
+  uint32_t errors;
+  uint32_t bytes;
+  uint64_t bus_time_us;
+};
+
+struct I2CTransaction;
+typedef void (*I2CCallback)(const I2CTransaction& transaction, bool ok);
+
+// Queued register burst, the transaction owns its payload
+struct I2CTransaction {
+  I2CDeviceId device;
+  uint8_t reg;
+  bool write;
+  uint8_t length;
+  uint8_t data[I2C_MAX_TRANSFER];  // Write payload or read result
+  I2CCallback callback;            // Runs on the bus task, may be nullptr
+  void* context;
+  uint8_t caller;                  // I2CCaller for the transaction trace
+};
+
+// Physical bus access. A transfer writes tx then reads rx with a repeated
+// start; both lengths 0 is an address probe.
+struct I2CBackend {
+  bool (*begin)(I2CBusId bus);
+  void (*set_clock)(I2CBusId bus, uint32_t clock_hz);
+  bool (*transfer)(I2CBusId bus, uint8_t address, const uint8_t* tx, size_t tx_length,
+                   uint8_t* rx, size_t rx_length);
+  uint32_t (*micros)();
+};
+
+// Setup
+void i2cConfigureDevice(I2CDeviceId device, const char* name, I2CBusId bus,
+                        uint8_t address, uint32_t clock_hz);
+void i2cSetDeviceAddress(I2CDeviceId device, uint8_t address);
+bool i2cBusStart(const I2CBackend& backend);
+
+// Synchronous register access
+bool i2cProbe(I2CDeviceId device);
+bool i2cReadRegs(I2CDeviceId device, uint8_t reg, uint8_t* data, size_t length);
+bool i2cWriteRegs(I2CDeviceId device, uint8_t reg, const uint8_t* data, size_t length);
+bool i2cWriteReg(I2CDeviceId device, uint8_t reg, uint8_t value);
+
+// Asynchronous transactions
+bool i2cSubmit(const I2CTransaction& transaction);
+int i2cServiceQueue(int max_transactions);  // Host only, the watch uses the bus task
+
+// Statistics
+I2CDeviceInfo i2cGetDeviceInfo(I2CDeviceId device);  // A consistent copy
+uint32_t i2cGetClockSwitches();
+void i2cResetStats();
+int i2cFormatStats(char* buffer, size_t size);
+
+#ifdef ARDUINO
+// Configure the watch's devices and start on the Wire backend
+bool i2cBusInit();
+void i2cReportStats();
+#endif
+
+#endif // I2C_BUS_H
\ No newline at end of file
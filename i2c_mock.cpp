@@ -0,0 +1,106 @@
+/*
+ * Simulated I2C Devices Implementation
+ * Register files with auto-increment and bit-time bus accounting
+ */
+
+#include "i2c_mock.h"
+
+#ifndef ARDUINO
+
+#include <string.h>
+
+static I2CMockDevice mock_devices[I2C_MOCK_MAX_DEVICES];
+static int mock_device_count = 0;
+static uint32_t mock_clock[I2C_BUS_COUNT];
+static uint32_t mock_now_us = 0;
+
+void i2cMockReset() {
+  memset(mock_devices, 0, sizeof(mock_devices));
+  mock_device_count = 0;
+  mock_now_us = 0;
+  for (int bus = 0; bus < I2C_BUS_COUNT; bus++) {
+    mock_clock[bus] = 100000;
+  }
+}
+
+I2CMockDevice* i2cMockAddDevice(I2CBusId bus, uint8_t address) {
+  if (mock_device_count >= I2C_MOCK_MAX_DEVICES) return nullptr;
+  I2CMockDevice* device = &mock_devices[mock_device_count++];
+  memset(device, 0, sizeof(*device));
+  device->bus = bus;
+  device->address = address;
+  device->present = true;
+  device->fixed_register = -1;
+  return device;
+}
+
+static I2CMockDevice* findDevice(I2CBusId bus, uint8_t address) {
+  for (int i = 0; i < mock_device_count; i++) {
+    if (mock_devices[i].bus == bus && mock_devices[i].address == address && mock_devices[i].present) {
+      return &mock_devices[i];
+    }
+  }
+  return nullptr;
+}
+
+// Bits on the wire: start, 9 bits per byte (8 + ack), stop
+static void chargeBusTime(I2CBusId bus, size_t bytes, bool repeated_start) {
+  uint32_t bits = 2 + bytes * 9 + (repeated_start ? 1 : 0);
+  mock_now_us += (uint32_t)((uint64_t)bits * 1000000 / mock_clock[bus]);
+}
+
+static bool mockBegin(I2CBusId bus) {
+  (void)bus;
+  return true;
+}
+
+static void mockSetClock(I2CBusId bus, uint32_t clock_hz) {
+  mock_clock[bus] = clock_hz;
+  mock_now_us += I2C_MOCK_CLOCK_SWITCH_US;
+}
+
+static bool mockTransfer(I2CBusId bus, uint8_t address, const uint8_t* tx, size_t tx_length,
+                         uint8_t* rx, size_t rx_length) {
+  I2CMockDevice* device = findDevice(bus, address);
+
+  // Address byte plus payload, a missing device NAKs the address
+  chargeBusTime(bus, 1 + tx_length, false);
+  if (device == nullptr) return false;
+
+  if (tx_length > 0) {
+    device->pointer = tx[0];
+    for (size_t i = 1; i < tx_length; i++) {
+      device->registers[device->pointer++] = tx[i];
+    }
+    if (tx_length > 1) device->writes++;
+  }
+
+  if (rx_length > 0) {
+    chargeBusTime(bus, 1 + rx_length, true);
+    for (size_t i = 0; i < rx_length; i++) {
+      rx[i] = device->registers[device->pointer];
+      if (device->pointer != device->fixed_register) device->pointer++;
+    }
+    device->reads++;
+  }
+  return true;
+}
+
+static uint32_t mockMicros() {
+  return mock_now_us;
+}
+
+const I2CBackend& i2cMockBackend() {
+  static const I2CBackend backend = {mockBegin, mockSetClock, mockTransfer, mockMicros};
+  return backend;
+}
+
+uint32_t i2cMockNow() {
+  return mock_now_us;
+}
+
+void i2cMockAdvance(uint32_t us) {
+  mock_now_us += us;
+}
+
+#endif // ARDUINO
\ No newline at end of file
@@ -0,0 +1,42 @@
+/*
+ * Simulated I2C Devices for Host Builds
+ * Register-file devices and bus timing behind the I2CBackend seam
+ *
+ * Each simulated device is a 256-byte register file with auto-increment,
+ * like the FT3168, QMI8658, PCF85063 and AXP2101. Transfer time comes
+ * from the bits on the wire at the current bus clock and advances a
+ * virtual microsecond clock, so bus time and clock-switch costs can be
+ * checked without hardware. Only compiled outside the Arduino build.
+ */
+
+#ifndef I2C_MOCK_H
+#define I2C_MOCK_H
+
+#ifndef ARDUINO
+
+#include "i2c_bus.h"
+
+#define I2C_MOCK_MAX_DEVICES 8
+#define I2C_MOCK_CLOCK_SWITCH_US 5    // Controller reconfiguration cost
+
+struct I2CMockDevice {
+  I2CBusId bus;
+  uint8_t address;
+  bool present;
+  uint8_t registers[256];
+  uint8_t pointer;          // Current register address
+  int fixed_register;       // Reads from this register do not auto-increment, -1 for none
+  uint32_t reads, writes;
+};
+
+void i2cMockReset();
+I2CMockDevice* i2cMockAddDevice(I2CBusId bus, uint8_t address);
+const I2CBackend& i2cMockBackend();
+
+// Virtual time
+uint32_t i2cMockNow();
+void i2cMockAdvance(uint32_t us);
+
+#endif // ARDUINO
+
+#endif // I2C_MOCK_H
\ No newline at end of file
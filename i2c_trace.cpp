@@ -0,0 +1,159 @@
+/*
+ * I2C Transaction Trace Implementation
+ * Overwriting ring buffer and slotted occupancy window
+ */
+
+#include "i2c_trace.h"
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+
+static I2CTraceRecord trace_ring[I2C_TRACE_CAPACITY];
+static int trace_head = 0;     // Next slot to write
+static int trace_count = 0;
+static uint32_t trace_dropped = 0;  // Records overwritten before a dump
+static bool trace_enabled = true;
+// Per task: the sensor task and the loop tag their own traffic on different cores
+static thread_local I2CCaller current_caller = I2C_CALLER_UNKNOWN;
+
+#ifdef ARDUINO
+// Both controllers can finish transfers concurrently (loop and bus task)
+static portMUX_TYPE trace_mux = portMUX_INITIALIZER_UNLOCKED;
+#define TRACE_LOCK() portENTER_CRITICAL(&trace_mux)
+#define TRACE_UNLOCK() portEXIT_CRITICAL(&trace_mux)
+#else
+#define TRACE_LOCK()
+#define TRACE_UNLOCK()
+#endif
+
+// Busy time per device in 100ms slots, tagged with the slot's epoch
+static uint32_t occupancy_busy_us[I2C_DEV_COUNT][I2C_OCCUPANCY_SLOTS];
+static uint32_t occupancy_epoch[I2C_DEV_COUNT][I2C_OCCUPANCY_SLOTS];
+
+static const char* caller_names[I2C_CALLER_COUNT] = {
+  "unknown", "touch", "sensors", "rtc", "power", "queue"
+};
+
+void i2cTraceEnable(bool enabled) {
+  trace_enabled = enabled;
+}
+
+bool i2cTraceIsEnabled() {
+  return trace_enabled;
+}
+
+void i2cTraceClear() {
+  trace_head = 0;
+  trace_count = 0;
+  trace_dropped = 0;
+  memset(occupancy_busy_us, 0, sizeof(occupancy_busy_us));
+  memset(occupancy_epoch, 0, sizeof(occupancy_epoch));
+}
+
+I2CCaller i2cTraceSetCaller(I2CCaller caller) {
+  I2CCaller previous = current_caller;
+  current_caller = caller;
+  return previous;
+}
+
+I2CCaller i2cTraceGetCaller() {
+  return current_caller;
+}
+
+void i2cTraceRecord(const I2CTraceRecord& record) {
+  TRACE_LOCK();
+  
+  // Occupancy is always tracked, the ring only while tracing
+  if (record.device < I2C_DEV_COUNT) {
+    uint32_t epoch = record.start_us / I2C_OCCUPANCY_SLOT_US;
+    int slot = epoch % I2C_OCCUPANCY_SLOTS;
+    if (occupancy_epoch[record.device][slot] != epoch) {
+      occupancy_epoch[record.device][slot] = epoch;
+      occupancy_busy_us[record.device][slot] = 0;
+    }
+    occupancy_busy_us[record.device][slot] += record.duration_us;
+  }
+
+  if (trace_enabled) {
+    trace_ring[trace_head] = record;
+    trace_head = (trace_head + 1) % I2C_TRACE_CAPACITY;
+    if (trace_count < I2C_TRACE_CAPACITY) {
+      trace_count++;
+    } else {
+      trace_dropped++;
+    }
+  }
+
+  TRACE_UNLOCK();
+}
+
+int i2cTraceCount() {
+  return trace_count;
+}
+
+uint32_t i2cTraceDropped() {
+  return trace_dropped;
+}
+
+const I2CTraceRecord& i2cTraceGet(int index) {
+  int oldest = (trace_head - trace_count + I2C_TRACE_CAPACITY) % I2C_TRACE_CAPACITY;
+  return trace_ring[(oldest + index) % I2C_TRACE_CAPACITY];
+}
+
+float i2cTraceOccupancy(I2CDeviceId device, uint32_t now_us) {
+  uint32_t now_epoch = now_us / I2C_OCCUPANCY_SLOT_US;
+  uint32_t busy = 0;
+
+  for (int slot = 0; slot < I2C_OCCUPANCY_SLOTS; slot++) {
+    uint32_t age = now_epoch - occupancy_epoch[device][slot];
+    if (age < I2C_OCCUPANCY_SLOTS) {
+      busy += occupancy_busy_us[device][slot];
+    }
+  }
+  return busy * 100.0f / (I2C_OCCUPANCY_SLOTS * I2C_OCCUPANCY_SLOT_US);
+}
+
+const char* i2cCallerName(uint8_t caller) {
+  return caller < I2C_CALLER_COUNT ? caller_names[caller] : "unknown";
+}
+
+#ifdef ARDUINO
+void dumpI2CTrace() {
+  // Pause recording so the ring is stable while printing
+  bool was_enabled = trace_enabled;
+  trace_enabled = false;
+
+  char line[96];
+  Serial.println("I2C_TRACE_BEGIN");
+  Serial.println("start_us,duration_us,device,address,reg,length,caller,flags");
+  for (int i = 0; i < trace_count; i++) {
+    const I2CTraceRecord& r = i2cTraceGet(i);
+    snprintf(line, sizeof(line), "%lu,%u,%s,0x%02X,0x%02X,%u,%s,%u",
+             (unsigned long)r.start_us, r.duration_us,
+             i2cGetDeviceInfo((I2CDeviceId)r.device).name, r.address, r.reg,
+             r.length, i2cCallerName(r.caller), r.flags);
+    Serial.println(line);
+  }
+  Serial.println("I2C_TRACE_END dropped=" + String(trace_dropped));
+
+  trace_head = 0;
+  trace_count = 0;
+  trace_dropped = 0;
+  trace_enabled = was_enabled;
+}
+
+void reportI2COccupancy() {
+  uint32_t now = micros();
+  Serial.print("I2C occupancy:");
+  for (int i = 0; i < I2C_DEV_COUNT; i++) {
+    Serial.print(" ");
+    Serial.print(i2cGetDeviceInfo((I2CDeviceId)i).name);
+    Serial.print(" ");
+    Serial.print(i2cTraceOccupancy((I2CDeviceId)i, now), 1);
+    Serial.print("%");
+  }
+  Serial.println();
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,69 @@
+/*
+ * I2C Transaction Trace for ESP32-S3 Watch
+ * RAM ring buffer of bus transfers and rolling per-device occupancy
+ *
+ * The bus manager records every transfer: start time, duration, device,
+ * register, byte count and the subsystem that asked for it. The ring can
+ * be dumped over Serial between I2C_TRACE_BEGIN / I2C_TRACE_END markers,
+ * and tools/i2c_trace_to_chrome.py turns a captured log into a Chrome
+ * trace timeline (chrome://tracing or Perfetto).
+ */
+
+#ifndef I2C_TRACE_H
+#define I2C_TRACE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "i2c_bus.h"
+
+#define I2C_TRACE_CAPACITY 512
+#define I2C_OCCUPANCY_SLOTS 10
+#define I2C_OCCUPANCY_SLOT_US 100000   // 10 x 100ms = 1s rolling window
+
+// Subsystem that issued a transfer
+enum I2CCaller {
+  I2C_CALLER_UNKNOWN,
+  I2C_CALLER_TOUCH,
+  I2C_CALLER_SENSORS,
+  I2C_CALLER_RTC,
+  I2C_CALLER_POWER,
+  I2C_CALLER_QUEUE,
+  I2C_CALLER_COUNT
+};
+
+#define I2C_TRACE_WRITE 0x01
+#define I2C_TRACE_ERROR 0x02
+#define I2C_TRACE_PROBE 0x04
+
+struct I2CTraceRecord {
+  uint32_t start_us;
+  uint16_t duration_us;
+  uint8_t device;
+  uint8_t address;
+  uint8_t reg;
+  uint8_t length;     // Payload bytes, register address excluded, saturates at 255
+  uint8_t caller;
+  uint8_t flags;
+};
+
+// Recording
+void i2cTraceEnable(bool enabled);
+bool i2cTraceIsEnabled();
+void i2cTraceClear();
+I2CCaller i2cTraceSetCaller(I2CCaller caller);  // Loop-side caller, returns the previous one
+I2CCaller i2cTraceGetCaller();
+void i2cTraceRecord(const I2CTraceRecord& record);
+
+// Inspection, index 0 is the oldest record
+int i2cTraceCount();
+uint32_t i2cTraceDropped();
+const I2CTraceRecord& i2cTraceGet(int index);
+float i2cTraceOccupancy(I2CDeviceId device, uint32_t now_us);  // Percent of the last second
+const char* i2cCallerName(uint8_t caller);
+
+#ifdef ARDUINO
+void dumpI2CTrace();
+void reportI2COccupancy();
+#endif
+
+#endif // I2C_TRACE_H
\ No newline at end of file
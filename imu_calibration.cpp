@@ -0,0 +1,171 @@
+/*
+ * IMU Calibration Implementation
+ * Still-window detection, six-face accel fit and gyro bias tracking
+ */
+
+#include "imu_calibration.h"
+#include <string.h>
+
+static int16_t saturate16(int32_t value) {
+  if (value > 32767) return 32767;
+  if (value < -32768) return -32768;
+  return value;
+}
+
+void imuCalibrationDefaults(IMUCalibration& calibration) {
+  memset(&calibration, 0, sizeof(calibration));
+  calibration.version = IMU_CAL_VERSION;
+  for (int axis = 0; axis < 3; axis++) {
+    calibration.accel_scale[axis] = IMU_CAL_UNITY;
+  }
+}
+
+bool imuCalibrationValid(const IMUCalibration& calibration) {
+  if (calibration.version != IMU_CAL_VERSION) return false;
+  for (int axis = 0; axis < 3; axis++) {
+    // A scale more than 10% off unity is a bad fit, not a sensor
+    if (calibration.accel_scale[axis] < IMU_CAL_UNITY * 9 / 10 ||
+        calibration.accel_scale[axis] > IMU_CAL_UNITY * 11 / 10) {
+      return false;
+    }
+    if (calibration.gyro_bias[axis] > (IMU_GYRO_BIAS_LIMIT << 8) ||
+        calibration.gyro_bias[axis] < -(IMU_GYRO_BIAS_LIMIT << 8)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void imuCalibrationApply(const IMUCalibration& calibration, IMUSample* samples, int count) {
+  int32_t bias[3];
+  for (int axis = 0; axis < 3; axis++) {
+    bias[axis] = (calibration.gyro_bias[axis] + 128) >> 8;
+  }
+
+  for (int i = 0; i < count; i++) {
+    for (int axis = 0; axis < 3; axis++) {
+      int32_t accel = samples[i].accel[axis] - calibration.accel_offset[axis];
+      samples[i].accel[axis] = saturate16((accel * calibration.accel_scale[axis]) >> 14);
+      samples[i].gyro[axis] = saturate16(samples[i].gyro[axis] - bias[axis]);
+    }
+  }
+}
+
+void imuCalibrationRestartFaces(IMUCalibration& calibration) {
+  calibration.faces = 0;
+  memset(calibration.face_reading, 0, sizeof(calibration.face_reading));
+}
+
+bool imuCalibrationSaveDue(const IMUCalibration& calibration, const int32_t saved_gyro_bias[3], int changed,
+                           uint32_t since_save_ms) {
+  if (changed & IMU_CAL_CHANGED_ACCEL) return true;
+  if (!(changed & IMU_CAL_CHANGED_GYRO)) return false;
+
+  // Bias drifts with temperature, persist it only when it has moved and not too often
+  bool drifted = false;
+  for (int axis = 0; axis < 3; axis++) {
+    int32_t delta = calibration.gyro_bias[axis] - saved_gyro_bias[axis];
+    if (delta > IMU_CAL_SAVE_DRIFT || delta < -IMU_CAL_SAVE_DRIFT) drifted = true;
+  }
+  return drifted && since_save_ms > IMU_CAL_SAVE_INTERVAL;
+}
+
+// ==================== STILL WINDOWS ====================
+static void startWindow(IMUStillDetector& detector) {
+  detector.count = 0;
+  for (int axis = 0; axis < 3; axis++) {
+    detector.gyro_sum[axis] = 0;
+    detector.accel_sum[axis] = 0;
+    detector.gyro_min[axis] = detector.accel_min[axis] = 32767;
+    detector.gyro_max[axis] = detector.accel_max[axis] = -32768;
+  }
+}
+
+void imuStillInit(IMUStillDetector& detector) {
+  memset(&detector, 0, sizeof(detector));
+  startWindow(detector);
+}
+
+// Gravity along one axis: record that face, refit once all six are known
+static int recordFace(IMUCalibration& calibration, const int32_t* accel_mean) {
+  int axis = 0;
+  for (int a = 1; a < 3; a++) {
+    int32_t magnitude = accel_mean[a] < 0 ? -accel_mean[a] : accel_mean[a];
+    int32_t best = accel_mean[axis] < 0 ? -accel_mean[axis] : accel_mean[axis];
+    if (magnitude > best) axis = a;
+  }
+  int32_t along = accel_mean[axis];
+  if (along < IMU_FACE_MIN && along > -IMU_FACE_MIN) return 0;
+  for (int a = 0; a < 3; a++) {
+    if (a != axis && (accel_mean[a] > IMU_FACE_MAX_CROSS || accel_mean[a] < -IMU_FACE_MAX_CROSS)) return 0;
+  }
+
+  int face = axis * 2 + (along < 0 ? 1 : 0);
+  if (calibration.faces & (1 << face)) {
+    calibration.face_reading[face] = (calibration.face_reading[face] + along) / 2;
+  } else {
+    calibration.face_reading[face] = along;
+    calibration.faces |= 1 << face;
+  }
+  if (calibration.faces != (1 << IMU_FACE_COUNT) - 1) return 0;
+
+  for (int a = 0; a < 3; a++) {
+    int32_t up = calibration.face_reading[a * 2];
+    int32_t down = calibration.face_reading[a * 2 + 1];
+    if (up - down <= 0) return 0;
+    calibration.accel_offset[a] = (up + down) / 2;
+    calibration.accel_scale[a] = (int32_t)(2 * IMU_ACCEL_LSB_PER_G) * IMU_CAL_UNITY / (up - down);
+  }
+  return IMU_CAL_CHANGED_ACCEL;
+}
+
+static int finishWindow(IMUStillDetector& detector, IMUCalibration& calibration) {
+  for (int axis = 0; axis < 3; axis++) {
+    if (detector.gyro_max[axis] - detector.gyro_min[axis] > IMU_STILL_GYRO_RANGE ||
+        detector.accel_max[axis] - detector.accel_min[axis] > IMU_STILL_ACCEL_RANGE) {
+      detector.moving_windows++;
+      return 0;
+    }
+  }
+  detector.still_windows++;
+
+  int changed = 0;
+  int32_t gyro_mean[3], accel_mean[3];
+  bool plausible = true;
+  for (int axis = 0; axis < 3; axis++) {
+    gyro_mean[axis] = detector.gyro_sum[axis] * 256 / detector.count;
+    accel_mean[axis] = detector.accel_sum[axis] / detector.count;
+    if (gyro_mean[axis] > (IMU_GYRO_BIAS_LIMIT << 8) || gyro_mean[axis] < -(IMU_GYRO_BIAS_LIMIT << 8)) {
+      plausible = false;  // Steady turn, a turntable or a car
+    }
+  }
+  if (plausible) {
+    for (int axis = 0; axis < 3; axis++) {
+      calibration.gyro_bias[axis] += (gyro_mean[axis] - calibration.gyro_bias[axis]) >> IMU_GYRO_BIAS_SHIFT;
+    }
+    changed |= IMU_CAL_CHANGED_GYRO;
+  }
+  return changed | recordFace(calibration, accel_mean);
+}
+
+int imuCalibrationTrack(IMUStillDetector& detector, IMUCalibration& calibration,
+                        const IMUSample* samples, int count) {
+  int changed = 0;
+  for (int i = 0; i < count; i++) {
+    for (int axis = 0; axis < 3; axis++) {
+      int16_t gyro = samples[i].gyro[axis];
+      int16_t accel = samples[i].accel[axis];
+      detector.gyro_sum[axis] += gyro;
+      detector.accel_sum[axis] += accel;
+      if (gyro < detector.gyro_min[axis]) detector.gyro_min[axis] = gyro;
+      if (gyro > detector.gyro_max[axis]) detector.gyro_max[axis] = gyro;
+      if (accel < detector.accel_min[axis]) detector.accel_min[axis] = accel;
+      if (accel > detector.accel_max[axis]) detector.accel_max[axis] = accel;
+    }
+    if (++detector.count >= IMU_STILL_WINDOW) {
+      changed |= finishWindow(detector, calibration);
+      startWindow(detector);
+    }
+  }
+  return changed;
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+/*
+ * IMU Calibration for ESP32-S3 Watch
+ * Fixed-point offsets and scales, tracked in the background
+ *
+ * Every FIFO batch passes through here before it reaches the ring. Raw
+ * samples are cut into one-second windows; a window where both the gyro
+ * and the accelerometer barely move is a still window. Its gyro mean
+ * nudges the gyro bias, and if gravity lies along one axis its accel mean
+ * becomes that face's reading. Once all six faces have been seen, the
+ * accel offset and scale fall out of each axis' +1g and -1g readings.
+ * Nothing blocks: leaving the watch on a table fixes the gyro within
+ * seconds, and the faces fill in as it is set down in different ways.
+ *
+ * All values are in raw sensor LSB, scales in Q14, the gyro bias in Q8
+ * so slow drift below one LSB still accumulates.
+ */
+
+#ifndef IMU_CALIBRATION_H
+#define IMU_CALIBRATION_H
+
+#include <stdint.h>
+#include "imu_fifo.h"
+
+#define IMU_CAL_VERSION 1
+#define IMU_CAL_UNITY 16384            // Q14 scale of 1.0
+
+#define IMU_STILL_WINDOW 56            // One second of samples
+#define IMU_STILL_GYRO_RANGE 96        // 1.5 dps peak to peak
+#define IMU_STILL_ACCEL_RANGE 164      // 0.02 g peak to peak
+#define IMU_GYRO_BIAS_LIMIT 1920       // 30 dps, anything larger is rotation
+#define IMU_GYRO_BIAS_SHIFT 2          // Each still window moves the bias 1/4 of the way
+#define IMU_FACE_MIN 7373              // 0.9 g along the face axis
+#define IMU_FACE_MAX_CROSS 819         // 0.1 g across it, about 6 degrees of tilt
+
+// Written to NVS when the gyro bias has moved by 0.1 dps (Q8), at most this often
+#define IMU_CAL_SAVE_DRIFT 1638
+#define IMU_CAL_SAVE_INTERVAL 600000
+
+// What a tracking call changed, so the caller knows when to persist
+#define IMU_CAL_CHANGED_GYRO 0x01
+#define IMU_CAL_CHANGED_ACCEL 0x02
+
+enum IMUFace {
+  IMU_FACE_X_UP, IMU_FACE_X_DOWN,
+  IMU_FACE_Y_UP, IMU_FACE_Y_DOWN,
+  IMU_FACE_Z_UP, IMU_FACE_Z_DOWN,
+  IMU_FACE_COUNT
+};
+
+// Persisted as one blob, version checked on load
+struct IMUCalibration {
+  uint16_t version;
+  uint8_t faces;                       // Bitmask of IMUFace readings held
+  int16_t face_reading[IMU_FACE_COUNT];
+  int16_t accel_offset[3];
+  int16_t accel_scale[3];              // Q14
+  int32_t gyro_bias[3];                // Q8
+};
+
+struct IMUStillDetector {
+  int count;
+  int32_t gyro_sum[3], accel_sum[3];
+  int16_t gyro_min[3], gyro_max[3];
+  int16_t accel_min[3], accel_max[3];
+  uint32_t still_windows, moving_windows;
+};
+
+void imuCalibrationDefaults(IMUCalibration& calibration);
+bool imuCalibrationValid(const IMUCalibration& calibration);
+void imuCalibrationApply(const IMUCalibration& calibration, IMUSample* samples, int count);
+void imuCalibrationRestartFaces(IMUCalibration& calibration);
+bool imuCalibrationSaveDue(const IMUCalibration& calibration, const int32_t saved_gyro_bias[3], int changed,
+                           uint32_t since_save_ms);
+
+// Background tracking on raw samples, returns IMU_CAL_CHANGED_* flags
+void imuStillInit(IMUStillDetector& detector);
+int imuCalibrationTrack(IMUStillDetector& detector, IMUCalibration& calibration,
+                        const IMUSample* samples, int count);
+
+#endif // IMU_CALIBRATION_H
\ No newline at end of file
@@ -0,0 +1,180 @@
+/*
+ * QMI8658 FIFO Acquisition Implementation
+ * Frame parsing, batch timestamps, sample ring and the FIFO read sequence
+ */
+
+#include "imu_fifo.h"
+#include "i2c_bus.h"
+#include <string.h>
+
+#define IMU_CMD_POLLS 20                // STATUSINT reads before a command times out
+#define IMU_TIMESTAMP_SLACK_US 250000   // Largest drain delay still treated as continuous
+
+static IMUFifoStats fifo_stats;
+static IMUBatchFilter batch_filter = nullptr;
+
+// ==================== FIFO PARSING ====================
+int imuFifoByteCount(uint8_t sample_count_lsb, uint8_t fifo_status) {
+  // The count is in 16-bit words, its top two bits live in FIFO_STATUS
+  return 2 * (((fifo_status & 0x03) << 8) | sample_count_lsb);
+}
+
+int imuFifoParse(const uint8_t* bytes, size_t length, IMUSample* samples, int max_samples) {
+  int count = 0;
+  for (size_t offset = 0; offset + IMU_FIFO_FRAME_BYTES <= length && count < max_samples;
+       offset += IMU_FIFO_FRAME_BYTES) {
+    const uint8_t* frame = bytes + offset;
+    IMUSample& sample = samples[count++];
+    sample.timestamp_us = 0;
+    for (int axis = 0; axis < 3; axis++) {
+      sample.accel[axis] = (int16_t)(frame[axis * 2] | (frame[axis * 2 + 1] << 8));
+      sample.gyro[axis] = (int16_t)(frame[6 + axis * 2] | (frame[6 + axis * 2 + 1] << 8));
+    }
+  }
+  return count;
+}
+
+void imuFifoTimestamp(IMUSample* samples, int count, uint32_t previous_us, bool has_previous,
+                      uint32_t now_us, uint32_t period_us) {
+  if (count <= 0) return;
+
+  // Continue the previous batch's timeline while it stays plausible, so
+  // drain jitter does not show up as sample jitter. After a gap or an
+  // overflow the newest sample is anchored to the drain time instead.
+  uint32_t last_us = now_us;
+  if (has_previous) {
+    uint32_t predicted = previous_us + count * period_us;
+    int32_t lag = (int32_t)(now_us - predicted);
+    if (lag >= 0 && lag < IMU_TIMESTAMP_SLACK_US) {
+      last_us = predicted;
+    }
+  }
+
+  for (int i = 0; i < count; i++) {
+    samples[i].timestamp_us = last_us - (count - 1 - i) * period_us;
+  }
+}
+
+// ==================== SAMPLE RING ====================
+void imuRingInit(IMUSampleRing& ring) {
+  memset(&ring, 0, sizeof(ring));
+}
+
+void imuRingPush(IMUSampleRing& ring, const IMUSample& sample) {
+  ring.samples[ring.written & (IMU_RING_SIZE - 1)] = sample;
+  ring.written++;
+}
+
+void imuRingCursorInit(const IMUSampleRing& ring, IMURingCursor& cursor) {
+  cursor.next = ring.written;
+  cursor.dropped = 0;
+}
+
+int imuRingRead(const IMUSampleRing& ring, IMURingCursor& cursor, IMUSample* out, int max_samples) {
+  uint32_t available = ring.written - cursor.next;
+  if (available > IMU_RING_SIZE) {
+    // Lapped by the writer, skip to the oldest sample still held
+    cursor.dropped += available - IMU_RING_SIZE;
+    cursor.next = ring.written - IMU_RING_SIZE;
+    available = IMU_RING_SIZE;
+  }
+
+  int count = available < (uint32_t)max_samples ? available : max_samples;
+  for (int i = 0; i < count; i++) {
+    out[i] = ring.samples[(cursor.next + i) & (IMU_RING_SIZE - 1)];
+  }
+  cursor.next += count;
+  return count;
+}
+
+bool imuRingLatest(const IMUSampleRing& ring, IMUSample& out) {
+  if (ring.written == 0) return false;
+  out = ring.samples[(ring.written - 1) & (IMU_RING_SIZE - 1)];
+  return true;
+}
+
+// ==================== DRIVER ====================
+// CTRL9 handshake: issue the command, wait for CmdDone, then acknowledge
+bool imuCommand(uint8_t command) {
+  if (!i2cWriteReg(I2C_DEV_IMU, QMI8658_CTRL9, command)) return false;
+
+  uint8_t status = 0;
+  int polls = 0;
+  do {
+    if (!i2cReadRegs(I2C_DEV_IMU, QMI8658_STATUSINT, &status, 1)) return false;
+  } while (!(status & QMI8658_STATUSINT_CMD_DONE) && ++polls < IMU_CMD_POLLS);
+
+  i2cWriteReg(I2C_DEV_IMU, QMI8658_CTRL9, QMI8658_CMD_ACK);
+  return status & QMI8658_STATUSINT_CMD_DONE;
+}
+
+bool imuFifoConfigure() {
+  // Auto-increment, FIFO watermark routed to INT1 (wired to IMU_INT)
+  bool ok = i2cWriteReg(I2C_DEV_IMU, QMI8658_CTRL1, 0x4C);
+  ok &= i2cWriteReg(I2C_DEV_IMU, QMI8658_CTRL2, 0x10 | IMU_ODR_CODE);  // ±4g
+  ok &= i2cWriteReg(I2C_DEV_IMU, QMI8658_CTRL3, 0x50 | IMU_ODR_CODE);  // ±512dps
+  ok &= i2cWriteReg(I2C_DEV_IMU, QMI8658_CTRL5, 0x00);
+  ok &= i2cWriteReg(I2C_DEV_IMU, QMI8658_FIFO_WTM_TH, IMU_FIFO_WATERMARK);
+  ok &= i2cWriteReg(I2C_DEV_IMU, QMI8658_FIFO_CTRL, IMU_FIFO_SIZE_CODE | 0x02);  // Stream mode
+  ok &= imuCommand(QMI8658_CMD_RST_FIFO);
+  ok &= i2cWriteReg(I2C_DEV_IMU, QMI8658_CTRL7, 0x03);  // Accel + gyro on
+  return ok;
+}
+
+int imuFifoDrain(IMUSampleRing& ring, uint32_t now_us) {
+  // Freeze the FIFO for reading, then count and fetch it in one burst
+  if (!imuCommand(QMI8658_CMD_REQ_FIFO)) {
+    fifo_stats.errors++;
+    return 0;
+  }
+
+  uint8_t count_regs[2];
+  static uint8_t fifo_bytes[IMU_FIFO_MAX_FRAMES * IMU_FIFO_FRAME_BYTES];
+  static IMUSample batch[IMU_FIFO_MAX_FRAMES];
+  int parsed = 0;
+
+  if (i2cReadRegs(I2C_DEV_IMU, QMI8658_FIFO_SMPL_CNT, count_regs, 2)) {
+    if (count_regs[1] & QMI8658_FIFO_STATUS_OVERFLOW) fifo_stats.overflows++;
+
+    int length = imuFifoByteCount(count_regs[0], count_regs[1]);
+    if (length > (int)sizeof(fifo_bytes)) length = sizeof(fifo_bytes);
+    length -= length % IMU_FIFO_FRAME_BYTES;
+
+    if (length > 0 && i2cReadRegs(I2C_DEV_IMU, QMI8658_FIFO_DATA, fifo_bytes, length)) {
+      parsed = imuFifoParse(fifo_bytes, length, batch, IMU_FIFO_MAX_FRAMES);
+      fifo_stats.bytes += length;
+    } else if (length > 0) {
+      fifo_stats.errors++;
+    }
+  } else {
+    fifo_stats.errors++;
+  }
+
+  // Leave read mode so the FIFO starts filling again
+  i2cWriteReg(I2C_DEV_IMU, QMI8658_FIFO_CTRL, IMU_FIFO_SIZE_CODE | 0x02);
+
+  if (parsed > 0) {
+    if (batch_filter != nullptr) batch_filter(batch, parsed);
+    IMUSample previous = {};
+    bool has_previous = imuRingLatest(ring, previous);
+    imuFifoTimestamp(batch, parsed, previous.timestamp_us, has_previous, now_us, IMU_SAMPLE_PERIOD_US);
+    for (int i = 0; i < parsed; i++) {
+      imuRingPush(ring, batch[i]);
+    }
+    fifo_stats.batches++;
+    fifo_stats.samples += parsed;
+  }
+  return parsed;
+}
+
+void imuFifoSetFilter(IMUBatchFilter filter) {
+  batch_filter = filter;
+}
+
+const IMUFifoStats& imuFifoGetStats() {
+  return fifo_stats;
+}
+
+void imuFifoResetStats() {
+  memset(&fifo_stats, 0, sizeof(fifo_stats));
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+/*
+ * QMI8658 FIFO Acquisition for ESP32-S3 Watch
+ * Watermark-driven batch reads into a shared timestamped sample ring
+ *
+ * The IMU samples accel and gyro at its own output data rate and buffers
+ * them in its on-chip FIFO. When the watermark is reached it raises
+ * IMU_INT, and the whole batch is fetched with one burst from FIFO_DATA.
+ * Frames are parsed into raw int16 samples and pushed into a ring that
+ * every motion algorithm reads through its own cursor, so a slow consumer
+ * never steals samples from another one. The parser and ring are plain
+ * C++, and the driver talks through i2c_bus, so captured FIFO byte
+ * streams can be replayed on host against i2c_mock.
+ */
+
+#ifndef IMU_FIFO_H
+#define IMU_FIFO_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// QMI8658 registers
+#define QMI8658_CTRL1 0x02
+#define QMI8658_CTRL2 0x03          // Accel full scale and ODR
+#define QMI8658_CTRL3 0x04          // Gyro full scale and ODR
+#define QMI8658_CTRL5 0x06          // Low pass filters
+#define QMI8658_CTRL7 0x08          // Sensor enables
+#define QMI8658_CTRL9 0x0A          // Host command
+#define QMI8658_FIFO_WTM_TH 0x13
+#define QMI8658_FIFO_CTRL 0x14
+#define QMI8658_FIFO_SMPL_CNT 0x15
+#define QMI8658_FIFO_STATUS 0x16
+#define QMI8658_FIFO_DATA 0x17
+#define QMI8658_STATUSINT 0x2D
+#define QMI8658_AX_L 0x35
+
+// CTRL9 host commands and FIFO register bits
+#define QMI8658_CMD_ACK 0x00
+#define QMI8658_CMD_RST_FIFO 0x04
+#define QMI8658_CMD_REQ_FIFO 0x05
+#define QMI8658_STATUSINT_CMD_DONE 0x80
+#define QMI8658_FIFO_RD_MODE 0x80
+#define QMI8658_FIFO_STATUS_OVERFLOW 0x20
+
+// Acquisition settings: ±4g, ±512dps, 56Hz, 16-sample batches
+#define IMU_ODR_CODE 0x07             // 56.05Hz with both sensors enabled
+#define IMU_SAMPLE_PERIOD_US 17841
+#define IMU_FIFO_WATERMARK 16         // ~285ms per batch
+#define IMU_FIFO_SIZE_CODE 0x08       // 64 sample FIFO
+#define IMU_FIFO_FRAME_BYTES 12       // Accel XYZ + gyro XYZ, little endian
+#define IMU_FIFO_MAX_FRAMES 64
+#define IMU_ACCEL_LSB_PER_G 8192.0f
+#define IMU_GYRO_LSB_PER_DPS 64.0f
+
+#define IMU_RING_SIZE 256             // Power of two, ~4.5s of samples
+
+// One accel + gyro sample in raw sensor units
+struct IMUSample {
+  uint32_t timestamp_us;
+  int16_t accel[3];
+  int16_t gyro[3];
+};
+
+// Shared sample history, written by the drain only
+struct IMUSampleRing {
+  IMUSample samples[IMU_RING_SIZE];
+  uint32_t written;         // Total samples ever pushed
+};
+
+// Per-consumer read position
+struct IMURingCursor {
+  uint32_t next;            // Sample number to read next
+  uint32_t dropped;         // Samples overwritten before this consumer got them
+};
+
+struct IMUFifoStats {
+  uint32_t batches;
+  uint32_t samples;
+  uint32_t overflows;
+  uint32_t errors;
+  uint32_t bytes;
+};
+
+// Runs on every drained batch before it reaches the ring, e.g. calibration
+typedef void (*IMUBatchFilter)(IMUSample* samples, int count);
+
+// FIFO parsing
+int imuFifoByteCount(uint8_t sample_count_lsb, uint8_t fifo_status);
+int imuFifoParse(const uint8_t* bytes, size_t length, IMUSample* samples, int max_samples);
+void imuFifoTimestamp(IMUSample* samples, int count, uint32_t previous_us, bool has_previous,
+                      uint32_t now_us, uint32_t period_us);
+
+// Sample ring
+void imuRingInit(IMUSampleRing& ring);
+void imuRingPush(IMUSampleRing& ring, const IMUSample& sample);
+void imuRingCursorInit(const IMUSampleRing& ring, IMURingCursor& cursor);  // Starts at new samples
+int imuRingRead(const IMUSampleRing& ring, IMURingCursor& cursor, IMUSample* out, int max_samples);
+bool imuRingLatest(const IMUSampleRing& ring, IMUSample& out);
+
+// Driver over i2c_bus
+bool imuCommand(uint8_t command);  // CTRL9 host command with CmdDone handshake
+bool imuFifoConfigure();
+int imuFifoDrain(IMUSampleRing& ring, uint32_t now_us);
+void imuFifoSetFilter(IMUBatchFilter filter);
+const IMUFifoStats& imuFifoGetStats();
+void imuFifoResetStats();
+
+#endif // IMU_FIFO_H
\ No newline at end of file
@@ -0,0 +1,339 @@
+/*
+ * IMU Gesture Recognition Implementation
+ * Framing, LB_Keogh, banded DTW with early abandoning and peak picking
+ */
+
+#include "imu_gestures.h"
+#include <math.h>
+#include <string.h>
+
+#define DISTANCE_INFINITY 0x3FFFFFFF
+
+static const char* GESTURE_NAMES[IMU_GESTURE_COUNT] = {"flick in", "flick out", "double tap", "shake"};
+
+static int16_t clamp16(int32_t value) {
+  if (value > 32767) return 32767;
+  if (value < -32768) return -32768;
+  return value;
+}
+
+static int32_t frameDistance(const IMUGestureFrame a, const IMUGestureFrame b) {
+  int32_t distance = 0;
+  for (int c = 0; c < IMU_GESTURE_CHANNELS; c++) {
+    int32_t d = a[c] - b[c];
+    distance += d < 0 ? -d : d;
+  }
+  return distance;
+}
+
+static int32_t windowEnergy(const IMUGestureFrame* frames) {
+  int32_t energy = 0;
+  for (int i = 0; i < IMU_GESTURE_LENGTH; i++) {
+    for (int c = 0; c < IMU_GESTURE_CHANNELS; c++) {
+      energy += frames[i][c] < 0 ? -frames[i][c] : frames[i][c];
+    }
+  }
+  return energy;
+}
+
+// ==================== DISTANCES ====================
+int32_t imuGestureLowerBound(const IMUGestureFrame* query, const IMUGestureFrame* upper,
+                             const IMUGestureFrame* lower, int32_t limit) {
+  int32_t bound = 0;
+  for (int i = 0; i < IMU_GESTURE_LENGTH; i++) {
+    for (int c = 0; c < IMU_GESTURE_CHANNELS; c++) {
+      if (query[i][c] > upper[i][c]) bound += query[i][c] - upper[i][c];
+      else if (query[i][c] < lower[i][c]) bound += lower[i][c] - query[i][c];
+    }
+    if (bound >= limit) return bound;
+  }
+  return bound;
+}
+
+static int32_t bandedDTW(const IMUGestureFrame* query, const IMUGestureFrame* templ, int32_t limit,
+                         bool& abandoned) {
+  int32_t previous[IMU_GESTURE_LENGTH], current[IMU_GESTURE_LENGTH];
+  for (int j = 0; j < IMU_GESTURE_LENGTH; j++) previous[j] = DISTANCE_INFINITY;
+  abandoned = false;
+
+  for (int i = 0; i < IMU_GESTURE_LENGTH; i++) {
+    int first = i > IMU_GESTURE_BAND ? i - IMU_GESTURE_BAND : 0;
+    int last = i + IMU_GESTURE_BAND < IMU_GESTURE_LENGTH ? i + IMU_GESTURE_BAND : IMU_GESTURE_LENGTH - 1;
+    for (int j = 0; j < IMU_GESTURE_LENGTH; j++) current[j] = DISTANCE_INFINITY;
+
+    int32_t row_min = DISTANCE_INFINITY;
+    for (int j = first; j <= last; j++) {
+      int32_t best;
+      if (i == 0 && j == 0) {
+        best = 0;
+      } else {
+        best = previous[j];
+        if (j > 0 && current[j - 1] < best) best = current[j - 1];
+        if (j > 0 && previous[j - 1] < best) best = previous[j - 1];
+      }
+      current[j] = best + frameDistance(query[i], templ[j]);
+      if (current[j] < row_min) row_min = current[j];
+    }
+
+    // Every path crosses this row, so none can come back under the limit
+    if (row_min >= limit) {
+      abandoned = true;
+      return row_min;
+    }
+    memcpy(previous, current, sizeof(previous));
+  }
+  return previous[IMU_GESTURE_LENGTH - 1];
+}
+
+int32_t imuGestureDTW(const IMUGestureFrame* query, const IMUGestureFrame* templ, int32_t limit) {
+  bool abandoned;
+  return bandedDTW(query, templ, limit, abandoned);
+}
+
+// ==================== LIBRARY ====================
+static void synthesize(IMUGestureFrame* frames, IMUGestureType gesture) {
+  memset(frames, 0, sizeof(IMUGestureFrame) * IMU_GESTURE_LENGTH);
+  const float pi = 3.14159265f;
+  for (int k = 0; k < IMU_GESTURE_LENGTH; k++) {
+    switch (gesture) {
+      case IMU_GESTURE_FLICK_IN:
+      case IMU_GESTURE_FLICK_OUT:
+        // Roll about the forearm at up to 300dps for ~0.3s, then back
+        if (k >= 8 && k < 24) {
+          float phase = sinf(pi * (k - 8) / 8.0f);
+          frames[k][1] = (int16_t)((gesture == IMU_GESTURE_FLICK_IN ? 2400 : -2400) * phase);
+          frames[k][3] = (int16_t)(200 * fabsf(phase));
+        }
+        break;
+      case IMU_GESTURE_DOUBLE_TAP:
+        // Two 1.2g knocks a quarter second apart, barely any rotation
+        if (k == 12 || k == 19) {
+          frames[k][3] = 1200;
+          frames[k][0] = 80;
+        }
+        break;
+      case IMU_GESTURE_SHAKE:
+        // Three and a half cycles of twist at 4Hz, 350dps
+        if (k >= 4 && k < 28) {
+          float phase = sinf(2 * pi * (k - 4) / 7.0f);
+          frames[k][2] = (int16_t)(2800 * phase);
+          frames[k][3] = (int16_t)(600 * fabsf(phase));
+        }
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+void imuGestureDefaults(IMUGestureLibrary& library) {
+  memset(&library, 0, sizeof(library));
+  library.version = IMU_GESTURE_LIBRARY_VERSION;
+  for (int g = 0; g < IMU_GESTURE_COUNT; g++) {
+    synthesize(library.frames[g][0], (IMUGestureType)g);
+    library.used[g] = 1;
+    library.next[g] = 0;    // The first recording replaces the synthetic shape
+  }
+}
+
+bool imuGestureLibraryValid(const IMUGestureLibrary& library) {
+  if (library.version != IMU_GESTURE_LIBRARY_VERSION) return false;
+  for (int g = 0; g < IMU_GESTURE_COUNT; g++) {
+    if (library.used[g] == 0 || library.used[g] > IMU_GESTURE_TEMPLATES) return false;
+    if (library.next[g] >= IMU_GESTURE_TEMPLATES) return false;
+  }
+  return true;
+}
+
+static void buildEnvelope(IMUGestureEngine& engine, int g, int t) {
+  const IMUGestureFrame* frames = engine.library.frames[g][t];
+  for (int i = 0; i < IMU_GESTURE_LENGTH; i++) {
+    for (int c = 0; c < IMU_GESTURE_CHANNELS; c++) {
+      int16_t high = frames[i][c], low = frames[i][c];
+      for (int j = i - IMU_GESTURE_BAND; j <= i + IMU_GESTURE_BAND; j++) {
+        if (j < 0 || j >= IMU_GESTURE_LENGTH) continue;
+        if (frames[j][c] > high) high = frames[j][c];
+        if (frames[j][c] < low) low = frames[j][c];
+      }
+      engine.upper[g][t][i][c] = high;
+      engine.lower[g][t][i][c] = low;
+    }
+  }
+  engine.accept[g][t] = windowEnergy(frames) * IMU_GESTURE_ACCEPT_PERCENT / 100;
+}
+
+void imuGestureSetLibrary(IMUGestureEngine& engine, const IMUGestureLibrary& library) {
+  if (&library != &engine.library) engine.library = library;
+  for (int g = 0; g < IMU_GESTURE_COUNT; g++) {
+    for (int t = 0; t < library.used[g]; t++) {
+      buildEnvelope(engine, g, t);
+    }
+  }
+}
+
+// ==================== RECOGNITION ====================
+void imuGestureInit(IMUGestureEngine& engine) {
+  memset(&engine, 0, sizeof(engine));
+  engine.candidate = IMU_GESTURE_NONE;
+  engine.recording = IMU_GESTURE_NONE;
+  engine.recorded = IMU_GESTURE_NONE;
+  IMUGestureLibrary library;
+  imuGestureDefaults(library);
+  imuGestureSetLibrary(engine, library);
+}
+
+void imuGestureRecord(IMUGestureEngine& engine, IMUGestureType gesture) {
+  engine.recording = gesture;
+}
+
+const char* imuGestureName(IMUGestureType gesture) {
+  if (gesture < 0 || gesture >= IMU_GESTURE_COUNT) return "none";
+  return GESTURE_NAMES[gesture];
+}
+
+// Keep the window as a template once its movement is centred in it
+static void tryRecord(IMUGestureEngine& engine, const IMUGestureFrame* query) {
+  int32_t energy = 0, moment = 0;
+  for (int i = 0; i < IMU_GESTURE_LENGTH; i++) {
+    int32_t frame_energy = 0;
+    for (int c = 0; c < IMU_GESTURE_CHANNELS; c++) {
+      frame_energy += query[i][c] < 0 ? -query[i][c] : query[i][c];
+    }
+    energy += frame_energy;
+    moment += frame_energy * i;
+  }
+  if (energy < IMU_GESTURE_MIN_ENERGY) return;
+  int32_t centre = moment / energy;
+  if (centre < IMU_GESTURE_LENGTH / 2 - IMU_GESTURE_HOP / 2 ||
+      centre >= IMU_GESTURE_LENGTH / 2 + IMU_GESTURE_HOP / 2) {
+    return;
+  }
+
+  int g = engine.recording;
+  IMUGestureLibrary& library = engine.library;
+  int slot = library.next[g];
+  memcpy(library.frames[g][slot], query, sizeof(library.frames[g][slot]));
+  if (slot + 1 > library.used[g]) library.used[g] = slot + 1;
+  library.next[g] = (slot + 1) % IMU_GESTURE_TEMPLATES;
+  buildEnvelope(engine, g, slot);
+
+  engine.recorded = engine.recording;
+  engine.recording = IMU_GESTURE_NONE;
+  engine.refractory = IMU_GESTURE_REFRACTORY;
+}
+
+// Nearest template within its acceptance distance, cheapest bounds first
+static IMUGestureType matchWindow(IMUGestureEngine& engine, const IMUGestureFrame* query, int32_t& distance) {
+  struct Candidate { int8_t g, t; int32_t bound; };
+  Candidate order[IMU_GESTURE_COUNT * IMU_GESTURE_TEMPLATES];
+  int count = 0;
+  for (int g = 0; g < IMU_GESTURE_COUNT; g++) {
+    for (int t = 0; t < engine.library.used[g]; t++) {
+      int32_t bound = imuGestureLowerBound(query, engine.upper[g][t], engine.lower[g][t], engine.accept[g][t]);
+      if (bound >= engine.accept[g][t]) {
+        engine.stats.lb_pruned++;
+        continue;
+      }
+      // Insertion sort by bound, a dozen entries at most
+      int k = count++;
+      while (k > 0 && order[k - 1].bound > bound) {
+        order[k] = order[k - 1];
+        k--;
+      }
+      order[k].g = g;
+      order[k].t = t;
+      order[k].bound = bound;
+    }
+  }
+
+  IMUGestureType best = IMU_GESTURE_NONE;
+  int32_t best_distance = DISTANCE_INFINITY;
+  for (int k = 0; k < count; k++) {
+    int32_t limit = engine.accept[order[k].g][order[k].t];
+    if (best_distance < limit) limit = best_distance;
+    if (order[k].bound >= limit) {
+      engine.stats.lb_pruned++;
+      continue;
+    }
+    bool abandoned;
+    int32_t d = bandedDTW(query, engine.library.frames[order[k].g][order[k].t], limit, abandoned);
+    engine.stats.dtw_runs++;
+    if (abandoned) engine.stats.dtw_abandoned++;
+    if (d < limit) {
+      best = (IMUGestureType)order[k].g;
+      best_distance = d;
+    }
+  }
+  distance = best_distance;
+  return best;
+}
+
+static IMUGestureType takeCandidate(IMUGestureEngine& engine) {
+  IMUGestureType gesture = engine.candidate;
+  if (gesture != IMU_GESTURE_NONE) {
+    engine.stats.matches[gesture]++;
+    engine.refractory = IMU_GESTURE_REFRACTORY;
+  }
+  engine.candidate = IMU_GESTURE_NONE;
+  return gesture;
+}
+
+static IMUGestureType processWindow(IMUGestureEngine& engine) {
+  IMUGestureFrame query[IMU_GESTURE_LENGTH];
+  int oldest = engine.frame_count % IMU_GESTURE_LENGTH;
+  for (int i = 0; i < IMU_GESTURE_LENGTH; i++) {
+    memcpy(query[i], engine.window[(oldest + i) % IMU_GESTURE_LENGTH], sizeof(IMUGestureFrame));
+  }
+  engine.stats.windows++;
+
+  if (engine.recording != IMU_GESTURE_NONE) {
+    tryRecord(engine, query);
+    return IMU_GESTURE_NONE;
+  }
+  if (engine.refractory > 0) return IMU_GESTURE_NONE;
+  if (windowEnergy(query) < IMU_GESTURE_MIN_ENERGY) {
+    engine.stats.gated++;
+    return takeCandidate(engine);
+  }
+
+  // Report a match once the next window fits worse, i.e. at its best alignment
+  int32_t distance;
+  IMUGestureType match = matchWindow(engine, query, distance);
+  if (match != IMU_GESTURE_NONE && (engine.candidate == IMU_GESTURE_NONE || distance <= engine.candidate_distance)) {
+    engine.candidate = match;
+    engine.candidate_distance = distance;
+    return IMU_GESTURE_NONE;
+  }
+  return takeCandidate(engine);
+}
+
+IMUGestureType imuGestureProcess(IMUGestureEngine& engine, const IMUSample* samples, int count) {
+  IMUGestureType recognized = IMU_GESTURE_NONE;
+  for (int i = 0; i < count; i++) {
+    const IMUSample& s = samples[i];
+    for (int axis = 0; axis < 3; axis++) engine.gyro_sum[axis] += s.gyro[axis];
+    float magnitude = sqrtf((float)s.accel[0] * s.accel[0] + (float)s.accel[1] * s.accel[1] +
+                            (float)s.accel[2] * s.accel[2]);
+    int32_t jolt = (int32_t)fabsf(magnitude - IMU_ACCEL_LSB_PER_G);
+    if (jolt > engine.jolt_peak) engine.jolt_peak = jolt;
+    if (++engine.frame_samples < IMU_GESTURE_DECIMATE) continue;
+
+    // Raw gyro is 64 LSB/dps and accel 8192 LSB/g, both drop three bits
+    int16_t* frame = engine.window[engine.frame_count % IMU_GESTURE_LENGTH];
+    for (int axis = 0; axis < 3; axis++) {
+      frame[axis] = clamp16(engine.gyro_sum[axis] / (IMU_GESTURE_DECIMATE * 8));
+      engine.gyro_sum[axis] = 0;
+    }
+    frame[3] = clamp16(engine.jolt_peak / 8);
+    engine.jolt_peak = 0;
+    engine.frame_samples = 0;
+    engine.frame_count++;
+    if (engine.refractory > 0) engine.refractory--;
+
+    if (engine.frame_count >= IMU_GESTURE_LENGTH && engine.frame_count % IMU_GESTURE_HOP == 0) {
+      IMUGestureType gesture = processWindow(engine);
+      if (gesture != IMU_GESTURE_NONE) recognized = gesture;
+    }
+  }
+  return recognized;
+}
\ No newline at end of file
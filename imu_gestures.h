@@ -0,0 +1,101 @@
+/*
+ * IMU Gesture Recognition for ESP32-S3 Watch
+ * Wrist gestures matched against recorded templates with banded DTW
+ *
+ * Samples from the ring are folded into 28Hz frames of gyro rate and the
+ * peak accel jolt, and every few frames the last 1.1s is compared with
+ * each gesture's templates. Most windows never get that far: a quiet
+ * wrist is gated out on energy alone, LB_Keogh bounds drop templates that
+ * cannot beat the best match so far, and the DTW itself abandons a
+ * template as soon as a whole row is already worse. A match is reported
+ * when its distance stops falling, so each gesture fires once, near its
+ * best alignment.
+ *
+ * Templates come from the wearer: arm recording and the next deliberate
+ * movement becomes a template. Until then shapes synthesized from typical
+ * gestures stand in. Plain C++, so recorded windows can be replayed and
+ * timed on host.
+ */
+
+#ifndef IMU_GESTURES_H
+#define IMU_GESTURES_H
+
+#include <stdint.h>
+#include "imu_fifo.h"
+
+#define IMU_GESTURE_LIBRARY_VERSION 1
+#define IMU_GESTURE_DECIMATE 2            // Samples per frame, 28Hz frames
+#define IMU_GESTURE_LENGTH 32             // Frames per window, ~1.1s
+#define IMU_GESTURE_HOP 4                 // Frames between matches, ~140ms
+#define IMU_GESTURE_CHANNELS 4            // Gyro X/Y/Z in 1/8 dps, accel jolt in ~1mg
+#define IMU_GESTURE_BAND 4                // Sakoe-Chiba radius in frames
+#define IMU_GESTURE_TEMPLATES 3           // Per gesture
+#define IMU_GESTURE_MIN_ENERGY 2000       // Window L1 energy below this is a still wrist
+#define IMU_GESTURE_ACCEPT_PERCENT 45     // Match when DTW < this share of the template's energy
+#define IMU_GESTURE_REFRACTORY 24         // Frames ignored after a match
+
+enum IMUGestureType {
+  IMU_GESTURE_NONE = -1,
+  IMU_GESTURE_FLICK_IN,       // Quick roll towards the body and back
+  IMU_GESTURE_FLICK_OUT,      // Quick roll away from the body and back
+  IMU_GESTURE_DOUBLE_TAP,     // Two knocks on the wrist or the case
+  IMU_GESTURE_SHAKE,
+  IMU_GESTURE_COUNT
+};
+
+typedef int16_t IMUGestureFrame[IMU_GESTURE_CHANNELS];
+
+// What is persisted: the templates only, envelopes are rebuilt on load
+struct IMUGestureLibrary {
+  uint16_t version;
+  uint8_t used[IMU_GESTURE_COUNT];            // Templates held per gesture
+  uint8_t next[IMU_GESTURE_COUNT];            // Slot the next recording replaces
+  IMUGestureFrame frames[IMU_GESTURE_COUNT][IMU_GESTURE_TEMPLATES][IMU_GESTURE_LENGTH];
+};
+
+struct IMUGestureStats {
+  uint32_t windows, gated;
+  uint32_t lb_pruned, dtw_runs, dtw_abandoned;
+  uint32_t matches[IMU_GESTURE_COUNT];
+};
+
+struct IMUGestureEngine {
+  IMUGestureLibrary library;
+  IMUGestureFrame upper[IMU_GESTURE_COUNT][IMU_GESTURE_TEMPLATES][IMU_GESTURE_LENGTH];
+  IMUGestureFrame lower[IMU_GESTURE_COUNT][IMU_GESTURE_TEMPLATES][IMU_GESTURE_LENGTH];
+  int32_t accept[IMU_GESTURE_COUNT][IMU_GESTURE_TEMPLATES];
+
+  // Frame assembly
+  int32_t gyro_sum[3];
+  int32_t jolt_peak;
+  int frame_samples;
+  IMUGestureFrame window[IMU_GESTURE_LENGTH];  // Circular
+  uint32_t frame_count;
+
+  // Peak picking
+  IMUGestureType candidate;
+  int32_t candidate_distance;
+  int refractory;
+
+  IMUGestureType recording;   // Armed recording, IMU_GESTURE_NONE when idle
+  IMUGestureType recorded;    // Set when a recording completed, cleared by the caller
+  IMUGestureStats stats;
+};
+
+// Library
+void imuGestureDefaults(IMUGestureLibrary& library);
+bool imuGestureLibraryValid(const IMUGestureLibrary& library);
+void imuGestureSetLibrary(IMUGestureEngine& engine, const IMUGestureLibrary& library);
+
+// Recognition, returns the gesture recognized in this batch if any
+void imuGestureInit(IMUGestureEngine& engine);
+IMUGestureType imuGestureProcess(IMUGestureEngine& engine, const IMUSample* samples, int count);
+void imuGestureRecord(IMUGestureEngine& engine, IMUGestureType gesture);
+const char* imuGestureName(IMUGestureType gesture);
+
+// Distances, exposed for host benchmarks; both stop early once past limit
+int32_t imuGestureLowerBound(const IMUGestureFrame* query, const IMUGestureFrame* upper,
+                             const IMUGestureFrame* lower, int32_t limit);
+int32_t imuGestureDTW(const IMUGestureFrame* query, const IMUGestureFrame* templ, int32_t limit);
+
+#endif // IMU_GESTURES_H
\ No newline at end of file
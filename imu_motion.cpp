@@ -0,0 +1,141 @@
+/*
+ * QMI8658 Low-Power Motion Mode Implementation
+ * Step counter reconciliation and the motion mode register sequence
+ */
+
+#include "imu_motion.h"
+#include "imu_fifo.h"
+#include "i2c_bus.h"
+
+#define STEP_COUNTER_MASK ((1UL << IMU_STEP_COUNTER_BITS) - 1)
+
+// ==================== STEP SYNC ====================
+void stepSyncBegin(StepSync& sync, uint32_t hardware_count) {
+  sync.last_count = hardware_count & STEP_COUNTER_MASK;
+  sync.has_baseline = true;
+}
+
+uint32_t stepSyncUpdate(StepSync& sync, uint32_t hardware_count) {
+  hardware_count &= STEP_COUNTER_MASK;
+  if (!sync.has_baseline) {
+    // Nothing to compare against, start counting from here
+    stepSyncBegin(sync, hardware_count);
+    return 0;
+  }
+
+  uint32_t delta = (hardware_count - sync.last_count) & STEP_COUNTER_MASK;
+  if (hardware_count < sync.last_count) {
+    if (delta <= STEP_SYNC_MAX_DELTA) {
+      sync.wraps++;
+    } else {
+      // The counter went backwards: the IMU reset and counted from zero
+      sync.resets++;
+      delta = hardware_count;
+    }
+  } else if (delta > STEP_SYNC_MAX_DELTA) {
+    // Implausible jump, resync without crediting it
+    sync.resets++;
+    delta = 0;
+  }
+
+  sync.last_count = hardware_count;
+  sync.credited += delta;
+  return delta;
+}
+
+// ==================== DRIVER ====================
+// Write CAL1_L..CAL4_H and run the command that consumes them
+static bool imuCommandWithParameters(uint8_t command, const uint8_t parameters[8]) {
+  if (!i2cWriteRegs(I2C_DEV_IMU, QMI8658_CAL1_L, parameters, 8)) return false;
+  return imuCommand(command);
+}
+
+bool imuMotionEnter() {
+  // Sensors off while reconfiguring, FIFO back to bypass
+  bool ok = i2cWriteReg(I2C_DEV_IMU, QMI8658_CTRL7, 0x00);
+  ok &= i2cWriteReg(I2C_DEV_IMU, QMI8658_FIFO_CTRL, 0x00);
+  ok &= i2cWriteReg(I2C_DEV_IMU, QMI8658_CTRL2, 0x10 | IMU_MOTION_ODR_CODE);  // ±4g
+
+  // Pedometer, QST reference settings with times in 31.25Hz samples:
+  // sample count 50, peak-to-peak and peak 200mg, 2s up time, then
+  // 0.3s low time, 8 steps before counting starts, 1 step signal count
+  const uint8_t pedometer_first[8] = {0x32, 0x00, 0xCC, 0x00, 0xCC, 0x00, 62, 0x01};
+  const uint8_t pedometer_second[8] = {9, 8, 0, 1, 0, 0, 0, 0x02};
+  ok &= imuCommandWithParameters(QMI8658_CMD_CONFIGURE_PEDOMETER, pedometer_first);
+  ok &= imuCommandWithParameters(QMI8658_CMD_CONFIGURE_PEDOMETER, pedometer_second);
+
+  // Wake-on-motion on INT1 (IMU_INT), starting low, 4 sample blanking
+  const uint8_t wake_on_motion[8] = {IMU_WOM_THRESHOLD_MG, 0x04, 0, 0, 0, 0, 0, 0};
+  ok &= imuCommandWithParameters(QMI8658_CMD_WRITE_WOM, wake_on_motion);
+
+  ok &= i2cWriteReg(I2C_DEV_IMU, QMI8658_CTRL8, QMI8658_CTRL8_PEDO_EN);
+  ok &= i2cWriteReg(I2C_DEV_IMU, QMI8658_CTRL7, 0x01);  // Accel only
+  return ok;
+}
+
+bool imuMotionExit() {
+  // Disable the engines, a zero threshold turns wake-on-motion off
+  bool ok = i2cWriteReg(I2C_DEV_IMU, QMI8658_CTRL7, 0x00);
+  ok &= i2cWriteReg(I2C_DEV_IMU, QMI8658_CTRL8, 0x00);
+  const uint8_t wake_on_motion_off[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+  ok &= imuCommandWithParameters(QMI8658_CMD_WRITE_WOM, wake_on_motion_off);
+  ok &= imuFifoConfigure();
+  return ok;
+}
+
+bool imuReadStepCount(uint32_t& count) {
+  uint8_t raw[3];
+  if (!i2cReadRegs(I2C_DEV_IMU, QMI8658_STEP_CNT_LOW, raw, 3)) return false;
+  count = raw[0] | ((uint32_t)raw[1] << 8) | ((uint32_t)raw[2] << 16);
+  return true;
+}
+
+bool imuMotionResume(uint32_t& count, bool& counted) {
+  // Motion mode outlives deep sleep, and imuFifoConfigure() leaves CTRL8 and
+  // the wake-on-motion threshold alone. The count is read before the exit
+  // turns the pedometer off
+  counted = imuReadStepCount(count);
+  return imuMotionExit();
+}
+
+bool imuMotionFifoStart() {
+  // The watermark sits at the full FIFO, the drain comes first, so INT1 only
+  // ever signals motion
+  bool ok = i2cWriteReg(I2C_DEV_IMU, QMI8658_FIFO_WTM_TH, IMU_MOTION_FIFO_MAX_FRAMES);
+  ok &= i2cWriteReg(I2C_DEV_IMU, QMI8658_FIFO_CTRL, IMU_MOTION_FIFO_SIZE_CODE | 0x02);  // Stream mode
+  ok &= imuCommand(QMI8658_CMD_RST_FIFO);
+  return ok;
+}
+
+bool imuMotionFifoStop() {
+  return i2cWriteReg(I2C_DEV_IMU, QMI8658_FIFO_CTRL, 0x00);  // Bypass
+}
+
+int imuMotionFifoDrain(IMUSample* samples, int max_samples) {
+  if (!imuCommand(QMI8658_CMD_REQ_FIFO)) return 0;
+
+  static uint8_t fifo_bytes[IMU_MOTION_FIFO_MAX_FRAMES * IMU_MOTION_FIFO_FRAME_BYTES];
+  uint8_t count_regs[2];
+  int parsed = 0;
+  if (i2cReadRegs(I2C_DEV_IMU, QMI8658_FIFO_SMPL_CNT, count_regs, 2)) {
+    int length = imuFifoByteCount(count_regs[0], count_regs[1]);
+    if (length > max_samples * IMU_MOTION_FIFO_FRAME_BYTES) length = max_samples * IMU_MOTION_FIFO_FRAME_BYTES;
+    if (length > (int)sizeof(fifo_bytes)) length = sizeof(fifo_bytes);
+    length -= length % IMU_MOTION_FIFO_FRAME_BYTES;
+
+    if (length > 0 && i2cReadRegs(I2C_DEV_IMU, QMI8658_FIFO_DATA, fifo_bytes, length)) {
+      for (int offset = 0; offset < length; offset += IMU_MOTION_FIFO_FRAME_BYTES) {
+        IMUSample& sample = samples[parsed++];
+        sample.timestamp_us = 0;
+        for (int axis = 0; axis < 3; axis++) {
+          sample.accel[axis] = (int16_t)(fifo_bytes[offset + axis * 2] | (fifo_bytes[offset + axis * 2 + 1] << 8));
+          sample.gyro[axis] = 0;
+        }
+      }
+    }
+  }
+
+  // Leave read mode so the FIFO starts filling again
+  i2cWriteReg(I2C_DEV_IMU, QMI8658_FIFO_CTRL, IMU_MOTION_FIFO_SIZE_CODE | 0x02);
+  return parsed;
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+/*
+ * QMI8658 Low-Power Motion Mode for ESP32-S3 Watch
+ * On-chip pedometer and wake-on-motion while the watch sleeps
+ *
+ * In SCREEN_SLEEP the gyro and FIFO are switched off, and the accel runs
+ * alone at 31Hz. The IMU's own pedometer counts steps, and wake-on-motion
+ * toggles IMU_INT, so the MCU can stay in light sleep instead of polling.
+ * The hardware counter is 24 bits, keeps running across our sleeps and
+ * restarts from zero if the IMU resets. The step sync credits only what
+ * is new since the last reading, and it is plain C++, so wraps and resets
+ * can be replayed on host against i2c_mock.
+ *
+ * Sleep tracking also wants the accel samples themselves. The FIFO then
+ * runs accel-only with six-byte frames and is fetched every few seconds
+ * instead of on a watermark, since INT1 belongs to wake-on-motion.
+ */
+
+#ifndef IMU_MOTION_H
+#define IMU_MOTION_H
+
+#include <stdint.h>
+#include "imu_fifo.h"
+
+// QMI8658 registers and commands used in motion mode
+#define QMI8658_CAL1_L 0x0B           // CAL1_L..CAL4_H carry command parameters
+#define QMI8658_CTRL8 0x09
+#define QMI8658_STEP_CNT_LOW 0x5A     // 24-bit count, low/mid/high
+#define QMI8658_CMD_WRITE_WOM 0x08
+#define QMI8658_CMD_CONFIGURE_PEDOMETER 0x0D
+#define QMI8658_CTRL8_PEDO_EN 0x10
+
+#define IMU_MOTION_ODR_CODE 0x08      // 31.25Hz accel-only
+#define IMU_WOM_THRESHOLD_MG 200
+#define IMU_STEP_COUNTER_BITS 24
+#define STEP_SYNC_MAX_DELTA 100000    // More steps than this between reads means a reset
+
+#define IMU_MOTION_FIFO_SIZE_CODE 0x0C  // 128 sample FIFO, ~4.1s at 31.25Hz
+#define IMU_MOTION_FIFO_FRAME_BYTES 6   // Accel XYZ only
+#define IMU_MOTION_FIFO_MAX_FRAMES 128
+
+struct StepSync {
+  uint32_t last_count;      // Hardware count at the previous read
+  bool has_baseline;
+  uint32_t credited;        // Steps handed out since the baseline
+  uint32_t wraps;
+  uint32_t resets;
+};
+
+// Reconciliation
+void stepSyncBegin(StepSync& sync, uint32_t hardware_count);
+uint32_t stepSyncUpdate(StepSync& sync, uint32_t hardware_count);  // Returns new steps
+
+// Driver over i2c_bus
+bool imuMotionEnter();
+bool imuMotionExit();
+bool imuReadStepCount(uint32_t& count);
+bool imuMotionResume(uint32_t& count, bool& counted);  // Warm boot, returns the FIFO restart
+bool imuMotionFifoStart();
+bool imuMotionFifoStop();
+int imuMotionFifoDrain(IMUSample* samples, int max_samples);  // Gyro fields are zero
+
+#endif // IMU_MOTION_H
\ No newline at end of file
@@ -0,0 +1,184 @@
+/*
+ * Touch-to-Photon Latency Implementation
+ * Per-screen stage histograms and Serial / HUD reporting
+ */
+
+#include "latency.h"
+#include <stdio.h>
+#include <string.h>
+
+// Bucket upper bounds in microseconds, the last bucket is open ended
+static const uint32_t latency_bucket_limits[LATENCY_BUCKETS] = {
+  1000, 2000, 4000, 8000, 12000, 16000, 24000, 33000, 50000, 67000, 100000, 0xFFFFFFFF
+};
+
+static const char* latency_stage_names[LATENCY_STAGE_COUNT] = {
+  "recognize", "dispatch", "queue", "render", "total"
+};
+
+void latencyReset(LatencyTracker& tracker) {
+  memset(&tracker, 0, sizeof(tracker));
+}
+
+void latencyTouch(LatencyTracker& tracker, int screen, uint32_t sample_us, uint32_t recognized_us) {
+  // Coalesce: events before the next present share the oldest stamp
+  if (tracker.pending) return;
+  if (screen < 0 || screen >= LATENCY_MAX_SCREENS) return;
+
+  tracker.pending = true;
+  tracker.dispatched = false;
+  tracker.frame_started = false;
+  tracker.screen = screen;
+  tracker.sample_us = sample_us;
+  tracker.recognized_us = recognized_us;
+}
+
+void latencyDispatched(LatencyTracker& tracker, uint32_t now_us) {
+  if (!tracker.pending || tracker.dispatched) return;
+  tracker.dispatched = true;
+  tracker.dispatched_us = now_us;
+}
+
+void latencyFrameStart(LatencyTracker& tracker, uint32_t now_us) {
+  if (!tracker.pending || !tracker.dispatched || tracker.frame_started) return;
+  tracker.frame_started = true;
+  tracker.frame_us = now_us;
+}
+
+void latencyPresented(LatencyTracker& tracker, uint32_t now_us) {
+  if (!tracker.pending || !tracker.frame_started) return;
+
+  LatencyHistogram* stages = tracker.stages[tracker.screen];
+  latencyHistogramAdd(stages[LATENCY_STAGE_RECOGNIZE], tracker.recognized_us - tracker.sample_us);
+  latencyHistogramAdd(stages[LATENCY_STAGE_DISPATCH], tracker.dispatched_us - tracker.recognized_us);
+  latencyHistogramAdd(stages[LATENCY_STAGE_QUEUE], tracker.frame_us - tracker.dispatched_us);
+  latencyHistogramAdd(stages[LATENCY_STAGE_RENDER], now_us - tracker.frame_us);
+  latencyHistogramAdd(stages[LATENCY_STAGE_TOTAL], now_us - tracker.sample_us);
+
+  tracker.pending = false;
+}
+
+void latencyHistogramAdd(LatencyHistogram& histogram, uint32_t value_us) {
+  int bucket = 0;
+  while (bucket < LATENCY_BUCKETS - 1 && value_us > latency_bucket_limits[bucket]) {
+    bucket++;
+  }
+
+  histogram.buckets[bucket]++;
+  histogram.count++;
+  histogram.sum_us += value_us;
+  if (value_us > histogram.max_us) histogram.max_us = value_us;
+}
+
+uint32_t latencyBucketLimit(int bucket) {
+  if (bucket < 0 || bucket >= LATENCY_BUCKETS) return 0;
+  return latency_bucket_limits[bucket];
+}
+
+uint32_t latencyPercentile(const LatencyHistogram& histogram, float percentile) {
+  if (histogram.count == 0) return 0;
+
+  // Report the upper bound of the bucket holding the percentile
+  uint32_t target = (uint32_t)(histogram.count * percentile + 0.5f);
+  if (target < 1) target = 1;
+
+  uint32_t cumulative = 0;
+  for (int i = 0; i < LATENCY_BUCKETS - 1; i++) {
+    cumulative += histogram.buckets[i];
+    if (cumulative >= target) {
+      uint32_t limit = latency_bucket_limits[i];
+      return limit < histogram.max_us ? limit : histogram.max_us;
+    }
+  }
+  return histogram.max_us;
+}
+
+int latencyFormatReport(const LatencyTracker& tracker, int screen, char* buffer, size_t size) {
+  if (screen < 0 || screen >= LATENCY_MAX_SCREENS || size == 0) return 0;
+
+  const LatencyHistogram* stages = tracker.stages[screen];
+  if (stages[LATENCY_STAGE_TOTAL].count == 0) {
+    buffer[0] = '\0';
+    return 0;
+  }
+
+  int written = snprintf(buffer, size, "screen %d: %lu touches\n", screen,
+                         (unsigned long)stages[LATENCY_STAGE_TOTAL].count);
+
+  for (int stage = 0; stage < LATENCY_STAGE_COUNT && written < (int)size; stage++) {
+    const LatencyHistogram& h = stages[stage];
+    written += snprintf(buffer + written, size - written,
+                        "  %-9s avg %6.1f ms  p50 %6.1f  p95 %6.1f  max %6.1f\n",
+                        latency_stage_names[stage],
+                        h.count ? (double)h.sum_us / h.count / 1000.0 : 0.0,
+                        latencyPercentile(h, 0.50f) / 1000.0,
+                        latencyPercentile(h, 0.95f) / 1000.0,
+                        h.max_us / 1000.0);
+  }
+
+  return written;
+}
+
+#ifdef ARDUINO
+// ==================== WATCH INSTRUMENTATION ====================
+#include "config.h"
+#include "display.h"
+#include "themes.h"
+
+LatencyTracker touch_latency;
+static bool perf_hud_enabled = ENABLE_PERF_HUD;
+
+void markTouchDispatched() {
+  latencyDispatched(touch_latency, micros());
+}
+
+void markFrameStart() {
+  latencyFrameStart(touch_latency, micros());
+}
+
+void markFramePresented() {
+  latencyPresented(touch_latency, micros());
+}
+
+void reportTouchLatency() {
+  static unsigned long last_report = 0;
+  if (millis() - last_report < LATENCY_REPORT_INTERVAL) return;
+  last_report = millis();
+
+  char report[512];
+  for (int screen = 0; screen < LATENCY_MAX_SCREENS; screen++) {
+    if (latencyFormatReport(touch_latency, screen, report, sizeof(report)) > 0) {
+      Serial.print("Touch latency ");
+      Serial.print(report);
+    }
+  }
+}
+
+void setPerfHUDEnabled(bool enabled) {
+  perf_hud_enabled = enabled;
+}
+
+bool isPerfHUDEnabled() {
+  return perf_hud_enabled;
+}
+
+void drawPerfHUD() {
+  int screen = system_state.current_screen;
+  if (!perf_hud_enabled || screen < 0 || screen >= LATENCY_MAX_SCREENS) return;
+
+  ThemeColors* theme = getCurrentTheme();
+  const LatencyHistogram& total = touch_latency.stages[screen][LATENCY_STAGE_TOTAL];
+
+  char line[40];
+  if (total.count > 0) {
+    sprintf(line, "T2P p50 %lu p95 %lu ms",
+            (unsigned long)(latencyPercentile(total, 0.50f) / 1000),
+            (unsigned long)(latencyPercentile(total, 0.95f) / 1000));
+  } else {
+    sprintf(line, "T2P --");
+  }
+
+  fillRect(0, DISPLAY_HEIGHT - 14, DISPLAY_WIDTH, 14, COLOR_BLACK);
+  drawText(line, 4, DISPLAY_HEIGHT - 11, theme->accent, 1);
+}
+#endif
\ No newline at end of file
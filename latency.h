@@ -0,0 +1,78 @@
+/*
+ * Touch-to-Photon Latency Measurement for ESP32-S3 Watch
+ * Stamps touch samples through recognition, dispatch, draw and present
+ *
+ * The tracker core only takes microsecond timestamps and screen indices,
+ * so a host build can replay scripted touch traces through it and print
+ * the same per-screen breakdown that the watch reports on Serial.
+ */
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "screens.h"
+
+#define LATENCY_MAX_SCREENS SCREEN_COUNT
+#define LATENCY_BUCKETS 12
+#define LATENCY_REPORT_INTERVAL 10000  // ms between Serial reports
+
+// Pipeline stages measured for each touch
+enum LatencyStage {
+  LATENCY_STAGE_RECOGNIZE,  // Raw sample -> gesture event
+  LATENCY_STAGE_DISPATCH,   // Gesture event -> touch handlers done
+  LATENCY_STAGE_QUEUE,      // Handlers done -> next frame starts drawing
+  LATENCY_STAGE_RENDER,     // Frame start -> updateDisplay() complete
+  LATENCY_STAGE_TOTAL,      // Raw sample -> photons
+  LATENCY_STAGE_COUNT
+};
+
+// Fixed-bucket latency histogram
+struct LatencyHistogram {
+  uint32_t buckets[LATENCY_BUCKETS];
+  uint32_t count;
+  uint64_t sum_us;
+  uint32_t max_us;
+};
+
+// Per-screen histograms plus the touch currently in flight
+struct LatencyTracker {
+  LatencyHistogram stages[LATENCY_MAX_SCREENS][LATENCY_STAGE_COUNT];
+
+  bool pending;
+  bool dispatched;
+  bool frame_started;
+  int screen;
+  uint32_t sample_us;
+  uint32_t recognized_us;
+  uint32_t dispatched_us;
+  uint32_t frame_us;
+};
+
+// Tracker core
+void latencyReset(LatencyTracker& tracker);
+void latencyTouch(LatencyTracker& tracker, int screen, uint32_t sample_us, uint32_t recognized_us);
+void latencyDispatched(LatencyTracker& tracker, uint32_t now_us);
+void latencyFrameStart(LatencyTracker& tracker, uint32_t now_us);
+void latencyPresented(LatencyTracker& tracker, uint32_t now_us);
+
+// Histogram helpers
+void latencyHistogramAdd(LatencyHistogram& histogram, uint32_t value_us);
+uint32_t latencyBucketLimit(int bucket);
+uint32_t latencyPercentile(const LatencyHistogram& histogram, float percentile);
+int latencyFormatReport(const LatencyTracker& tracker, int screen, char* buffer, size_t size);
+
+#ifdef ARDUINO
+// Watch-side instrumentation hooks
+extern LatencyTracker touch_latency;
+void markTouchDispatched();
+void markFrameStart();
+void markFramePresented();
+void reportTouchLatency();
+void setPerfHUDEnabled(bool enabled);
+bool isPerfHUDEnabled();
+void drawPerfHUD();
+#endif
+
+#endif // LATENCY_H
\ No newline at end of file
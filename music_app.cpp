@@ -20,24 +20,56 @@ struct MusicPlayerState {
   String current_title;
   String current_artist;
 } music_state;
+static bool music_state_ready = false;  // Track, volume and modes carry over between launches
+
+// Touch regions registered by drawMusicApp()
+enum MusicHitTag {
+  MUSIC_HIT_PREV,
+  MUSIC_HIT_PLAY,
+  MUSIC_HIT_NEXT,
+  MUSIC_HIT_VOLUME
+};
 
 void initMusicApp() {
   music_state.is_playing = false;
-  music_state.current_track = 0;
-  music_state.volume = 50;
   music_state.progress_seconds = 0;
-  music_state.shuffle = false;
-  music_state.repeat = false;
+  if (!music_state_ready) {
+    music_state.current_track = 0;
+    music_state.volume = 50;
+    music_state.shuffle = false;
+    music_state.repeat = false;
+    music_state_ready = true;
+  }
   
-  // Scan for MP3 files
-  total_music_files = scanMusicFiles(music_files, 100);
+  // MP3 files from the boot scan, or scanned now after a warm boot
+  ensureMediaIndex();
+  if (music_state.current_track >= total_music_files) music_state.current_track = 0;
   
   if (total_music_files > 0) {
-    music_state.current_title = music_files[0].title;
-    music_state.current_artist = music_files[0].artist;
+    music_state.current_title = music_files[music_state.current_track].title;
+    music_state.current_artist = music_files[music_state.current_track].artist;
   }
 }
 
+void saveMusicResume(ResumeMedia& media) {
+  media.current_track = music_state.current_track;
+  media.volume = music_state.volume;
+  media.shuffle = music_state.shuffle;
+  media.repeat = music_state.repeat;
+  media.music_count = total_music_files;
+  media.pdf_count = total_pdf_files;
+}
+
+void restoreMusicResume(const ResumeMedia& media) {
+  // The lists come back on first use; initMusicApp() checks the track then
+  music_state.is_playing = false;
+  music_state.current_track = media.current_track;
+  music_state.volume = media.volume;
+  music_state.shuffle = media.shuffle;
+  music_state.repeat = media.repeat;
+  music_state_ready = true;
+}
+
 void drawMusicApp() {
   clearDisplay();
   ThemeColors* theme = getCurrentTheme();
@@ -112,9 +144,11 @@ void drawMusicApp() {
   int prev_x = center_x - button_spacing - button_size/2;
   drawCircle(prev_x, button_y, button_size/2, theme->secondary);
   drawText("<<", prev_x - 8, button_y - 4, theme->text, 1);
+  addHitRegion(prev_x - button_size/2, button_y - button_size/2, button_size, button_size, MUSIC_HIT_PREV);
   
   // Play/Pause button
   drawCircle(center_x, button_y, button_size/2, theme->accent);
+  addHitRegion(center_x - button_size/2, button_y - button_size/2, button_size, button_size, MUSIC_HIT_PLAY);
   if (music_state.is_playing) {
     fillRect(center_x - 6, button_y - 8, 4, 16, theme->background);
     fillRect(center_x + 2, button_y - 8, 4, 16, theme->background);
@@ -130,6 +164,7 @@ void drawMusicApp() {
   int next_x = center_x + button_spacing - button_size/2;
   drawCircle(next_x, button_y, button_size/2, theme->secondary);
   drawText(">>", next_x - 8, button_y - 4, theme->text, 1);
+  addHitRegion(next_x - button_size/2, button_y - button_size/2, button_size, button_size, MUSIC_HIT_NEXT);
   
   // Volume control
   int volume_y = button_y + 60;
@@ -140,6 +175,7 @@ void drawMusicApp() {
   drawRect(volume_bar_x, volume_y + 5, volume_bar_width, 8, theme->secondary);
   fillRect(volume_bar_x, volume_y + 5, 
            (volume_bar_width * music_state.volume) / 100, 8, theme->accent);
+  addHitRegion(volume_bar_x, volume_y - 5, volume_bar_width, 28, MUSIC_HIT_VOLUME);
   
   // Track list info
   char track_info[50];
@@ -152,48 +188,27 @@ void drawMusicApp() {
 void handleMusicTouch(TouchGesture& gesture) {
   if (gesture.event != TOUCH_TAP) return;
   
-  // Handle button touches
-  int button_y = 300; // Approximate button Y position
-  int center_x = DISPLAY_WIDTH / 2;
-  int button_size = 40;
-  int button_spacing = 60;
-  
-  // Check play/pause button
-  if (abs(gesture.x - center_x) <= button_size/2 && 
-      abs(gesture.y - button_y) <= button_size/2) {
-    if (music_state.is_playing) {
-      pauseMusic();
-    } else {
-      playMusic();
-    }
-    return;
-  }
-  
-  // Check previous button
-  int prev_x = center_x - button_spacing - button_size/2;
-  if (abs(gesture.x - prev_x) <= button_size/2 && 
-      abs(gesture.y - button_y) <= button_size/2) {
-    previousTrack();
-    return;
-  }
-  
-  // Check next button
-  int next_x = center_x + button_spacing - button_size/2;
-  if (abs(gesture.x - next_x) <= button_size/2 && 
-      abs(gesture.y - button_y) <= button_size/2) {
-    nextTrack();
-    return;
-  }
-  
-  // Handle volume control
-  int volume_y = button_y + 60;
-  int volume_bar_x = 80;
-  int volume_bar_width = DISPLAY_WIDTH - 100;
-  
-  if (gesture.x >= volume_bar_x && gesture.x <= volume_bar_x + volume_bar_width &&
-      abs(gesture.y - (volume_y + 5)) <= 10) {
-    music_state.volume = map(gesture.x - volume_bar_x, 0, volume_bar_width, 0, 100);
-    // Update actual volume here
+  const HitRegion* region = findHitRegion(gesture);
+  if (region == nullptr) return;
+  
+  switch (region->tag) {
+    case MUSIC_HIT_PLAY:
+      if (music_state.is_playing) {
+        pauseMusic();
+      } else {
+        playMusic();
+      }
+      break;
+    case MUSIC_HIT_PREV:
+      previousTrack();
+      break;
+    case MUSIC_HIT_NEXT:
+      nextTrack();
+      break;
+    case MUSIC_HIT_VOLUME:
+      music_state.volume = constrain(map(gesture.x - region->x, 0, region->width, 0, 100), 0, 100);
+      // Update actual volume here
+      break;
   }
 }
 
@@ -201,12 +216,14 @@ void playMusic() {
   if (total_music_files == 0) return;
   
   music_state.is_playing = true;
+  system_state.music_playing = true;
   // Start actual audio playback here
   Serial.println("Playing: " + music_files[music_state.current_track].title);
 }
 
 void pauseMusic() {
   music_state.is_playing = false;
+  system_state.music_playing = false;
   // Pause actual audio playback here
   Serial.println("Music paused");
 }
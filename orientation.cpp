@@ -0,0 +1,171 @@
+/*
+ * Orientation Fusion Implementation
+ * Mahony complementary filter and the wrist pose state machine
+ */
+
+#include "orientation.h"
+#include <math.h>
+#include <string.h>
+
+#define RADIANS_PER_DEGREE 0.017453292f
+
+// ==================== MAHONY ====================
+void mahonyInit(MahonyFilter& filter, float kp, float ki) {
+  memset(&filter, 0, sizeof(filter));
+  filter.q[0] = 1.0f;
+  filter.kp = kp;
+  filter.ki = ki;
+}
+
+// Start from the accelerometer's tilt instead of converging from identity
+static void alignToGravity(MahonyFilter& filter, const float a[3]) {
+  float roll = atan2f(a[1], a[2]);
+  float pitch = atan2f(-a[0], sqrtf(a[1] * a[1] + a[2] * a[2]));
+  float cr = cosf(roll * 0.5f), sr = sinf(roll * 0.5f);
+  float cp = cosf(pitch * 0.5f), sp = sinf(pitch * 0.5f);
+  filter.q[0] = cr * cp;
+  filter.q[1] = sr * cp;
+  filter.q[2] = cr * sp;
+  filter.q[3] = -sr * sp;
+  filter.initialized = true;
+}
+
+void mahonyUpdate(MahonyFilter& filter, const float gyro_dps[3], const float accel_g[3], float dt) {
+  float* q = filter.q;
+  float gx = gyro_dps[0] * RADIANS_PER_DEGREE;
+  float gy = gyro_dps[1] * RADIANS_PER_DEGREE;
+  float gz = gyro_dps[2] * RADIANS_PER_DEGREE;
+
+  // Only trust the accelerometer near 1g, swings and impacts are not gravity
+  float norm = sqrtf(accel_g[0] * accel_g[0] + accel_g[1] * accel_g[1] + accel_g[2] * accel_g[2]);
+  if (norm > 0.7f && norm < 1.3f) {
+    float a[3] = {accel_g[0] / norm, accel_g[1] / norm, accel_g[2] / norm};
+    if (!filter.initialized) {
+      alignToGravity(filter, a);
+      return;
+    }
+
+    // Estimated up vector, error is its cross product with the measured one
+    float vx = 2.0f * (q[1] * q[3] - q[0] * q[2]);
+    float vy = 2.0f * (q[0] * q[1] + q[2] * q[3]);
+    float vz = q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3];
+    float ex = a[1] * vz - a[2] * vy;
+    float ey = a[2] * vx - a[0] * vz;
+    float ez = a[0] * vy - a[1] * vx;
+
+    if (filter.ki > 0.0f) {
+      filter.integral[0] += filter.ki * ex * dt;
+      filter.integral[1] += filter.ki * ey * dt;
+      filter.integral[2] += filter.ki * ez * dt;
+      gx += filter.integral[0];
+      gy += filter.integral[1];
+      gz += filter.integral[2];
+    }
+    gx += filter.kp * ex;
+    gy += filter.kp * ey;
+    gz += filter.kp * ez;
+  }
+
+  // q += 0.5 * q * (0, g) * dt
+  float half_dt = 0.5f * dt;
+  float q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3];
+  q[0] += (-q1 * gx - q2 * gy - q3 * gz) * half_dt;
+  q[1] += (q0 * gx + q2 * gz - q3 * gy) * half_dt;
+  q[2] += (q0 * gy - q1 * gz + q3 * gx) * half_dt;
+  q[3] += (q0 * gz + q1 * gy - q2 * gx) * half_dt;
+
+  float inverse = 1.0f / sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+  for (int i = 0; i < 4; i++) q[i] *= inverse;
+}
+
+void mahonyGravity(const MahonyFilter& filter, float up[3]) {
+  const float* q = filter.q;
+  up[0] = 2.0f * (q[1] * q[3] - q[0] * q[2]);
+  up[1] = 2.0f * (q[0] * q[1] + q[2] * q[3]);
+  up[2] = q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3];
+}
+
+// ==================== WRIST DETECTOR ====================
+void wristDetectorInit(WristDetector& detector) {
+  memset(&detector, 0, sizeof(detector));
+  detector.state = WRIST_STATE_UNKNOWN;
+}
+
+void wristDetectorArm(WristDetector& detector) {
+  detector.state = WRIST_STATE_UNKNOWN;
+  detector.hold_since_ms = 0;
+  detector.lower_since_ms = 0;
+  detector.armed = true;
+}
+
+static void enterState(WristDetector& detector, WristState state, uint32_t now_ms) {
+  detector.state = state;
+  detector.state_since_ms = now_ms;
+  detector.hold_since_ms = 0;
+  detector.lower_since_ms = 0;
+}
+
+WristEvent wristDetectorUpdate(WristDetector& detector, const float up[3], float rate_dps, uint32_t now_ms) {
+  bool face_up = up[2] >= WRIST_UP_Z && fabsf(up[0]) < WRIST_UP_MAX_X;
+  bool down = up[2] < WRIST_DOWN_Z;
+  bool armed = detector.armed;
+  detector.armed = false;
+
+  switch (detector.state) {
+    case WRIST_STATE_UNKNOWN:
+      if (down) {
+        enterState(detector, WRIST_STATE_DOWN, now_ms);
+        // Woken by motion: the arm was resting while we slept
+        if (armed) detector.state_since_ms = now_ms - WRIST_DOWN_HOLD_MS;
+      } else if (face_up && !armed) {
+        enterState(detector, WRIST_STATE_UP, now_ms);
+      }
+      break;
+
+    case WRIST_STATE_DOWN:
+      if (!down) {
+        if (now_ms - detector.state_since_ms >= WRIST_DOWN_HOLD_MS) {
+          enterState(detector, WRIST_STATE_RISING, now_ms);
+        } else {
+          enterState(detector, WRIST_STATE_UNKNOWN, now_ms);
+        }
+      }
+      break;
+
+    case WRIST_STATE_RISING:
+      if (down) {
+        enterState(detector, WRIST_STATE_DOWN, now_ms);
+        break;
+      }
+      if (face_up && rate_dps < WRIST_STILL_DPS) {
+        if (detector.hold_since_ms == 0) detector.hold_since_ms = now_ms;
+        if (now_ms - detector.hold_since_ms >= WRIST_UP_HOLD_MS) {
+          enterState(detector, WRIST_STATE_UP, now_ms);
+          detector.raises++;
+          return WRIST_RAISE;
+        }
+      } else {
+        detector.hold_since_ms = 0;
+        // Drifted up slowly or stopped halfway, not a glance
+        if (now_ms - detector.state_since_ms > WRIST_RAISE_MAX_MS) {
+          enterState(detector, WRIST_STATE_UNKNOWN, now_ms);
+        }
+      }
+      break;
+
+    case WRIST_STATE_UP:
+      if (down) {
+        if (detector.lower_since_ms == 0) detector.lower_since_ms = now_ms;
+        if (now_ms - detector.lower_since_ms >= WRIST_LOWER_HOLD_MS) {
+          uint32_t since = detector.lower_since_ms;
+          enterState(detector, WRIST_STATE_DOWN, since);
+          detector.lowers++;
+          return WRIST_LOWER;
+        }
+      } else {
+        detector.lower_since_ms = 0;
+      }
+      break;
+  }
+  return WRIST_NONE;
+}
\ No newline at end of file
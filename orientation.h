@@ -0,0 +1,73 @@
+/*
+ * Orientation Fusion for ESP32-S3 Watch
+ * Mahony filter and wrist raise/lower detection
+ *
+ * The Mahony filter integrates the gyro into a quaternion and pulls it
+ * towards the accelerometer's gravity estimate, so the watch knows which
+ * way its screen faces even mid-swing. The wrist detector only looks at
+ * that gravity direction and the rotation rate: a raise is the screen
+ * going from hanging down to facing up within about a second, then being
+ * held still. Single precision throughout (the S3 has a float unit), and
+ * no Arduino dependencies, so recorded traces replay on host.
+ *
+ * Watch frame: x towards 3 o'clock, y towards 12, z out of the screen.
+ */
+
+#ifndef ORIENTATION_H
+#define ORIENTATION_H
+
+#include <stdint.h>
+
+#define MAHONY_KP 2.0f
+#define MAHONY_KI 0.02f
+
+// Gravity poses, on the z component of the unit "up" vector
+#define WRIST_UP_Z 0.70f            // Screen within ~45 degrees of facing up
+#define WRIST_UP_MAX_X 0.50f        // Not rolled onto the 3 or 9 o'clock edge
+#define WRIST_DOWN_Z 0.30f          // Screen facing sideways or down
+#define WRIST_DOWN_HOLD_MS 300      // Arm must rest down before a raise counts
+#define WRIST_RAISE_MAX_MS 1200     // Down -> face up must happen this fast
+#define WRIST_UP_HOLD_MS 200        // Then stay face up and still this long
+#define WRIST_STILL_DPS 60.0f
+#define WRIST_LOWER_HOLD_MS 400
+
+struct MahonyFilter {
+  float q[4];               // w, x, y, z
+  float integral[3];        // Gyro bias estimate, rad/s
+  float kp, ki;
+  bool initialized;
+};
+
+enum WristEvent {
+  WRIST_NONE,
+  WRIST_RAISE,
+  WRIST_LOWER
+};
+
+enum WristState {
+  WRIST_STATE_UNKNOWN,
+  WRIST_STATE_DOWN,
+  WRIST_STATE_RISING,
+  WRIST_STATE_UP
+};
+
+struct WristDetector {
+  WristState state;
+  uint32_t state_since_ms;
+  uint32_t hold_since_ms;   // Face up and still since, 0 when not
+  uint32_t lower_since_ms;  // Down since while UP, 0 when not
+  bool armed;               // Next down sample counts as already held
+  uint32_t raises, lowers;
+};
+
+// Fusion
+void mahonyInit(MahonyFilter& filter, float kp, float ki);
+void mahonyUpdate(MahonyFilter& filter, const float gyro_dps[3], const float accel_g[3], float dt);
+void mahonyGravity(const MahonyFilter& filter, float up[3]);  // Unit up vector in the watch frame
+
+// Wrist gestures
+void wristDetectorInit(WristDetector& detector);
+void wristDetectorArm(WristDetector& detector);  // After sleep, trust a down pose at once
+WristEvent wristDetectorUpdate(WristDetector& detector, const float up[3], float rate_dps, uint32_t now_ms);
+
+#endif // ORIENTATION_H
\ No newline at end of file
@@ -0,0 +1,203 @@
+/*
+ * Streaming Pedometer Implementation
+ * Integer filter chain, step candidates and cadence-based stride
+ */
+
+#include "pedometer.h"
+#include "fixed_math.h"
+#include <string.h>
+
+// Butterworth sections at 56.05Hz, Q14: {b0, b1, b2, a1, a2}
+static const int32_t HIGHPASS_05HZ[5] = {15747, -31495, 15747, -31470, 15135};
+static const int32_t LOWPASS_4HZ[5] = {620, 1240, 620, -22601, 8696};
+
+#define PEDO_REST_CADENCE 100       // spm assumed before the first lag estimate
+
+static int32_t biquadStep(PedometerBiquad& state, const int32_t* c, int32_t x) {
+  int32_t acc = c[0] * x + c[1] * state.x1 + c[2] * state.x2
+              - c[3] * state.y1 - c[4] * state.y2;
+  int32_t y = (acc + (1 << 13)) >> 14;
+  state.x2 = state.x1;
+  state.x1 = x;
+  state.y2 = state.y1;
+  state.y1 = y;
+  return y;
+}
+
+void pedometerInit(Pedometer& pedometer, const PedometerProfile& profile) {
+  memset(&pedometer, 0, sizeof(pedometer));
+  pedometer.profile = profile;
+}
+
+void pedometerResetTotals(Pedometer& pedometer) {
+  pedometer.steps = 0;
+  pedometer.rejected_steps = 0;
+  pedometer.distance_m = 0;
+  pedometer.energy_kcal = 0;
+}
+
+float pedometerStepLength(const Pedometer& pedometer) {
+  // Step length grows with step frequency, roughly 0.41 x height at
+  // 1.8Hz walking and 0.63 x height at 2.8Hz running
+  uint16_t cadence = pedometer.cadence_spm ? pedometer.cadence_spm : PEDO_REST_CADENCE;
+  float ratio = 0.01f + 0.22f * (cadence / 60.0f);
+  if (ratio < 0.25f) ratio = 0.25f;
+  if (ratio > 0.75f) ratio = 0.75f;
+  return pedometer.profile.height_cm * ratio / 100.0f;
+}
+
+// Credit confirmed steps with distance and ACSM walking/running energy
+static void commitSteps(Pedometer& pedometer, uint32_t steps) {
+  if (steps == 0) return;
+  float step_m = pedometerStepLength(pedometer);
+  uint16_t cadence = pedometer.cadence_spm ? pedometer.cadence_spm : PEDO_REST_CADENCE;
+  float speed_m_min = step_m * cadence;
+
+  // VO2 in ml/kg/min, running costs twice the horizontal term of walking
+  float vo2 = 3.5f + (cadence >= 140 ? 0.2f : 0.1f) * speed_m_min;
+  float kcal_per_min = vo2 * pedometer.profile.weight_kg * 5.0f / 1000.0f;
+
+  pedometer.steps += steps;
+  pedometer.distance_m += steps * step_m;
+  pedometer.energy_kcal += steps * kcal_per_min / cadence;
+}
+
+// Normalized autocorrelation over the history window, picks the step lag
+static void checkPeriodicity(Pedometer& pedometer) {
+  int16_t window[PEDO_HISTORY];
+  uint32_t start = pedometer.sample_index;  // Oldest sample in the ring
+  for (int i = 0; i < PEDO_HISTORY; i++) {
+    window[i] = pedometer.history[(start + i) % PEDO_HISTORY];
+  }
+
+  int64_t energy = 0;
+  for (int i = 0; i < PEDO_HISTORY; i++) {
+    energy += (int32_t)window[i] * window[i];
+  }
+
+  // One jolt rings through the band-pass like a short gait, so the window
+  // needs several step candidates before its correlation means anything
+  bool enough_peaks = true;
+  for (int i = 0; i < PEDO_MIN_PEAKS; i++) {
+    uint32_t peak = pedometer.recent_peaks[i];
+    if (peak == 0 || pedometer.sample_index - (peak - 1) > PEDO_HISTORY) enough_peaks = false;
+  }
+
+  // A quiet signal is never periodic, however regular its noise
+  int64_t min_energy = (int64_t)PEDO_MIN_THRESHOLD * PEDO_MIN_THRESHOLD * PEDO_HISTORY / 4;
+  int scores[2 * PEDO_MAX_LAG + 1];
+  int best_lag = 0;
+  int best_score = 0;
+  if (enough_peaks && energy > min_energy) {
+    for (int lag = PEDO_MIN_LAG; lag <= 2 * PEDO_MAX_LAG; lag++) {
+      int64_t sum = 0;
+      for (int i = 0; i + lag < PEDO_HISTORY; i++) {
+        sum += (int32_t)window[i] * window[i + lag];
+      }
+      // Unbiased estimate, scaled to percent of the zero-lag energy
+      scores[lag] = (int)(sum * 100 * PEDO_HISTORY / ((PEDO_HISTORY - lag) * energy));
+      if (scores[lag] > best_score) {
+        best_score = scores[lag];
+        best_lag = lag;
+      }
+    }
+  }
+
+  // Fold stride (or two-stride) lags back to one step
+  while (best_lag > 0 && best_lag / 2 >= PEDO_MIN_LAG) {
+    int half = best_lag / 2;
+    if (scores[half + 1] > scores[half]) half++;
+    // Once locked on the step lag, stay there while the gait lasts
+    int drift = half - (int)pedometer.step_lag;
+    bool locked = pedometer.periodic && drift >= -2 && drift <= 2;
+    if (best_lag <= PEDO_MAX_LAG && scores[half] < PEDO_HALF_CORRELATION && !locked) break;
+    best_lag = half;
+  }
+
+  pedometer.correlation = best_score > 100 ? 100 : best_score;
+  if (best_score >= PEDO_MIN_CORRELATION) {
+    pedometer.periodic = true;
+    pedometer.aperiodic_checks = 0;
+    pedometer.step_lag = best_lag;
+    pedometer.cadence_spm = 60000000UL / ((uint32_t)best_lag * IMU_SAMPLE_PERIOD_US);
+    commitSteps(pedometer, pedometer.pending_steps);
+    pedometer.pending_steps = 0;
+  } else {
+    pedometer.periodic = false;
+    pedometer.cadence_spm = 0;
+    if (++pedometer.aperiodic_checks >= PEDO_UNCONFIRMED_CHECKS) {
+      pedometer.rejected_steps += pedometer.pending_steps;
+      pedometer.pending_steps = 0;
+      pedometer.aperiodic_checks = PEDO_UNCONFIRMED_CHECKS;
+    }
+  }
+}
+
+void pedometerAddSteps(Pedometer& pedometer, uint32_t steps) {
+  commitSteps(pedometer, steps);
+}
+
+int pedometerProcess(Pedometer& pedometer, const IMUSample* samples, int count) {
+  uint32_t steps_before = pedometer.steps;
+
+  for (int n = 0; n < count; n++) {
+    const IMUSample& sample = samples[n];
+
+    // |a| in 1/1024 g with gravity removed, the band-pass takes the rest
+    int32_t magnitude = (int32_t)(vectorLength3(sample.accel) >> 3) - 1024;
+
+    int32_t y = biquadStep(pedometer.highpass, HIGHPASS_05HZ, magnitude);
+    y = biquadStep(pedometer.lowpass, LOWPASS_4HZ, y);
+    if (y > 32767) y = 32767;
+    if (y < -32768) y = -32768;
+
+    pedometer.history[pedometer.sample_index % PEDO_HISTORY] = (int16_t)y;
+    pedometer.sample_index++;
+
+    // Envelope jumps to peaks and decays with a ~1.1s time constant
+    int32_t amplitude = y < 0 ? -y : y;
+    if (amplitude > pedometer.envelope) {
+      pedometer.envelope = amplitude;
+    } else {
+      pedometer.envelope -= pedometer.envelope >> 6;
+    }
+    int32_t threshold = pedometer.envelope / 3;
+    if (threshold < PEDO_MIN_THRESHOLD) threshold = PEDO_MIN_THRESHOLD;
+
+    if (y < threshold / 2) pedometer.armed = true;
+
+    // Local maximum one sample back
+    uint32_t peak_index = pedometer.sample_index - 2;
+    uint32_t min_interval = pedometer.periodic ? pedometer.step_lag * 6 / 10 : PEDO_MIN_LAG;
+    if (pedometer.armed &&
+        pedometer.previous > threshold &&
+        pedometer.previous >= pedometer.previous2 &&
+        pedometer.previous > y &&
+        peak_index - pedometer.last_step_index >= min_interval) {
+      uint32_t interval = peak_index - pedometer.last_step_index;
+      pedometer.armed = false;
+      pedometer.last_step_index = peak_index;
+      pedometer.recent_peaks[pedometer.next_peak] = peak_index + 1;
+      pedometer.next_peak = (pedometer.next_peak + 1) % PEDO_MIN_PEAKS;
+      if (pedometer.periodic) {
+        // Arm swing can flatten every other impact, fill gaps of whole steps
+        uint16_t steps = 1;
+        if (interval > pedometer.step_lag * 3u / 2 && interval < pedometer.step_lag * 4u) {
+          steps = (interval + pedometer.step_lag / 2) / pedometer.step_lag;
+        }
+        commitSteps(pedometer, steps);
+      } else {
+        pedometer.pending_steps++;
+      }
+    }
+
+    pedometer.previous2 = pedometer.previous;
+    pedometer.previous = y;
+
+    if (pedometer.sample_index % PEDO_AC_HOP == 0 && pedometer.sample_index >= PEDO_HISTORY) {
+      checkPeriodicity(pedometer);
+    }
+  }
+
+  return pedometer.steps - steps_before;
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+/*
+ * Streaming Pedometer for ESP32-S3 Watch
+ * Fixed-point band-pass, adaptive peaks and autocorrelation gating
+ *
+ * Accel magnitude from the IMU sample ring runs through a Q14 biquad
+ * band-pass (0.5-4Hz), then peaks above an adaptive threshold become step
+ * candidates. Candidates only count once autocorrelation of the filtered
+ * signal confirms a periodic gait, so arm gestures do not add steps. Arm
+ * swing often repeats per stride rather than per step, so the lag search
+ * covers strides and folds them back to one step. That lag gives cadence,
+ * which drives stride length and energy for the wearer's height and
+ * weight. The per-sample path is integer math, so recorded walks and runs
+ * replay on host with the same step counts as the watch.
+ */
+
+#ifndef PEDOMETER_H
+#define PEDOMETER_H
+
+#include <stdint.h>
+#include "imu_fifo.h"
+
+#define PEDO_HISTORY 192            // Filtered samples kept for autocorrelation, ~3.4s
+#define PEDO_AC_HOP 28              // Samples between periodicity checks, ~0.5s
+#define PEDO_MIN_LAG 14             // 0.25s per step, 240 spm
+#define PEDO_MAX_LAG 48             // 0.86s per step, 70 spm
+#define PEDO_MIN_THRESHOLD 40       // 0.04g in filter units (1/1024 g)
+#define PEDO_MIN_CORRELATION 50     // Percent, normalized autocorrelation
+#define PEDO_HALF_CORRELATION 20    // Step lag score that wins over its stride lag
+#define PEDO_UNCONFIRMED_CHECKS 4   // Aperiodic checks before pending steps are dropped
+#define PEDO_MIN_PEAKS 3            // Candidates inside the history before it can be periodic
+
+// Q14 second order section, direct form I
+struct PedometerBiquad {
+  int32_t x1, x2, y1, y2;
+};
+
+struct PedometerProfile {
+  uint16_t height_cm;
+  uint16_t weight_kg;
+};
+
+struct Pedometer {
+  PedometerProfile profile;
+
+  // Band-pass
+  PedometerBiquad highpass, lowpass;
+
+  // Peak picking
+  int16_t history[PEDO_HISTORY];    // Filtered signal, circular
+  uint32_t sample_index;
+  int32_t previous, previous2;
+  int32_t envelope;                 // Decaying peak amplitude
+  bool armed;                       // Signal went negative since the last step
+  uint32_t last_step_index;
+  uint32_t recent_peaks[PEDO_MIN_PEAKS];  // Sample index + 1 of the last candidates, 0 for none
+  uint8_t next_peak;
+
+  // Periodicity gate
+  bool periodic;
+  uint8_t aperiodic_checks;
+  uint16_t pending_steps;           // Candidates waiting for confirmation
+  uint16_t step_lag;                // Samples per step from autocorrelation
+  uint8_t correlation;              // Last normalized correlation, percent
+
+  // Totals
+  uint32_t steps;
+  uint32_t rejected_steps;
+  uint16_t cadence_spm;
+  float distance_m;
+  float energy_kcal;
+};
+
+void pedometerInit(Pedometer& pedometer, const PedometerProfile& profile);
+void pedometerResetTotals(Pedometer& pedometer);
+int pedometerProcess(Pedometer& pedometer, const IMUSample* samples, int count);  // Returns confirmed steps
+void pedometerAddSteps(Pedometer& pedometer, uint32_t steps);  // Steps counted elsewhere, e.g. in hardware
+float pedometerStepLength(const Pedometer& pedometer);  // Meters at the current cadence
+
+#endif // PEDOMETER_H
\ No newline at end of file
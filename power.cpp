@@ -4,22 +4,213 @@
  */
 
 #include "power.h"
+#include "reg_cache.h"
+#include "i2c_trace.h"
+#include "fuel_gauge.h"
+#include "sensors.h"
+#include "i2c_bus.h"
+#include "display.h"
+#include "themes.h"
+#include "filesystem.h"
+#include "governor.h"
+#include "touch.h"
+#include "rtc.h"
+#include "quests.h"
+#include "apps.h"
+#include "resume.h"
+#include "apl.h"
+#include <Preferences.h>
+
+#if CONFIG_PM_ENABLE
+#include "esp_pm.h"
+#if ESP_IDF_VERSION_MAJOR >= 5
+typedef esp_pm_config_t PMConfig;
+#else
+typedef esp_pm_config_esp32s3_t PMConfig;
+#endif
+#endif
 
 // Power state variables
 static PowerState current_power_state = POWER_ACTIVE;
 static BatteryInfo current_battery_info;
 static unsigned long last_battery_update = 0;
 
+// The AXP2101 has no battery current ADC, so the gauge counts charge from
+// its load model; the learned currents survive reboots in NVS
+static FuelGauge fuel_gauge;
+static bool pmic_present = false;              // Only a watch without one runs the simulated cell
+static int32_t sim_battery_uah = -1;
+static unsigned long sim_battery_time = 0;
+
+// Energy attribution: time in each power state, costed by a per-state
+// current model that can be recalibrated over Serial and lives in NVS
+static EnergyModel energy_model;
+static EnergyLedger energy_ledger;
+static uint32_t loop_busy_us = 0;
+static uint32_t light_sleep_us = 0;
+static uint32_t last_energy_us = 0;
+static uint32_t last_loop_busy = 0, last_light_sleep = 0, last_task_busy = 0, last_sd_busy = 0;
+static uint64_t last_i2c_busy = 0;
+static ScreenType energy_screen = SCREEN_SPLASH;
+static AppType energy_app = APP_WATCHFACE;
+
+static const char* const screen_names[] = {
+  "Splash", "Watch face", "App grid", "Music", "Notes", "Quests", "Settings",
+  "PDF reader", "Files", "Sleep", "Charging", "Activity", "Sleep report", "Battery use"
+};
+static_assert(ARRAY_SIZE(screen_names) == SCREEN_COUNT, "every screen needs a name");
+static_assert(SCREEN_COUNT <= ENERGY_MAX_SCREENS, "every screen needs a ledger slot");
+
+static const char* const app_names[] = {
+  "Watch", "Quests", "Music", "Notes", "Files", "Settings", "PDF", "Weather", "Games"
+};
+
+// CPU clock follows frame pressure and pending work. With power management
+// in the SDK a CPU_FREQ_MAX lock is held while awake and the governor moves
+// the maximum; without it the clock is set directly
+static Governor cpu_governor;
+static uint32_t last_governor_sd_busy = 0;
+static unsigned long last_sd_activity = 0;
+#if CONFIG_PM_ENABLE
+static esp_pm_lock_handle_t cpu_lock = nullptr;
+#endif
+
+// Panel current held to a budget from each frame's picture level
+static AplLimiter display_limiter;
+static ScreenType limiter_screen = SCREEN_SPLASH;
+
+// What the user would miss after a deep sleep, in RTC slow memory, which
+// stays powered through it; a power cycle clears it and fails the seal
+RTC_DATA_ATTR static ResumeState resume_state;
+static uint32_t warm_boots = 0;
+
+// AXP2101 register shadow: status and ADC age out, rail controls only
+// change through our own writes, PWR_INT drops everything
+static RegCacheEntry pmic_registers[0x80];
+static RegCache pmic_cache;
+
+// Light sleep wake lines, restored to their edge interrupts afterwards
+enum WakeLine {
+  WAKE_LINE_IMU,
+  WAKE_LINE_TOUCH,
+  WAKE_LINE_PMIC,
+  WAKE_LINE_RTC,
+  WAKE_LINE_BTN_PWR,
+  WAKE_LINE_BTN_BOOT,
+  WAKE_LINE_COUNT
+};
+
+struct WakeLinePin {
+  int pin;
+  gpio_int_type_t restore;
+};
+
+static const WakeLinePin wake_lines[WAKE_LINE_COUNT] = {
+  {IMU_INT, GPIO_INTR_POSEDGE},
+  {TOUCH_INT, GPIO_INTR_DISABLE},   // Polled
+  {PWR_INT, GPIO_INTR_NEGEDGE},
+  {RTC_INT, GPIO_INTR_NEGEDGE},
+  {BTN_PWR, GPIO_INTR_ANYEDGE},
+  {BTN_BOOT, GPIO_INTR_ANYEDGE}
+};
+
+// Last edge on each button, stamped by its interrupt or by the wake it
+// caused, so press timing does not depend on when the loop looks
+static volatile unsigned long button_edge_ms[2] = {0, 0};
+
+static void IRAM_ATTR onPowerButton() {
+  button_edge_ms[0] = millis();
+}
+
+static void IRAM_ATTR onBootButton() {
+  button_edge_ms[1] = millis();
+}
+
+static void IRAM_ATTR onPowerInterrupt() {
+  regCacheInvalidateFromISR(pmic_cache);
+}
+
+static void loadFuelModel() {
+  uint32_t load_ua[FUEL_LOAD_COUNT] = {};
+  Preferences preferences;
+  preferences.begin("fuel", true);
+  size_t length = preferences.getBytes("model", load_ua, sizeof(load_ua));
+  preferences.end();
+  if (length == sizeof(load_ua)) fuelGaugeSetModel(fuel_gauge, load_ua);
+}
+
+static void saveFuelModel() {
+  uint32_t load_ua[FUEL_LOAD_COUNT];
+  for (int load = 0; load < FUEL_LOAD_COUNT; load++) {
+    load_ua[load] = fuelGaugeLoadCurrent(fuel_gauge, (FuelLoad)load);
+  }
+  Preferences preferences;
+  preferences.begin("fuel", false);
+  preferences.putBytes("model", load_ua, sizeof(load_ua));
+  preferences.end();
+  fuel_gauge.model_changed = false;
+}
+
+static void loadEnergyModel() {
+  energyModelDefaults(energy_model);
+  EnergyModel stored;
+  Preferences preferences;
+  preferences.begin("energy", true);
+  size_t length = preferences.getBytes("model", &stored, sizeof(stored));
+  preferences.end();
+  if (length == sizeof(stored)) energy_model = stored;
+}
+
+static void saveEnergyModel() {
+  Preferences preferences;
+  preferences.begin("energy", false);
+  preferences.putBytes("model", &energy_model, sizeof(energy_model));
+  preferences.end();
+}
+
+static int simulatedBatteryVoltage(unsigned long now) {
+  // Without the PMIC a cell drains at the model's current, from 80%
+  FuelLoad load = fuel_gauge.load;
+  if (sim_battery_uah < 0) {
+    sim_battery_uah = BATTERY_CAPACITY_MAH * 800;
+  } else {
+    sim_battery_uah -= (int32_t)((uint64_t)fuelGaugeLoadCurrent(fuel_gauge, load) * (now - sim_battery_time) / 3600000);
+    if (sim_battery_uah < 0) sim_battery_uah = 0;
+  }
+  sim_battery_time = now;
+  
+  int permille = sim_battery_uah / BATTERY_CAPACITY_MAH;
+  int drop_mv = fuelGaugeLoadCurrent(fuel_gauge, load) / 1000 * FUEL_RESISTANCE_MOHM / 1000;
+  return fuelPermilleToOcv(permille) - drop_mv;
+}
+
 bool initializePower() {
   Serial.println("Initializing power management...");
   
-  // Initialize I2C for AXP2101
-  Wire1.begin(PWR_SDA, PWR_SCL);
-  Wire1.setClock(400000);
+  regCacheInit(pmic_cache, "pmic", I2C_DEV_PMIC, 0x00, pmic_registers, 0x80);
+  regCacheSetPolicy(pmic_cache, 0x00, 2, 1000);              // Power status
+  regCacheSetPolicy(pmic_cache, 0x10, 16, REG_AGE_FOREVER);  // DCDC/LDO and charger control
+  regCacheSetPolicy(pmic_cache, 0x78, 2, 2000);              // Battery voltage ADC
+  
+  FuelGaugeProfile profile = {BATTERY_CAPACITY_MAH, BATTERY_CHARGE_MA, {BATTERY_ACTIVE_UA, BATTERY_SLEEP_UA}};
+  fuelGaugeInit(fuel_gauge, profile);
+  loadFuelModel();
+  loadEnergyModel();
+  resetEnergyLedger();
+  initializeCpuGovernor();
+  initializeDisplayLimiter();
+  
+  pinMode(PWR_INT, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(PWR_INT), onPowerInterrupt, FALLING);
+  
+  pinMode(BTN_PWR, INPUT_PULLUP);
+  pinMode(BTN_BOOT, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(BTN_PWR), onPowerButton, CHANGE);
+  attachInterrupt(digitalPinToInterrupt(BTN_BOOT), onBootButton, CHANGE);
   
   // AXP2101 I2C address is typically 0x34
-  Wire1.beginTransmission(0x34);
-  if (Wire1.endTransmission() != 0) {
+  pmic_present = i2cProbe(I2C_DEV_PMIC);
+  if (!pmic_present) {
     Serial.println("AXP2101 power management IC not found!");
     // Continue with simulated power management
   } else {
@@ -27,22 +218,13 @@ bool initializePower() {
     
     // Configure AXP2101 power rails
     // Enable DCDC1 (3.3V for system)
-    Wire1.beginTransmission(0x34);
-    Wire1.write(0x10); // DCDC1 control register
-    Wire1.write(0x80); // Enable DCDC1
-    Wire1.endTransmission();
+    regCacheWriteReg(pmic_cache, 0x10, 0x80, millis()); // DCDC1 control register
     
     // Enable LDO2 (Display power)
-    Wire1.beginTransmission(0x34);
-    Wire1.write(0x12); // LDO2 control register
-    Wire1.write(0x80); // Enable LDO2
-    Wire1.endTransmission();
+    regCacheWriteReg(pmic_cache, 0x12, 0x80, millis()); // LDO2 control register
     
     // Configure battery charging
-    Wire1.beginTransmission(0x34);
-    Wire1.write(0x18); // Charging control register
-    Wire1.write(0xC0); // Enable charging, 4.2V target
-    Wire1.endTransmission();
+    regCacheWriteReg(pmic_cache, 0x18, 0xC0, millis()); // Charging control: enable, 4.2V target
   }
   
   // Initialize battery info
@@ -65,77 +247,83 @@ bool initializePower() {
 BatteryInfo updateBatteryStatus() {
   unsigned long current_time = millis();
   
+  // Charge is counted per load, so a screen change is booked when it happens
+  FuelLoad load = system_state.current_screen == SCREEN_SLEEP ? FUEL_LOAD_SLEEP : FUEL_LOAD_ACTIVE;
+  fuelGaugeSetLoad(fuel_gauge, load, current_time);
+  
   // Update battery status every 30 seconds
-  if (current_time - last_battery_update < 30000) {
+  if (current_time - last_battery_update < BATTERY_UPDATE_INTERVAL) {
     return current_battery_info;
   }
   
   last_battery_update = current_time;
+  I2CCaller previous_caller = i2cTraceSetCaller(I2C_CALLER_POWER);
   
   // Read battery voltage from AXP2101
-  Wire1.beginTransmission(0x34);
-  Wire1.write(0x78); // Battery voltage register
-  Wire1.endTransmission();
-  
-  Wire1.requestFrom(0x34, 2);
-  if (Wire1.available() >= 2) {
-    uint16_t voltage_raw = (Wire1.read() << 4) | (Wire1.read() & 0x0F);
+  uint8_t voltage_regs[2];
+  if (!pmic_present) {
+    current_battery_info.voltage_mv = simulatedBatteryVoltage(current_time);
+  } else if (regCacheRead(pmic_cache, 0x78, voltage_regs, sizeof(voltage_regs), current_time)) { // Battery voltage register
+    uint16_t voltage_raw = (voltage_regs[0] << 4) | (voltage_regs[1] & 0x0F);
     current_battery_info.voltage_mv = voltage_raw * 1.1; // Convert to mV
   } else {
-    // Simulate battery discharge
-    static int sim_battery = 80;
-    if (current_time % 60000 == 0 && sim_battery > 0) { // Every minute
-      sim_battery--;
-    }
-    current_battery_info.voltage_mv = 3200 + (sim_battery * 600 / 100); // 3.2V to 3.8V range
-  }
-  
-  // Convert voltage to percentage (simplified)
-  if (current_battery_info.voltage_mv >= 4100) {
-    current_battery_info.percentage = 100;
-  } else if (current_battery_info.voltage_mv >= 3900) {
-    current_battery_info.percentage = 80 + (current_battery_info.voltage_mv - 3900) * 20 / 200;
-  } else if (current_battery_info.voltage_mv >= 3700) {
-    current_battery_info.percentage = 40 + (current_battery_info.voltage_mv - 3700) * 40 / 200;
-  } else if (current_battery_info.voltage_mv >= 3400) {
-    current_battery_info.percentage = 10 + (current_battery_info.voltage_mv - 3400) * 30 / 300;
-  } else {
-    current_battery_info.percentage = (current_battery_info.voltage_mv - 3200) * 10 / 200;
+    // A failed read is not a voltage: leave the gauge and its model alone
+    // until the next update rather than anchor them to a made-up cell
+    i2cTraceSetCaller(previous_caller);
+    return current_battery_info;
   }
   
-  // Ensure percentage is within bounds
-  if (current_battery_info.percentage > 100) current_battery_info.percentage = 100;
-  if (current_battery_info.percentage < 0) current_battery_info.percentage = 0;
-  
   // Check charging status
-  Wire1.beginTransmission(0x34);
-  Wire1.write(0x01); // Power status register
-  Wire1.endTransmission();
-  
-  Wire1.requestFrom(0x34, 1);
-  if (Wire1.available()) {
-    uint8_t power_status = Wire1.read();
+  uint8_t power_status;
+  if (regCacheRead(pmic_cache, 0x01, &power_status, 1, current_time)) { // Power status register
     current_battery_info.is_charging = (power_status & 0x04) != 0;
     current_battery_info.is_plugged = (power_status & 0x20) != 0;
   }
   
-  // Calculate estimated runtime
+  // The IMU sits next to the cell, close enough for its resistance and capacity
+  SensorSnapshot sensors;
+  bool has_temperature = getSensorSnapshot(sensors) && sensors.temperature_valid;
+  current_battery_info.temperature = has_temperature ? sensors.temperature_c10 / 10 : 25;
+  
+  FuelGaugeInput input;
+  input.now_ms = current_time;
+  input.voltage_mv = current_battery_info.voltage_mv;
+  input.current_ma = 0;
+  input.current_valid = false;
+  input.temperature_c10 = has_temperature ? sensors.temperature_c10 : 250;
+  input.charging = current_battery_info.is_charging;
+  input.plugged = current_battery_info.is_plugged;
+  fuelGaugeUpdate(fuel_gauge, input);
+  if (fuel_gauge.model_changed) saveFuelModel();
+  
+  current_battery_info.percentage = fuelGaugePercent(fuel_gauge);
+  current_battery_info.current_ma = (int)fuel_gauge.current_ma;
   if (current_battery_info.is_charging) {
     current_battery_info.estimated_runtime = 0xFFFFFFFF; // Infinite while charging
-    current_battery_info.charge_time_remaining = (100 - current_battery_info.percentage) * 60; // ~1% per minute
+    current_battery_info.charge_time_remaining = fuelGaugeChargeMinutes(fuel_gauge) * 60;
   } else {
-    // Estimate based on current consumption and battery level
-    int estimated_hours = current_battery_info.percentage * 12 / 100; // 12 hours at 100%
-    current_battery_info.estimated_runtime = estimated_hours * 3600;
+    // Usable charge over the learned current at the recent screen-on/asleep mix
+    current_battery_info.estimated_runtime = fuelGaugeRuntimeMinutes(fuel_gauge) * 60;
+    current_battery_info.charge_time_remaining = 0;
   }
   
   // Update system state
   system_state.battery_percentage = current_battery_info.percentage;
   system_state.is_charging = current_battery_info.is_charging;
   
+  i2cTraceSetCaller(previous_caller);
   return current_battery_info;
 }
 
+unsigned long powerDueIn() {
+  unsigned long elapsed = millis() - last_battery_update;
+  return elapsed < BATTERY_UPDATE_INTERVAL ? BATTERY_UPDATE_INTERVAL - elapsed : 0;
+}
+
+unsigned long buttonEdgeTime(int pin) {
+  return pin == BTN_PWR ? button_edge_ms[0] : button_edge_ms[1];
+}
+
 int getBatteryPercentage() {
   return current_battery_info.percentage;
 }
@@ -197,14 +385,144 @@ void enterSleepMode() {
 void enterDeepSleepMode() {
   setPowerState(POWER_DEEP_SLEEP);
   
+  // The IMU counts steps from here; once the task has switched over it is
+  // paused, so the counters and the activity log hold still to be saved
+  enterMotionSleep();
+  unsigned long settle_start = millis();
+  while (!sensorsCaughtUp() && millis() - settle_start < 500) delay(1);
+  pauseSensorTask();
+  saveResumeState();
+  
   // Configure wake sources
   esp_sleep_enable_ext0_wakeup(GPIO_NUM_0, 0); // PWR button
-  esp_sleep_enable_ext1_wakeup(GPIO_NUM_10, ESP_EXT1_WAKEUP_ANY_HIGH); // Touch interrupt
+  esp_sleep_enable_ext1_wakeup(1ULL << TOUCH_INT, ESP_EXT1_WAKEUP_ALL_LOW); // Touch interrupt, low while touched
   
   // Enter deep sleep
   esp_deep_sleep_start();
 }
 
+// ==================== WARM RESUME ====================
+static uint32_t resumeMinuteNow() {
+  WatchTime now = getCurrentTime();
+  return activityLogMinuteOf(now.year, now.month, now.day, now.hour, now.minute);
+}
+
+void saveResumeState() {
+  // Padding is under the checksum too
+  memset(&resume_state, 0, sizeof(resume_state));
+  
+  ResumeSystem& system = resume_state.system;
+  system.screen = system_state.current_screen;
+  system.theme = system_state.current_theme;
+  system.app = system_state.current_app;
+  system.flags = (system_state.low_battery_warning ? RESUME_SYSTEM_LOW_BATTERY : 0) |
+                 (system_state.music_playing ? RESUME_SYSTEM_MUSIC_PLAYING : 0);
+  system.brightness = system_state.brightness;
+  system.wake_time = system_state.wake_time;
+  system.sleep_time = system_state.sleep_time;
+  system.current_quest = system_state.current_quest;
+  system.current_song = system_state.current_song;
+  system.total_mp3_files = system_state.total_mp3_files;
+  system.total_pdf_files = system_state.total_pdf_files;
+  system.steps_today = system_state.steps_today;
+  system.step_goal = system_state.step_goal;
+  
+  saveSensorResume(resume_state.steps);
+  saveQuestResume(resume_state.quests);
+  saveMusicResume(resume_state.media);
+  resume_state.warm_boots = warm_boots;
+  resumeSeal(resume_state, resumeMinuteNow());
+}
+
+bool hasResumeState() {
+  // Only a deep sleep wake finds the block as it was left
+  return esp_reset_reason() == ESP_RST_DEEPSLEEP && resumeValid(resume_state);
+}
+
+bool restoreResumeState() {
+  if (!hasResumeState()) {
+    resumeInvalidate(resume_state);
+    warm_boots = 0;
+    return false;
+  }
+  
+  uint32_t now_minute = resumeMinuteNow();
+  uint32_t asleep_ms = resumeAsleepMs(resume_state, now_minute);
+  bool same_day = resumeSameDay(resume_state, now_minute);
+  
+  // Back on the watch face, whatever was open; apps start over when launched
+  const ResumeSystem& system = resume_state.system;
+  system_state.current_screen = SCREEN_WATCHFACE;
+  system_state.current_app = APP_WATCHFACE;
+  system_state.current_theme = (ThemeType)system.theme;
+  system_state.low_battery_warning = system.flags & RESUME_SYSTEM_LOW_BATTERY;
+  system_state.music_playing = false;
+  system_state.low_power_mode = false;
+  system_state.brightness = system.brightness;
+  system_state.wake_time = system.wake_time;
+  system_state.sleep_time = system.sleep_time;
+  system_state.current_quest = system.current_quest;
+  system_state.current_song = system.current_song;
+  system_state.total_mp3_files = system.total_mp3_files;
+  system_state.total_pdf_files = system.total_pdf_files;
+  system_state.steps_today = same_day ? system.steps_today : 0;
+  system_state.step_goal = system.step_goal;
+  
+  restoreSensorResume(resume_state.steps, same_day);
+  restoreQuestResume(resume_state.quests, asleep_ms, same_day);
+  restoreMusicResume(resume_state.media);
+  
+  warm_boots = resume_state.warm_boots + 1;
+  Serial.printf("Warm boot %lu: %lu min in deep sleep from %s%s\n", (unsigned long)warm_boots,
+                (unsigned long)(asleep_ms / 60000), getScreenName(system.screen),
+                same_day ? "" : ", new day");
+  
+  // Used once: a crash or reset later must not bring back stale state
+  resumeInvalidate(resume_state);
+  return true;
+}
+
+WakeCause lightSleepUntilEvent(uint32_t max_ms) {
+  // Every line wakes on the level it is not at now: wake-on-motion toggles
+  // IMU_INT, and a held button or an uncleared PMIC interrupt must not keep
+  // the chip awake
+  int levels[WAKE_LINE_COUNT];
+  for (int line = 0; line < WAKE_LINE_COUNT; line++) {
+    levels[line] = digitalRead(wake_lines[line].pin);
+    gpio_wakeup_enable((gpio_num_t)wake_lines[line].pin, levels[line] ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+  }
+  esp_sleep_enable_gpio_wakeup();
+  esp_sleep_enable_timer_wakeup((uint64_t)max_ms * 1000);
+  
+  Serial.flush();
+  uint32_t sleep_start = micros();
+  esp_light_sleep_start();
+  light_sleep_us += micros() - sleep_start;
+  unsigned long woke = millis();
+  
+  bool by_gpio = esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO;
+  bool changed[WAKE_LINE_COUNT];
+  for (int line = 0; line < WAKE_LINE_COUNT; line++) {
+    changed[line] = digitalRead(wake_lines[line].pin) != levels[line];
+  }
+  
+  // Hand the pins back to their normal edge interrupts. Button edges that
+  // ended the sleep never reached their ISR, so the wake stamps them
+  for (int line = 0; line < WAKE_LINE_COUNT; line++) {
+    gpio_wakeup_disable((gpio_num_t)wake_lines[line].pin);
+    gpio_set_intr_type((gpio_num_t)wake_lines[line].pin, wake_lines[line].restore);
+  }
+  esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER);
+  if (changed[WAKE_LINE_BTN_PWR]) button_edge_ms[0] = woke;
+  if (changed[WAKE_LINE_BTN_BOOT]) button_edge_ms[1] = woke;
+  
+  if (!by_gpio) return WAKE_TIMER;
+  if (changed[WAKE_LINE_IMU]) return WAKE_MOTION;
+  if (changed[WAKE_LINE_PMIC]) return WAKE_PMIC;
+  if (changed[WAKE_LINE_RTC]) return WAKE_RTC;
+  return WAKE_INPUT;
+}
+
 void wakeFromSleep() {
   setPowerState(POWER_ACTIVE);
   system_state.low_power_mode = false;
@@ -227,10 +545,9 @@ void setPowerRail(int rail, bool enabled) {
   uint8_t rail_reg = 0x10 + rail; // DCDC/LDO control registers start at 0x10
   uint8_t rail_value = enabled ? 0x80 : 0x00;
   
-  Wire1.beginTransmission(0x34);
-  Wire1.write(rail_reg);
-  Wire1.write(rail_value);
-  Wire1.endTransmission();
+  I2CCaller previous_caller = i2cTraceSetCaller(I2C_CALLER_POWER);
+  regCacheWriteReg(pmic_cache, rail_reg, rail_value, millis());
+  i2cTraceSetCaller(previous_caller);
 }
 
 void setWiFiPower(bool enabled) {
@@ -259,9 +576,123 @@ void setAudioPower(bool enabled) {
   setPowerRail(4, enabled); // Assuming audio on LDO4
 }
 
+// ==================== CPU GOVERNOR ====================
+static void applyCpuLevel(int level) {
+  uint16_t mhz = governorLevelMhz(level);
+  if (getCpuFrequencyMhz() == mhz) return;
+#if CONFIG_PM_ENABLE
+  // The held lock keeps the CPU at the configured maximum; light sleep
+  // stays manual
+  PMConfig config = {};
+  config.max_freq_mhz = mhz;
+  config.min_freq_mhz = governorLevelMhz(GOVERNOR_80MHZ);
+  config.light_sleep_enable = false;
+  if (cpu_lock != nullptr && esp_pm_configure(&config) == ESP_OK) return;
+#endif
+  setCpuFrequencyMhz(mhz);
+}
+
+void initializeCpuGovernor() {
+  GovernorProfile profile = {UI_UPDATE_INTERVAL * 1000, GOVERNOR_TARGET_LOAD, GOVERNOR_DOWN_HOLD_MS,
+                             GOVERNOR_DWELL_MS, 3};
+  governorInit(cpu_governor, profile, GOVERNOR_240MHZ);
+#if CONFIG_PM_ENABLE
+  if (esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "governor", &cpu_lock) == ESP_OK) {
+    esp_pm_lock_acquire(cpu_lock);
+  } else {
+    cpu_lock = nullptr;
+  }
+#endif
+  applyCpuLevel(GOVERNOR_240MHZ);
+}
+
+void updateCpuGovernor(uint32_t frame_us, bool animating) {
+  // SD work counts as pending for a moment after the last transfer
+  uint32_t sd_busy = getSDBusyMicros();
+  if (sd_busy != last_governor_sd_busy) last_sd_activity = millis();
+  last_governor_sd_busy = sd_busy;
+  
+  GovernorInput input;
+  input.now_ms = millis();
+  input.frame_us = frame_us;
+  input.animating = animating;
+  input.touching = isTouchPressed();
+  input.audio = system_state.music_playing;
+  input.sd_busy = millis() - last_sd_activity < GOVERNOR_SD_LINGER_MS;
+  applyCpuLevel(governorUpdate(cpu_governor, input));
+}
+
+void reportCpuGovernor() {
+  const GovernorStats& stats = cpu_governor.stats;
+  uint64_t total = 0;
+  for (int level = 0; level < GOVERNOR_LEVELS; level++) total += stats.residency_ms[level];
+  if (total == 0) return;
+  Serial.printf("CPU: 80MHz %d%%, 160MHz %d%%, 240MHz %d%%, %lu switches, %lu/%lu frames over budget, now %d MHz\n",
+                (int)(stats.residency_ms[GOVERNOR_80MHZ] * 100 / total),
+                (int)(stats.residency_ms[GOVERNOR_160MHZ] * 100 / total),
+                (int)(stats.residency_ms[GOVERNOR_240MHZ] * 100 / total),
+                (unsigned long)stats.switches, (unsigned long)stats.over_budget, (unsigned long)stats.frames,
+                governorLevelMhz(cpu_governor.level));
+}
+
+const GovernorStats& getCpuGovernorStats() {
+  return cpu_governor.stats;
+}
+
+// ==================== DISPLAY LIMITER ====================
+void initializeDisplayLimiter() {
+  AplLimiterProfile profile = {DISPLAY_POWER_BUDGET_UA, DISPLAY_LOW_BATTERY_BUDGET_UA, DISPLAY_LOW_BATTERY_PERCENT,
+                               DISPLAY_MIN_BRIGHTNESS, DISPLAY_DIM_STEP, DISPLAY_DARK_HOLD_MS};
+  aplLimiterInit(display_limiter, profile);
+}
+
+bool updateDisplayLimiter() {
+#if ENABLE_DISPLAY_LIMITER
+  if (system_state.current_screen != limiter_screen) {
+    aplLimiterScreenChanged(display_limiter);
+    limiter_screen = system_state.current_screen;
+  }
+  
+  AplLimiterInput input;
+  input.now_ms = millis();
+  input.apl = getFrameAPL();
+  input.requested = constrain(getDisplayBrightnessSetting(), 0, 100);
+  input.battery_percent = constrain(current_battery_info.percentage, 0, 100);
+  input.charging = current_battery_info.is_charging;
+  setDisplayBrightnessLimit(aplLimiterUpdate(display_limiter, energy_model, input));
+  
+  // A new variant needs a redraw to show
+  if (display_limiter.dark == isThemeDark()) return false;
+  setThemeDark(display_limiter.dark);
+  Serial.printf("Display: %s variant at APL %d.%d%%\n", display_limiter.dark ? "dark" : "normal",
+                input.apl / 10, input.apl % 10);
+  return true;
+#else
+  return false;
+#endif
+}
+
+void reportDisplayLimiter() {
+  const AplLimiterStats& stats = display_limiter.stats;
+  if (stats.updates == 0) return;
+  uint16_t bins[APL_HISTOGRAM_BINS];
+  getFrameAPLHistogram(bins);
+  char histogram[APL_HISTOGRAM_BINS * 5 + 1];
+  int length = 0;
+  for (int bin = 0; bin < APL_HISTOGRAM_BINS; bin++) {
+    length += snprintf(histogram + length, sizeof(histogram) - length, bin ? " %d" : "%d", bins[bin]);
+  }
+  uint16_t apl = getFrameAPL();
+  Serial.printf("Display: APL %d.%d%% [%s], %d/%d%% brightness, %lu s limited, %lu s dark (%lu switches)\n",
+                apl / 10, apl % 10, histogram, getDisplayBrightness(), getDisplayBrightnessSetting(),
+                (unsigned long)(stats.limited_ms / 1000), (unsigned long)(stats.dark_ms / 1000),
+                (unsigned long)stats.dark_switches);
+}
+
 void enableLowPowerMode() {
-  // Reduce CPU frequency
-  setCpuFrequencyMhz(80); // Reduce from 240MHz to 80MHz
+  // Cap the governor at 80MHz
+  governorSetCeiling(cpu_governor, GOVERNOR_80MHZ);
+  applyCpuLevel(GOVERNOR_80MHZ);
   
   // Reduce peripheral clocks
   setSensorPower(false);
@@ -271,8 +702,8 @@ void enableLowPowerMode() {
 }
 
 void disableLowPowerMode() {
-  // Restore full CPU frequency
-  setCpuFrequencyMhz(240);
+  // Let the governor use the full range again
+  governorSetCeiling(cpu_governor, GOVERNOR_240MHZ);
   
   // Re-enable peripherals
   setSensorPower(true);
@@ -396,17 +827,203 @@ void logPowerUsage() {
   Serial.println("Voltage: " + String(current_battery_info.voltage_mv) + "mV");
   Serial.println("Charging: " + String(current_battery_info.is_charging ? "Yes" : "No"));
   Serial.println("Estimated runtime: " + String(current_battery_info.estimated_runtime / 3600) + "h");
+  reportEnergy();
 }
 
 int getEstimatedRuntime() {
   return current_battery_info.estimated_runtime;
 }
 
+void reportFuelGauge() {
+  const FuelGaugeStats& stats = fuel_gauge.stats;
+  Serial.printf("Battery: %d%%, %d mV, %d mA %s, %dC, %lu min left, model %.1f/%.2f mA, %lu corrections (last %+.1f mAh), %lu checkpoints\n",
+                current_battery_info.percentage, current_battery_info.voltage_mv, current_battery_info.current_ma,
+                fuel_gauge.measured ? "measured" : "modelled", current_battery_info.temperature,
+                (unsigned long)(current_battery_info.estimated_runtime / 60),
+                fuelGaugeLoadCurrent(fuel_gauge, FUEL_LOAD_ACTIVE) / 1000.0, fuelGaugeLoadCurrent(fuel_gauge, FUEL_LOAD_SLEEP) / 1000.0,
+                (unsigned long)stats.corrections, stats.last_correction_uah / 1000.0, (unsigned long)stats.checkpoints);
+}
+
 void generatePowerReport() {
   logPowerUsage();
   
-  // Additional power analysis
+  // Where the charge went since the ledger was reset
+  const EnergyLedger& ledger = energy_ledger;
+  uint64_t total = energyLedgerTotal(ledger);
   Serial.println("Power State: " + String(current_power_state));
   Serial.println("Low Power Mode: " + String(system_state.low_power_mode ? "Enabled" : "Disabled"));
   Serial.println("Display Brightness: " + String(system_state.brightness) + "%");
+  for (int subsystem = 0; subsystem < ENERGY_SUBSYSTEM_COUNT; subsystem++) {
+    Serial.printf("  %-8s %7.2f mAh %3d%%\n", energySubsystemName(subsystem),
+                  energyMilliampHours(ledger.subsystem_uams[subsystem]),
+                  total ? (int)(ledger.subsystem_uams[subsystem] * 100 / total) : 0);
+  }
+  for (int screen = 0; screen < ENERGY_MAX_SCREENS; screen++) {
+    if (ledger.screen_us[screen] == 0) continue;
+    uint16_t apl = energyScreenLuminance(ledger, screen);
+    Serial.printf("  %-12s %6lu s %7.2f mAh %6.2f mA, display %6.2f mA at APL %d.%d%%\n", getScreenName(screen),
+                  (unsigned long)(ledger.screen_us[screen] / 1000000), energyMilliampHours(ledger.screen_uams[screen]),
+                  energyScreenCurrent(ledger, screen) / 1000.0, energyScreenDisplayCurrent(ledger, screen) / 1000.0,
+                  apl / 10, apl % 10);
+  }
+  for (int app = 0; app < ENERGY_MAX_APPS; app++) {
+    if (ledger.app_us[app] == 0) continue;
+    Serial.printf("  %-12s %6lu s %7.2f mAh\n", getAppName(app),
+                  (unsigned long)(ledger.app_us[app] / 1000000), energyMilliampHours(ledger.app_uams[app]));
+  }
+}
+
+// ==================== ENERGY ATTRIBUTION ====================
+const char* getScreenName(int screen) {
+  if (screen < 0 || screen >= (int)ARRAY_SIZE(screen_names)) return "?";
+  return screen_names[screen];
+}
+
+const char* getAppName(int app) {
+  if (app < 0 || app >= (int)ARRAY_SIZE(app_names)) return "?";
+  return app_names[app];
+}
+
+static uint16_t governorMeanMhz() {
+  // The clock the governor ran at over the interval, by residency
+  static uint64_t last_residency[GOVERNOR_LEVELS] = {};
+  uint64_t weighted = 0, total = 0;
+  for (int level = 0; level < GOVERNOR_LEVELS; level++) {
+    uint64_t spent = cpu_governor.stats.residency_ms[level] - last_residency[level];
+    last_residency[level] = cpu_governor.stats.residency_ms[level];
+    weighted += spent * governorLevelMhz(level);
+    total += spent;
+  }
+  return total ? (uint16_t)(weighted / total) : getCpuFrequencyMhz();
+}
+
+static uint64_t i2cBusyMicros() {
+  uint64_t busy = 0;
+  for (int device = 0; device < I2C_DEV_COUNT; device++) {
+    busy += i2cGetDeviceInfo((I2CDeviceId)device).bus_time_us;
+  }
+  return busy;
+}
+
+void noteLoopBusy(uint32_t busy_us) {
+  loop_busy_us += busy_us;
+}
+
+void updateEnergyAccounting() {
+  // Book the interval to the screen and app it was spent on, so a change
+  // closes it early
+  uint32_t now = micros();
+  uint32_t elapsed = now - last_energy_us;
+  if (elapsed < ENERGY_SAMPLE_MS * 1000UL && system_state.current_screen == energy_screen &&
+      system_state.current_app == energy_app) {
+    return;
+  }
+  
+  SensorSnapshot sensors;
+  bool has_sensors = getSensorSnapshot(sensors);
+  uint32_t task_busy = has_sensors ? sensors.busy_us : last_task_busy;
+  uint32_t sd_busy = getSDBusyMicros();
+  uint64_t i2c_busy = i2cBusyMicros();
+  
+  EnergySample sample;
+  sample.interval_us = elapsed;
+  sample.sleep_us = light_sleep_us - last_light_sleep;
+  sample.busy_us[0] = task_busy - last_task_busy;       // Sensor task on core 0
+  sample.busy_us[1] = loop_busy_us - last_loop_busy;    // Loop and display on core 1
+  sample.cpu_mhz = governorMeanMhz();
+  sample.display_on = current_power_state != POWER_DEEP_SLEEP;
+  sample.brightness = constrain(getDisplayBrightness(), 0, 100);
+  sample.luminance = getFrameAPL();
+  sample.sd_us = sd_busy - last_sd_busy;
+  sample.audio_on = system_state.music_playing;
+  sample.imu_mode = !has_sensors ? ENERGY_IMU_FULL : sensors.motion_sleep ? ENERGY_IMU_LOW : ENERGY_IMU_FULL;
+  sample.i2c_us = (uint32_t)(i2c_busy - last_i2c_busy);
+  sample.screen = energy_screen;
+  sample.app = energy_app;
+  if (last_energy_us != 0) energyAccount(energy_ledger, energy_model, sample);
+  
+  last_energy_us = now;
+  last_light_sleep = light_sleep_us;
+  last_task_busy = task_busy;
+  last_loop_busy = loop_busy_us;
+  last_sd_busy = sd_busy;
+  last_i2c_busy = i2c_busy;
+  energy_screen = system_state.current_screen;
+  energy_app = system_state.current_app;
+}
+
+const EnergyLedger& getEnergyLedger() {
+  return energy_ledger;
+}
+
+void resetEnergyLedger() {
+  energyLedgerReset(energy_ledger);
+}
+
+bool calibrateEnergyModel(int coefficient, uint32_t ua) {
+  if (!energyModelSet(energy_model, coefficient, ua)) return false;
+  saveEnergyModel();
+  Serial.printf("Energy model: %s = %lu uA\n", energyCoefficientName(coefficient), (unsigned long)ua);
+  return true;
+}
+
+void reportEnergy() {
+  // The screen-asleep and screen-on means are what the fuel gauge learns,
+  // so the two side by side show which way to calibrate the model
+  const EnergyLedger& ledger = energy_ledger;
+  if (ledger.total_us == 0) return;
+  uint64_t asleep_us = ledger.screen_us[SCREEN_SLEEP];
+  uint64_t awake_us = ledger.total_us - asleep_us;
+  uint64_t awake_uams = energyLedgerTotal(ledger) - ledger.screen_uams[SCREEN_SLEEP];
+  uint64_t total = energyLedgerTotal(ledger);
+  Serial.printf("Energy: %.2f mAh over %lu min, %.2f mA mean; display %d%%, cpu %d%%, other %d%%; "
+                "model %.1f/%.2f mA vs gauge %.1f/%.2f mA\n",
+                energyMilliampHours(total), (unsigned long)(ledger.total_us / 60000000),
+                energyAverageCurrent(ledger) / 1000.0,
+                total ? (int)(ledger.subsystem_uams[ENERGY_DISPLAY] * 100 / total) : 0,
+                total ? (int)(ledger.subsystem_uams[ENERGY_CPU] * 100 / total) : 0,
+                total ? (int)((total - ledger.subsystem_uams[ENERGY_DISPLAY] - ledger.subsystem_uams[ENERGY_CPU]) * 100 / total) : 0,
+                awake_us ? (double)awake_uams / awake_us : 0.0,
+                energyScreenCurrent(ledger, SCREEN_SLEEP) / 1000.0,
+                fuelGaugeLoadCurrent(fuel_gauge, FUEL_LOAD_ACTIVE) / 1000.0,
+                fuelGaugeLoadCurrent(fuel_gauge, FUEL_LOAD_SLEEP) / 1000.0);
+}
+
+void exportEnergyCSV() {
+  // One record per line: kind, name, seconds, mAh; model lines carry uA,
+  // apl lines permille
+  const EnergyLedger& ledger = energy_ledger;
+  Serial.printf("energy,total,all,%.3f,%.4f\n", ledger.total_us / 1000000.0, energyMilliampHours(energyLedgerTotal(ledger)));
+  for (int subsystem = 0; subsystem < ENERGY_SUBSYSTEM_COUNT; subsystem++) {
+    Serial.printf("energy,subsystem,%s,%.3f,%.4f\n", energySubsystemName(subsystem),
+                  ledger.total_us / 1000000.0, energyMilliampHours(ledger.subsystem_uams[subsystem]));
+  }
+  for (int screen = 0; screen < ENERGY_MAX_SCREENS; screen++) {
+    if (ledger.screen_us[screen] == 0) continue;
+    Serial.printf("energy,screen,%s,%.3f,%.4f\n", getScreenName(screen),
+                  ledger.screen_us[screen] / 1000000.0, energyMilliampHours(ledger.screen_uams[screen]));
+    Serial.printf("energy,display,%s,%.3f,%.4f\n", getScreenName(screen),
+                  ledger.screen_us[screen] / 1000000.0, energyMilliampHours(ledger.screen_display_uams[screen]));
+    Serial.printf("energy,apl,%s,%.3f,%d\n", getScreenName(screen),
+                  ledger.screen_us[screen] / 1000000.0, energyScreenLuminance(ledger, screen));
+  }
+  for (int app = 0; app < ENERGY_MAX_APPS; app++) {
+    if (ledger.app_us[app] == 0) continue;
+    Serial.printf("energy,app,%s,%.3f,%.4f\n", getAppName(app),
+                  ledger.app_us[app] / 1000000.0, energyMilliampHours(ledger.app_uams[app]));
+  }
+  static const char* const state_names[ENERGY_STATE_COUNT] = {
+    "display_on", "cpu_busy", "cpu_80", "cpu_160", "cpu_240", "cpu_sleep",
+    "sd", "audio", "imu_full", "imu_low", "i2c"
+  };
+  for (int state = 0; state < ENERGY_STATE_COUNT; state++) {
+    Serial.printf("energy,state,%s,%.3f,\n", state_names[state], ledger.state_us[state] / 1000000.0);
+  }
+  uint64_t display_us = ledger.state_us[ENERGY_STATE_DISPLAY_ON];
+  Serial.printf("energy,state,brightness_mean,%.1f,\n", display_us ? (double)ledger.brightness_sum / display_us : 0.0);
+  Serial.printf("energy,state,luminance_mean,%.1f,\n", display_us ? (double)ledger.luminance_sum / display_us : 0.0);
+  for (int coefficient = 0; coefficient < ENERGY_COEFF_COUNT; coefficient++) {
+    Serial.printf("energy,model,%d:%s,%lu,\n", coefficient, energyCoefficientName(coefficient),
+                  (unsigned long)energy_model.ua[coefficient]);
+  }
 }
\ No newline at end of file
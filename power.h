@@ -8,6 +8,8 @@
 
 #include "config.h"
 #include <Wire.h>
+#include "energy.h"
+#include "governor.h"
 
 // Power states
 enum PowerState {
@@ -18,6 +20,15 @@ enum PowerState {
   POWER_CHARGING
 };
 
+// What ended a light sleep
+enum WakeCause {
+  WAKE_TIMER,
+  WAKE_MOTION,    // IMU wake-on-motion or FIFO watermark toggled IMU_INT
+  WAKE_PMIC,      // AXP2101 interrupt
+  WAKE_RTC,       // PCF85063 alarm or timer
+  WAKE_INPUT      // Button or touch
+};
+
 // Battery info structure
 struct BatteryInfo {
   int percentage;
@@ -39,6 +50,7 @@ int getBatteryPercentage();
 int getBatteryVoltage();
 bool isCharging();
 bool isPluggedIn();
+unsigned long powerDueIn();  // Until the next battery reading
 
 // Power state management
 void setPowerState(PowerState state);
@@ -46,6 +58,13 @@ PowerState getCurrentPowerState();
 void enterSleepMode();
 void enterDeepSleepMode();
 void wakeFromSleep();
+WakeCause lightSleepUntilEvent(uint32_t max_ms);
+unsigned long buttonEdgeTime(int pin);  // millis() of the last press or release
+
+// Deep sleep keeps the user's state in RTC memory for a warm boot
+void saveResumeState();
+bool hasResumeState();      // Woken from deep sleep with a valid block
+bool restoreResumeState();  // Once sensors and the RTC are up; consumes the block
 
 // Display power management
 void setDisplayPower(bool on);
@@ -59,6 +78,18 @@ void setBluetoothPower(bool enabled);
 void setSensorPower(bool enabled);
 void setAudioPower(bool enabled);
 
+// CPU clock governor, fed once per frame
+void initializeCpuGovernor();
+void updateCpuGovernor(uint32_t frame_us, bool animating);
+const GovernorStats& getCpuGovernorStats();
+void reportCpuGovernor();
+
+// Display brightness and theme variant against a panel current budget,
+// fed once per frame; true when the theme variant changed and needs a redraw
+void initializeDisplayLimiter();
+bool updateDisplayLimiter();
+void reportDisplayLimiter();
+
 // Low power optimizations
 void enableLowPowerMode();
 void disableLowPowerMode();
@@ -78,5 +109,17 @@ void showChargingNotification();
 void logPowerUsage();
 int getEstimatedRuntime();
 void generatePowerReport();
+void reportFuelGauge();
+
+// Energy attribution per subsystem, screen and app
+void noteLoopBusy(uint32_t busy_us);   // Loop time on core 1, excluding delay() and light sleep
+void updateEnergyAccounting();
+const EnergyLedger& getEnergyLedger();
+void resetEnergyLedger();
+bool calibrateEnergyModel(int coefficient, uint32_t ua);  // Saved to NVS
+void reportEnergy();
+void exportEnergyCSV();
+const char* getScreenName(int screen);
+const char* getAppName(int app);
 
 #endif // POWER_H
\ No newline at end of file
@@ -15,6 +15,7 @@ QuestData urgent_quest;
 int active_quest_count = 0;
 int player_xp = 0;
 int player_level = 1;
+int quest_scroll_offset = 0;
 
 // Quest templates for each character
 QuestData luffy_quest_templates[] = {
@@ -41,6 +42,13 @@ QuestData yugo_quest_templates[] = {
 void initializeQuests() {
   Serial.println("Initializing quest system...");
   
+  // Daily quests and their progress stay until the day ends or a warm
+  // boot brings them back
+  if (active_quest_count > 0) {
+    Serial.println("Quest system resumed");
+    return;
+  }
+  
   // Generate initial daily quests
   generateDailyQuests();
   
@@ -229,18 +237,13 @@ void drawQuestScreen() {
   clearDisplay();
   ThemeColors* theme = getCurrentTheme();
   
+  // Advance any fling or overscroll bounce in progress
+  updateListScroll(quest_scroll_offset);
+  
   // Background
   fillRect(0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT, theme->background);
   
-  // Title
-  drawNavigationBar("Urgent Quests", true);
-  
-  // Player level and XP
-  char level_str[30];
-  sprintf(level_str, "Level %d - %d XP", player_level, player_xp);
-  drawCenteredText(level_str, DISPLAY_WIDTH/2, 50, theme->accent, 1);
-  
-  int y_offset = 80;
+  int y_offset = 80 - quest_scroll_offset;
   
   // Draw urgent quest if active
   if (urgent_quest.urgent && !urgent_quest.completed) {
@@ -249,14 +252,31 @@ void drawQuestScreen() {
   }
   
   // Draw daily quests
-  for (int i = 0; i < active_quest_count && i < 3; i++) {
+  for (int i = 0; i < active_quest_count; i++) {
     drawQuestCard(10, y_offset, DISPLAY_WIDTH-20, 60, daily_quests[i]);
     y_offset += 70;
   }
   
+  // Scroll range covers whatever overflows the screen
+  int content_bottom = y_offset + quest_scroll_offset;
+  setListScrollRange(max(0, content_bottom - DISPLAY_HEIGHT));
+  
+  // Header is drawn last so cards scroll underneath it
+  fillRect(0, 40, DISPLAY_WIDTH, 30, theme->background);
+  drawNavigationBar("Urgent Quests", true);
+  
+  // Player level and XP
+  char level_str[30];
+  sprintf(level_str, "Level %d - %d XP", player_level, player_xp);
+  drawCenteredText(level_str, DISPLAY_WIDTH/2, 50, theme->accent, 1);
+  
   updateDisplay();
 }
 
+void handleQuestTouch(TouchGesture& gesture) {
+  handleListScroll(gesture, quest_scroll_offset);
+}
+
 void drawQuestCard(int x, int y, int w, int h, QuestData& quest) {
   ThemeColors* theme = getCurrentTheme();
   
@@ -353,4 +373,78 @@ void showQuestCompleted(QuestData& quest) {
     updateDisplay();
     delay(200);
   }
+}
+
+// ==================== WARM RESUME ====================
+#define QUEST_TEMPLATES_PER_CHARACTER 4
+
+static QuestData* questTemplates(int character) {
+  switch (character) {
+    case QUEST_LUFFY: return luffy_quest_templates;
+    case QUEST_JINWOO: return jinwoo_quest_templates;
+    case QUEST_YUGO: return yugo_quest_templates;
+    default: return nullptr;
+  }
+}
+
+static void packQuest(const QuestData& quest, ResumeQuest& packed) {
+  // Text comes back from the template, found by its title
+  QuestData* templates = questTemplates(quest.character);
+  packed.character = quest.character;
+  packed.template_index = 0;
+  for (int i = 0; templates && i < QUEST_TEMPLATES_PER_CHARACTER; i++) {
+    if (templates[i].title == quest.title) packed.template_index = i;
+  }
+  packed.flags = (quest.completed ? RESUME_QUEST_COMPLETED : 0) |
+                 (quest.urgent ? RESUME_QUEST_URGENT : 0) |
+                 (quest.daily ? RESUME_QUEST_DAILY : 0);
+  packed.target_value = quest.target_value;
+  packed.current_progress = quest.current_progress;
+  packed.reward_points = quest.reward_points;
+  packed.time_limit_ms = quest.time_limit;
+  packed.age_ms = millis() - quest.start_time;
+}
+
+static bool unpackQuest(const ResumeQuest& packed, uint32_t asleep_ms, QuestData& quest) {
+  QuestData* templates = questTemplates(packed.character);
+  if (!templates || packed.template_index >= QUEST_TEMPLATES_PER_CHARACTER) return false;
+  
+  quest = templates[packed.template_index];
+  quest.completed = packed.flags & RESUME_QUEST_COMPLETED;
+  quest.urgent = packed.flags & RESUME_QUEST_URGENT;
+  quest.daily = packed.flags & RESUME_QUEST_DAILY;
+  quest.target_value = packed.target_value;
+  quest.current_progress = packed.current_progress;
+  quest.reward_points = packed.reward_points;
+  quest.time_limit = packed.time_limit_ms;
+  quest.start_time = millis() - resumeAge(packed.age_ms, asleep_ms);
+  return true;
+}
+
+void saveQuestResume(ResumeQuests& quests) {
+  quests.count = min(active_quest_count, RESUME_MAX_QUESTS);
+  for (int i = 0; i < quests.count; i++) {
+    packQuest(daily_quests[i], quests.daily[i]);
+  }
+  quests.has_urgent = urgent_quest.urgent;
+  if (quests.has_urgent) packQuest(urgent_quest, quests.urgent);
+  quests.player_xp = player_xp;
+  quests.player_level = player_level;
+}
+
+void restoreQuestResume(const ResumeQuests& quests, uint32_t asleep_ms, bool same_day) {
+  // XP is for keeps; a new day gets new daily quests when the app opens,
+  // and an urgent quest that ran out while asleep expires on its next check
+  player_xp = quests.player_xp;
+  player_level = quests.player_level;
+  if (!same_day) return;
+  
+  active_quest_count = 0;
+  for (int i = 0; i < quests.count && i < RESUME_MAX_QUESTS; i++) {
+    if (unpackQuest(quests.daily[i], asleep_ms, daily_quests[active_quest_count])) {
+      active_quest_count++;
+    }
+  }
+  urgent_quest.urgent = false;
+  if (quests.has_urgent) unpackQuest(quests.urgent, asleep_ms, urgent_quest);
 }
\ No newline at end of file
@@ -7,6 +7,8 @@
 #define QUESTS_H
 
 #include "config.h"
+#include "touch.h"
+#include "resume.h"
 
 // Quest difficulty levels
 enum QuestDifficulty {
@@ -62,6 +64,7 @@ void drawQuestScreen();
 void drawQuestCard(int x, int y, int w, int h, QuestData& quest);
 void showQuestNotification(QuestData& quest);
 void showQuestCompleted(QuestData& quest);
+void handleQuestTouch(TouchGesture& gesture);
 
 // Character-specific quests
 QuestData generateLuffyQuest();
@@ -74,6 +77,10 @@ void updatePlayerLevel();
 int getPlayerLevel();
 int getPlayerXP();
 
+// Progress kept across deep sleep
+void saveQuestResume(ResumeQuests& quests);
+void restoreQuestResume(const ResumeQuests& quests, uint32_t asleep_ms, bool same_day);
+
 // Quest templates
 extern QuestData luffy_quests[];
 extern QuestData jinwoo_quests[];
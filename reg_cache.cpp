@@ -0,0 +1,209 @@
+/*
+ * Register Shadow Cache Implementation
+ * Staleness checks, burst refills and write-through
+ */
+
+#include "reg_cache.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+
+static RegCache* registered_caches[REG_CACHE_MAX_CACHES];
+static int registered_cache_count = 0;
+
+#ifdef ARDUINO
+static void lockCache(RegCache& cache) {
+  xSemaphoreTake(cache.lock, portMAX_DELAY);
+}
+
+static void unlockCache(RegCache& cache) {
+  xSemaphoreGive(cache.lock);
+}
+#else
+static void lockCache(RegCache& cache) { cache.lock.lock(); }
+static void unlockCache(RegCache& cache) { cache.lock.unlock(); }
+#endif
+
+void regCacheInit(RegCache& cache, const char* name, I2CDeviceId device,
+                  uint8_t first_reg, RegCacheEntry* entries, uint8_t count) {
+  cache.name = name;
+  cache.device = device;
+  cache.first_reg = first_reg;
+  cache.count = count;
+  cache.entries = entries;
+  cache.invalidate_pending = false;
+  cache.hits = cache.misses = cache.registers_read = 0;
+#ifdef ARDUINO
+  if (cache.lock == nullptr) cache.lock = xSemaphoreCreateMutex();
+#endif
+
+  // Everything is re-read until a policy says otherwise
+  memset(entries, 0, sizeof(RegCacheEntry) * count);
+
+  for (int i = 0; i < registered_cache_count; i++) {
+    if (registered_caches[i] == &cache) return;
+  }
+  if (registered_cache_count < REG_CACHE_MAX_CACHES) {
+    registered_caches[registered_cache_count++] = &cache;
+  }
+}
+
+void regCacheSetPolicy(RegCache& cache, uint8_t reg, uint8_t count, uint16_t max_age_ms) {
+  for (int i = 0; i < count; i++) {
+    int index = reg + i - cache.first_reg;
+    if (index < 0 || index >= cache.count) continue;
+    cache.entries[index].max_age_ms = max_age_ms;
+  }
+}
+
+// With the cache locked
+static void dropEntries(RegCache& cache) {
+  cache.invalidate_pending = false;
+  for (int i = 0; i < cache.count; i++) {
+    cache.entries[i].valid = false;
+  }
+}
+
+void regCacheInvalidate(RegCache& cache) {
+  lockCache(cache);
+  dropEntries(cache);
+  unlockCache(cache);
+}
+
+static bool isFresh(const RegCacheEntry& entry, uint32_t now_ms) {
+  if (!entry.valid || entry.max_age_ms == REG_AGE_VOLATILE) return false;
+  if (entry.max_age_ms == REG_AGE_FOREVER) return true;
+  return now_ms - entry.read_at < entry.max_age_ms;
+}
+
+static bool inWindow(const RegCache& cache, uint8_t reg, size_t length) {
+  return reg >= cache.first_reg && reg + length <= (size_t)cache.first_reg + cache.count;
+}
+
+static bool readLocked(RegCache& cache, uint8_t reg, uint8_t* data, size_t length, uint32_t now_ms) {
+  if (!inWindow(cache, reg, length)) {
+    cache.misses++;
+    return i2cReadRegs(cache.device, reg, data, length);
+  }
+
+  if (cache.invalidate_pending) {
+    dropEntries(cache);
+  }
+
+  // Find the stale span, fresh registers inside it are re-read too
+  int base = reg - cache.first_reg;
+  int first_stale = -1, last_stale = -1;
+  for (size_t i = 0; i < length; i++) {
+    if (!isFresh(cache.entries[base + i], now_ms)) {
+      if (first_stale < 0) first_stale = i;
+      last_stale = i;
+    }
+  }
+
+  if (first_stale >= 0) {
+    int span = last_stale - first_stale + 1;
+    uint8_t burst[256];
+    if (!i2cReadRegs(cache.device, reg + first_stale, burst, span)) {
+      cache.misses++;
+      return false;
+    }
+    for (int i = 0; i < span; i++) {
+      RegCacheEntry& entry = cache.entries[base + first_stale + i];
+      entry.value = burst[i];
+      entry.valid = true;
+      entry.read_at = now_ms;
+    }
+    cache.misses++;
+    cache.registers_read += span;
+  } else {
+    cache.hits++;
+  }
+
+  for (size_t i = 0; i < length; i++) {
+    data[i] = cache.entries[base + i].value;
+  }
+  return true;
+}
+
+bool regCacheRead(RegCache& cache, uint8_t reg, uint8_t* data, size_t length, uint32_t now_ms) {
+  if (length == 0) return false;
+  lockCache(cache);
+  bool ok = readLocked(cache, reg, data, length, now_ms);
+  unlockCache(cache);
+  return ok;
+}
+
+static bool writeLocked(RegCache& cache, uint8_t reg, const uint8_t* data, size_t length, uint32_t now_ms) {
+  if (!i2cWriteRegs(cache.device, reg, data, length)) {
+    // Unknown device state, drop the shadow of what we tried to write
+    if (inWindow(cache, reg, length)) {
+      for (size_t i = 0; i < length; i++) {
+        cache.entries[reg - cache.first_reg + i].valid = false;
+      }
+    }
+    return false;
+  }
+
+  if (inWindow(cache, reg, length)) {
+    for (size_t i = 0; i < length; i++) {
+      RegCacheEntry& entry = cache.entries[reg - cache.first_reg + i];
+      entry.value = data[i];
+      entry.valid = true;
+      entry.read_at = now_ms;
+    }
+  }
+  return true;
+}
+
+bool regCacheWrite(RegCache& cache, uint8_t reg, const uint8_t* data, size_t length, uint32_t now_ms) {
+  lockCache(cache);
+  bool ok = writeLocked(cache, reg, data, length, now_ms);
+  unlockCache(cache);
+  return ok;
+}
+
+bool regCacheWriteReg(RegCache& cache, uint8_t reg, uint8_t value, uint32_t now_ms) {
+  return regCacheWrite(cache, reg, &value, 1, now_ms);
+}
+
+void regCacheResetStats() {
+  for (int i = 0; i < registered_cache_count; i++) {
+    RegCache& cache = *registered_caches[i];
+    lockCache(cache);
+    cache.hits = 0;
+    cache.misses = 0;
+    cache.registers_read = 0;
+    unlockCache(cache);
+  }
+}
+
+int regCacheFormatStats(char* buffer, size_t size) {
+  if (size == 0) return 0;
+  buffer[0] = '\0';
+
+  int written = 0;
+  for (int i = 0; i < registered_cache_count && written < (int)size; i++) {
+    RegCache& cache = *registered_caches[i];
+    lockCache(cache);
+    uint32_t hits = cache.hits, misses = cache.misses, registers_read = cache.registers_read;
+    unlockCache(cache);
+    uint32_t total = hits + misses;
+    written += snprintf(buffer + written, size - written,
+                        "%-6s cache %6lu hits %6lu misses (%3lu%% hit) %7lu regs read\n",
+                        cache.name, (unsigned long)hits, (unsigned long)misses,
+                        (unsigned long)(total ? hits * 100 / total : 0),
+                        (unsigned long)registers_read);
+  }
+  return written;
+}
+
+#ifdef ARDUINO
+void reportRegisterCaches() {
+  char report[256];
+  regCacheFormatStats(report, sizeof(report));
+  Serial.print(report);
+}
+#endif
\ No newline at end of file
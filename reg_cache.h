@@ -0,0 +1,84 @@
+/*
+ * Register Shadow Cache for ESP32-S3 Watch
+ * Cached device registers with per-register staleness policies
+ *
+ * Each cache shadows a window of one device's registers. Every register
+ * has a maximum age: 0 means always re-read, REG_AGE_FOREVER means keep
+ * it until a write, an invalidate or the device's interrupt line. Reads
+ * that miss fetch the whole stale span in one burst. Writes go through to
+ * the device and update the shadow. The sensor task and the UI share the
+ * RTC and PMIC caches from both cores, so each cache has a lock held for
+ * the whole read or write. Bus access goes through i2c_bus, so the cache
+ * runs on host against i2c_mock, the lock there being a std::mutex.
+ */
+
+#ifndef REG_CACHE_H
+#define REG_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "i2c_bus.h"
+
+#ifdef ARDUINO
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#else
+#include <mutex>
+#endif
+
+#define REG_AGE_VOLATILE 0
+#define REG_AGE_FOREVER 0xFFFF
+#define REG_CACHE_MAX_CACHES 4
+
+struct RegCacheEntry {
+  uint8_t value;
+  bool valid;
+  uint16_t max_age_ms;
+  uint32_t read_at;
+};
+
+struct RegCache {
+  const char* name;
+  I2CDeviceId device;
+  uint8_t first_reg;
+  uint8_t count;
+  RegCacheEntry* entries;
+  volatile bool invalidate_pending;   // Set from the device's interrupt
+#ifdef ARDUINO
+  SemaphoreHandle_t lock;             // Created once, by the first init
+#else
+  std::mutex lock;
+#endif
+
+  uint32_t hits;          // Reads served without bus traffic
+  uint32_t misses;        // Reads that needed a burst
+  uint32_t registers_read;
+};
+
+// Setup, entries must hold count registers starting at first_reg
+void regCacheInit(RegCache& cache, const char* name, I2CDeviceId device,
+                  uint8_t first_reg, RegCacheEntry* entries, uint8_t count);
+void regCacheSetPolicy(RegCache& cache, uint8_t reg, uint8_t count, uint16_t max_age_ms);
+
+// Access, registers outside the window go straight to the bus
+bool regCacheRead(RegCache& cache, uint8_t reg, uint8_t* data, size_t length, uint32_t now_ms);
+bool regCacheWrite(RegCache& cache, uint8_t reg, const uint8_t* data, size_t length, uint32_t now_ms);
+bool regCacheWriteReg(RegCache& cache, uint8_t reg, uint8_t value, uint32_t now_ms);
+
+// Invalidation
+void regCacheInvalidate(RegCache& cache);
+
+// ISR safe, the next read drops every cached value
+inline void regCacheInvalidateFromISR(RegCache& cache) {
+  cache.invalidate_pending = true;
+}
+
+// Statistics over every initialized cache
+void regCacheResetStats();
+int regCacheFormatStats(char* buffer, size_t size);
+
+#ifdef ARDUINO
+void reportRegisterCaches();
+#endif
+
+#endif // REG_CACHE_H
\ No newline at end of file
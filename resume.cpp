@@ -0,0 +1,59 @@
+/*
+ * Warm Resume State Implementation
+ * Sealing the RTC memory block and ageing what it holds
+ */
+
+#include "resume.h"
+#include <stddef.h>
+
+#define MINUTES_PER_DAY 1440
+
+// ==================== SEALING ====================
+uint32_t resumeChecksum(const ResumeState& state) {
+  // CRC-32, reflected, bitwise: a few hundred bytes once per deep sleep
+  const uint8_t* bytes = (const uint8_t*)&state;
+  size_t length = offsetof(ResumeState, crc);
+  uint32_t crc = 0xFFFFFFFFUL;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= bytes[i];
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320UL & (0 - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+void resumeSeal(ResumeState& state, uint32_t now_minute) {
+  state.magic = RESUME_MAGIC;
+  state.version = RESUME_VERSION;
+  state.size = sizeof(ResumeState);
+  state.saved_minute = now_minute;
+  state.crc = resumeChecksum(state);
+}
+
+bool resumeValid(const ResumeState& state) {
+  // Power loss leaves RTC memory random and a new build may move fields
+  return state.magic == RESUME_MAGIC && state.version == RESUME_VERSION &&
+         state.size == sizeof(ResumeState) && state.crc == resumeChecksum(state);
+}
+
+void resumeInvalidate(ResumeState& state) {
+  state.magic = 0;
+}
+
+// ==================== AGEING ====================
+uint32_t resumeAsleepMs(const ResumeState& state, uint32_t now_minute) {
+  // A clock set backwards while asleep counts as no time
+  if (now_minute <= state.saved_minute) return 0;
+  uint32_t minutes = now_minute - state.saved_minute;
+  if (minutes > 0xFFFFFFFFUL / 60000) return 0xFFFFFFFFUL;
+  return minutes * 60000;
+}
+
+bool resumeSameDay(const ResumeState& state, uint32_t now_minute) {
+  return now_minute / MINUTES_PER_DAY == state.saved_minute / MINUTES_PER_DAY;
+}
+
+uint32_t resumeAge(uint32_t age_ms, uint32_t asleep_ms) {
+  return age_ms > 0xFFFFFFFFUL - asleep_ms ? 0xFFFFFFFFUL : age_ms + asleep_ms;
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+/*
+ * Warm Resume State for ESP32-S3 Watch
+ * What survives a deep sleep in RTC slow memory
+ *
+ * Deep sleep powers down RAM and PSRAM, so waking from it restarts
+ * setup(). Before sleeping, each module packs what the user would miss
+ * into its section of one ResumeState: the settings in system_state,
+ * today's step counters, quest progress, and the music player's place.
+ * The block lives in RTC slow memory, which stays powered, and is sealed
+ * with a magic, a version, its size and a CRC-32. On a deep sleep wake a
+ * block that checks out lets setup() skip the splash, the SD scans and
+ * app initialization and go straight to the watch face; anything else
+ * is a cold boot.
+ *
+ * Times in the block are ages, because millis() restarts from zero. The
+ * time asleep comes from activity log minutes read off the RTC, so a
+ * wake on another day also knows to start today's counters over.
+ *
+ * Plain C++ on stdint, so sealing, corruption and ageing are checked on
+ * host with the block copied around as bytes, as RTC memory would hold it.
+ */
+
+#ifndef RESUME_H
+#define RESUME_H
+
+#include <stdint.h>
+
+#define RESUME_MAGIC 0x57524D42UL    // "WRMB"
+#define RESUME_VERSION 1
+#define RESUME_MAX_QUESTS 5
+
+// ResumeQuest.flags
+#define RESUME_QUEST_COMPLETED 0x01
+#define RESUME_QUEST_URGENT 0x02
+#define RESUME_QUEST_DAILY 0x04
+
+// ResumeSystem.flags
+#define RESUME_SYSTEM_LOW_BATTERY 0x01
+#define RESUME_SYSTEM_MUSIC_PLAYING 0x02
+
+// Settings and counters from system_state; the Strings stay behind
+struct ResumeSystem {
+  uint8_t screen;                // ScreenType when it went to sleep
+  uint8_t theme;
+  uint8_t app;
+  uint8_t flags;
+  int16_t brightness;
+  int16_t wake_time;             // Minutes from midnight
+  int16_t sleep_time;
+  int16_t current_quest;
+  int16_t current_song;
+  int16_t total_mp3_files;
+  int16_t total_pdf_files;
+  int32_t steps_today;
+  int32_t step_goal;
+};
+
+// Today's step counters and the IMU's own count to credit steps taken asleep
+struct ResumeSteps {
+  int32_t daily_steps;
+  int32_t calories_burned;
+  int32_t active_minutes;
+  uint32_t pedometer_steps;
+  float distance_m;
+  float energy_kcal;
+  uint32_t hardware_count;       // QMI8658 step counter at sleep
+  bool hardware_valid;           // The IMU was left counting
+};
+
+// A quest rebuilt from its template; titles and descriptions are not kept
+struct ResumeQuest {
+  uint8_t character;             // QuestCharacter
+  uint8_t template_index;
+  uint8_t flags;
+  int32_t target_value;
+  int32_t current_progress;
+  int32_t reward_points;
+  uint32_t time_limit_ms;
+  uint32_t age_ms;               // Since it started
+};
+
+struct ResumeQuests {
+  uint8_t count;
+  bool has_urgent;
+  ResumeQuest daily[RESUME_MAX_QUESTS];
+  ResumeQuest urgent;
+  int32_t player_xp;
+  int32_t player_level;
+};
+
+// The music player's place; the file lists are rebuilt from SD on demand
+struct ResumeMedia {
+  int16_t current_track;
+  int16_t volume;
+  bool shuffle;
+  bool repeat;
+  int16_t music_count;           // At sleep, for the log on wake
+  int16_t pdf_count;
+};
+
+struct ResumeState {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t size;
+  uint32_t saved_minute;         // Activity log minute when saved
+  uint32_t warm_boots;           // Resumes in a row since the last cold boot
+  ResumeSystem system;
+  ResumeSteps steps;
+  ResumeQuests quests;
+  ResumeMedia media;
+  uint32_t crc;                  // Over everything above
+};
+
+// Sealing
+void resumeSeal(ResumeState& state, uint32_t now_minute);
+bool resumeValid(const ResumeState& state);
+void resumeInvalidate(ResumeState& state);  // After use, so a later reset boots cold
+uint32_t resumeChecksum(const ResumeState& state);
+
+// Time asleep, from the minutes at save and wake
+uint32_t resumeAsleepMs(const ResumeState& state, uint32_t now_minute);
+bool resumeSameDay(const ResumeState& state, uint32_t now_minute);
+uint32_t resumeAge(uint32_t age_ms, uint32_t asleep_ms);  // Saturates
+
+#endif // RESUME_H
\ No newline at end of file
@@ -4,6 +4,8 @@
  */
 
 #include "rtc.h"
+#include "reg_cache.h"
+#include "i2c_trace.h"
 
 // RTC state variables
 static Alarm watch_alarms[5];
@@ -15,32 +17,40 @@ static unsigned long stopwatch_start_time = 0;
 static unsigned long stopwatch_pause_time = 0;
 static bool stopwatch_running = false;
 
+// PCF85063 register shadow (0x00-0x11). Time registers are re-read at
+// most every 200ms, so checkAlarms() and the watch face share one burst;
+// control and alarm registers only change through our writes or RTC_INT.
+#define RTC_TIME_MAX_AGE 200
+static RegCacheEntry rtc_registers[0x12];
+static RegCache rtc_cache;
+
+static void IRAM_ATTR onRTCInterrupt() {
+  regCacheInvalidateFromISR(rtc_cache);
+}
+
 bool initializeRTC() {
   Serial.println("Initializing RTC...");
   
-  // Initialize I2C for PCF85063
-  Wire1.begin(RTC_SDA, RTC_SCL);
-  Wire1.setClock(100000); // 100kHz for RTC
+  regCacheInit(rtc_cache, "rtc", I2C_DEV_RTC, 0x00, rtc_registers, 0x12);
+  regCacheSetPolicy(rtc_cache, 0x00, 4, REG_AGE_FOREVER);   // Control, offset, RAM
+  regCacheSetPolicy(rtc_cache, 0x04, 7, RTC_TIME_MAX_AGE);  // Seconds to years
+  regCacheSetPolicy(rtc_cache, 0x0B, 7, REG_AGE_FOREVER);   // Alarm and timer
   
-  // PCF85063 I2C address is 0x51
-  Wire1.beginTransmission(0x51);
-  if (Wire1.endTransmission() != 0) {
+  pinMode(RTC_INT, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(RTC_INT), onRTCInterrupt, FALLING);
+  
+  // PCF85063 I2C address is 0x51, its bus clock is set per transfer
+  if (!i2cProbe(I2C_DEV_RTC)) {
     Serial.println("PCF85063 RTC not found! Using system time.");
     // Continue with system time fallback
   } else {
     Serial.println("PCF85063 RTC found");
     
     // Configure RTC
-    Wire1.beginTransmission(0x51);
-    Wire1.write(0x00); // Control register
-    Wire1.write(0x00); // Normal operation
-    Wire1.endTransmission();
+    regCacheWriteReg(rtc_cache, 0x00, 0x00, millis()); // Control register: normal operation
     
     // Set 24-hour mode
-    Wire1.beginTransmission(0x51);
-    Wire1.write(0x01); // Control register 2
-    Wire1.write(0x00); // 24-hour format
-    Wire1.endTransmission();
+    regCacheWriteReg(rtc_cache, 0x01, 0x00, millis()); // Control register 2: 24-hour format
   }
   
   // Initialize alarms
@@ -67,21 +77,21 @@ bool initializeRTC() {
 WatchTime getCurrentTime() {
   WatchTime watch_time;
   
-  // Try to read from PCF85063 first
-  Wire1.beginTransmission(0x51);
-  Wire1.write(0x04); // Seconds register
-  Wire1.endTransmission();
+  // Try to read from PCF85063 first, seconds register onwards
+  uint8_t regs[7];
+  I2CCaller previous_caller = i2cTraceSetCaller(I2C_CALLER_RTC);
+  bool rtc_ok = regCacheRead(rtc_cache, 0x04, regs, sizeof(regs), millis());
+  i2cTraceSetCaller(previous_caller);
   
-  Wire1.requestFrom(0x51, 7);
-  if (Wire1.available() >= 7) {
+  if (rtc_ok) {
     // Read BCD time from RTC
-    uint8_t seconds = Wire1.read();
-    uint8_t minutes = Wire1.read();
-    uint8_t hours = Wire1.read();
-    uint8_t days = Wire1.read();
-    uint8_t weekdays = Wire1.read();
-    uint8_t months = Wire1.read();
-    uint8_t years = Wire1.read();
+    uint8_t seconds = regs[0];
+    uint8_t minutes = regs[1];
+    uint8_t hours = regs[2];
+    uint8_t days = regs[3];
+    uint8_t weekdays = regs[4];
+    uint8_t months = regs[5];
+    uint8_t years = regs[6];
     
     // Convert BCD to decimal
     watch_time.second = (seconds & 0x0F) + ((seconds >> 4) & 0x07) * 10;
@@ -120,17 +130,11 @@ void setCurrentTime(WatchTime& time) {
   uint8_t months = (time.month % 10) | ((time.month / 10) << 4);
   uint8_t years = ((time.year - 2000) % 10) | (((time.year - 2000) / 10) << 4);
   
-  // Write to PCF85063
-  Wire1.beginTransmission(0x51);
-  Wire1.write(0x04); // Seconds register
-  Wire1.write(seconds);
-  Wire1.write(minutes);
-  Wire1.write(hours);
-  Wire1.write(days);
-  Wire1.write(weekdays);
-  Wire1.write(months);
-  Wire1.write(years);
-  Wire1.endTransmission();
+  // Write to PCF85063, seconds register onwards
+  uint8_t regs[7] = {seconds, minutes, hours, days, weekdays, months, years};
+  I2CCaller previous_caller = i2cTraceSetCaller(I2C_CALLER_RTC);
+  regCacheWrite(rtc_cache, 0x04, regs, sizeof(regs), millis());
+  i2cTraceSetCaller(previous_caller);
   
   Serial.println("Time set: " + formatTime(time));
 }
@@ -259,13 +263,19 @@ void enableAlarm(int id, bool enabled) {
 }
 
 void checkAlarms() {
+  static int last_checked_minute = -1;
   WatchTime current = getCurrentTime();
   
+  // Once per minute, on whichever check lands in it first: the loop may
+  // sleep through second 0
+  int minute_of_day = current.hour * 60 + current.minute;
+  if (minute_of_day == last_checked_minute) return;
+  last_checked_minute = minute_of_day;
+  
   for (int i = 0; i < active_alarms; i++) {
     if (watch_alarms[i].enabled &&
         watch_alarms[i].hour == current.hour &&
-        watch_alarms[i].minute == current.minute &&
-        current.second == 0) { // Only trigger at the exact minute
+        watch_alarms[i].minute == current.minute) {
       
       triggerAlarm(i);
     }
@@ -432,6 +442,22 @@ void checkTimeBasedEvents() {
   }
 }
 
+unsigned long timeEventsDueIn() {
+  // The timer's end, and the next minute while any alarm is set
+  unsigned long due = TIME_EVENTS_NONE;
+  if (timer_active) {
+    unsigned long elapsed = millis() - timer_start_time;
+    due = elapsed < (unsigned long)timer_duration ? timer_duration - elapsed : 0;
+  }
+  for (int i = 0; i < active_alarms; i++) {
+    if (!watch_alarms[i].enabled) continue;
+    WatchTime current = getCurrentTime();
+    due = min(due, (unsigned long)(60 - current.second) * 1000);
+    break;
+  }
+  return due;
+}
+
 void setWakeUpTime(int hour, int minute) {
   system_state.wake_time = hour * 60 + minute;
 }
@@ -76,7 +76,9 @@ void resetStopwatch();
 unsigned long getStopwatchTime();
 
 // Time-based automation
+#define TIME_EVENTS_NONE 0xFFFFFFFFUL
 void checkTimeBasedEvents();
+unsigned long timeEventsDueIn();  // Until checkTimeBasedEvents() has work, or TIME_EVENTS_NONE
 void setWakeUpTime(int hour, int minute);
 void setSleepTime(int hour, int minute);
 
@@ -0,0 +1,68 @@
+/*
+ * Loop Scheduler Implementation
+ * Wrap-safe deadlines and sleep planning
+ */
+
+#include "scheduler.h"
+#include <string.h>
+
+// Signed distance, so deadlines keep working across the millis() wrap
+static int32_t untilDue(uint32_t due_ms, uint32_t now_ms) {
+  return (int32_t)(due_ms - now_ms);
+}
+
+void schedulerInit(LoopScheduler& scheduler) {
+  memset(&scheduler, 0, sizeof(scheduler));
+}
+
+void schedulerArm(LoopScheduler& scheduler, int deadline, uint32_t due_ms) {
+  if (deadline < 0 || deadline >= DEADLINE_COUNT) return;
+  scheduler.due_ms[deadline] = due_ms;
+  scheduler.armed |= 1u << deadline;
+}
+
+void schedulerDisarm(LoopScheduler& scheduler, int deadline) {
+  if (deadline < 0 || deadline >= DEADLINE_COUNT) return;
+  scheduler.armed &= ~(1u << deadline);
+}
+
+bool schedulerArmed(const LoopScheduler& scheduler, int deadline) {
+  if (deadline < 0 || deadline >= DEADLINE_COUNT) return false;
+  return (scheduler.armed & (1u << deadline)) != 0;
+}
+
+bool schedulerDue(const LoopScheduler& scheduler, int deadline, uint32_t now_ms) {
+  if (!schedulerArmed(scheduler, deadline)) return false;
+  return untilDue(scheduler.due_ms[deadline], now_ms) <= 0;
+}
+
+SleepPlan schedulerPlanSleep(LoopScheduler& scheduler, uint32_t now_ms, uint32_t max_ms) {
+  SleepPlan plan = {0, -1};
+  int32_t gap = (int32_t)max_ms;
+  for (int deadline = 0; deadline < DEADLINE_COUNT; deadline++) {
+    if (!(scheduler.armed & (1u << deadline))) continue;
+    int32_t until = untilDue(scheduler.due_ms[deadline], now_ms);
+    if (until < gap) {
+      gap = until;
+      plan.deadline = deadline;
+    }
+  }
+
+  if (gap - SCHEDULER_WAKE_MARGIN_MS < SCHEDULER_MIN_SLEEP_MS) {
+    if (gap > 0) scheduler.stats.idles++;
+    return plan;
+  }
+  plan.sleep_ms = gap - SCHEDULER_WAKE_MARGIN_MS;
+  return plan;
+}
+
+void schedulerNoteWake(LoopScheduler& scheduler, const SleepPlan& plan, uint32_t slept_ms) {
+  SchedulerStats& stats = scheduler.stats;
+  stats.sleeps++;
+  stats.slept_ms += slept_ms;
+  if (slept_ms < plan.sleep_ms) {
+    stats.early_wakes++;
+  } else if (plan.deadline >= 0) {
+    stats.woken_by[plan.deadline]++;
+  }
+}
\ No newline at end of file
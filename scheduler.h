@@ -0,0 +1,63 @@
+/*
+ * Loop Scheduler for ESP32-S3 Watch
+ * Deadlines for the main loop and how long it may sleep before the next
+ *
+ * Each periodic job in the loop keeps a deadline for when it next needs
+ * the CPU: the next frame, an animation tick, the sensor task's next
+ * cycle, an alarm or timer, battery upkeep, a button waiting out its
+ * debounce. Once a pass of the loop has done what was due, it asks for
+ * the earliest deadline and light-sleeps until just before it, with the
+ * touch, IMU, PMIC, RTC and button lines as wake sources to end the sleep
+ * early. A gap shorter than the cost of sleeping is idled instead.
+ *
+ * Time is passed in, so a virtual clock drives the scheduler on host.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+
+#define SCHEDULER_MIN_SLEEP_MS 4     // Shorter gaps cost more to sleep through than to idle
+#define SCHEDULER_WAKE_MARGIN_MS 1   // Wake this much early to be on time
+
+enum LoopDeadline {
+  DEADLINE_FRAME,       // Next redraw at the screen's idle rate
+  DEADLINE_ANIMATION,   // Next tick while something moves
+  DEADLINE_SENSORS,     // Sensor task cycle or overnight FIFO fetch
+  DEADLINE_TIME,        // Alarm minute or timer expiry
+  DEADLINE_POWER,       // Battery reading
+  DEADLINE_INPUT,       // Button debounce settling
+  DEADLINE_COUNT
+};
+
+struct SchedulerStats {
+  uint32_t sleeps;
+  uint32_t early_wakes;        // Ended by an interrupt before the deadline
+  uint32_t idles;              // Gaps too short to sleep through
+  uint64_t slept_ms;
+  uint32_t woken_by[DEADLINE_COUNT];  // Sleeps that ran to each deadline
+};
+
+struct LoopScheduler {
+  uint32_t due_ms[DEADLINE_COUNT];
+  uint32_t armed;              // One bit per deadline
+  SchedulerStats stats;
+};
+
+struct SleepPlan {
+  uint32_t sleep_ms;           // 0: stay awake
+  int deadline;                // Earliest, -1 when none is armed before max_ms
+};
+
+void schedulerInit(LoopScheduler& scheduler);
+void schedulerArm(LoopScheduler& scheduler, int deadline, uint32_t due_ms);
+void schedulerDisarm(LoopScheduler& scheduler, int deadline);
+bool schedulerArmed(const LoopScheduler& scheduler, int deadline);
+bool schedulerDue(const LoopScheduler& scheduler, int deadline, uint32_t now_ms);
+
+// Sleep until the earliest deadline; max_ms bounds it when nothing is armed
+SleepPlan schedulerPlanSleep(LoopScheduler& scheduler, uint32_t now_ms, uint32_t max_ms);
+void schedulerNoteWake(LoopScheduler& scheduler, const SleepPlan& plan, uint32_t slept_ms);
+
+#endif // SCHEDULER_H
\ No newline at end of file
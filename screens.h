@@ -0,0 +1,27 @@
+/*
+ * Screen Identifiers for ESP32-S3 Watch
+ * Kept free of Arduino headers so per-screen tables size from them on host
+ */
+
+#ifndef SCREENS_H
+#define SCREENS_H
+
+enum ScreenType {
+  SCREEN_SPLASH,
+  SCREEN_WATCHFACE,
+  SCREEN_APP_GRID,
+  SCREEN_MUSIC,
+  SCREEN_NOTES,
+  SCREEN_QUESTS,
+  SCREEN_SETTINGS,
+  SCREEN_PDF_READER,
+  SCREEN_FILE_BROWSER,
+  SCREEN_SLEEP,
+  SCREEN_CHARGING,
+  SCREEN_ACTIVITY,
+  SCREEN_SLEEP_REPORT,
+  SCREEN_ENERGY,
+  SCREEN_COUNT                 // Not a screen: sizes per-screen tables
+};
+
+#endif // SCREENS_H
\ No newline at end of file
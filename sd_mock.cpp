@@ -0,0 +1,92 @@
+/*
+ * Directory-Backed SD Card Implementation
+ * stdio files with positioned reads and writes
+ */
+
+#include "sd_mock.h"
+
+#ifndef ARDUINO
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+static char mock_root[256];
+static SDMockStats mock_stats;
+
+void sdMockBegin(const char* root) {
+  snprintf(mock_root, sizeof(mock_root), "%s", root);
+  mkdir(mock_root, 0755);
+  memset(&mock_stats, 0, sizeof(mock_stats));
+}
+
+static void hostPath(const char* path, char* full, size_t length) {
+  snprintf(full, length, "%s%s", mock_root, path);
+}
+
+// Create the directories leading up to a file
+static void makeParents(const char* full) {
+  char partial[512];
+  snprintf(partial, sizeof(partial), "%s", full);
+  for (char* slash = partial + strlen(mock_root) + 1; (slash = strchr(slash, '/')) != nullptr; slash++) {
+    *slash = '\0';
+    mkdir(partial, 0755);
+    *slash = '/';
+  }
+}
+
+static int32_t mockSize(const char* path) {
+  char full[512];
+  hostPath(path, full, sizeof(full));
+  mock_stats.sizes++;
+  struct stat info;
+  if (stat(full, &info) != 0) return -1;
+  return (int32_t)info.st_size;
+}
+
+static bool mockRead(const char* path, uint32_t offset, uint8_t* data, size_t length) {
+  char full[512];
+  hostPath(path, full, sizeof(full));
+  FILE* file = fopen(full, "rb");
+  if (file == nullptr) return false;
+  bool ok = fseek(file, offset, SEEK_SET) == 0 && fread(data, 1, length, file) == length;
+  fclose(file);
+  mock_stats.reads++;
+  mock_stats.bytes_read += length;
+  return ok;
+}
+
+static bool mockWrite(const char* path, uint32_t offset, const uint8_t* data, size_t length) {
+  char full[512];
+  hostPath(path, full, sizeof(full));
+  FILE* file = fopen(full, "r+b");
+  if (file == nullptr) {
+    makeParents(full);
+    file = fopen(full, "w+b");
+    if (file == nullptr) return false;
+  }
+
+  // Like FAT, no holes: writes start inside the file or at its end
+  fseek(file, 0, SEEK_END);
+  bool ok = (uint32_t)ftell(file) >= offset && fseek(file, offset, SEEK_SET) == 0 &&
+            fwrite(data, 1, length, file) == length;
+  fclose(file);
+  mock_stats.writes++;
+  mock_stats.bytes_written += length;
+  return ok;
+}
+
+const ActivityLogStorage& sdMockStorage() {
+  static const ActivityLogStorage storage = {mockSize, mockRead, mockWrite};
+  return storage;
+}
+
+const SDMockStats& sdMockGetStats() {
+  return mock_stats;
+}
+
+void sdMockResetStats() {
+  memset(&mock_stats, 0, sizeof(mock_stats));
+}
+
+#endif // ARDUINO
\ No newline at end of file
@@ -0,0 +1,30 @@
+/*
+ * Directory-Backed SD Card for Host Builds
+ * ActivityLogStorage over ordinary files under a root directory
+ *
+ * Paths like "/activity/days.dat" map to <root>/activity/days.dat, with
+ * directories created on first write. Every call is counted, so append
+ * and query costs can be compared by SD operations as well as wall time.
+ * Only compiled outside the Arduino build.
+ */
+
+#ifndef SD_MOCK_H
+#define SD_MOCK_H
+
+#ifndef ARDUINO
+
+#include "activity_log.h"
+
+struct SDMockStats {
+  uint32_t sizes, reads, writes;
+  uint64_t bytes_read, bytes_written;
+};
+
+void sdMockBegin(const char* root);
+const ActivityLogStorage& sdMockStorage();
+const SDMockStats& sdMockGetStats();
+void sdMockResetStats();
+
+#endif // ARDUINO
+
+#endif // SD_MOCK_H
\ No newline at end of file
@@ -4,17 +4,215 @@
  */
 
 #include "sensors.h"
+#include "i2c_bus.h"
+#include "i2c_trace.h"
+#include "imu_motion.h"
+#include "orientation.h"
+#include "rtc.h"
+#include "imu_calibration.h"
+#include "sleep_tracker.h"
+#include "channels.h"
+#include <Preferences.h>
 
 // Sensor state variables
 IMUData current_imu;
 StepData step_data;
-float step_threshold = MIN_STEP_THRESHOLD;
 unsigned long last_step_check = 0;
 bool step_detection_active = true;
 
+// Pedometer and its measured cost on the target
+static Pedometer pedometer;
+static uint64_t pedometer_cycles = 0;
+static uint32_t pedometer_samples = 0;
+
+// FIFO batches land here, each motion algorithm keeps its own cursor
+IMUSampleRing imu_ring;
+static IMURingCursor step_cursor;
+static bool imu_fifo_active = false;
+static volatile bool imu_fifo_ready = false;
+static unsigned long last_fifo_drain = 0;
+
+// Calibration applied to every batch on its way into the ring, kept in NVS
+static IMUCalibration imu_calibration;
+static IMUStillDetector still_detector;
+static int32_t saved_gyro_bias[3];
+static unsigned long last_calibration_save = 0;
+static bool calibration_save_due = false;
+
+// Activity classifier, fed a window per second from the ring
+static ActivityClassifier activity;
+static IMURingCursor activity_cursor;
+static uint64_t activity_cycles = 0;
+static uint32_t active_windows = 0;
+
+// History store, the open minute accumulates here until the clock moves on
+static ActivityLog activity_log;
+static bool activity_log_ready = false;
+static uint32_t log_minute = 0;
+static int log_steps_start = 0;
+static float log_energy_start = 0;
+static uint32_t log_active_seconds = 0;
+static ActivityTotals log_open = {};           // The open minute as the loop sees it, under history_lock
+static unsigned long last_log_check = 0;
+static uint64_t chart_query_us = 0;
+static uint32_t chart_queries = 0;
+
+// Orientation and wrist gestures, one detector across sleep and wake
+static MahonyFilter fusion;
+static WristDetector wrist;
+static IMURingCursor orientation_cursor;
+static uint64_t orientation_cycles = 0;
+static uint32_t orientation_samples = 0;
+static unsigned long wrist_watch_until = 0;
+static float sleep_up[3];
+static unsigned long last_sleep_sample = 0;
+
+// Overnight actigraphy from the motion mode FIFO
+static SleepTracker sleep_tracker;
+static bool sleep_tracking = false;
+static bool sleep_fifo_active = false;
+static uint32_t sleep_minute = 0;         // Epoch being counted
+static bool sleep_minute_awake = false;   // The screen was on during it
+static unsigned long last_sleep_drain = 0;
+static unsigned long last_sleep_check = 0;
+static uint64_t sleep_drain_us = 0;
+static uint32_t sleep_drains = 0;
+static SleepNight last_night;
+static bool has_last_night = false;
+static void loadLastNight();
+static void loadIMUGestures();
+static void startSleepFifo();
+static void drainSleepFifo();
+
+// Template-matched wrist gestures, handed to the loop as touch events
+static IMUGestureEngine imu_gestures;
+static IMURingCursor gesture_cursor;
+static int next_gesture_recording = 0;
+static uint64_t gesture_cycles = 0;
+
+// Raw sample stream for tools/train_activity.py
+static bool imu_streaming = false;
+static IMURingCursor stream_cursor;
+
+// While the watch sleeps the IMU counts steps itself
+static bool imu_motion_active = false;
+static StepSync hardware_steps;
+
+// Loop -> task requests, each run at the start of the next cycle
+enum SensorCommandType {
+  SENSOR_CMD_SERVICE,              // Just run a cycle
+  SENSOR_CMD_ENTER_MOTION_SLEEP,
+  SENSOR_CMD_EXIT_MOTION_SLEEP,
+  SENSOR_CMD_WATCH_WRIST,
+  SENSOR_CMD_CALIBRATE,
+  SENSOR_CMD_RECORD_GESTURE,
+  SENSOR_CMD_STREAM,               // arg: on or off
+  SENSOR_CMD_REPORT
+};
+
+struct SensorCommand {
+  uint8_t type;
+  uint8_t arg;
+};
+
+// Task -> loop, what used to be the pending_* flags
+enum SensorEventType {
+  SENSOR_EVENT_WRIST,              // value: WristEvent
+  SENSOR_EVENT_GESTURE,            // value: IMUGestureType
+  SENSOR_EVENT_NEW_NIGHT
+};
+
+struct SensorEvent {
+  uint8_t type;
+  int8_t value;
+};
+
+// Sensor task on core 0 and what it hands the loop. Everything above is
+// owned by the task; the loop only sees the snapshot and the event queue.
+static TaskHandle_t sensor_task = nullptr;
+static SemaphoreHandle_t sensor_idle = nullptr;    // Held for a whole cycle, light sleep waits on it
+static SemaphoreHandle_t history_lock = nullptr;   // Activity log and last night, read by the UI
+static Seqlock sensor_snapshot;
+static SPSCQueue command_queue;                    // Loop -> task
+static SPSCQueue event_queue;                      // Task -> loop
+static SensorCommand command_slots[SENSOR_QUEUE_LENGTH];
+static SensorEvent event_slots[SENSOR_QUEUE_LENGTH];
+static uint32_t commands_done = 0;
+static uint32_t sensor_cycles = 0;
+static unsigned long last_cycle_start = 0;
+static uint32_t cycle_us_total = 0;
+static uint32_t cycle_us_max = 0;
+static unsigned long cycle_gap_max = 0;
+static int16_t imu_temperature_c10 = 0;
+static bool imu_temperature_valid = false;
+static unsigned long last_temperature_read = 0;
+
+// Loop side of the handoff
+static SensorSnapshot sensor_view;
+static uint32_t view_sequence = 1;                 // Odd, so the first look always reads
+static uint32_t commands_posted = 0;
+static WristEvent pending_wrist = WRIST_NONE;
+static IMUGestureType pending_imu_gesture = IMU_GESTURE_NONE;
+static bool new_night = false;
+
+static void IRAM_ATTR onIMUInterrupt() {
+  imu_fifo_ready = true;
+  if (sensor_task != nullptr) {
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(sensor_task, &woken);
+    portYIELD_FROM_ISR(woken);
+  }
+}
+
+static void postSensorEvent(SensorEventType type, int8_t value) {
+  SensorEvent event = {(uint8_t)type, value};
+  spscPush(event_queue, &event);
+}
+
+static void loadIMUCalibration() {
+  Preferences preferences;
+  preferences.begin("imu_cal", true);
+  size_t length = preferences.getBytes("cal", &imu_calibration, sizeof(imu_calibration));
+  preferences.end();
+  
+  if (length != sizeof(imu_calibration) || !imuCalibrationValid(imu_calibration)) {
+    imuCalibrationDefaults(imu_calibration);
+    Serial.println("IMU calibration: none stored, learning in the background");
+  }
+  memcpy(saved_gyro_bias, imu_calibration.gyro_bias, sizeof(saved_gyro_bias));
+  imuStillInit(still_detector);
+}
+
+static void saveIMUCalibration() {
+  Preferences preferences;
+  preferences.begin("imu_cal", false);
+  preferences.putBytes("cal", &imu_calibration, sizeof(imu_calibration));
+  preferences.end();
+  
+  memcpy(saved_gyro_bias, imu_calibration.gyro_bias, sizeof(saved_gyro_bias));
+  last_calibration_save = millis();
+  calibration_save_due = false;
+}
+
+static void calibrateBatch(IMUSample* samples, int count) {
+  // Track on the raw batch, then correct it before anyone else sees it
+  int changed = imuCalibrationTrack(still_detector, imu_calibration, samples, count);
+  imuCalibrationApply(imu_calibration, samples, count);
+  
+  if (imuCalibrationSaveDue(imu_calibration, saved_gyro_bias, changed, millis() - last_calibration_save)) {
+    calibration_save_due = true;
+  }
+}
+
 bool initializeSensors() {
   Serial.println("Initializing sensors...");
   
+  seqlockInit(sensor_snapshot, sizeof(SensorSnapshot));
+  spscInit(command_queue, command_slots, sizeof(SensorCommand), SENSOR_QUEUE_LENGTH);
+  spscInit(event_queue, event_slots, sizeof(SensorEvent), SENSOR_QUEUE_LENGTH);
+  sensor_idle = xSemaphoreCreateMutex();
+  history_lock = xSemaphoreCreateMutex();
+  
   if (!initializeIMU()) {
     Serial.println("IMU initialization failed!");
     return false;
@@ -25,292 +223,1014 @@ bool initializeSensors() {
   step_data.calories_burned = 0;
   step_data.distance_km = 0.0;
   step_data.active_minutes = 0;
+  step_data.cadence_spm = 0;
   step_data.last_step_time = 0;
   
+  PedometerProfile profile = {USER_HEIGHT_CM, USER_WEIGHT_KG};
+  pedometerInit(pedometer, profile);
+  loadLastNight();
+  
   Serial.println("Sensors initialized successfully");
   return true;
 }
 
 bool initializeIMU() {
-  // Initialize I2C for QMI8658
-  Wire1.begin(IMU_SDA, IMU_SCL);
-  Wire1.setClock(400000);
-  
   // QMI8658 I2C address is typically 0x6A or 0x6B
-  uint8_t imu_address = 0x6A;
-  
-  // Test communication
-  Wire1.beginTransmission(imu_address);
-  if (Wire1.endTransmission() != 0) {
-    imu_address = 0x6B;
-    Wire1.beginTransmission(imu_address);
-    if (Wire1.endTransmission() != 0) {
+  if (!i2cProbe(I2C_DEV_IMU)) {
+    i2cSetDeviceAddress(I2C_DEV_IMU, 0x6B);
+    if (!i2cProbe(I2C_DEV_IMU)) {
       Serial.println("QMI8658 IMU not found!");
       return false;
     }
   }
   
-  // Configure IMU settings
-  // Enable accelerometer and gyroscope
-  Wire1.beginTransmission(imu_address);
-  Wire1.write(0x02); // CTRL2 register
-  Wire1.write(0x05); // Enable accel and gyro
-  Wire1.endTransmission();
+  // ±4g / ±512dps at 56Hz, batched through the FIFO
+  imuRingInit(imu_ring);
+  imuRingCursorInit(imu_ring, step_cursor);
+  imuRingCursorInit(imu_ring, activity_cursor);
+  imuRingCursorInit(imu_ring, orientation_cursor);
+  activityInit(activity);
+  mahonyInit(fusion, MAHONY_KP, MAHONY_KI);
+  wristDetectorInit(wrist);
+  imuRingCursorInit(imu_ring, gesture_cursor);
+  loadIMUGestures();
+  loadIMUCalibration();
+  imuFifoSetFilter(calibrateBatch);
   
-  // Set accelerometer range to ±4g
-  Wire1.beginTransmission(imu_address);
-  Wire1.write(0x03); // CTRL3 register
-  Wire1.write(0x04); // ±4g range, 100Hz ODR
-  Wire1.endTransmission();
+  I2CCaller previous_caller = i2cTraceSetCaller(I2C_CALLER_SENSORS);
+  imu_fifo_active = imuFifoConfigure();
+  i2cTraceSetCaller(previous_caller);
   
-  // Set gyroscope range to ±512 dps
-  Wire1.beginTransmission(imu_address);
-  Wire1.write(0x04); // CTRL4 register
-  Wire1.write(0x04); // ±512 dps, 100Hz ODR
-  Wire1.endTransmission();
+  if (!imu_fifo_active) {
+    Serial.println("QMI8658 FIFO setup failed!");
+    return false;
+  }
+  
+  // Watermark interrupt, polling in serviceIMUFifo() covers a missed edge
+  pinMode(IMU_INT, INPUT);
+  attachInterrupt(digitalPinToInterrupt(IMU_INT), onIMUInterrupt, RISING);
+  last_fifo_drain = millis();
   
   Serial.println("QMI8658 IMU configured successfully");
   return true;
 }
 
-IMUData readIMU() {
+static IMUData imuSampleToData(const IMUSample& sample) {
   IMUData imu_data;
-  uint8_t imu_address = 0x6A; // Assuming successful initialization
-  
-  // Read accelerometer data (6 bytes)
-  Wire1.beginTransmission(imu_address);
-  Wire1.write(0x35); // Accel X LSB register
-  Wire1.endTransmission();
-  
-  Wire1.requestFrom(imu_address, 6);
-  if (Wire1.available() >= 6) {
-    int16_t ax = Wire1.read() | (Wire1.read() << 8);
-    int16_t ay = Wire1.read() | (Wire1.read() << 8);
-    int16_t az = Wire1.read() | (Wire1.read() << 8);
-    
-    // Convert to g-force (±4g range, 16-bit)
-    imu_data.accel_x = ax / 8192.0;
-    imu_data.accel_y = ay / 8192.0;
-    imu_data.accel_z = az / 8192.0;
-  }
-  
-  // Read gyroscope data (6 bytes)
-  Wire1.beginTransmission(imu_address);
-  Wire1.write(0x3B); // Gyro X LSB register
-  Wire1.endTransmission();
-  
-  Wire1.requestFrom(imu_address, 6);
-  if (Wire1.available() >= 6) {
-    int16_t gx = Wire1.read() | (Wire1.read() << 8);
-    int16_t gy = Wire1.read() | (Wire1.read() << 8);
-    int16_t gz = Wire1.read() | (Wire1.read() << 8);
-    
-    // Convert to degrees per second (±512 dps range)
-    imu_data.gyro_x = gx / 64.0;
-    imu_data.gyro_y = gy / 64.0;
-    imu_data.gyro_z = gz / 64.0;
-  }
-  
-  imu_data.timestamp = millis();
+  imu_data.accel_x = sample.accel[0] / IMU_ACCEL_LSB_PER_G;
+  imu_data.accel_y = sample.accel[1] / IMU_ACCEL_LSB_PER_G;
+  imu_data.accel_z = sample.accel[2] / IMU_ACCEL_LSB_PER_G;
+  imu_data.gyro_x = sample.gyro[0] / IMU_GYRO_LSB_PER_DPS;
+  imu_data.gyro_y = sample.gyro[1] / IMU_GYRO_LSB_PER_DPS;
+  imu_data.gyro_z = sample.gyro[2] / IMU_GYRO_LSB_PER_DPS;
+  imu_data.temperature = 0;
+  imu_data.timestamp = sample.timestamp_us / 1000;
   return imu_data;
 }
 
-void updateStepCounter() {
-  if (!step_detection_active) return;
+void serviceIMUFifo() {
+  if (!imu_fifo_active) return;
   
-  unsigned long current_time = millis();
-  if (current_time - last_step_check < 50) return; // Limit to 20Hz
+  // Drain on the watermark, or after two batch periods without one
+  unsigned long now = millis();
+  unsigned long batch_ms = IMU_FIFO_WATERMARK * IMU_SAMPLE_PERIOD_US / 1000;
+  if (!imu_fifo_ready && now - last_fifo_drain < 2 * batch_ms) return;
+  imu_fifo_ready = false;
+  last_fifo_drain = now;
   
-  current_imu = readIMU();
+  I2CCaller previous_caller = i2cTraceSetCaller(I2C_CALLER_SENSORS);
+  int drained = imuFifoDrain(imu_ring, micros());
+  i2cTraceSetCaller(previous_caller);
   
-  if (detectStep(current_imu)) {
-    step_data.daily_steps++;
-    step_data.last_step_time = current_time;
-    
-    // Calculate calories (rough approximation)
-    step_data.calories_burned = step_data.daily_steps * 0.04; // ~0.04 cal per step
-    
-    // Calculate distance (rough approximation)
-    step_data.distance_km = step_data.daily_steps * 0.0007; // ~70cm per step
+  IMUSample latest;
+  if (drained > 0 && imuRingLatest(imu_ring, latest)) {
+    current_imu = imuSampleToData(latest);
+  }
+  if (calibration_save_due) saveIMUCalibration();
+}
+
+static void startMotionSleep() {
+  if (!imu_fifo_active) return;
+  
+  // Catch up on buffered samples before the FIFO goes away
+  serviceIMUFifo();
+  updateStepCounter();
+  
+  I2CCaller previous_caller = i2cTraceSetCaller(I2C_CALLER_SENSORS);
+  uint32_t count = 0;
+  bool ok = imuMotionEnter() && imuReadStepCount(count);
+  i2cTraceSetCaller(previous_caller);
+  
+  if (!ok) {
+    Serial.println("IMU motion mode failed, staying on FIFO");
+    imuFifoConfigure();
+    return;
   }
   
-  last_step_check = current_time;
+  stepSyncBegin(hardware_steps, count);
+  imu_fifo_active = false;
+  imu_motion_active = true;
+  wrist_watch_until = 0;
+  if (sleep_tracking) startSleepFifo();
 }
 
-bool detectStep(IMUData& imu) {
-  static float last_magnitude = 0;
-  static unsigned long last_step = 0;
-  static bool step_in_progress = false;
+void reconcileHardwareSteps() {
+  if (!imu_motion_active) return;
   
-  // Calculate magnitude of acceleration
-  float magnitude = sqrt(imu.accel_x * imu.accel_x + 
-                        imu.accel_y * imu.accel_y + 
-                        imu.accel_z * imu.accel_z);
+  I2CCaller previous_caller = i2cTraceSetCaller(I2C_CALLER_SENSORS);
+  uint32_t count;
+  bool ok = imuReadStepCount(count);
+  i2cTraceSetCaller(previous_caller);
+  if (!ok) return;
   
-  unsigned long current_time = millis();
+  uint32_t steps = stepSyncUpdate(hardware_steps, count);
+  if (steps > 0) {
+    pedometerAddSteps(pedometer, steps);
+    step_data.daily_steps += steps;
+    step_data.last_step_time = millis();
+    step_data.distance_km = pedometer.distance_m / 1000.0;
+    step_data.calories_burned = (int)pedometer.energy_kcal;
+  }
+}
+
+static void stopMotionSleep() {
+  if (!imu_motion_active) return;
+  reconcileHardwareSteps();
+  if (sleep_fifo_active) drainSleepFifo();
+  sleep_fifo_active = false;
   
-  // Step detection algorithm
-  // Look for peaks above threshold with proper timing
-  if (magnitude > step_threshold && !step_in_progress && 
-      current_time - last_step > STEP_TIME_WINDOW) {
-    
-    // Confirm it's a step by checking if it's followed by a valley
-    if (last_magnitude < step_threshold * 0.8) {
-      step_in_progress = true;
-      last_step = current_time;
-      last_magnitude = magnitude;
-      return true;
+  I2CCaller previous_caller = i2cTraceSetCaller(I2C_CALLER_SENSORS);
+  bool ok = imuMotionExit();
+  i2cTraceSetCaller(previous_caller);
+  
+  imu_motion_active = false;
+  imu_fifo_active = ok;
+  imu_fifo_ready = false;
+  last_fifo_drain = millis();
+  wrist_watch_until = 0;
+  
+  // The quaternion is stale after the gap, realign it on the first sample
+  fusion.initialized = false;
+  imuRingCursorInit(imu_ring, orientation_cursor);
+  imuRingCursorInit(imu_ring, gesture_cursor);
+  if (!ok) {
+    Serial.println("IMU FIFO restart failed!");
+  }
+}
+
+static void reportIMUFifo() {
+  const IMUFifoStats& stats = imuFifoGetStats();
+  Serial.printf("IMU FIFO: %lu batches, %lu samples, %lu overflows, %lu errors, %lu step drops\n",
+                (unsigned long)stats.batches, (unsigned long)stats.samples,
+                (unsigned long)stats.overflows, (unsigned long)stats.errors,
+                (unsigned long)step_cursor.dropped);
+}
+
+IMUData readIMU() {
+  IMUData imu_data = {};
+  
+  // Accel X LSB (0x35) through gyro Z MSB (0x40) in one burst
+  uint8_t raw[12];
+  I2CCaller previous_caller = i2cTraceSetCaller(I2C_CALLER_SENSORS);
+  bool read_ok = i2cReadRegs(I2C_DEV_IMU, 0x35, raw, sizeof(raw));
+  i2cTraceSetCaller(previous_caller);
+  
+  if (read_ok) {
+    IMUSample sample = {};
+    for (int axis = 0; axis < 3; axis++) {
+      sample.accel[axis] = raw[axis * 2] | (raw[axis * 2 + 1] << 8);
+      sample.gyro[axis] = raw[6 + axis * 2] | (raw[7 + axis * 2] << 8);
     }
+    imuCalibrationApply(imu_calibration, &sample, 1);
+    imu_data = imuSampleToData(sample);
   }
   
-  // Reset step detection state
-  if (magnitude < step_threshold * 0.7) {
-    step_in_progress = false;
+  imu_data.timestamp = millis();
+  return imu_data;
+}
+
+void updateStepCounter() {
+  if (!step_detection_active) return;
+  
+  // Feed every sample since the last call through the pedometer
+  IMUSample samples[32];
+  int count;
+  while ((count = imuRingRead(imu_ring, step_cursor, samples, 32)) > 0) {
+    uint32_t start = ESP.getCycleCount();
+    int steps = pedometerProcess(pedometer, samples, count);
+    pedometer_cycles += ESP.getCycleCount() - start;
+    pedometer_samples += count;
+    
+    if (steps > 0) {
+      step_data.daily_steps += steps;
+      step_data.last_step_time = samples[count - 1].timestamp_us / 1000;
+    }
   }
   
-  last_magnitude = magnitude;
-  return false;
+  // Distance and energy follow cadence-dependent stride length
+  step_data.cadence_spm = pedometer.cadence_spm;
+  step_data.distance_km = pedometer.distance_m / 1000.0;
+  step_data.calories_burned = (int)pedometer.energy_kcal;
+  
+  last_step_check = millis();
 }
 
 void resetDailySteps() {
+  pedometerResetTotals(pedometer);
   step_data.daily_steps = 0;
   step_data.calories_burned = 0;
   step_data.distance_km = 0.0;
   step_data.active_minutes = 0;
 }
 
-int getDailySteps() {
-  return step_data.daily_steps;
+void updateActivity() {
+  IMUSample samples[32];
+  int count;
+  while ((count = imuRingRead(imu_ring, activity_cursor, samples, 32)) > 0) {
+    uint32_t start = ESP.getCycleCount();
+    int windows = activityProcess(activity, samples, count);
+    activity_cycles += ESP.getCycleCount() - start;
+    
+    // Every classified window is one second of the active total
+    if (windows > 0 && activityIsMoving(activity.current)) {
+      active_windows += windows;
+      log_active_seconds += windows;
+    }
+  }
 }
 
-bool isMoving() {
-  float magnitude = sqrt(current_imu.accel_x * current_imu.accel_x + 
-                        current_imu.accel_y * current_imu.accel_y + 
-                        current_imu.accel_z * current_imu.accel_z);
-  
-  return magnitude > 1.2; // Above 1.2g indicates movement
+static void startIMUStream(bool enabled) {
+  imu_streaming = enabled;
+  imuRingCursorInit(imu_ring, stream_cursor);
 }
 
-bool isRunning() {
-  // Check for higher frequency and magnitude changes
-  return isMoving() && abs(current_imu.gyro_y) > 50; // High angular velocity
+static void streamIMUSamples() {
+  IMUSample samples[32];
+  int count;
+  while ((count = imuRingRead(imu_ring, stream_cursor, samples, 32)) > 0) {
+    for (int i = 0; i < count; i++) {
+      const IMUSample& s = samples[i];
+      Serial.printf("imu,%lu,%d,%d,%d,%d,%d,%d\n", (unsigned long)s.timestamp_us,
+                    s.accel[0], s.accel[1], s.accel[2], s.gyro[0], s.gyro[1], s.gyro[2]);
+    }
+  }
 }
 
-String getCurrentActivity() {
-  if (isRunning()) {
-    return "Running";
-  } else if (isMoving()) {
-    return "Walking";
-  } else {
-    return "Stationary";
+static void reportActivity() {
+  Serial.printf("Activity: %s, %lu windows, %.0f cycles/window\n",
+                activityName(activity.current), (unsigned long)activity.windows,
+                activity.windows ? (double)activity_cycles / activity.windows : 0.0);
+}
+
+bool initializeActivityLog(const ActivityLogStorage& storage) {
+  // A warm boot mounts the SD card after the task has started
+  xSemaphoreTake(history_lock, portMAX_DELAY);
+  activity_log_ready = activityLogOpen(activity_log, storage);
+  xSemaphoreGive(history_lock);
+  if (!activity_log_ready) {
+    Serial.println("Activity history unavailable, keeping today's counters only");
+    return false;
   }
+  Serial.printf("Activity history: page %lu, %u records open\n",
+                (unsigned long)activity_log.page_number, activity_log.page_records);
+  return true;
+}
+
+static uint32_t currentLogMinute() {
+  WatchTime now = getCurrentTime();
+  return activityLogMinuteOf(now.year, now.month, now.day, now.hour, now.minute);
+}
+
+static void startLogMinute(uint32_t minute) {
+  log_minute = minute;
+  log_steps_start = step_data.daily_steps;
+  log_energy_start = pedometer.energy_kcal;
+  log_active_seconds = 0;
+  log_open = ActivityTotals();
+}
+
+static void publishOpenMinute() {
+  if (!activity_log_ready || history_lock == nullptr || log_minute == 0) return;
+  
+  // The counters themselves are the task's, the loop reads this copy
+  ActivityTotals open = {};
+  open.steps = max(step_data.daily_steps - log_steps_start, 0);
+  open.active_seconds = log_active_seconds;
+  open.energy_dcal = max((int)((pedometer.energy_kcal - log_energy_start) * 10.0f), 0);
+  xSemaphoreTake(history_lock, portMAX_DELAY);
+  log_open = open;
+  xSemaphoreGive(history_lock);
 }
 
-bool detectWristRaise() {
-  // Detect wrist raise gesture for screen wake
-  static float baseline_z = -9.8; // Gravity when arm is down
+void updateActivityLog() {
+  if (millis() - last_log_check < 1000) return;
+  last_log_check = millis();
   
-  if (current_imu.accel_z > baseline_z + 3.0 && // Wrist raised
-      abs(current_imu.gyro_x) > 30) { // Quick rotation
-    return true;
+  uint32_t minute = currentLogMinute();
+  if (log_minute == 0) {
+    xSemaphoreTake(history_lock, portMAX_DELAY);
+    startLogMinute(minute);
+    xSemaphoreGive(history_lock);
+    return;
   }
-  return false;
+  if (minute == log_minute) return;
+  
+  // Close the finished minute, clamped into the record's fields
+  int steps = step_data.daily_steps - log_steps_start;
+  int energy = (int)((pedometer.energy_kcal - log_energy_start) * 10.0f + 0.5f);
+  ActivityMinute bucket;
+  bucket.minute = log_minute;
+  bucket.steps = constrain(steps, 0, 65535);
+  bucket.active_seconds = min(log_active_seconds, (uint32_t)60);
+  bucket.energy_dcal = constrain(energy, 0, 65535);
+  
+  bool new_day = activityLogPeriod(ROLLUP_DAY, minute) != activityLogPeriod(ROLLUP_DAY, log_minute);
+  xSemaphoreTake(history_lock, portMAX_DELAY);
+  if (activity_log_ready) {
+    activityLogAppend(activity_log, bucket);
+    if (new_day || minute % ACTIVITY_LOG_FLUSH_MINUTES == 0) {
+      activityLogFlush(activity_log);
+    }
+  }
+  
+  // Today's counters start over at midnight, the days before live in the log
+  if (new_day) resetDailySteps();
+  startLogMinute(minute);
+  xSemaphoreGive(history_lock);
 }
 
-bool detectWristFlick() {
-  // Detect quick wrist flick for navigation
-  return abs(current_imu.gyro_z) > 100; // Quick Z-axis rotation
+int getActivityHistory(RollupLevel level, int periods, ActivityTotals* totals) {
+  if (!activity_log_ready || history_lock == nullptr) return 0;
+  
+  // Runs on the loop: the task waits only to close or publish a minute meanwhile
+  xSemaphoreTake(history_lock, portMAX_DELAY);
+  if (log_minute == 0) {
+    xSemaphoreGive(history_lock);
+    return 0;
+  }
+  
+  // The last few periods up to and including the current one
+  uint32_t start = micros();
+  uint32_t current = activityLogPeriod(level, log_minute);
+  uint32_t first = current + 1 > (uint32_t)periods ? current + 1 - periods : 0;
+  int count = activityLogTotals(activity_log, level, first, current + 1 - first, totals);
+  
+  // The open minute is not in the log yet
+  if (count > 0) {
+    totals[count - 1].steps += log_open.steps;
+    totals[count - 1].active_seconds += log_open.active_seconds;
+    totals[count - 1].energy_dcal += log_open.energy_dcal;
+  }
+  chart_query_us += micros() - start;
+  chart_queries++;
+  xSemaphoreGive(history_lock);
+  return count;
+}
+
+static void reportActivityLog() {
+  if (!activity_log_ready) return;
+  const ActivityLogStats& stats = activity_log.stats;
+  Serial.printf("History: %lu minutes, %lu idle, %lu rejected, %lu pages, %lu KB written, %.0f us/chart\n",
+                (unsigned long)stats.appended, (unsigned long)stats.idle, (unsigned long)stats.rejected,
+                (unsigned long)stats.pages_written, (unsigned long)(stats.bytes_written / 1024),
+                chart_queries ? (double)chart_query_us / chart_queries : 0.0);
+}
+
+static void loadLastNight() {
+  Preferences preferences;
+  preferences.begin("sleep", true);
+  size_t length = preferences.getBytes("night", &last_night, sizeof(last_night));
+  preferences.end();
+  has_last_night = length == sizeof(last_night) && sleepNightValid(last_night);
+}
+
+static void saveLastNight() {
+  Preferences preferences;
+  preferences.begin("sleep", false);
+  preferences.putBytes("night", &last_night, sizeof(last_night));
+  preferences.end();
 }
 
-bool detectDoubleTab() {
-  // Detect double tap on watch face
-  static unsigned long last_tap = 0;
-  static int tap_count = 0;
+// Minutes from one time of day to the next, across midnight
+static int minutesAfter(int from, int to) {
+  return (to - from + 24 * 60) % (24 * 60);
+}
+
+static void startSleepFifo() {
+  I2CCaller previous_caller = i2cTraceSetCaller(I2C_CALLER_SENSORS);
+  sleep_fifo_active = imuMotionFifoStart();
+  i2cTraceSetCaller(previous_caller);
+  last_sleep_drain = millis();
+}
+
+static void drainSleepFifo() {
+  static IMUSample samples[IMU_MOTION_FIFO_MAX_FRAMES];
+  uint32_t start = micros();
+  I2CCaller previous_caller = i2cTraceSetCaller(I2C_CALLER_SENSORS);
+  int count = imuMotionFifoDrain(samples, IMU_MOTION_FIFO_MAX_FRAMES);
+  i2cTraceSetCaller(previous_caller);
   
-  float magnitude = sqrt(current_imu.accel_x * current_imu.accel_x + 
-                        current_imu.accel_y * current_imu.accel_y + 
-                        current_imu.accel_z * current_imu.accel_z);
+  sleepTrackerAddSamples(sleep_tracker, samples, count);
+  last_sleep_drain = millis();
+  sleep_drain_us += micros() - start;
+  sleep_drains++;
+}
+
+static void finishSleepTracking() {
+  if (sleep_fifo_active) {
+    I2CCaller previous_caller = i2cTraceSetCaller(I2C_CALLER_SENSORS);
+    imuMotionFifoStop();
+    i2cTraceSetCaller(previous_caller);
+  }
+  sleep_tracking = false;
+  sleep_fifo_active = false;
   
-  if (magnitude > 15.0) { // Sharp acceleration spike
-    unsigned long current_time = millis();
-    
-    if (current_time - last_tap < 500) {
-      tap_count++;
-    } else {
-      tap_count = 1;
+  SleepNight night;
+  if (!sleepTrackerFinish(sleep_tracker, night)) {
+    Serial.println("Sleep: session too short or watch not worn, not kept");
+    return;
+  }
+  xSemaphoreTake(history_lock, portMAX_DELAY);
+  last_night = night;
+  has_last_night = true;
+  xSemaphoreGive(history_lock);
+  postSensorEvent(SENSOR_EVENT_NEW_NIGHT, 0);
+  saveLastNight();
+  Serial.printf("Sleep: %u min asleep of %u, %u%% efficient, %u awakenings\n",
+                night.summary.asleep_minutes, night.summary.epochs,
+                night.summary.efficiency, night.summary.awakenings);
+}
+
+void updateSleepTracking() {
+  if (sleep_fifo_active && millis() - last_sleep_drain >= SLEEP_TRACK_DRAIN_MS) drainSleepFifo();
+  if (sleep_tracking && !imu_motion_active) sleep_minute_awake = true;
+  
+  if (millis() - last_sleep_check < 1000) return;
+  last_sleep_check = millis();
+  
+  WatchTime now = getCurrentTime();
+  uint32_t minute = activityLogMinuteOf(now.year, now.month, now.day, now.hour, now.minute);
+  int time_of_day = now.hour * 60 + now.minute;
+  int window = minutesAfter(system_state.sleep_time, system_state.wake_time) + SLEEP_TRACK_LATE_MINUTES;
+  bool in_window = minutesAfter(system_state.sleep_time, time_of_day) < window;
+  bool morning = in_window && minutesAfter(system_state.wake_time, time_of_day) < SLEEP_TRACK_LATE_MINUTES;
+  
+  if (!sleep_tracking) {
+    // Lights out: the first time the screen sleeps inside the window
+    if (!in_window || morning || !imu_motion_active) return;
+    sleepTrackerBegin(sleep_tracker, minute);
+    sleep_tracking = true;
+    sleep_minute = minute;
+    sleep_minute_awake = false;
+    startSleepFifo();
+    Serial.println("Sleep: tracking started");
+    return;
+  }
+  
+  if (minute != sleep_minute) {
+    // A jump backwards or a long gap means the clock was set, end the night there
+    if (minute < sleep_minute || minute - sleep_minute > 10) {
+      finishSleepTracking();
+      return;
     }
-    
-    last_tap = current_time;
-    
-    if (tap_count >= 2) {
-      tap_count = 0;
-      return true;
+    if (sleep_fifo_active) drainSleepFifo();
+    while (sleep_minute != minute) {
+      sleepTrackerEndEpoch(sleep_tracker, sleep_minute_awake);
+      sleep_minute_awake = !imu_motion_active;
+      sleep_minute++;
     }
   }
   
-  return false;
+  // Up for the day once the screen is in use after wake_time
+  if (!in_window || (morning && !imu_motion_active) ||
+      sleep_tracker.night.summary.epochs >= SLEEP_MAX_EPOCHS) {
+    finishSleepTracking();
+  }
 }
 
-float getHeartRate() {
-  // Simulate heart rate based on activity level
-  if (isRunning()) {
-    return 140 + random(-10, 10);
-  } else if (isMoving()) {
-    return 90 + random(-5, 5);
+bool getLastNight(SleepNight& night) {
+  if (history_lock == nullptr) return false;
+  xSemaphoreTake(history_lock, portMAX_DELAY);
+  bool found = has_last_night;
+  if (found) night = last_night;
+  xSemaphoreGive(history_lock);
+  return found;
+}
+
+static void reportSleepTracking() {
+  Serial.printf("Sleep: %s, %u epochs, %lu drains, %.0f us/drain\n",
+                sleep_tracking ? "tracking" : "idle", sleep_tracker.night.summary.epochs,
+                (unsigned long)sleep_drains, sleep_drains ? (double)sleep_drain_us / sleep_drains : 0.0);
+}
+
+void updateOrientation() {
+  IMUSample samples[32];
+  int count;
+  while ((count = imuRingRead(imu_ring, orientation_cursor, samples, 32)) > 0) {
+    uint32_t start = ESP.getCycleCount();
+    for (int i = 0; i < count; i++) {
+      const IMUSample& s = samples[i];
+      float accel[3], gyro[3];
+      for (int axis = 0; axis < 3; axis++) {
+        accel[axis] = s.accel[axis] / IMU_ACCEL_LSB_PER_G;
+        gyro[axis] = s.gyro[axis] / IMU_GYRO_LSB_PER_DPS;
+      }
+      mahonyUpdate(fusion, gyro, accel, IMU_SAMPLE_PERIOD_US / 1e6f);
+      
+      float up[3];
+      mahonyGravity(fusion, up);
+      float rate = sqrtf(gyro[0] * gyro[0] + gyro[1] * gyro[1] + gyro[2] * gyro[2]);
+      WristEvent event = wristDetectorUpdate(wrist, up, rate, s.timestamp_us / 1000);
+      if (event != WRIST_NONE) postSensorEvent(SENSOR_EVENT_WRIST, event);
+    }
+    orientation_cycles += ESP.getCycleCount() - start;
+    orientation_samples += count;
+  }
+}
+
+static void startWristWatch() {
+  // Woken by motion: look at gravity for a moment before sleeping again
+  if (!imu_motion_active) return;
+  wristDetectorArm(wrist);
+  wrist_watch_until = millis() + WRIST_WATCH_MS;
+  last_sleep_sample = 0;
+}
+
+static void sampleWristInSleep() {
+  // Gyro and FIFO are off, so gravity comes straight from the accelerometer
+  // at the 100ms sensor cadence
+  unsigned long now = millis();
+  if ((long)(now - wrist_watch_until) >= 0) {
+    wrist_watch_until = 0;
+    return;
+  }
+  
+  IMUData imu = readIMU();
+  float norm = sqrtf(imu.accel_x * imu.accel_x + imu.accel_y * imu.accel_y + imu.accel_z * imu.accel_z);
+  if (norm < 0.5f) return;
+  float up[3] = {imu.accel_x / norm, imu.accel_y / norm, imu.accel_z / norm};
+  
+  // Rotation rate from how far gravity moved since the last look
+  float rate = 0;
+  if (last_sleep_sample != 0 && now != last_sleep_sample) {
+    float dot = up[0] * sleep_up[0] + up[1] * sleep_up[1] + up[2] * sleep_up[2];
+    rate = acosf(dot > 1.0f ? 1.0f : dot) * 57.29578f * 1000.0f / (now - last_sleep_sample);
+  }
+  memcpy(sleep_up, up, sizeof(sleep_up));
+  last_sleep_sample = now;
+  
+  WristEvent event = wristDetectorUpdate(wrist, up, rate, now);
+  if (event != WRIST_NONE) postSensorEvent(SENSOR_EVENT_WRIST, event);
+  if (event == WRIST_RAISE) wrist_watch_until = 0;
+}
+
+static void reportOrientation() {
+  Serial.printf("Wrist: %lu raises, %lu lowers, %.1f cycles/sample\n",
+                (unsigned long)wrist.raises, (unsigned long)wrist.lowers,
+                orientation_samples ? (double)orientation_cycles / orientation_samples : 0.0);
+}
+
+static void loadIMUGestures() {
+  // Read straight into the engine, 3KB is too much to stage on the stack
+  imuGestureInit(imu_gestures);
+  IMUGestureLibrary& library = imu_gestures.library;
+  Preferences preferences;
+  preferences.begin("gestures", true);
+  size_t length = preferences.getBytes("library", &library, sizeof(library));
+  preferences.end();
+  
+  if (length == sizeof(library) && imuGestureLibraryValid(library)) {
+    imuGestureSetLibrary(imu_gestures, library);
   } else {
-    return 70 + random(-3, 3);
+    imuGestureInit(imu_gestures);
+    Serial.println("Gestures: no recordings stored, using built-in shapes");
   }
 }
 
+static void saveIMUGestures() {
+  Preferences preferences;
+  preferences.begin("gestures", false);
+  preferences.putBytes("library", &imu_gestures.library, sizeof(imu_gestures.library));
+  preferences.end();
+}
+
+void updateIMUGestures() {
+  IMUSample samples[32];
+  int count;
+  while ((count = imuRingRead(imu_ring, gesture_cursor, samples, 32)) > 0) {
+    // Arm swing while walking is not a command, but recordings still go through
+    if (activityIsMoving(activity.current) && imu_gestures.recording == IMU_GESTURE_NONE) continue;
+    
+    uint32_t start = ESP.getCycleCount();
+    IMUGestureType gesture = imuGestureProcess(imu_gestures, samples, count);
+    gesture_cycles += ESP.getCycleCount() - start;
+    if (gesture != IMU_GESTURE_NONE) postSensorEvent(SENSOR_EVENT_GESTURE, gesture);
+  }
+  
+  if (imu_gestures.recorded != IMU_GESTURE_NONE) {
+    Serial.printf("Gestures: recorded a %s template\n", imuGestureName(imu_gestures.recorded));
+    imu_gestures.recorded = IMU_GESTURE_NONE;
+    saveIMUGestures();
+  }
+}
+
+static void recordGesture() {
+  IMUGestureType gesture = (IMUGestureType)(next_gesture_recording++ % IMU_GESTURE_COUNT);
+  imuGestureRecord(imu_gestures, gesture);
+  Serial.printf("Gestures: hold still, then %s once\n", imuGestureName(gesture));
+}
+
+static void reportIMUGestures() {
+  const IMUGestureStats& stats = imu_gestures.stats;
+  Serial.printf("Gestures: %lu/%lu/%lu/%lu matched, %lu windows, %lu gated, %lu pruned, %lu DTW (%lu abandoned), %.0f cycles/window\n",
+                (unsigned long)stats.matches[IMU_GESTURE_FLICK_IN], (unsigned long)stats.matches[IMU_GESTURE_FLICK_OUT],
+                (unsigned long)stats.matches[IMU_GESTURE_DOUBLE_TAP], (unsigned long)stats.matches[IMU_GESTURE_SHAKE],
+                (unsigned long)stats.windows, (unsigned long)stats.gated, (unsigned long)stats.lb_pruned,
+                (unsigned long)stats.dtw_runs, (unsigned long)stats.dtw_abandoned,
+                stats.windows ? (double)gesture_cycles / stats.windows : 0.0);
+}
+
+static void reportPedometer() {
+  Serial.printf("Pedometer: %lu steps, %lu rejected, %u spm, %.1f cycles/sample\n",
+                (unsigned long)pedometer.steps, (unsigned long)pedometer.rejected_steps,
+                pedometer.cadence_spm,
+                pedometer_samples ? (double)pedometer_cycles / pedometer_samples : 0.0);
+}
+
 void processSensorData() {
   updateStepCounter();
+  updateActivity();
+  updateOrientation();
+  if (ENABLE_IMU_GESTURES) updateIMUGestures();
   updateActivityMetrics();
+  updateActivityLog();
+  updateSleepTracking();
+  if (imu_streaming) streamIMUSamples();
 }
 
 void updateActivityMetrics() {
-  // Update activity ring progress and other metrics
-  static unsigned long last_activity_update = 0;
-  unsigned long current_time = millis();
+  // A minute of classified movement, not necessarily contiguous
+  while (active_windows >= 60) {
+    step_data.active_minutes++;
+    active_windows -= 60;
+  }
+}
+
+static void restartCalibration() {
+  // Nothing to wait for: the gyro bias settles whenever the watch rests, and
+  // a fresh accel fit completes once it has rested on all six sides
+  imuCalibrationRestartFaces(imu_calibration);
+  Serial.println("IMU calibration: rest the watch still on each of its six sides for a few seconds");
+}
+
+static void reportIMUCalibration() {
+  const IMUCalibration& c = imu_calibration;
+  Serial.printf("IMU cal: gyro bias %.2f/%.2f/%.2f dps, accel offset %d/%d/%d, faces 0x%02x, %lu still / %lu moving windows\n",
+                c.gyro_bias[0] / 256.0f / IMU_GYRO_LSB_PER_DPS, c.gyro_bias[1] / 256.0f / IMU_GYRO_LSB_PER_DPS,
+                c.gyro_bias[2] / 256.0f / IMU_GYRO_LSB_PER_DPS, c.accel_offset[0], c.accel_offset[1],
+                c.accel_offset[2], c.faces, (unsigned long)still_detector.still_windows,
+                (unsigned long)still_detector.moving_windows);
+}
+
+// ==================== WARM RESUME ====================
+void saveSensorResume(ResumeSteps& steps) {
+  reconcileHardwareSteps();
+  steps.daily_steps = step_data.daily_steps;
+  steps.calories_burned = step_data.calories_burned;
+  steps.active_minutes = step_data.active_minutes;
+  steps.pedometer_steps = pedometer.steps;
+  steps.distance_m = pedometer.distance_m;
+  steps.energy_kcal = pedometer.energy_kcal;
+  steps.hardware_count = hardware_steps.last_count;
+  steps.hardware_valid = imu_motion_active && hardware_steps.has_baseline;
   
-  if (current_time - last_activity_update > 60000) { // Update every minute
-    if (isMoving()) {
-      step_data.active_minutes++;
-    }
-    last_activity_update = current_time;
+  // The open page is in RAM
+  if (activity_log_ready) activityLogFlush(activity_log);
+}
+
+void restoreSensorResume(const ResumeSteps& steps, bool same_day) {
+  if (same_day) {
+    step_data.daily_steps = steps.daily_steps;
+    step_data.calories_burned = steps.calories_burned;
+    step_data.active_minutes = steps.active_minutes;
+    pedometer.steps = steps.pedometer_steps;
+    pedometer.distance_m = steps.distance_m;
+    pedometer.energy_kcal = steps.energy_kcal;
+  }
+  
+  // The IMU may still be in motion mode from before deep sleep
+  if (!imu_fifo_active) return;
+  I2CCaller previous_caller = i2cTraceSetCaller(I2C_CALLER_SENSORS);
+  uint32_t count;
+  bool counted;
+  imu_fifo_active = imuMotionResume(count, counted);
+  i2cTraceSetCaller(previous_caller);
+  imu_fifo_ready = false;
+  last_fifo_drain = millis();
+  if (!imu_fifo_active) Serial.println("IMU FIFO restart failed!");
+  
+  // Steps the IMU counted while the CPU was off, credited to today
+  if (!steps.hardware_valid || !counted) return;
+  
+  StepSync sync = {};
+  stepSyncBegin(sync, steps.hardware_count);
+  uint32_t asleep_steps = stepSyncUpdate(sync, count);
+  if (asleep_steps > 0) {
+    pedometerAddSteps(pedometer, asleep_steps);
+    step_data.daily_steps += asleep_steps;
   }
+  step_data.distance_km = pedometer.distance_m / 1000.0;
+  step_data.calories_burned = (int)pedometer.energy_kcal;
+  Serial.printf("Steps while in deep sleep: %lu\n", (unsigned long)asleep_steps);
 }
 
-void calibrateIMU() {
-  Serial.println("Calibrating IMU... Keep watch still for 5 seconds");
+// ==================== SENSOR TASK ====================
+static void reportSensorTask() {
+  Serial.printf("Sensor task: %lu cycles, %.0f us avg, %lu us max, %lu ms max gap, %lu events dropped\n",
+                (unsigned long)sensor_cycles, sensor_cycles ? (double)cycle_us_total / sensor_cycles : 0.0,
+                (unsigned long)cycle_us_max, cycle_gap_max, (unsigned long)event_queue.dropped);
+  cycle_gap_max = 0;
+  cycle_us_max = 0;
+}
+
+static void sampleIMUTemperature() {
+  if (imu_temperature_valid && millis() - last_temperature_read < SENSOR_TEMPERATURE_MS) return;
+  last_temperature_read = millis();
   
-  // Calibration routine
-  float accel_offset_x = 0, accel_offset_y = 0, accel_offset_z = 0;
-  float gyro_offset_x = 0, gyro_offset_y = 0, gyro_offset_z = 0;
-  int samples = 100;
+  // TEMP_L/TEMP_H, 1/256 degree
+  uint8_t raw[2];
+  I2CCaller previous_caller = i2cTraceSetCaller(I2C_CALLER_SENSORS);
+  bool read_ok = i2cReadRegs(I2C_DEV_IMU, 0x33, raw, sizeof(raw));
+  i2cTraceSetCaller(previous_caller);
+  if (!read_ok) return;
   
-  for (int i = 0; i < samples; i++) {
-    IMUData cal_data = readIMU();
-    
-    accel_offset_x += cal_data.accel_x;
-    accel_offset_y += cal_data.accel_y;
-    accel_offset_z += cal_data.accel_z - 1.0; // Account for gravity
-    
-    gyro_offset_x += cal_data.gyro_x;
-    gyro_offset_y += cal_data.gyro_y;
-    gyro_offset_z += cal_data.gyro_z;
-    
-    delay(50);
+  int16_t temperature = (int16_t)(raw[0] | (raw[1] << 8));
+  imu_temperature_c10 = (int16_t)(temperature * 10 / 256);
+  imu_temperature_valid = true;
+}
+
+static void runSensorCommand(const SensorCommand& command) {
+  switch (command.type) {
+    case SENSOR_CMD_ENTER_MOTION_SLEEP: startMotionSleep(); break;
+    case SENSOR_CMD_EXIT_MOTION_SLEEP: stopMotionSleep(); break;
+    case SENSOR_CMD_WATCH_WRIST: startWristWatch(); break;
+    case SENSOR_CMD_CALIBRATE: restartCalibration(); break;
+    case SENSOR_CMD_RECORD_GESTURE: recordGesture(); break;
+    case SENSOR_CMD_STREAM: startIMUStream(command.arg != 0); break;
+    case SENSOR_CMD_REPORT:
+      reportIMUFifo();
+      reportIMUCalibration();
+      reportPedometer();
+      reportActivity();
+      reportOrientation();
+      reportIMUGestures();
+      reportActivityLog();
+      reportSleepTracking();
+      reportSensorTask();
+      break;
+    default: break;  // SENSOR_CMD_SERVICE only asks for a cycle
   }
+}
+
+static void publishSensorSnapshot() {
+  SensorSnapshot snapshot;
+  snapshot.cycle = sensor_cycles;
+  snapshot.commands_done = commands_done;
+  snapshot.busy_us = cycle_us_total;
+  snapshot.cycle_ms = last_cycle_start;
+  snapshot.daily_steps = step_data.daily_steps;
+  snapshot.calories_burned = step_data.calories_burned;
+  snapshot.distance_km = step_data.distance_km;
+  snapshot.active_minutes = step_data.active_minutes;
+  snapshot.cadence_spm = step_data.cadence_spm;
+  snapshot.last_step_time = step_data.last_step_time;
+  snapshot.last_sleep_drain = last_sleep_drain;
+  snapshot.activity = activity.current;
+  snapshot.motion_sleep = imu_motion_active;
+  snapshot.watching_wrist = wrist_watch_until != 0;
+  snapshot.sleep_tracking = sleep_tracking;
+  snapshot.sleep_fifo = sleep_fifo_active;
+  snapshot.streaming = imu_streaming;
+  mahonyGravity(fusion, snapshot.gravity);
+  snapshot.temperature_c10 = imu_temperature_c10;
+  snapshot.temperature_valid = imu_temperature_valid;
+  seqlockWrite(sensor_snapshot, &snapshot);
+}
+
+static void runSensorCycle() {
+  unsigned long now = millis();
+  if (last_cycle_start != 0 && now - last_cycle_start > cycle_gap_max) cycle_gap_max = now - last_cycle_start;
+  last_cycle_start = now;
+  uint32_t start = micros();
   
-  // Calculate offsets
-  accel_offset_x /= samples;
-  accel_offset_y /= samples;
-  accel_offset_z /= samples;
+  // Commands first, so the cycle after them is what the loop waits for
+  SensorCommand command;
+  uint32_t done = 0;
+  while (spscPop(command_queue, &command)) {
+    runSensorCommand(command);
+    done++;
+  }
   
-  gyro_offset_x /= samples;
-  gyro_offset_y /= samples;
-  gyro_offset_z /= samples;
+  serviceIMUFifo();
+  reconcileHardwareSteps();
+  if (wrist_watch_until != 0) sampleWristInSleep();
+  processSensorData();
+  sampleIMUTemperature();
   
-  // Store calibration values (would typically save to EEPROM)
-  Serial.println("IMU calibration completed");
+  commands_done += done;
+  sensor_cycles++;
+  publishSensorSnapshot();
+  publishOpenMinute();
+  
+  uint32_t elapsed = micros() - start;
+  cycle_us_total += elapsed;
+  if (elapsed > cycle_us_max) cycle_us_max = elapsed;
+}
+
+static void sensorTask(void* parameter) {
+  for (;;) {
+    // Woken early by the FIFO watermark or a command
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SENSOR_TASK_PERIOD_MS));
+    xSemaphoreTake(sensor_idle, portMAX_DELAY);
+    runSensorCycle();
+    xSemaphoreGive(sensor_idle);
+  }
+}
+
+bool startSensorTask() {
+  if (sensor_task != nullptr) return true;
+  publishSensorSnapshot();
+  BaseType_t created = xTaskCreatePinnedToCore(sensorTask, "sensors", SENSOR_TASK_STACK, nullptr,
+                                               SENSOR_TASK_PRIORITY, &sensor_task, SENSOR_TASK_CORE);
+  if (created != pdPASS) {
+    sensor_task = nullptr;
+    Serial.println("Sensor task failed to start, sampling from the loop");
+    return false;
+  }
+  return true;
+}
+
+// ==================== LOOP SIDE ====================
+static const SensorSnapshot& sensorView() {
+  // One load when nothing was published since; a failed read keeps the last view
+  if (seqlockSequence(sensor_snapshot) != view_sequence) {
+    seqlockRead(sensor_snapshot, &sensor_view, &view_sequence);
+  }
+  return sensor_view;
+}
+
+static void pollSensorEvents() {
+  SensorEvent event;
+  while (spscPop(event_queue, &event)) {
+    switch (event.type) {
+      case SENSOR_EVENT_WRIST: pending_wrist = (WristEvent)event.value; break;
+      case SENSOR_EVENT_GESTURE: pending_imu_gesture = (IMUGestureType)event.value; break;
+      case SENSOR_EVENT_NEW_NIGHT: new_night = true; break;
+    }
+  }
+}
+
+static void postSensorCommand(SensorCommandType type, uint8_t arg = 0) {
+  SensorCommand command = {(uint8_t)type, arg};
+  if (!spscPush(command_queue, &command)) return;
+  commands_posted++;
+  if (sensor_task != nullptr) xTaskNotifyGive(sensor_task);
+}
+
+void updateSensors() {
+  // Without the task the loop runs the cycle itself, as before
+  if (sensor_task == nullptr) runSensorCycle();
+  system_state.steps_today = sensorView().daily_steps;
+}
+
+bool getSensorSnapshot(SensorSnapshot& snapshot) {
+  snapshot = sensorView();
+  return snapshot.cycle != 0;
+}
+
+bool sensorsCaughtUp() {
+  return sensorView().commands_done == commands_posted;
+}
+
+void pauseSensorTask() {
+  // Light sleep stops both cores, never in the middle of an I2C transfer
+  if (sensor_task != nullptr) xSemaphoreTake(sensor_idle, portMAX_DELAY);
+}
+
+void resumeSensorTask() {
+  if (sensor_task != nullptr) xSemaphoreGive(sensor_idle);
+  postSensorCommand(SENSOR_CMD_SERVICE);
+}
+
+void reportSensors() {
+  postSensorCommand(SENSOR_CMD_REPORT);
+}
+
+void enterMotionSleep() {
+  pending_imu_gesture = IMU_GESTURE_NONE;
+  postSensorCommand(SENSOR_CMD_ENTER_MOTION_SLEEP);
+}
+
+void exitMotionSleep() {
+  postSensorCommand(SENSOR_CMD_EXIT_MOTION_SLEEP);
+}
+
+bool isMotionSleepActive() {
+  return sensorView().motion_sleep;
+}
+
+void calibrateIMU() {
+  postSensorCommand(SENSOR_CMD_CALIBRATE);
+}
+
+int getDailySteps() {
+  return sensorView().daily_steps;
+}
+
+bool isMoving() {
+  return activityIsMoving((ActivityClass)sensorView().activity);
+}
+
+bool isRunning() {
+  return sensorView().activity == ACTIVITY_RUNNING;
+}
+
+ActivityClass getActivityClass() {
+  return (ActivityClass)sensorView().activity;
+}
+
+String getCurrentActivity() {
+  return activityName(getActivityClass());
+}
+
+float getHeartRate() {
+  // Simulate heart rate based on activity level
+  if (isRunning()) {
+    return 140 + random(-10, 10);
+  } else if (isMoving()) {
+    return 90 + random(-5, 5);
+  } else {
+    return 70 + random(-3, 3);
+  }
+}
+
+void setIMUStreaming(bool enabled) {
+  postSensorCommand(SENSOR_CMD_STREAM, enabled);
+}
+
+bool isIMUStreaming() {
+  return sensorView().streaming;
+}
+
+unsigned long sleepTrackingDueIn() {
+  const SensorSnapshot& view = sensorView();
+  if (!view.sleep_fifo) return SLEEP_FACE_REFRESH;
+  unsigned long elapsed = millis() - view.last_sleep_drain;
+  return elapsed < SLEEP_TRACK_DRAIN_MS ? SLEEP_TRACK_DRAIN_MS - elapsed : 1;
+}
+
+unsigned long sensorsDueIn() {
+  // In motion sleep the IMU counts on its own and only the overnight FIFO
+  // needs fetching; awake, the task cycles on a timer between watermarks
+  const SensorSnapshot& view = sensorView();
+  if (view.motion_sleep) return sleepTrackingDueIn();
+  unsigned long elapsed = millis() - view.cycle_ms;
+  return elapsed < SENSOR_TASK_PERIOD_MS ? SENSOR_TASK_PERIOD_MS - elapsed : 0;
+}
+
+bool isSleepTracking() {
+  return sensorView().sleep_tracking;
+}
+
+bool takeNewNight() {
+  pollSensorEvents();
+  bool fresh = new_night;
+  new_night = false;
+  return fresh;
+}
+
+void watchForWristRaise() {
+  postSensorCommand(SENSOR_CMD_WATCH_WRIST);
+}
+
+bool isWatchingWrist() {
+  return sensorView().watching_wrist;
+}
+
+WristEvent takeWristEvent() {
+  pollSensorEvents();
+  WristEvent event = pending_wrist;
+  pending_wrist = WRIST_NONE;
+  return event;
+}
+
+IMUGestureType takeIMUGesture() {
+  pollSensorEvents();
+  IMUGestureType gesture = pending_imu_gesture;
+  pending_imu_gesture = IMU_GESTURE_NONE;
+  return gesture;
+}
+
+void recordNextIMUGesture() {
+  postSensorCommand(SENSOR_CMD_RECORD_GESTURE);
 }
\ No newline at end of file
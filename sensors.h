@@ -1,6 +1,14 @@
 /*
  * Sensor Management for ESP32-S3 Watch
  * QMI8658 6-Axis IMU Integration
+ *
+ * Acquisition and every motion algorithm run in a task pinned to core 0,
+ * so a slow frame on the UI core never delays a FIFO drain. The loop sees
+ * the results through a seqlocked SensorSnapshot and takes wrist, gesture
+ * and sleep events from a queue; its requests go the other way as
+ * commands. serviceIMUFifo(), readIMU(), reconcileHardwareSteps() and the
+ * update*() and processSensorData() steps belong to the task, everything
+ * else is safe from the loop.
  */
 
 #ifndef SENSORS_H
@@ -8,6 +16,14 @@
 
 #include "config.h"
 #include <Wire.h>
+#include "imu_fifo.h"
+#include "pedometer.h"
+#include "activity.h"
+#include "orientation.h"
+#include "activity_log.h"
+#include "sleep_tracker.h"
+#include "imu_gestures.h"
+#include "resume.h"
 
 // IMU data structure
 struct IMUData {
@@ -23,37 +39,116 @@ struct StepData {
   int calories_burned;
   float distance_km;
   int active_minutes;
+  int cadence_spm;
   unsigned long last_step_time;
 };
 
+#define SENSOR_TASK_STACK 8192
+#define SENSOR_TASK_PRIORITY 2        // Above the loop, below the I2C bus task
+#define SENSOR_TASK_CORE 0            // The loop and the display stay on core 1
+#define SENSOR_TASK_PERIOD_MS 100     // Cycle when no watermark or command comes sooner
+#define SENSOR_QUEUE_LENGTH 16        // Commands and events each, power of two
+#define SENSOR_TEMPERATURE_MS 30000   // IMU die temperature, a stand-in for the cell's
+
+// What the loop sees of the sensors, republished after every task cycle
+struct SensorSnapshot {
+  uint32_t cycle;                     // Task cycles completed, 0 before the first
+  uint32_t commands_done;             // Commands run, followed by a full cycle
+  uint32_t busy_us;                   // Time spent in cycles, wraps
+  uint32_t cycle_ms;                  // millis() when the last cycle started
+  int32_t daily_steps;
+  int32_t calories_burned;
+  float distance_km;
+  int32_t active_minutes;
+  int32_t cadence_spm;
+  uint32_t last_step_time;
+  uint32_t last_sleep_drain;          // millis() of the last sleep FIFO fetch
+  float gravity[3];                   // Fused "up" in the watch frame
+  int16_t temperature_c10;            // Tenths of a degree, valid once read
+  bool temperature_valid;
+  uint8_t activity;                   // ActivityClass
+  bool motion_sleep;
+  bool watching_wrist;
+  bool sleep_tracking;
+  bool sleep_fifo;
+  bool streaming;
+};
+
+// Timestamped IMU samples shared by the motion algorithms
+extern IMUSampleRing imu_ring;
+
 // Initialize sensor systems
 bool initializeSensors();
+bool startSensorTask();  // Falls back to updateSensors() running the cycle
+
+// Loop side of the sensor task
+bool getSensorSnapshot(SensorSnapshot& snapshot);
+bool sensorsCaughtUp();  // Every command posted so far has run, with a cycle after it
+unsigned long sensorsDueIn();  // Until the task next needs the CPU without an interrupt
+void pauseSensorTask();  // Waits out the current cycle, around light sleep
+void resumeSensorTask();
+void reportSensors();    // The task prints its once-a-minute statistics
 
 // IMU functions
 bool initializeIMU();
 IMUData readIMU();
-void calibrateIMU();
+void calibrateIMU();  // Restarts the background accel fit, never blocks
+void serviceIMUFifo();
+
+// Low-power motion mode for SCREEN_SLEEP
+void enterMotionSleep();
+void exitMotionSleep();
+void reconcileHardwareSteps();
+bool isMotionSleepActive();
+
+// Deep sleep: the IMU counts steps, today's counters wait in RTC memory
+void saveSensorResume(ResumeSteps& steps);  // Task paused, flushes the activity log
+void restoreSensorResume(const ResumeSteps& steps, bool same_day);  // Before startSensorTask()
 
 // Step counting
 void updateStepCounter();
-bool detectStep(IMUData& imu);
 void resetDailySteps();
 int getDailySteps();
 
 // Activity detection
+void updateActivity();
 bool isMoving();
 bool isRunning();
+ActivityClass getActivityClass();
 String getCurrentActivity();
 
-// Gesture recognition using IMU
-bool detectWristRaise();
-bool detectWristFlick();
-bool detectDoubleTab();
+// Raw sample stream over Serial for offline training
+void setIMUStreaming(bool enabled);
+bool isIMUStreaming();
+
+// Per-minute activity history with rollups for charts
+bool initializeActivityLog(const ActivityLogStorage& storage);
+void updateActivityLog();
+int getActivityHistory(RollupLevel level, int periods, ActivityTotals* totals);
+
+// Overnight sleep tracking between sleep_time and wake_time
+void updateSleepTracking();
+unsigned long sleepTrackingDueIn();  // Longest light sleep before the FIFO needs fetching
+bool isSleepTracking();
+bool getLastNight(SleepNight& night);
+bool takeNewNight();  // True once after a night has been scored
+
+// Wrist raise/lower from fused orientation
+void updateOrientation();
+void watchForWristRaise();
+bool isWatchingWrist();
+WristEvent takeWristEvent();
+
+// Wrist gestures matched against recorded templates
+void updateIMUGestures();
+IMUGestureType takeIMUGesture();
+void recordNextIMUGesture();  // The next deliberate movement becomes a template
 
 // Heart rate simulation (for demonstration)
 float getHeartRate();
 
 // Sensor data processing
+void updateSensors();  // Loop: picks up the latest snapshot
 void processSensorData();
 void updateActivityMetrics();
 
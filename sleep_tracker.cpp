@@ -0,0 +1,171 @@
+/*
+ * Sleep Tracking Implementation
+ * Movement counts, Cole-Kripke scoring, Webster rescoring and the summary
+ */
+
+#include "sleep_tracker.h"
+#include <string.h>
+
+// Oldest to newest: four epochs before the scored one, itself, two after
+static const uint16_t COLE_KRIPKE_WEIGHTS[SLEEP_CK_WINDOW] = {106, 54, 58, 76, 230, 74, 67};
+
+static void setAsleep(uint8_t* asleep, int epoch, bool value) {
+  if (value) {
+    asleep[epoch >> 3] |= 1 << (epoch & 7);
+  } else {
+    asleep[epoch >> 3] &= ~(1 << (epoch & 7));
+  }
+}
+
+static bool isAsleep(const uint8_t* asleep, int epoch) {
+  return asleep[epoch >> 3] & (1 << (epoch & 7));
+}
+
+// ==================== COUNTS ====================
+void sleepTrackerBegin(SleepTracker& tracker, uint32_t start_minute) {
+  memset(&tracker, 0, sizeof(tracker));
+  tracker.night.version = SLEEP_NIGHT_VERSION;
+  tracker.night.summary.start_minute = start_minute;
+}
+
+void sleepTrackerAddSamples(SleepTracker& tracker, const IMUSample* samples, int count) {
+  for (int i = 0; i < count; i++) {
+    for (int axis = 0; axis < 3; axis++) {
+      int32_t value = (int32_t)samples[i].accel[axis] << SLEEP_BASELINE_SHIFT;
+      if (!tracker.has_baseline) tracker.baseline[axis] = value;
+      int32_t deviation = (value - tracker.baseline[axis]) >> SLEEP_BASELINE_SHIFT;
+      if (deviation > SLEEP_MOVE_THRESHOLD || deviation < -SLEEP_MOVE_THRESHOLD) tracker.moved = true;
+      tracker.baseline[axis] += (value - tracker.baseline[axis]) >> SLEEP_BASELINE_SHIFT;
+    }
+    tracker.has_baseline = true;
+
+    if (++tracker.window_samples >= SLEEP_WINDOW_SAMPLES) {
+      if (tracker.moved && tracker.epoch_count < 60) tracker.epoch_count++;
+      tracker.moved = false;
+      tracker.window_samples = 0;
+    }
+  }
+}
+
+// ==================== SCORING ====================
+// Score one epoch from the counts around it; later epochs not yet seen count as still
+static void scoreEpoch(SleepTracker& tracker, int epoch) {
+  int epochs = tracker.night.summary.epochs;
+  uint32_t sum = 0;
+  for (int i = 0; i < SLEEP_CK_WINDOW; i++) {
+    int source = epoch - (SLEEP_CK_WINDOW - 1 - SLEEP_CK_LAG) + i;
+    if (source < 0 || source >= epochs) continue;
+    sum += (uint32_t)COLE_KRIPKE_WEIGHTS[i] * tracker.counts[source % SLEEP_CK_WINDOW];
+  }
+  setAsleep(tracker.night.asleep, epoch, sum < SLEEP_CK_THRESHOLD);
+  tracker.scored = epoch + 1;
+}
+
+void sleepTrackerEndEpoch(SleepTracker& tracker, bool awake) {
+  SleepSummary& summary = tracker.night.summary;
+  if (summary.epochs >= SLEEP_MAX_EPOCHS) return;
+
+  uint16_t count = awake ? SLEEP_COUNT_AWAKE : tracker.epoch_count;
+  tracker.counts[summary.epochs % SLEEP_CK_WINDOW] = count;
+  tracker.total_count += count;
+  summary.epochs++;
+  tracker.epoch_count = 0;
+
+  // The epoch two back now has its whole window
+  int ready = summary.epochs - 1 - SLEEP_CK_LAG;
+  if (ready >= 0) scoreEpoch(tracker, ready);
+}
+
+bool sleepTrackerFinish(SleepTracker& tracker, SleepNight& night) {
+  while (tracker.scored < tracker.night.summary.epochs) {
+    scoreEpoch(tracker, tracker.scored);
+  }
+  // A watch left on the nightstand never moves and would sleep perfectly
+  if (tracker.night.summary.epochs < SLEEP_MIN_EPOCHS || tracker.total_count == 0) return false;
+
+  sleepRescore(tracker.night.asleep, tracker.night.summary.epochs);
+  sleepSummarize(tracker.night);
+  night = tracker.night;
+  return true;
+}
+
+// ==================== RESCORING ====================
+static int runLength(const uint8_t* asleep, int from, int step, int epochs, bool value) {
+  int length = 0;
+  for (int epoch = from; epoch >= 0 && epoch < epochs && isAsleep(asleep, epoch) == value; epoch += step) {
+    length++;
+  }
+  return length;
+}
+
+void sleepRescore(uint8_t* asleep, int epochs) {
+  // Rules read the original scores, so one rescoring cannot feed the next
+  uint8_t original[SLEEP_MAX_EPOCHS / 8];
+  memcpy(original, asleep, sizeof(original));
+
+  int epoch = 0;
+  while (epoch < epochs) {
+    bool value = isAsleep(original, epoch);
+    int length = runLength(original, epoch, 1, epochs, value);
+    if (value) {
+      int wake_before = runLength(original, epoch - 1, -1, epochs, false);
+      int wake_after = runLength(original, epoch + length, 1, epochs, false);
+
+      // Webster a-c: after 4, 10 or 15 minutes awake, the first 1, 3 or 4
+      // minutes scored asleep are really still awake
+      int rescore = 0;
+      if (wake_before >= 15) rescore = 4;
+      else if (wake_before >= 10) rescore = 3;
+      else if (wake_before >= 4) rescore = 1;
+
+      // Webster d-e: short sleep with long wake on both sides is wake
+      if ((length <= 6 && wake_before >= 10 && wake_after >= 10) ||
+          (length <= 10 && wake_before >= 20 && wake_after >= 20)) {
+        rescore = length;
+      }
+
+      for (int i = 0; i < rescore && i < length; i++) {
+        setAsleep(asleep, epoch + i, false);
+      }
+    }
+    epoch += length;
+  }
+}
+
+// ==================== SUMMARY ====================
+void sleepSummarize(SleepNight& night) {
+  SleepSummary& summary = night.summary;
+  summary.onset_epoch = summary.final_wake_epoch = 0;
+  summary.asleep_minutes = summary.waso_minutes = 0;
+  summary.awakenings = summary.efficiency = 0;
+
+  int first = -1, last = -1;
+  for (int epoch = 0; epoch < summary.epochs; epoch++) {
+    if (!isAsleep(night.asleep, epoch)) continue;
+    if (first < 0) first = epoch;
+    last = epoch;
+    summary.asleep_minutes++;
+  }
+  if (first < 0) return;
+
+  summary.onset_epoch = first;
+  summary.final_wake_epoch = last + 1;
+  summary.waso_minutes = summary.final_wake_epoch - summary.onset_epoch - summary.asleep_minutes;
+  for (int epoch = first + 1; epoch <= last; epoch++) {
+    if (!isAsleep(night.asleep, epoch) && isAsleep(night.asleep, epoch - 1) && summary.awakenings < 255) {
+      summary.awakenings++;
+    }
+  }
+  summary.efficiency = summary.asleep_minutes * 100 / summary.final_wake_epoch;
+}
+
+bool sleepNightValid(const SleepNight& night) {
+  const SleepSummary& summary = night.summary;
+  return night.version == SLEEP_NIGHT_VERSION && summary.epochs <= SLEEP_MAX_EPOCHS &&
+         summary.final_wake_epoch <= summary.epochs && summary.efficiency <= 100;
+}
+
+bool sleepNightAsleep(const SleepNight& night, int epoch) {
+  if (epoch < 0 || epoch >= night.summary.epochs) return false;
+  return isAsleep(night.asleep, epoch);
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+/*
+ * Sleep Tracking for ESP32-S3 Watch
+ * Actigraphy counts scored into sleep and wake with Cole-Kripke
+ *
+ * Overnight the IMU stays in motion mode and buffers its 31Hz accel
+ * samples in the FIFO, so the MCU only wakes every few seconds to fetch
+ * them. Each second of samples is checked against a slow per-axis
+ * baseline; a second where any axis strays past the dead band counts as
+ * one second of movement. A minute's count is the epoch's activity.
+ *
+ * Epochs are scored with the Cole-Kripke 1-minute weights over the four
+ * epochs before and two after, so a score lags two minutes. When the
+ * night ends, Webster's rules rescore short sleep right after long wake,
+ * and the night is kept as one bit per minute plus a summary.
+ */
+
+#ifndef SLEEP_TRACKER_H
+#define SLEEP_TRACKER_H
+
+#include <stdint.h>
+#include "imu_fifo.h"
+
+#define SLEEP_NIGHT_VERSION 1
+#define SLEEP_MAX_EPOCHS 720             // Twelve hours of one-minute epochs
+#define SLEEP_MIN_EPOCHS 60              // Shorter sessions are naps or noise, not kept
+#define SLEEP_WINDOW_SAMPLES 31          // About one second at the motion mode rate
+#define SLEEP_BASELINE_SHIFT 4           // Per-axis baseline follows over ~0.5s
+#define SLEEP_MOVE_THRESHOLD 246         // 30 mg away from the baseline
+#define SLEEP_COUNT_AWAKE 60             // Minutes with the screen on are a full minute of movement
+
+// Cole-Kripke: D = P * sum(weight * count), asleep while D < 1. The paper's
+// P is 0.001 for its counts; seconds moved run higher, so P is 1/1600
+#define SLEEP_CK_WINDOW 7
+#define SLEEP_CK_LAG 2                   // Epochs after the one being scored
+#define SLEEP_CK_THRESHOLD 1600
+
+struct SleepSummary {
+  uint32_t start_minute;       // First epoch, minutes since 2000-01-01 as in activity_log.h
+  uint16_t epochs;             // Epochs tracked
+  uint16_t onset_epoch;        // First epoch asleep
+  uint16_t final_wake_epoch;   // One past the last epoch asleep
+  uint16_t asleep_minutes;
+  uint16_t waso_minutes;       // Wake after sleep onset
+  uint8_t awakenings;
+  uint8_t efficiency;          // Percent asleep between lights out and the final wake
+};
+
+// What is kept of a night, persisted as one blob
+struct SleepNight {
+  uint16_t version;
+  SleepSummary summary;
+  uint8_t asleep[SLEEP_MAX_EPOCHS / 8];   // Bit per epoch, set when asleep
+};
+
+struct SleepTracker {
+  // Current second
+  int32_t baseline[3];         // Raw LSB << SLEEP_BASELINE_SHIFT
+  bool has_baseline;
+  bool moved;
+  int window_samples;
+
+  // Current epoch and the scoring window
+  uint16_t epoch_count;
+  uint16_t counts[SLEEP_CK_WINDOW];   // Ring of the latest epoch counts
+  uint16_t scored;             // Epochs with a stage so far
+  uint32_t total_count;
+  SleepNight night;
+};
+
+// Tracking
+void sleepTrackerBegin(SleepTracker& tracker, uint32_t start_minute);
+void sleepTrackerAddSamples(SleepTracker& tracker, const IMUSample* samples, int count);
+void sleepTrackerEndEpoch(SleepTracker& tracker, bool awake);  // awake: the watch was in use
+bool sleepTrackerFinish(SleepTracker& tracker, SleepNight& night);  // False when not worth keeping
+
+// Reading a night
+bool sleepNightValid(const SleepNight& night);
+bool sleepNightAsleep(const SleepNight& night, int epoch);
+
+// Post-processing, exposed for host checks
+void sleepRescore(uint8_t* asleep, int epochs);
+void sleepSummarize(SleepNight& night);
+
+#endif // SLEEP_TRACKER_H
\ No newline at end of file
@@ -37,6 +37,40 @@ void initStopwatchTimerApp() {
   Serial.println("Stopwatch & Timer app initialized");
 }
 
+// Touch regions registered by the draw functions below, alarm cards and
+// their toggles add the alarm slot to the base tag
+enum StopwatchHitTag {
+  SW_HIT_TAB_STOPWATCH,
+  SW_HIT_TAB_TIMER,
+  SW_HIT_TAB_ALARMS,
+  SW_HIT_START_PAUSE,
+  SW_HIT_RESET,
+  SW_HIT_PLUS_1M,
+  SW_HIT_PLUS_10S,
+  SW_HIT_MINUS_10S,
+  SW_HIT_MINUS_1M,
+  SW_HIT_TIMER_START,
+  SW_HIT_TIMER_PAUSE,
+  SW_HIT_TIMER_STOP,
+  SW_HIT_PRESET_1,
+  SW_HIT_PRESET_5,
+  SW_HIT_PRESET_10,
+  SW_HIT_PRESET_30,
+  SW_HIT_ADD_ALARM,
+  SW_HIT_ALARM = 32,
+  SW_HIT_ALARM_TOGGLE = 48
+};
+
+void handleStopwatchTouch(int tag);
+void handleTimerTouch(int tag);
+void handleAlarmsTouch(int tag);
+
+// Button that is also registered as a touch region
+static void drawStopwatchButton(int x, int y, int w, int h, String text, bool active, int tag) {
+  drawGameButton(x, y, w, h, text, active);
+  addHitRegion(x, y, w, h, tag);
+}
+
 void drawStopwatchTimerApp() {
   clearDisplay();
   ThemeColors* theme = getCurrentTheme();
@@ -44,9 +78,9 @@ void drawStopwatchTimerApp() {
   fillRect(0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT, theme->background);
   
   // Mode tabs
-  drawGameButton(10, 50, 110, 30, "Stopwatch", stopwatch_state.current_mode == MODE_STOPWATCH);
-  drawGameButton(130, 50, 110, 30, "Timer", stopwatch_state.current_mode == MODE_TIMER);
-  drawGameButton(250, 50, 110, 30, "Alarms", stopwatch_state.current_mode == MODE_ALARMS);
+  drawStopwatchButton(10, 50, 110, 30, "Stopwatch", stopwatch_state.current_mode == MODE_STOPWATCH, SW_HIT_TAB_STOPWATCH);
+  drawStopwatchButton(130, 50, 110, 30, "Timer", stopwatch_state.current_mode == MODE_TIMER, SW_HIT_TAB_TIMER);
+  drawStopwatchButton(250, 50, 110, 30, "Alarms", stopwatch_state.current_mode == MODE_ALARMS, SW_HIT_TAB_ALARMS);
   
   switch (stopwatch_state.current_mode) {
     case MODE_STOPWATCH:
@@ -85,13 +119,8 @@ void drawStopwatchMode() {
   // Control buttons
   bool is_running = stopwatch_running;
   
-  if (is_running) {
-    drawGameButton(50, 250, 100, 50, "PAUSE", false);
-  } else {
-    drawGameButton(50, 250, 100, 50, "START", false);
-  }
-  
-  drawGameButton(200, 250, 100, 50, "RESET", false);
+  drawStopwatchButton(50, 250, 100, 50, is_running ? "PAUSE" : "START", false, SW_HIT_START_PAUSE);
+  drawStopwatchButton(200, 250, 100, 50, "RESET", false, SW_HIT_RESET);
   
   // Lap times area (simplified)
   drawText("Lap Times:", 20, 320, theme->secondary, 1);
@@ -156,27 +185,27 @@ void drawTimerMode() {
   
   // Time setting buttons (when not running)
   if (!stopwatch_state.timer_running) {
-    drawGameButton(20, 220, 60, 30, "+1m", false);
-    drawGameButton(90, 220, 60, 30, "+10s", false);
-    drawGameButton(160, 220, 60, 30, "-10s", false);
-    drawGameButton(230, 220, 60, 30, "-1m", false);
+    drawStopwatchButton(20, 220, 60, 30, "+1m", false, SW_HIT_PLUS_1M);
+    drawStopwatchButton(90, 220, 60, 30, "+10s", false, SW_HIT_PLUS_10S);
+    drawStopwatchButton(160, 220, 60, 30, "-10s", false, SW_HIT_MINUS_10S);
+    drawStopwatchButton(230, 220, 60, 30, "-1m", false, SW_HIT_MINUS_1M);
     
     drawCenteredText("Set timer duration", DISPLAY_WIDTH/2, 270, theme->secondary, 1);
   }
   
   // Control buttons
   if (stopwatch_state.timer_running) {
-    drawGameButton(50, 300, 100, 50, "PAUSE", false);
-    drawGameButton(200, 300, 100, 50, "STOP", false);
+    drawStopwatchButton(50, 300, 100, 50, "PAUSE", false, SW_HIT_TIMER_PAUSE);
+    drawStopwatchButton(200, 300, 100, 50, "STOP", false, SW_HIT_TIMER_STOP);
   } else {
-    drawGameButton(125, 300, 100, 50, "START", false);
+    drawStopwatchButton(125, 300, 100, 50, "START", false, SW_HIT_TIMER_START);
   }
   
   // Quick preset buttons
-  drawGameButton(20, 380, 70, 30, "1min", false);
-  drawGameButton(100, 380, 70, 30, "5min", false);
-  drawGameButton(180, 380, 70, 30, "10min", false);
-  drawGameButton(260, 380, 70, 30, "30min", false);
+  drawStopwatchButton(20, 380, 70, 30, "1min", false, SW_HIT_PRESET_1);
+  drawStopwatchButton(100, 380, 70, 30, "5min", false, SW_HIT_PRESET_5);
+  drawStopwatchButton(180, 380, 70, 30, "10min", false, SW_HIT_PRESET_10);
+  drawStopwatchButton(260, 380, 70, 30, "30min", false, SW_HIT_PRESET_30);
 }
 
 void drawAlarmsMode() {
@@ -192,6 +221,7 @@ void drawAlarmsMode() {
     uint16_t card_color = alarm.enabled ? theme->accent : theme->shadow;
     fillRoundRect(20, y, DISPLAY_WIDTH - 40, 50, 8, card_color);
     drawRoundRect(20, y, DISPLAY_WIDTH - 40, 50, 8, theme->primary);
+    addHitRegion(20, y, DISPLAY_WIDTH - 40, 50, SW_HIT_ALARM + i);
     
     // Alarm time
     char time_str[10];
@@ -210,10 +240,11 @@ void drawAlarmsMode() {
     
     // Enable/disable toggle
     drawText(alarm.enabled ? "ON" : "OFF", 280, y + 20, theme->background, 1);
+    addHitRegion(280, y, 40, 50, SW_HIT_ALARM_TOGGLE + i);  // On top of the card
   }
   
   // Add new alarm button
-  drawGameButton(20, 300, DISPLAY_WIDTH - 40, 40, "Add New Alarm", false);
+  drawStopwatchButton(20, 300, DISPLAY_WIDTH - 40, 40, "Add New Alarm", false, SW_HIT_ADD_ALARM);
   
   // Instructions
   drawCenteredText("Tap alarm to edit", DISPLAY_WIDTH/2, 360, theme->secondary, 1);
@@ -223,137 +254,126 @@ void drawAlarmsMode() {
 void handleStopwatchTimerTouch(TouchGesture& gesture) {
   if (gesture.event != TOUCH_TAP) return;
   
+  const HitRegion* region = findHitRegion(gesture);
+  if (region == nullptr) return;
+  
   // Mode tab selection
-  if (gesture.y >= 50 && gesture.y <= 80) {
-    if (gesture.x >= 10 && gesture.x <= 120) {
+  switch (region->tag) {
+    case SW_HIT_TAB_STOPWATCH:
       stopwatch_state.current_mode = MODE_STOPWATCH;
-    } else if (gesture.x >= 130 && gesture.x <= 240) {
+      return;
+    case SW_HIT_TAB_TIMER:
       stopwatch_state.current_mode = MODE_TIMER;
-    } else if (gesture.x >= 250 && gesture.x <= 360) {
+      return;
+    case SW_HIT_TAB_ALARMS:
       stopwatch_state.current_mode = MODE_ALARMS;
-    }
-    return;
+      return;
   }
   
   switch (stopwatch_state.current_mode) {
     case MODE_STOPWATCH:
-      handleStopwatchTouch(gesture);
+      handleStopwatchTouch(region->tag);
       break;
     case MODE_TIMER:
-      handleTimerTouch(gesture);
+      handleTimerTouch(region->tag);
       break;
     case MODE_ALARMS:
-      handleAlarmsTouch(gesture);
+      handleAlarmsTouch(region->tag);
       break;
   }
 }
 
-void handleStopwatchTouch(TouchGesture& gesture) {
-  // Start/Pause button
-  if (gesture.y >= 250 && gesture.y <= 300) {
-    if (gesture.x >= 50 && gesture.x <= 150) {
-      if (stopwatch_running) {
-        pauseStopwatch();
-      } else {
-        startStopwatch();
-      }
-    }
-    // Reset button
-    else if (gesture.x >= 200 && gesture.x <= 300) {
-      resetStopwatch();
+void handleStopwatchTouch(int tag) {
+  if (tag == SW_HIT_START_PAUSE) {
+    if (stopwatch_running) {
+      pauseStopwatch();
+    } else {
+      startStopwatch();
     }
+  } else if (tag == SW_HIT_RESET) {
+    resetStopwatch();
   }
 }
 
-void handleTimerTouch(TouchGesture& gesture) {
+void handleTimerTouch(int tag) {
   if (!stopwatch_state.timer_running) {
-    // Time adjustment buttons
-    if (gesture.y >= 220 && gesture.y <= 250) {
-      if (gesture.x >= 20 && gesture.x <= 80) { // +1m
+    switch (tag) {
+      // Time adjustment buttons
+      case SW_HIT_PLUS_1M:
         stopwatch_state.timer_minutes++;
         if (stopwatch_state.timer_minutes > 59) stopwatch_state.timer_minutes = 59;
-      } else if (gesture.x >= 90 && gesture.x <= 150) { // +10s
+        break;
+      case SW_HIT_PLUS_10S:
         stopwatch_state.timer_seconds += 10;
         if (stopwatch_state.timer_seconds >= 60) {
           stopwatch_state.timer_seconds -= 60;
           stopwatch_state.timer_minutes++;
         }
-      } else if (gesture.x >= 160 && gesture.x <= 220) { // -10s
+        break;
+      case SW_HIT_MINUS_10S:
         stopwatch_state.timer_seconds -= 10;
         if (stopwatch_state.timer_seconds < 0) {
           stopwatch_state.timer_seconds += 60;
           if (stopwatch_state.timer_minutes > 0) stopwatch_state.timer_minutes--;
         }
-      } else if (gesture.x >= 230 && gesture.x <= 290) { // -1m
+        break;
+      case SW_HIT_MINUS_1M:
         if (stopwatch_state.timer_minutes > 0) stopwatch_state.timer_minutes--;
-      }
-      
-      // Update total seconds
-      stopwatch_state.timer_total_seconds = stopwatch_state.timer_minutes * 60 + stopwatch_state.timer_seconds;
-    }
-    
-    // Preset buttons
-    if (gesture.y >= 380 && gesture.y <= 410) {
-      if (gesture.x >= 20 && gesture.x <= 90) { // 1min
+        break;
+        
+      // Preset buttons
+      case SW_HIT_PRESET_1:
         stopwatch_state.timer_minutes = 1;
         stopwatch_state.timer_seconds = 0;
-      } else if (gesture.x >= 100 && gesture.x <= 170) { // 5min
+        break;
+      case SW_HIT_PRESET_5:
         stopwatch_state.timer_minutes = 5;
         stopwatch_state.timer_seconds = 0;
-      } else if (gesture.x >= 180 && gesture.x <= 250) { // 10min
+        break;
+      case SW_HIT_PRESET_10:
         stopwatch_state.timer_minutes = 10;
         stopwatch_state.timer_seconds = 0;
-      } else if (gesture.x >= 260 && gesture.x <= 330) { // 30min
+        break;
+      case SW_HIT_PRESET_30:
         stopwatch_state.timer_minutes = 30;
         stopwatch_state.timer_seconds = 0;
-      }
-      stopwatch_state.timer_total_seconds = stopwatch_state.timer_minutes * 60 + stopwatch_state.timer_seconds;
-    }
-  }
-  
-  // Control buttons
-  if (gesture.y >= 300 && gesture.y <= 350) {
-    if (stopwatch_state.timer_running) {
-      if (gesture.x >= 50 && gesture.x <= 150) { // PAUSE
-        stopwatch_state.timer_running = false;
-      } else if (gesture.x >= 200 && gesture.x <= 300) { // STOP
-        stopwatch_state.timer_running = false;
-        stopwatch_state.timer_minutes = 5; // Reset to default
-        stopwatch_state.timer_seconds = 0;
-        stopwatch_state.timer_total_seconds = 300;
-      }
-    } else {
-      if (gesture.x >= 125 && gesture.x <= 225) { // START
+        break;
+        
+      case SW_HIT_TIMER_START:
         startTimer(stopwatch_state.timer_minutes, "Custom Timer");
         stopwatch_state.timer_running = true;
         stopwatch_state.timer_start_time = millis();
-      }
+        break;
     }
+    
+    // Update total seconds
+    stopwatch_state.timer_total_seconds = stopwatch_state.timer_minutes * 60 + stopwatch_state.timer_seconds;
+    return;
+  }
+  
+  // Control buttons while running
+  if (tag == SW_HIT_TIMER_PAUSE) {
+    stopwatch_state.timer_running = false;
+  } else if (tag == SW_HIT_TIMER_STOP) {
+    stopwatch_state.timer_running = false;
+    stopwatch_state.timer_minutes = 5; // Reset to default
+    stopwatch_state.timer_seconds = 0;
+    stopwatch_state.timer_total_seconds = 300;
   }
 }
 
-void handleAlarmsTouch(TouchGesture& gesture) {
-  // Alarm cards
-  for (int i = 0; i < 3; i++) {
-    int y = 100 + i * 60;
-    if (gesture.y >= y && gesture.y <= y + 50) {
-      // Toggle alarm on/off
-      if (gesture.x >= 280 && gesture.x <= 320) {
-        Alarm alarm = getAlarm(i);
-        alarm.enabled = !alarm.enabled;
-        setAlarm(i, alarm);
-      } else {
-        // Edit alarm (simplified - just change time by 1 hour)
-        Alarm alarm = getAlarm(i);
-        alarm.hour = (alarm.hour + 1) % 24;
-        setAlarm(i, alarm);
-      }
-      return;
-    }
-  }
-  
-  // Add new alarm button
-  if (gesture.y >= 300 && gesture.y <= 340) {
+void handleAlarmsTouch(int tag) {
+  // Alarm cards: the toggle sits on top of the card
+  if (tag >= SW_HIT_ALARM_TOGGLE && tag < SW_HIT_ALARM_TOGGLE + 3) {
+    Alarm alarm = getAlarm(tag - SW_HIT_ALARM_TOGGLE);
+    alarm.enabled = !alarm.enabled;
+    setAlarm(tag - SW_HIT_ALARM_TOGGLE, alarm);
+  } else if (tag >= SW_HIT_ALARM && tag < SW_HIT_ALARM + 3) {
+    // Edit alarm (simplified - just change time by 1 hour)
+    Alarm alarm = getAlarm(tag - SW_HIT_ALARM);
+    alarm.hour = (alarm.hour + 1) % 24;
+    setAlarm(tag - SW_HIT_ALARM, alarm);
+  } else if (tag == SW_HIT_ADD_ALARM) {
     // Create new alarm at current time + 1 hour
     WatchTime current = getCurrentTime();
     Alarm new_alarm;
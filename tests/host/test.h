@@ -0,0 +1,54 @@
+/*
+ * Host Test Checks
+ * Just enough to count failures and say where they were
+ */
+
+#ifndef TEST_H
+#define TEST_H
+
+#include <math.h>
+#include <stdio.h>
+
+static int test_checks = 0;
+static int test_failures = 0;
+
+#define CHECK(condition) do { \
+    test_checks++; \
+    if (!(condition)) { \
+      test_failures++; \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+    } \
+  } while (0)
+
+#define CHECK_EQ(actual, expected) do { \
+    test_checks++; \
+    long long actual_value = (long long)(actual), expected_value = (long long)(expected); \
+    if (actual_value != expected_value) { \
+      test_failures++; \
+      fprintf(stderr, "%s:%d: %s == %lld, expected %lld\n", __FILE__, __LINE__, #actual, \
+              actual_value, expected_value); \
+    } \
+  } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance) do { \
+    test_checks++; \
+    double actual_value = (double)(actual), expected_value = (double)(expected); \
+    if (fabs(actual_value - expected_value) > (tolerance)) { \
+      test_failures++; \
+      fprintf(stderr, "%s:%d: %s == %g, expected %g +/- %g\n", __FILE__, __LINE__, #actual, \
+              actual_value, expected_value, (double)(tolerance)); \
+    } \
+  } while (0)
+
+#define RUN(test) do { \
+    int failures_before = test_failures; \
+    test(); \
+    printf("%-40s %s\n", #test, test_failures == failures_before ? "ok" : "FAILED"); \
+  } while (0)
+
+static int testSummary() {
+  printf("%d checks, %d failed\n", test_checks, test_failures);
+  return test_failures ? 1 : 0;
+}
+
+#endif // TEST_H
\ No newline at end of file
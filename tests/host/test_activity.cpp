@@ -0,0 +1,107 @@
+/*
+ * Activity Classifier Tests
+ * Features and tree output for synthetic wrist signals, plus hysteresis
+ */
+
+#include "test.h"
+#include "activity.h"
+
+#define SAMPLE_RATE_HZ (1000000.0 / IMU_SAMPLE_PERIOD_US)
+#define PI 3.14159265358979
+
+// Gravity on z with a periodic bounce, gyro spinning at a fixed rate
+static IMUSample wristSample(int n, double hz, double amplitude_g, double gyro_dps) {
+  double t = n / SAMPLE_RATE_HZ;
+  IMUSample sample = {};
+  sample.timestamp_us = (uint32_t)(n * IMU_SAMPLE_PERIOD_US);
+  sample.accel[2] = (int16_t)((1.0 + amplitude_g * sin(2 * PI * hz * t)) * IMU_ACCEL_LSB_PER_G);
+  sample.gyro[0] = (int16_t)(gyro_dps * IMU_GYRO_LSB_PER_DPS);
+  return sample;
+}
+
+static void extract(double hz, double amplitude_g, double gyro_dps, int32_t* features) {
+  IMUSample window[ACTIVITY_WINDOW];
+  for (int i = 0; i < ACTIVITY_WINDOW; i++) window[i] = wristSample(i, hz, amplitude_g, gyro_dps);
+  activityExtractFeatures(window, ACTIVITY_WINDOW, features);
+}
+
+static ActivityClass classify(double hz, double amplitude_g, double gyro_dps) {
+  int32_t features[FEATURE_COUNT];
+  extract(hz, amplitude_g, gyro_dps, features);
+  return activityTreeClassify(features);
+}
+
+// Runs whole seconds through the classifier in FIFO-sized batches
+static void feed(ActivityClassifier& classifier, int seconds, double hz, double amplitude_g, double gyro_dps) {
+  IMUSample batch[IMU_FIFO_WATERMARK];
+  int total = seconds * ACTIVITY_HOP;
+  for (int n = 0; n < total; n += IMU_FIFO_WATERMARK) {
+    int count = total - n < IMU_FIFO_WATERMARK ? total - n : IMU_FIFO_WATERMARK;
+    for (int i = 0; i < count; i++) {
+      batch[i] = wristSample(classifier.sample_count + i, hz, amplitude_g, gyro_dps);
+    }
+    activityProcess(classifier, batch, count);
+  }
+}
+
+static void testFeatures() {
+  int32_t features[FEATURE_COUNT];
+  extract(2.0, 0.25, 0, features);
+  // A 0.25g sine holds (256)^2 / 2 of variance in 1/1024 g units
+  CHECK_NEAR(features[FEATURE_MAGNITUDE_VARIANCE], 32768, 1500);
+  CHECK_NEAR(features[FEATURE_AXIS_ENERGY], 32768, 1500);
+  CHECK_EQ(features[FEATURE_DOMINANT_FREQ], 200);
+  CHECK(features[FEATURE_PERIODICITY] > 80);
+  CHECK_EQ(features[FEATURE_GYRO_MEAN], 0);
+
+  extract(0, 0, 40, features);
+  CHECK_EQ(features[FEATURE_MAGNITUDE_VARIANCE], 0);
+  CHECK_EQ(features[FEATURE_PERIODICITY], 0);
+  CHECK_EQ(features[FEATURE_GYRO_MEAN], 40);
+}
+
+static void testTreeClasses() {
+  CHECK_EQ(classify(0, 0, 0), ACTIVITY_STATIONARY);
+  CHECK_EQ(classify(0, 0, 40), ACTIVITY_OTHER);        // Still but turning the wrist
+  CHECK_EQ(classify(1.5, 0.1, 5), ACTIVITY_CYCLING);   // Periodic and gentle
+  CHECK_EQ(classify(1.8, 0.25, 5), ACTIVITY_WALKING);
+  CHECK_EQ(classify(2.8, 0.8, 5), ACTIVITY_RUNNING);
+  CHECK_EQ(classify(2.8, 0.25, 5), ACTIVITY_WALKING);  // Brisk but light is still a walk
+}
+
+static void testHysteresis() {
+  ActivityClassifier classifier;
+  activityInit(classifier);
+  feed(classifier, 3, 0, 0, 0);
+  CHECK_EQ(classifier.windows, 1);  // First full window at 3 s
+  CHECK_EQ(classifier.current, ACTIVITY_STATIONARY);
+
+  // Start walking: the window fills with gait, then two windows confirm it
+  feed(classifier, 2, 1.8, 0.25, 5);
+  CHECK_EQ(classifier.current, ACTIVITY_STATIONARY);
+  feed(classifier, 3, 1.8, 0.25, 5);
+  CHECK_EQ(classifier.current, ACTIVITY_WALKING);
+  CHECK(activityIsMoving(classifier.current));
+
+  // Stopping: the still class needs a whole still window, then confirmation
+  feed(classifier, 1, 0, 0, 0);
+  CHECK_EQ(classifier.current, ACTIVITY_WALKING);
+  feed(classifier, 5, 0, 0, 0);
+  CHECK_EQ(classifier.current, ACTIVITY_STATIONARY);
+  CHECK_EQ(classifier.windows, 12);
+  CHECK(classifier.class_seconds[ACTIVITY_WALKING] >= 3);
+}
+
+static void testNames() {
+  CHECK(activityName(ACTIVITY_RUNNING)[0] == 'R');
+  CHECK(activityName(ACTIVITY_CLASS_COUNT)[0] == 'U');
+  CHECK(!activityIsMoving(ACTIVITY_OTHER));
+}
+
+int main() {
+  RUN(testFeatures);
+  RUN(testTreeClasses);
+  RUN(testHysteresis);
+  RUN(testNames);
+  return testSummary();
+}
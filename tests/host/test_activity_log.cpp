@@ -0,0 +1,124 @@
+/*
+ * Activity History Store Tests
+ * Append, rollups, reopen and range queries against sd_mock
+ */
+
+#include "test.h"
+#include "activity_log.h"
+#include "sd_mock.h"
+#include <stdlib.h>
+#include <string.h>
+
+static char sd_root[] = "/tmp/watch_sd_XXXXXX";
+
+// Two busy days: 50 steps a minute from 09:00 to 17:00, idle otherwise
+static void appendDays(ActivityLog& log, uint32_t first_day_minute, int days) {
+  int refused = 0;
+  for (int day = 0; day < days; day++) {
+    for (int minute = 0; minute < 1440; minute++) {
+      ActivityMinute record = {first_day_minute + day * 1440 + minute, 0, 0, 0};
+      if (minute >= 9 * 60 && minute < 17 * 60) {
+        record.steps = 50 + minute % 7;
+        record.active_seconds = 30;
+        record.energy_dcal = 25;
+      }
+      if (!activityLogAppend(log, record)) refused++;
+    }
+  }
+  CHECK_EQ(refused, 0);
+}
+
+static uint32_t expectedDaySteps() {
+  uint32_t steps = 0;
+  for (int minute = 9 * 60; minute < 17 * 60; minute++) steps += 50 + minute % 7;
+  return steps;
+}
+
+static void testCalendar() {
+  CHECK_EQ(activityLogMinuteOf(2000, 1, 1, 0, 0), 0);
+  CHECK_EQ(activityLogMinuteOf(2000, 3, 1, 0, 0), (31 + 29) * 1440);  // Leap year
+  CHECK_EQ(activityLogMinuteOf(2001, 1, 1, 1, 30), 366 * 1440 + 90);
+  uint32_t monday = activityLogMinuteOf(2026, 10, 12, 8, 0);
+  uint32_t sunday = activityLogMinuteOf(2026, 10, 18, 23, 59);
+  CHECK_EQ(activityLogPeriod(ROLLUP_WEEK, monday), activityLogPeriod(ROLLUP_WEEK, sunday));
+  CHECK_EQ(activityLogPeriod(ROLLUP_WEEK, sunday + 1), activityLogPeriod(ROLLUP_WEEK, monday) + 1);
+  CHECK_EQ(activityLogPeriod(ROLLUP_DAY, sunday), activityLogPeriod(ROLLUP_HOUR, sunday) / 24);
+}
+
+static void testAppendAndRollups() {
+  sdMockBegin(sd_root);
+  ActivityLog log;
+  CHECK(activityLogOpen(log, sdMockStorage()));
+  uint32_t start = activityLogMinuteOf(2026, 10, 12, 0, 0);
+  appendDays(log, start, 2);
+  CHECK_EQ(log.stats.appended, 2 * 8 * 60);
+  CHECK_EQ(log.stats.idle, 2 * 16 * 60);
+  CHECK(log.stats.pages_written > 0);
+
+  // The write-back counts days as they close, the open day is read from RAM
+  ActivityTotals days[3];
+  CHECK_EQ(activityLogTotals(log, ROLLUP_DAY, activityLogPeriod(ROLLUP_DAY, start), 3, days), 3);
+  CHECK_EQ(days[0].steps, expectedDaySteps());
+  CHECK_EQ(days[1].steps, expectedDaySteps());
+  CHECK_EQ(days[1].active_seconds, 8 * 60 * 30);
+  CHECK_EQ(days[2].steps, 0);
+
+  ActivityTotals hours[24];
+  activityLogTotals(log, ROLLUP_HOUR, activityLogPeriod(ROLLUP_HOUR, start), 24, hours);
+  CHECK_EQ(hours[8].steps, 0);
+  CHECK(hours[9].steps >= 60 * 50);
+  CHECK_EQ(hours[9].energy_dcal, 60 * 25);
+
+  // Time only moves forward
+  ActivityMinute stale = {start + 600, 10, 10, 10};
+  CHECK(!activityLogAppend(log, stale));
+  CHECK_EQ(log.stats.rejected, 1);
+  CHECK(activityLogFlush(log));
+}
+
+static void testReopenAndQuery() {
+  // Same card, fresh RAM: rollups and the open page come back from SD
+  sdMockResetStats();
+  ActivityLog log;
+  CHECK(activityLogOpen(log, sdMockStorage()));
+  uint32_t start = activityLogMinuteOf(2026, 10, 12, 0, 0);
+  ActivityTotals week;
+  activityLogTotals(log, ROLLUP_WEEK, activityLogPeriod(ROLLUP_WEEK, start), 1, &week);
+  CHECK_EQ(week.steps, 2 * expectedDaySteps());
+
+  // A 30 day chart is one small rollup read
+  sdMockResetStats();
+  ActivityTotals month[30];
+  activityLogTotals(log, ROLLUP_DAY, activityLogPeriod(ROLLUP_DAY, start) - 28, 30, month);
+  CHECK_EQ(month[28].steps, expectedDaySteps());
+  CHECK(sdMockGetStats().reads <= 2);
+
+  // Minutes across the page boundaries of the second afternoon
+  ActivityMinute minutes[120];
+  uint32_t from = start + 1440 + 16 * 60;
+  int found = activityLogMinutes(log, from, from + 120, minutes, 120);
+  CHECK_EQ(found, 60);  // The hour after 17:00 is idle and was never stored
+  CHECK_EQ(minutes[0].minute, from);
+  CHECK_EQ(minutes[59].minute, from + 59);
+  CHECK_EQ(minutes[59].steps, 50 + (17 * 60 - 1) % 7);
+
+  // Appending continues where the card left off
+  ActivityMinute next = {start + 2 * 1440 + 600, 80, 40, 30};
+  CHECK(activityLogAppend(log, next));
+  CHECK(activityLogFlush(log));
+  found = activityLogMinutes(log, next.minute, next.minute + 1, minutes, 1);
+  CHECK_EQ(found, 1);
+  CHECK_EQ(minutes[0].steps, 80);
+}
+
+int main() {
+  if (mkdtemp(sd_root) == nullptr) return 1;
+  RUN(testCalendar);
+  RUN(testAppendAndRollups);
+  RUN(testReopenAndQuery);
+  int result = testSummary();
+  char command[64];
+  snprintf(command, sizeof(command), "rm -rf %s", sd_root);
+  if (system(command) != 0) fprintf(stderr, "could not remove %s\n", sd_root);
+  return result;
+}
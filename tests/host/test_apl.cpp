@@ -0,0 +1,170 @@
+/*
+ * Picture Level and Display Limiter Tests
+ * The tile map against known frames, and the limiter against the energy model's panel terms
+ */
+
+#include "test.h"
+#include "apl.h"
+#include <stdlib.h>
+
+#define WIDTH 368
+#define HEIGHT 448
+#define FRAME_MS 33
+
+static const AplLimiterProfile profile = {30000, 12000, 20, 30, 4, 3000};
+static EnergyModel model;
+
+static AplLimiterInput frame(uint32_t now_ms, uint16_t apl, uint8_t requested) {
+  AplLimiterInput input = {now_ms, apl, requested, 80, false};
+  return input;
+}
+
+// ==================== MAP ====================
+static void testKnownFrames() {
+  AplMap map;
+  aplInit(map, WIDTH, HEIGHT);
+  CHECK_EQ(map.cols, 23);
+  CHECK_EQ(map.rows, 28);
+  aplClear(map, 0);
+  CHECK_EQ(aplLevel(map), 0);
+
+  aplPaint(map, 0, 0, WIDTH, HEIGHT / 2, 1000, 1000);  // Top half white
+  CHECK_EQ(aplLevel(map), 500);
+  aplPaint(map, 0, 0, WIDTH, HEIGHT, 1000, 785);       // A full-screen circle
+  CHECK_NEAR(aplLevel(map), 500 + 500 * 0.785, 2);
+  aplClear(map, 1000);
+  CHECK_EQ(aplLevel(map), 1000);
+
+  // Half a tile painted black takes the tile halfway
+  aplPaint(map, 0, 0, 8, 16, 0, 1000);
+  CHECK_EQ(map.tile[0][0], 500);
+  CHECK_EQ(map.tile[0][1], 1000);
+}
+
+static void testClippingAndHistogram() {
+  AplMap map;
+  aplInit(map, WIDTH, HEIGHT);
+  aplClear(map, 0);
+  aplPaint(map, -100, -100, 50, 50, 1000, 1000);     // Wholly off screen
+  aplPaint(map, WIDTH - 8, 0, 100, 16, 1000, 1000);  // Clipped to half the last tile
+  aplPaint(map, 0, 0, 16, 16, 1000, 0);               // Nothing covered
+  CHECK_EQ(map.paints, 1);
+  CHECK_EQ(map.tile[0][map.cols - 1], 500);
+
+  uint16_t bins[APL_HISTOGRAM_BINS];
+  aplHistogram(map, bins);
+  int tiles = 0;
+  for (int bin = 0; bin < APL_HISTOGRAM_BINS; bin++) tiles += bins[bin];
+  CHECK_EQ(tiles, map.cols * map.rows);
+  CHECK_EQ(bins[4], 1);  // Half white sits at the top of the fifth tenth
+  CHECK_EQ(bins[0], tiles - 1);
+}
+
+static void testRunningSumMatchesTiles() {
+  AplMap map;
+  aplInit(map, WIDTH, HEIGHT);
+  aplClear(map, 120);
+  srand(7);
+  for (int i = 0; i < 2000; i++) {
+    aplPaint(map, rand() % WIDTH - 20, rand() % HEIGHT - 20, rand() % 120 + 1, rand() % 120 + 1,
+             rand() % 1001, rand() % 1001);
+  }
+  uint32_t sum = 0;
+  for (int row = 0; row < map.rows; row++) {
+    for (int col = 0; col < map.cols; col++) sum += map.tile[row][col];
+  }
+  CHECK_EQ(map.sum, sum);
+  CHECK_EQ(energyLuminanceFromRGB565(0xFFFF), 1000);
+  CHECK_EQ(energyLuminanceFromRGB565(0x0000), 0);
+}
+
+// ==================== LIMITER ====================
+static void testAllowedBrightnessInvertsPanelCurrent() {
+  for (uint16_t apl = 100; apl <= 1000; apl += 100) {
+    uint8_t allowed = aplAllowedBrightness(model, 30000, apl);
+    CHECK(energyDisplayCurrent(model, allowed, apl) <= 30000);
+    if (allowed < 100) CHECK(energyDisplayCurrent(model, allowed + 1, apl) > 30000);
+  }
+  CHECK_EQ(aplAllowedBrightness(model, 30000, 0), 100);
+  CHECK_EQ(aplAllowedBrightness(model, 1000, 500), 0);  // Under the black panel's own draw
+}
+
+static void testDimsGraduallyRecoversAtOnce() {
+  AplLimiter limiter;
+  aplLimiterInit(limiter, profile);
+  uint32_t now = 0;
+  CHECK_EQ(aplLimiterUpdate(limiter, model, frame(now, 1000, 100)), 96);  // One step per frame
+  uint8_t target = aplAllowedBrightness(model, profile.budget_ua, 1000);
+  int frames = 1;
+  while (limiter.brightness > target && frames < 100) {
+    aplLimiterUpdate(limiter, model, frame(now += FRAME_MS, 1000, 100));
+    frames++;
+  }
+  CHECK_EQ(limiter.brightness, target);
+  CHECK_EQ(frames, (100 - target + profile.step - 1) / profile.step);
+  CHECK(!limiter.dark);  // At that brightness white fits the budget
+
+  CHECK_EQ(aplLimiterUpdate(limiter, model, frame(now += FRAME_MS, 150, 100)), 100);
+  CHECK(limiter.stats.limited_ms > 0);
+
+  // A dim choice below the floor is followed down, never past it
+  for (int i = 0; i < 30; i++) aplLimiterUpdate(limiter, model, frame(now += FRAME_MS, 1000, 20));
+  CHECK_EQ(limiter.brightness, 20);
+}
+
+static void testDarkVariantHeldForScreen() {
+  AplLimiterProfile high_floor = profile;
+  high_floor.min_brightness = 60;
+  AplLimiter limiter;
+  aplLimiterInit(limiter, high_floor);
+
+  // White at the floor is still over budget: dark after the hold
+  uint32_t now = 0;
+  for (; now < high_floor.dark_hold_ms; now += FRAME_MS) {
+    aplLimiterUpdate(limiter, model, frame(now, 1000, 100));
+    CHECK(!limiter.dark);
+  }
+  aplLimiterUpdate(limiter, model, frame(now, 1000, 100));
+  CHECK(limiter.dark);
+  CHECK_EQ(limiter.brightness, 60);
+
+  // Darker frames do not argue it back, a new screen does
+  aplLimiterUpdate(limiter, model, frame(now += FRAME_MS, 100, 100));
+  CHECK(limiter.dark);
+  aplLimiterScreenChanged(limiter);
+  aplLimiterUpdate(limiter, model, frame(now += FRAME_MS, 100, 100));
+  CHECK(!limiter.dark);
+  CHECK_EQ(limiter.stats.dark_switches, 1);
+}
+
+static void testLowBatteryGoesDarkUntilCharging() {
+  AplLimiter limiter;
+  aplLimiterInit(limiter, profile);
+  AplLimiterInput input = frame(0, 300, 100);
+  input.battery_percent = 15;
+  while (!limiter.dark && input.now_ms < 2 * profile.dark_hold_ms) {
+    aplLimiterUpdate(limiter, model, input);
+    input.now_ms += FRAME_MS;
+  }
+  CHECK(limiter.dark);
+  CHECK(input.now_ms > profile.dark_hold_ms);
+  CHECK(limiter.for_battery);
+  CHECK(energyDisplayCurrent(model, limiter.brightness, 300) <= profile.low_battery_budget_ua);
+
+  input.charging = true;
+  input.now_ms += FRAME_MS;
+  aplLimiterUpdate(limiter, model, input);
+  CHECK(!limiter.dark);
+}
+
+int main() {
+  energyModelDefaults(model);
+  RUN(testKnownFrames);
+  RUN(testClippingAndHistogram);
+  RUN(testRunningSumMatchesTiles);
+  RUN(testAllowedBrightnessInvertsPanelCurrent);
+  RUN(testDimsGraduallyRecoversAtOnce);
+  RUN(testDarkVariantHeldForScreen);
+  RUN(testLowBatteryGoesDarkUntilCharging);
+  return testSummary();
+}
@@ -0,0 +1,185 @@
+/*
+ * Staged Boot Tests
+ * setup() and loop() replayed with stand-in stages on a virtual clock
+ *
+ * Stage costs are bench figures for the board; the time to first frame
+ * they add up to is printed on every run so a change that moves work in
+ * front of the watch face shows up in the host build.
+ */
+
+#include "test.h"
+#include "boot.h"
+
+#define FRAME_DRAW_MS 35
+#define FIRST_FRAME_BUDGET_MS 400
+#define LOOP_PASS_MS 16
+
+static const uint32_t stage_ms[BOOT_STAGE_COUNT] = {
+  3,      // i2c
+  25,     // power
+  120,    // display
+  30,     // touch
+  60,     // sensors
+  8,      // rtc
+  4,      // state
+  2,      // sensor_task
+  45,     // ui
+  300,    // storage
+  40,     // settings
+  80,     // activity_log
+  1500,   // media
+  60      // apps
+};
+
+struct VirtualBoot {
+  BootPlan plan;
+  uint32_t now;
+  uint32_t failing;            // Stages that fail, one bit each
+  uint32_t passes;
+  int order[BOOT_STAGE_COUNT];
+  int ran;
+};
+
+static void runStage(VirtualBoot& boot, int stage) {
+  bootBegin(boot.plan, stage, boot.now);
+  boot.now += stage_ms[stage];
+  bootEnd(boot.plan, stage, !(boot.failing & (1u << stage)), boot.now);
+  boot.order[boot.ran++] = stage;
+}
+
+// setup(), then loop() passes until the background stages are through
+static void runBoot(VirtualBoot& boot, uint32_t failing = 0, bool warm = false) {
+  boot.now = 0;
+  boot.failing = failing;
+  boot.passes = 0;
+  boot.ran = 0;
+  bootInit(boot.plan, boot.now);
+
+  int stage;
+  while ((stage = bootNext(boot.plan)) >= 0) {
+    runStage(boot, stage);
+    if (stage == BOOT_STATE && warm) {
+      bootSkip(boot.plan, BOOT_SETTINGS);
+      bootSkip(boot.plan, BOOT_MEDIA);
+      bootSkip(boot.plan, BOOT_APPS);
+    }
+  }
+  if (boot.plan.halted) return;
+
+  while (!bootComplete(boot.plan) && boot.passes < 100) {
+    boot.now += FRAME_DRAW_MS;
+    bootNoteFirstFrame(boot.plan, boot.now);
+    stage = bootNext(boot.plan);
+    if (stage >= 0) runStage(boot, stage);
+    boot.now += LOOP_PASS_MS;
+    boot.passes++;
+  }
+}
+
+static int position(const VirtualBoot& boot, int stage) {
+  for (int i = 0; i < boot.ran; i++) {
+    if (boot.order[i] == stage) return i;
+  }
+  return -1;
+}
+
+static void testColdBootFirstFrame() {
+  VirtualBoot boot;
+  runBoot(boot);
+  CHECK(bootComplete(boot.plan));
+  CHECK(!boot.plan.halted);
+  CHECK_EQ(boot.ran, BOOT_STAGE_COUNT);
+
+  // Only the foreground stages stand between reset and the watch face
+  uint32_t foreground = 0;
+  for (int stage = 0; stage < BOOT_STAGE_COUNT; stage++) {
+    if (!bootIsBackground(stage)) foreground += stage_ms[stage];
+    CHECK_EQ(bootStageMs(boot.plan, stage), stage_ms[stage]);
+  }
+  uint32_t first_frame = boot.plan.first_frame_ms - boot.plan.begin_ms;
+  CHECK_EQ(first_frame, foreground + FRAME_DRAW_MS);
+  CHECK(first_frame <= FIRST_FRAME_BUDGET_MS);
+  for (int stage = BOOT_STORAGE; stage < BOOT_STAGE_COUNT; stage++) {
+    CHECK(boot.plan.stages[stage].start_ms >= boot.plan.first_frame_ms);
+  }
+  printf("time to first frame: %lu ms (budget %d), fully up: %lu ms\n",
+         (unsigned long)first_frame, FIRST_FRAME_BUDGET_MS, (unsigned long)boot.now);
+}
+
+static void testDependencyOrder() {
+  VirtualBoot boot;
+  runBoot(boot);
+  CHECK(position(boot, BOOT_I2C) < position(boot, BOOT_POWER));
+  CHECK(position(boot, BOOT_POWER) < position(boot, BOOT_DISPLAY));
+  CHECK(position(boot, BOOT_RTC) < position(boot, BOOT_STATE));
+  CHECK(position(boot, BOOT_STATE) < position(boot, BOOT_UI));
+  CHECK(position(boot, BOOT_STORAGE) < position(boot, BOOT_SETTINGS));
+  CHECK(position(boot, BOOT_MEDIA) < position(boot, BOOT_APPS));
+  CHECK_EQ(boot.passes, 5);  // One background stage per loop pass
+}
+
+static void testMissingCardCostsOnlyItsStages() {
+  VirtualBoot boot;
+  runBoot(boot, 1u << BOOT_STORAGE);
+  CHECK(bootComplete(boot.plan));
+  CHECK(!boot.plan.halted);
+  CHECK_EQ(boot.plan.stages[BOOT_STORAGE].state, BOOT_FAILED);
+  CHECK_EQ(boot.plan.stages[BOOT_SETTINGS].state, BOOT_SKIPPED);
+  CHECK_EQ(boot.plan.stages[BOOT_ACTIVITY_LOG].state, BOOT_SKIPPED);
+  CHECK_EQ(boot.plan.stages[BOOT_MEDIA].state, BOOT_SKIPPED);
+  CHECK_EQ(boot.plan.stages[BOOT_APPS].state, BOOT_DONE);  // Only runs after them
+  CHECK_EQ(bootStageMs(boot.plan, BOOT_MEDIA), 0);
+
+  // No touch controller: still a watch, just not a touch one
+  runBoot(boot, 1u << BOOT_TOUCH);
+  CHECK(!boot.plan.halted);
+  CHECK_EQ(boot.plan.stages[BOOT_UI].state, BOOT_DONE);
+
+  // No IMU: the sensor task and history need it
+  runBoot(boot, 1u << BOOT_SENSORS);
+  CHECK_EQ(boot.plan.stages[BOOT_SENSOR_TASK].state, BOOT_SKIPPED);
+  CHECK_EQ(boot.plan.stages[BOOT_ACTIVITY_LOG].state, BOOT_SKIPPED);
+  CHECK_EQ(boot.plan.stages[BOOT_MEDIA].state, BOOT_DONE);
+}
+
+static void testRequiredFailureHalts() {
+  VirtualBoot boot;
+  runBoot(boot, 1u << BOOT_POWER);
+  CHECK(boot.plan.halted);
+  CHECK(bootComplete(boot.plan));
+  CHECK(!boot.plan.first_frame);
+  CHECK_EQ(bootNext(boot.plan), -1);
+  CHECK_EQ(boot.plan.stages[BOOT_DISPLAY].state, BOOT_PENDING);
+}
+
+static void testWarmResumeSkipsRestoredStages() {
+  VirtualBoot cold, warm;
+  runBoot(cold);
+  runBoot(warm, 0, true);
+  CHECK(bootComplete(warm.plan));
+  CHECK_EQ(warm.plan.stages[BOOT_SETTINGS].state, BOOT_SKIPPED);
+  CHECK_EQ(warm.plan.stages[BOOT_MEDIA].state, BOOT_SKIPPED);
+  CHECK_EQ(warm.plan.stages[BOOT_APPS].state, BOOT_SKIPPED);
+  CHECK_EQ(warm.plan.stages[BOOT_ACTIVITY_LOG].state, BOOT_DONE);
+  CHECK_EQ(warm.plan.first_frame_ms, cold.plan.first_frame_ms);
+  CHECK(warm.now + 1500 < cold.now);
+  printf("warm resume fully up: %lu ms\n", (unsigned long)warm.now);
+}
+
+static void testNames() {
+  CHECK(bootStageName(BOOT_MEDIA)[0] == 'm');
+  CHECK(bootStageName(-1)[0] == '?');
+  CHECK(bootStateName(BOOT_SKIPPED)[0] == 's');
+  CHECK(!bootIsBackground(BOOT_UI));
+  CHECK(bootIsBackground(BOOT_APPS));
+}
+
+int main() {
+  RUN(testColdBootFirstFrame);
+  RUN(testDependencyOrder);
+  RUN(testMissingCardCostsOnlyItsStages);
+  RUN(testRequiredFailureHalts);
+  RUN(testWarmResumeSkipsRestoredStages);
+  RUN(testNames);
+  return testSummary();
+}
@@ -0,0 +1,123 @@
+/*
+ * Lock-Free Channel Tests
+ * The queue and the seqlock between a producer and consumer thread
+ */
+
+#include "test.h"
+#include "channels.h"
+#include <string.h>
+#include <thread>
+
+#define QUEUE_CAPACITY 16
+#define STRESS_ITEMS 100000
+
+struct Item {
+  uint32_t sequence;
+  uint32_t check;              // ~sequence, catches a half-copied slot
+};
+
+struct Snapshot {
+  uint32_t words[SEQLOCK_MAX_WORDS];
+};
+
+static void testQueueSingleThread() {
+  static Item storage[4];
+  SPSCQueue queue;
+  spscInit(queue, storage, sizeof(Item), 4);
+  Item item = {0, 0};
+  CHECK(!spscPop(queue, &item));
+  for (uint32_t i = 0; i < 4; i++) {
+    item.sequence = i;
+    CHECK(spscPush(queue, &item));
+  }
+  CHECK(!spscPush(queue, &item));  // Full drops at the producer
+  CHECK_EQ(queue.dropped, 1);
+  CHECK_EQ(spscCount(queue), 4);
+  CHECK(spscPop(queue, &item));
+  CHECK_EQ(item.sequence, 0);
+  CHECK_EQ(spscCount(queue), 3);
+}
+
+static void testQueueAcrossThreads() {
+  static Item storage[QUEUE_CAPACITY];
+  static SPSCQueue queue;
+  spscInit(queue, storage, sizeof(Item), QUEUE_CAPACITY);
+
+  // Sensor task side: never blocks, retries a full queue so nothing is lost
+  std::thread producer([]() {
+    for (uint32_t i = 0; i < STRESS_ITEMS; i++) {
+      Item item = {i, ~i};
+      while (!spscPush(queue, &item)) std::this_thread::yield();
+    }
+  });
+
+  uint32_t expected = 0, out_of_order = 0, torn = 0;
+  while (expected < STRESS_ITEMS) {
+    Item item;
+    if (!spscPop(queue, &item)) {
+      std::this_thread::yield();
+      continue;
+    }
+    if (item.check != ~item.sequence) torn++;
+    if (item.sequence != expected) out_of_order++;
+    expected = item.sequence + 1;
+  }
+  producer.join();
+
+  CHECK_EQ(out_of_order, 0);
+  CHECK_EQ(torn, 0);
+  CHECK_EQ(spscCount(queue), 0);
+}
+
+static void testSeqlockNeverTears() {
+  static Seqlock lock;
+  seqlockInit(lock, sizeof(Snapshot));
+  Snapshot empty;
+  uint32_t sequence;
+  CHECK(seqlockRead(lock, &empty, &sequence));
+  CHECK_EQ(sequence, 0);
+
+  // Every word of a snapshot holds the same value, a mix is a torn read
+  std::thread writer([]() {
+    Snapshot snapshot;
+    for (uint32_t i = 1; i <= STRESS_ITEMS; i++) {
+      for (int w = 0; w < SEQLOCK_MAX_WORDS; w++) snapshot.words[w] = i;
+      seqlockWrite(lock, &snapshot);
+    }
+  });
+
+  uint32_t reads = 0, torn = 0, backwards = 0, last = 0;
+  while (seqlockSequence(lock) < 2 * STRESS_ITEMS) {
+    Snapshot snapshot;
+    if (!seqlockRead(lock, &snapshot)) {
+      std::this_thread::yield();
+      continue;
+    }
+    reads++;
+    for (int w = 1; w < SEQLOCK_MAX_WORDS; w++) {
+      if (snapshot.words[w] != snapshot.words[0]) {
+        torn++;
+        break;
+      }
+    }
+    if (snapshot.words[0] < last) backwards++;
+    last = snapshot.words[0];
+  }
+  writer.join();
+
+  CHECK(reads > 0);
+  CHECK_EQ(torn, 0);
+  CHECK_EQ(backwards, 0);
+  CHECK_EQ(lock.writes, STRESS_ITEMS);
+  Snapshot final_snapshot;
+  CHECK(seqlockRead(lock, &final_snapshot, &sequence));
+  CHECK_EQ(final_snapshot.words[SEQLOCK_MAX_WORDS - 1], STRESS_ITEMS);
+  CHECK_EQ(sequence, 2 * STRESS_ITEMS);
+}
+
+int main() {
+  RUN(testQueueSingleThread);
+  RUN(testQueueAcrossThreads);
+  RUN(testSeqlockNeverTears);
+  return testSummary();
+}
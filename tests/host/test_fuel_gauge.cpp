@@ -0,0 +1,181 @@
+/*
+ * Fuel Gauge Tests
+ * The OCV curve, counting, rested corrections and model learning on a simulated cell
+ */
+
+#include "test.h"
+#include "fuel_gauge.h"
+
+#define CAPACITY_MAH 300
+#define UPDATE_MS 30000
+
+// A cell that really drains at true_ua, seen through its terminal voltage
+struct Cell {
+  float remaining_uah;
+  uint32_t true_ua;
+};
+
+static int terminalVoltage(const Cell& cell) {
+  int permille = (int)(cell.remaining_uah / CAPACITY_MAH);
+  int drop_mv = (int)(cell.true_ua / 1000 * FUEL_RESISTANCE_MOHM / 1000);
+  return fuelPermilleToOcv(permille) - drop_mv;
+}
+
+static FuelGaugeInput reading(uint32_t now_ms, int voltage_mv) {
+  FuelGaugeInput input;
+  input.now_ms = now_ms;
+  input.voltage_mv = (int16_t)voltage_mv;
+  input.current_ma = 0;
+  input.current_valid = false;
+  input.temperature_c10 = 250;
+  input.charging = false;
+  input.plugged = false;
+  return input;
+}
+
+static void startGauge(FuelGauge& gauge, uint32_t active_ua, uint32_t sleep_ua) {
+  FuelGaugeProfile profile = {CAPACITY_MAH, 200, {active_ua, sleep_ua}};
+  fuelGaugeInit(gauge, profile);
+}
+
+// Runs the watch asleep for hours, updating the way updateBatteryStatus() does
+static uint32_t runAsleep(FuelGauge& gauge, Cell& cell, uint32_t now_ms, uint32_t hours) {
+  for (uint32_t step = 0; step < hours * 3600000 / UPDATE_MS; step++) {
+    now_ms += UPDATE_MS;
+    cell.remaining_uah -= cell.true_ua * (float)UPDATE_MS / 3600000.0f;
+    fuelGaugeUpdate(gauge, reading(now_ms, terminalVoltage(cell)));
+  }
+  return now_ms;
+}
+
+// ==================== OCV CURVE ====================
+static void testOcvRoundTrip() {
+  int worst = 0;
+  bool monotonic = true;
+  for (int permille = 0; permille <= 1000; permille += 10) {
+    int ocv = fuelPermilleToOcv(permille);
+    int error = fuelOcvToPermille(ocv) - permille;
+    if (error < 0) error = -error;
+    if (error > worst) worst = error;
+    if (permille > 0 && ocv < fuelPermilleToOcv(permille - 10)) monotonic = false;
+  }
+  CHECK(monotonic);
+  CHECK(worst <= 2);
+  CHECK_EQ(fuelOcvToPermille(3000), 0);
+  CHECK_EQ(fuelOcvToPermille(4300), 1000);
+}
+
+static void testColdStrandsCharge() {
+  CHECK_EQ(fuelResistanceMohm(300), FUEL_RESISTANCE_MOHM);
+  CHECK(fuelResistanceMohm(0) > FUEL_RESISTANCE_MOHM);
+  CHECK_EQ(fuelStrandedPermille(250), 0);
+  CHECK(fuelStrandedPermille(-100) > fuelStrandedPermille(0));
+
+  FuelGauge gauge;
+  startGauge(gauge, 20000, 2000);
+  fuelGaugeUpdate(gauge, reading(0, fuelPermilleToOcv(500)));
+  int warm = fuelGaugePercent(gauge);
+  FuelGaugeInput cold = reading(UPDATE_MS, fuelPermilleToOcv(500));
+  cold.temperature_c10 = -100;
+  fuelGaugeUpdate(gauge, cold);
+  CHECK(fuelGaugePercent(gauge) < warm);
+}
+
+// ==================== COUNTING ====================
+static void testCountsModelCharge() {
+  FuelGauge gauge;
+  startGauge(gauge, 30000, 2000);
+  fuelGaugeUpdate(gauge, reading(0, 3900));
+  int32_t start = gauge.remaining_uah;
+
+  // An hour with the screen on at 30 mA, voltage held so no rest applies
+  fuelGaugeUpdate(gauge, reading(3600000, 3900));
+  CHECK_NEAR(start - gauge.remaining_uah, 30000, 5);
+  CHECK_EQ(gauge.stats.corrections, 0);
+
+  // Load switches are booked at the switch
+  fuelGaugeSetLoad(gauge, FUEL_LOAD_SLEEP, 3600000 + 1800000);
+  CHECK_NEAR(start - gauge.remaining_uah, 45000, 5);
+}
+
+static void testRestCorrectsTowardOcv() {
+  FuelGauge gauge;
+  startGauge(gauge, 30000, 1000);
+  fuelGaugeSetLoad(gauge, FUEL_LOAD_SLEEP, 0);
+  fuelGaugeUpdate(gauge, reading(0, fuelPermilleToOcv(800)));
+  CHECK_NEAR(fuelGaugePercent(gauge), 80, 1);
+
+  // The rested cell says 30%, near the steep bottom of the curve
+  uint32_t now = 0;
+  while (gauge.stats.corrections == 0 && now < 2 * FUEL_RELAX_MS) {
+    now += UPDATE_MS;
+    fuelGaugeUpdate(gauge, reading(now, fuelPermilleToOcv(300)));
+  }
+  CHECK_EQ(gauge.stats.corrections, 1);
+  CHECK(now >= FUEL_RELAX_MS);
+  CHECK(gauge.stats.last_correction_uah < 0);
+  CHECK(fuelGaugePercent(gauge) < 80);
+  CHECK(fuelGaugePercent(gauge) >= 30);
+}
+
+static void testLearnsSleepCurrent() {
+  FuelGauge gauge;
+  startGauge(gauge, 30000, 2000);
+  fuelGaugeSetLoad(gauge, FUEL_LOAD_SLEEP, 0);
+  Cell cell = {CAPACITY_MAH * 900.0f, 4000};
+  fuelGaugeUpdate(gauge, reading(0, terminalVoltage(cell)));
+
+  // Twice the modelled current: rested checkpoints scale the model up
+  runAsleep(gauge, cell, 0, 24);
+  CHECK(gauge.stats.checkpoints > 0);
+  CHECK(gauge.model_changed);
+  CHECK(fuelGaugeLoadCurrent(gauge, FUEL_LOAD_SLEEP) > 3000);
+  CHECK(fuelGaugeLoadCurrent(gauge, FUEL_LOAD_SLEEP) < 6000);
+  CHECK_NEAR(fuelGaugePercent(gauge), cell.remaining_uah / CAPACITY_MAH / 10, 8);
+}
+
+static void testChargerFinishAnchorsFull() {
+  FuelGauge gauge;
+  startGauge(gauge, 30000, 2000);
+  FuelGaugeInput input = reading(0, 3800);
+  input.charging = input.plugged = true;
+  fuelGaugeUpdate(gauge, input);
+  CHECK(fuelGaugeChargeMinutes(gauge) > 0);
+  int before = fuelGaugePercent(gauge);
+
+  input.now_ms = 600000;
+  fuelGaugeUpdate(gauge, input);
+  CHECK(fuelGaugePercent(gauge) > before);  // 200 mA for ten minutes
+
+  input.now_ms = 1200000;
+  input.charging = false;
+  fuelGaugeUpdate(gauge, input);
+  CHECK_EQ(fuelGaugePercent(gauge), 100);
+  CHECK_EQ(fuelGaugeChargeMinutes(gauge), 0);
+}
+
+static void testRuntimeFollowsLoadMix() {
+  FuelGauge gauge;
+  startGauge(gauge, 30000, 2000);
+  fuelGaugeUpdate(gauge, reading(0, fuelPermilleToOcv(500)));
+  uint32_t runtime = fuelGaugeRuntimeMinutes(gauge);
+  // 150 mAh over 10% at 30 mA and 90% at 2 mA
+  CHECK_NEAR(runtime, 150.0 / 4.8 * 60, 60);
+
+  uint32_t saved[FUEL_LOAD_COUNT] = {60000, 0};
+  fuelGaugeSetModel(gauge, saved);
+  CHECK_EQ(fuelGaugeLoadCurrent(gauge, FUEL_LOAD_ACTIVE), 60000);
+  CHECK_EQ(fuelGaugeLoadCurrent(gauge, FUEL_LOAD_SLEEP), 2000);  // Zero keeps the default
+  CHECK(fuelGaugeRuntimeMinutes(gauge) < runtime);
+}
+
+int main() {
+  RUN(testOcvRoundTrip);
+  RUN(testColdStrandsCharge);
+  RUN(testCountsModelCharge);
+  RUN(testRestCorrectsTowardOcv);
+  RUN(testLearnsSleepCurrent);
+  RUN(testChargerFinishAnchorsFull);
+  RUN(testRuntimeFollowsLoadMix);
+  return testSummary();
+}
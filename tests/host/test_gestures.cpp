@@ -0,0 +1,329 @@
+/*
+ * Gesture Recognizer and Kinetic Scroller Tests
+ * Recorded touch traces replayed the way handleTouch() feeds them
+ */
+
+#include "test.h"
+#include "gestures.h"
+#include <string.h>
+
+#define MAX_EVENTS 64
+
+struct Replay {
+  GestureEventData events[MAX_EVENTS];
+  int count;
+};
+
+static void keep(Replay& replay, const GestureEventData& event) {
+  if (event.type != GESTURE_NONE && replay.count < MAX_EVENTS) replay.events[replay.count++] = event;
+}
+
+static bool replayTrace(const char* name, Replay& replay, GestureTracker& tracker) {
+  char path[128];
+  snprintf(path, sizeof(path), "traces/%s", name);
+  FILE* file = fopen(path, "r");
+  if (!file) {
+    fprintf(stderr, "%s: missing\n", path);
+    return false;
+  }
+
+  replay.count = 0;
+  char line[128];
+  while (fgets(line, sizeof(line), file)) {
+    unsigned long time;
+    char action[8];
+    int x, y;
+    if (line[0] == '#' || sscanf(line, "%lu %7s", &time, action) != 2) continue;
+    if (strcmp(action, "down") == 0 && sscanf(line, "%lu %7s %d %d", &time, action, &x, &y) == 4) {
+      // A sample that changes nothing still lets the long press timer run
+      GestureEventData event = gestureTouchDown(tracker, x, y, time);
+      if (event.type == GESTURE_NONE) event = gestureTick(tracker, time);
+      keep(replay, event);
+    } else if (strcmp(action, "up") == 0) {
+      keep(replay, gestureTouchUp(tracker, time));
+    } else {
+      keep(replay, gestureTick(tracker, time));
+    }
+  }
+  fclose(file);
+  return true;
+}
+
+static int countType(const Replay& replay, GestureEventType type) {
+  int count = 0;
+  for (int i = 0; i < replay.count; i++) {
+    if (replay.events[i].type == type) count++;
+  }
+  return count;
+}
+
+static GestureEventType lastType(const Replay& replay) {
+  return replay.count ? replay.events[replay.count - 1].type : GESTURE_NONE;
+}
+
+// ==================== TRACES ====================
+static void testTap() {
+  GestureTracker tracker;
+  gestureReset(tracker);
+  Replay replay;
+  CHECK(replayTrace("tap.trace", replay, tracker));
+  CHECK_EQ(replay.events[0].type, GESTURE_PRESS);
+  CHECK_EQ(countType(replay, GESTURE_DRAG), 0);  // Jitter stays inside the slop
+  CHECK_EQ(countType(replay, GESTURE_TAP), 1);
+  CHECK_EQ(countType(replay, GESTURE_LONG_PRESS), 0);
+  CHECK(!tracker.tap_armed);  // The trailing tick closed the double tap window
+}
+
+static void testDoubleTap() {
+  GestureTracker tracker;
+  gestureReset(tracker);
+  Replay replay;
+  CHECK(replayTrace("double_tap.trace", replay, tracker));
+  CHECK_EQ(countType(replay, GESTURE_TAP), 1);
+  CHECK_EQ(lastType(replay), GESTURE_DOUBLE_TAP);
+  CHECK(!tracker.tap_armed);  // A third tap starts over
+}
+
+static void testLongPress() {
+  GestureTracker tracker;
+  gestureReset(tracker);
+  Replay replay;
+  CHECK(replayTrace("long_press.trace", replay, tracker));
+  CHECK_EQ(countType(replay, GESTURE_LONG_PRESS), 1);
+  CHECK_EQ(countType(replay, GESTURE_TAP), 0);
+  CHECK_EQ(lastType(replay), GESTURE_RELEASE);
+  for (int i = 0; i < replay.count; i++) {
+    if (replay.events[i].type == GESTURE_LONG_PRESS) CHECK_EQ(replay.events[i].timestamp, 1000 + GESTURE_LONG_PRESS_TIME);
+  }
+}
+
+static void testFling() {
+  GestureTracker tracker;
+  gestureReset(tracker);
+  Replay replay;
+  CHECK(replayTrace("fling_up.trace", replay, tracker));
+  CHECK(countType(replay, GESTURE_DRAG) > 5);
+  CHECK_EQ(lastType(replay), GESTURE_FLING);
+  const GestureEventData& fling = replay.events[replay.count - 1];
+  CHECK_NEAR(fling.vy, -1.5, 0.05);
+  CHECK_NEAR(fling.vx, 0, 0.01);
+  CHECK_EQ(fling.start_y, 400);
+}
+
+static void testStoppedDragDoesNotFling() {
+  GestureTracker tracker;
+  gestureReset(tracker);
+  Replay replay;
+  CHECK(replayTrace("drag_stop.trace", replay, tracker));
+  CHECK(countType(replay, GESTURE_DRAG) > 5);
+  CHECK_EQ(countType(replay, GESTURE_FLING), 0);
+  CHECK_EQ(lastType(replay), GESTURE_RELEASE);
+}
+
+// ==================== VELOCITY AND MULTI-TOUCH ====================
+static void testVelocityFitIgnoresOldSamples() {
+  GestureTracker tracker;
+  gestureReset(tracker);
+  gestureTouchDown(tracker, 0, 0, 0);
+  // Slow start, then 2 px/ms for the last 100 ms
+  for (uint32_t t = 10; t <= 300; t += 10) {
+    int x = t <= 200 ? (int)(t / 10) : 20 + (int)(t - 200) * 2;
+    gestureTouchDown(tracker, x, 0, t);
+  }
+  float vx, vy;
+  CHECK(gestureEstimateVelocity(tracker, vx, vy));
+  CHECK_NEAR(vx, 2.0, 0.05);
+  CHECK_NEAR(vy, 0, 0.001);
+  CHECK_EQ(gestureTouchUp(tracker, 305).type, GESTURE_FLING);
+}
+
+static void testFlingClamped() {
+  GestureTracker tracker;
+  gestureReset(tracker);
+  for (uint32_t t = 0; t <= 50; t += 10) gestureTouchDown(tracker, (int)t * 20, 0, t);
+  GestureEventData event = gestureTouchUp(tracker, 55);
+  CHECK_EQ(event.type, GESTURE_FLING);
+  CHECK_NEAR(event.vx, GESTURE_FLING_MAX_VELOCITY, 0.01);
+}
+
+static void testCancelDropsTap() {
+  GestureTracker tracker;
+  gestureReset(tracker);
+  gestureTouchDown(tracker, 10, 10, 0);
+  gestureCancel(tracker);
+  CHECK_EQ(gestureTouchUp(tracker, 50).type, GESTURE_NONE);
+}
+
+static void testPointTracking() {
+  TouchPoint tracked[GESTURE_MAX_POINTS];
+  int next_id = 0;
+  TouchPoint raw[2] = {{0, -1, 100, 100}, {0, -1, 300, 300}};
+  int count = trackTouchPoints(tracked, 0, raw, 2, next_id);
+  CHECK_EQ(count, 2);
+  CHECK_EQ(tracked[0].id, 0);
+  CHECK_EQ(tracked[1].id, 1);
+
+  // Reported in the other order, matched by distance
+  TouchPoint swapped[2] = {{0, -1, 305, 298}, {0, -1, 104, 101}};
+  count = trackTouchPoints(tracked, count, swapped, 2, next_id);
+  CHECK_EQ(tracked[0].id, 0);
+  CHECK_EQ(tracked[0].x, 104);
+  CHECK_EQ(tracked[1].id, 1);
+
+  // First finger lifts: the second keeps its id
+  TouchPoint second[1] = {{0, -1, 310, 296}};
+  count = trackTouchPoints(tracked, count, second, 1, next_id);
+  CHECK_EQ(count, 1);
+  CHECK_EQ(tracked[0].id, 1);
+}
+
+static void testPinch() {
+  PinchTracker pinch;
+  pinchReset(pinch);
+  TouchPoint a = {0, -1, 100, 200}, b = {1, -1, 200, 200};
+  CHECK_EQ(pinchUpdate(pinch, a, b, 0).type, GESTURE_NONE);  // Reference span
+  a.x = 50;
+  b.x = 250;
+  GestureEventData event = pinchUpdate(pinch, a, b, 20);
+  CHECK_EQ(event.type, GESTURE_PINCH);
+  CHECK_NEAR(event.scale, 2.0, 0.001);
+  CHECK_EQ(event.x, 150);
+
+  // Rotate a quarter turn about the centre at the same span
+  TouchPoint c = {0, -1, 150, 100}, d = {1, -1, 150, 300};
+  event = pinchUpdate(pinch, c, d, 40);
+  CHECK(event.type == GESTURE_ROTATE || event.type == GESTURE_PINCH);
+  CHECK_NEAR(pinch.last_rotation, 90, 0.5);
+  CHECK_EQ(pinchEnd(pinch, 60).type, GESTURE_RELEASE);
+  CHECK_EQ(pinchEnd(pinch, 70).type, GESTURE_NONE);
+}
+
+// ==================== TOUCH SESSION ====================
+// One poll, as readTouchSample() does it; count 0 is the panel going quiet
+static GestureEventData poll(TouchSession& session, const TouchPoint* raw, int count, uint32_t now) {
+  if (count == 0) return touchSessionRelease(session, now);
+  GestureEventData event;
+  if (!touchSessionContacts(session, raw, count, now, event)) return event;
+  event = gestureTouchDown(session.tracker, session.points[0].x, session.points[0].y, now);
+  return event.type == GESTURE_NONE ? gestureTick(session.tracker, now) : event;
+}
+
+static void testPinchLandingTogetherThenTap() {
+  TouchSession session;
+  touchSessionReset(session);
+
+  // Both fingers in the first poll: the pinch starts without any press
+  TouchPoint both[2] = {{0, 0, 100, 200}, {0, 1, 200, 200}};
+  CHECK_EQ(poll(session, both, 2, 0).type, GESTURE_NONE);
+  CHECK(session.pinch.active);
+  both[0].x = 60;
+  both[1].x = 240;
+  CHECK_EQ(poll(session, both, 2, 20).type, GESTURE_PINCH);
+
+  // Both lift in the same poll: the pinch ends
+  CHECK_EQ(poll(session, nullptr, 0, 40).type, GESTURE_RELEASE);
+  CHECK(!session.pinch.active);
+  CHECK_EQ(session.count, 0);
+
+  // And the next touch is an ordinary tap
+  TouchPoint finger[1] = {{0, 0, 150, 150}};
+  CHECK_EQ(poll(session, finger, 1, 500).type, GESTURE_PRESS);
+  CHECK_EQ(poll(session, nullptr, 0, 560).type, GESTURE_TAP);
+  CHECK_EQ(poll(session, nullptr, 0, 580).type, GESTURE_NONE);  // Idle polls stay quiet
+}
+
+static void testFingerLeftAfterPinchWaits() {
+  TouchSession session;
+  touchSessionReset(session);
+  TouchPoint finger[1] = {{0, 0, 100, 200}};
+  TouchPoint both[2] = {{0, 0, 100, 200}, {0, 1, 200, 200}};
+  CHECK_EQ(poll(session, finger, 1, 0).type, GESTURE_PRESS);
+  poll(session, both, 2, 20);
+  CHECK_EQ(poll(session, finger, 1, 40).type, GESTURE_NONE);  // Not a new press
+  CHECK_EQ(poll(session, finger, 1, 60).type, GESTURE_NONE);
+  CHECK_EQ(poll(session, nullptr, 0, 80).type, GESTURE_RELEASE);
+  CHECK_EQ(poll(session, finger, 1, 400).type, GESTURE_PRESS);
+}
+
+// ==================== SCROLLER ====================
+static void testScrollerCoastsAndStops() {
+  KineticScroller scroller;
+  scrollerInit(scroller, 0, 10000);
+  scrollerBeginDrag(scroller, 0);
+  scrollerDrag(scroller, 500);
+  scrollerRelease(scroller, 2.0f, 0);
+  uint32_t now = 0;
+  float last = scroller.position;
+  bool monotonic = true;
+  while (scrollerUpdate(scroller, now += 16) && now < 20000) {
+    if (scroller.position < last) monotonic = false;
+    last = scroller.position;
+  }
+  CHECK(monotonic);
+  CHECK(!scroller.animating);
+  CHECK(now < 20000);
+  // Friction 0.998/ms: about v / -ln(0.998) px of coast
+  CHECK_NEAR(scroller.position, 500 + 2.0 / 0.002, 60);
+}
+
+static void testScrollerSpringsBack() {
+  KineticScroller scroller;
+  scrollerInit(scroller, 0, 1000);
+  scrollerBeginDrag(scroller, 0);
+  scrollerDrag(scroller, -40);
+  CHECK_NEAR(scroller.position, -40, 0.001);
+  scrollerDrag(scroller, -40);  // Rubber band past the edge
+  CHECK(scroller.position > -80);
+  scrollerRelease(scroller, 0, 0);
+  uint32_t now = 0;
+  while (scrollerUpdate(scroller, now += 16) && now < 10000) {}
+  CHECK_EQ(scroller.position, 0);
+  CHECK(!scroller.animating);
+}
+
+static void testScrollerFlingIntoEdge() {
+  KineticScroller scroller;
+  scrollerInit(scroller, 0, 300);
+  scroller.position = 250;
+  scrollerRelease(scroller, 3.0f, 0);
+  uint32_t now = 0;
+  float peak = 0;
+  while (scrollerUpdate(scroller, now += 16) && now < 10000) {
+    if (scroller.position > peak) peak = scroller.position;
+  }
+  CHECK(peak > 300);           // Overshoots the end...
+  CHECK(peak < 300 + 400);
+  CHECK_EQ(scroller.position, 300);  // ...and settles on it
+}
+
+static void testScrollerBoundsShrink() {
+  KineticScroller scroller;
+  scrollerInit(scroller, 0, 1000);
+  scroller.position = 900;
+  scrollerSetBounds(scroller, 0, 400);
+  CHECK(scroller.animating);
+  uint32_t now = 0;
+  scroller.last_update = 0;
+  while (scrollerUpdate(scroller, now += 16) && now < 20000) {}
+  CHECK_EQ(scroller.position, 400);
+}
+
+int main() {
+  RUN(testTap);
+  RUN(testDoubleTap);
+  RUN(testLongPress);
+  RUN(testFling);
+  RUN(testStoppedDragDoesNotFling);
+  RUN(testVelocityFitIgnoresOldSamples);
+  RUN(testFlingClamped);
+  RUN(testCancelDropsTap);
+  RUN(testPointTracking);
+  RUN(testPinch);
+  RUN(testPinchLandingTogetherThenTap);
+  RUN(testFingerLeftAfterPinchWaits);
+  RUN(testScrollerCoastsAndStops);
+  RUN(testScrollerSpringsBack);
+  RUN(testScrollerFlingIntoEdge);
+  RUN(testScrollerBoundsShrink);
+  return testSummary();
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+/*
+ * CPU Governor Tests
+ * Demand levels, immediate raises, held step-downs and residency on workload traces
+ */
+
+#include "test.h"
+#include "governor.h"
+
+#define FRAME_MS 33
+
+static const GovernorProfile profile = {33333, 70, 500, 1000, 3};
+
+static GovernorInput idle(uint32_t now_ms) {
+  GovernorInput input = {now_ms, 0, false, false, false, false};
+  return input;
+}
+
+// A frame whose work, at 240MHz, takes work_us; it runs at the current clock
+static int frame(Governor& governor, uint32_t now_ms, uint32_t work_us) {
+  GovernorInput input = idle(now_ms);
+  input.frame_us = work_us * 240 / governorLevelMhz(governor.level);
+  return governorUpdate(governor, input);
+}
+
+static void testDemandLevels() {
+  GovernorInput input = idle(0);
+  CHECK_EQ(governorDemand(profile, input, 0), GOVERNOR_80MHZ);
+  CHECK_EQ(governorDemand(profile, input, 7000), GOVERNOR_80MHZ);
+  CHECK_EQ(governorDemand(profile, input, 12000), GOVERNOR_160MHZ);
+  CHECK_EQ(governorDemand(profile, input, 20000), GOVERNOR_240MHZ);
+
+  input.audio = true;
+  CHECK_EQ(governorDemand(profile, input, 0), GOVERNOR_160MHZ);
+  CHECK_EQ(governorDemand(profile, input, 20000), GOVERNOR_240MHZ);
+  input.audio = false;
+  input.touching = true;
+  CHECK_EQ(governorDemand(profile, input, 0), GOVERNOR_240MHZ);
+  CHECK_EQ(governorLevelMhz(GOVERNOR_160MHZ), 160);
+  CHECK_EQ(governorLevelMhz(7), 240);
+}
+
+static void testRaisesAtOnce() {
+  Governor governor;
+  governorInit(governor, profile, GOVERNOR_80MHZ);
+  CHECK_EQ(frame(governor, 0, 2000), GOVERNOR_80MHZ);
+  CHECK_EQ(frame(governor, FRAME_MS, 20000), GOVERNOR_240MHZ);  // One heavy frame is enough
+  CHECK_EQ(governor.stats.switches, 1);
+  CHECK_EQ(governor.stats.over_budget, 1);  // 60 ms at 80MHz
+}
+
+static void testStepsDownOneAtATime() {
+  Governor governor;
+  governorInit(governor, profile, GOVERNOR_240MHZ);
+  uint32_t now = 0;
+  uint32_t left_240 = 0, left_160 = 0;
+  for (; now < 5000; now += FRAME_MS) {
+    int level = frame(governor, now, 2000);
+    if (level == GOVERNOR_160MHZ && !left_240) left_240 = now;
+    if (level == GOVERNOR_80MHZ && !left_160) left_160 = now;
+  }
+  CHECK_EQ(governor.level, GOVERNOR_80MHZ);
+  CHECK_EQ(governor.stats.switches, 2);
+  CHECK(left_240 >= profile.dwell_ms);
+  CHECK(left_160 - left_240 >= profile.down_hold_ms);
+  CHECK(left_160 - left_240 >= profile.dwell_ms);
+}
+
+static void testBurstsDoNotThrash() {
+  Governor governor;
+  governorInit(governor, profile, GOVERNOR_80MHZ);
+  // A heavy frame every 300 ms, light ones between: up once, then held there
+  for (uint32_t now = 0, n = 0; now < 10000; now += FRAME_MS, n++) {
+    frame(governor, now, n % 9 == 0 ? 20000 : 2000);
+  }
+  CHECK_EQ(governor.level, GOVERNOR_240MHZ);
+  CHECK_EQ(governor.stats.switches, 1);
+}
+
+static void testFloorsAndCeiling() {
+  Governor governor;
+  governorInit(governor, profile, GOVERNOR_80MHZ);
+  GovernorInput input = idle(0);
+  input.sd_busy = true;
+  CHECK_EQ(governorUpdate(governor, input), GOVERNOR_160MHZ);
+
+  // Low power mode caps animation, and pulls a higher clock down at once
+  input = idle(100);
+  input.animating = true;
+  CHECK_EQ(governorUpdate(governor, input), GOVERNOR_240MHZ);
+  governorSetCeiling(governor, GOVERNOR_160MHZ);
+  input.now_ms = 200;
+  CHECK_EQ(governorUpdate(governor, input), GOVERNOR_160MHZ);
+}
+
+static void testResidencyCoversTrace() {
+  Governor governor;
+  governorInit(governor, profile, GOVERNOR_80MHZ);
+  // Two seconds of scrolling, then ten idle
+  uint32_t now = 0;
+  for (; now < 2000; now += FRAME_MS) {
+    GovernorInput input = idle(now);
+    input.animating = true;
+    input.frame_us = 9000;
+    governorUpdate(governor, input);
+  }
+  for (; now < 12000; now += FRAME_MS) frame(governor, now, 1500);
+
+  uint64_t total = 0;
+  for (int level = 0; level < GOVERNOR_LEVELS; level++) total += governor.stats.residency_ms[level];
+  CHECK_EQ(total, governor.last_ms);
+  CHECK(governor.stats.residency_ms[GOVERNOR_80MHZ] > 8000);
+  CHECK(governor.stats.residency_ms[GOVERNOR_240MHZ] >= 2000);
+  CHECK_EQ(governor.stats.over_budget, 0);
+}
+
+int main() {
+  RUN(testDemandLevels);
+  RUN(testRaisesAtOnce);
+  RUN(testStepsDownOneAtATime);
+  RUN(testBurstsDoNotThrash);
+  RUN(testFloorsAndCeiling);
+  RUN(testResidencyCoversTrace);
+  return testSummary();
+}
@@ -0,0 +1,127 @@
+/*
+ * Hit Index Tests
+ * Top-most lookup, clipping, cell overflow and stale frames
+ */
+
+#include "test.h"
+#include "hit_index.h"
+
+#define SCREEN_W 368
+#define SCREEN_H 448
+
+static int callback_runs = 0;
+static void countCallback() {
+  callback_runs++;
+}
+
+static void testFindsRegion() {
+  HitIndex index;
+  hitIndexInit(index, SCREEN_W, SCREEN_H);
+  hitIndexClear(index, 1);
+  CHECK(hitIndexAdd(index, 20, 320, 80, 30, 7, nullptr));
+  const HitRegion* region = hitIndexFind(index, 60, 335);
+  CHECK(region != nullptr);
+  if (region) CHECK_EQ(region->tag, 7);
+
+  // Edges: left and top inclusive, right and bottom exclusive
+  CHECK(hitIndexFind(index, 20, 320) != nullptr);
+  CHECK(hitIndexFind(index, 100, 335) == nullptr);
+  CHECK(hitIndexFind(index, 60, 350) == nullptr);
+  CHECK(hitIndexFind(index, 10, 10) == nullptr);
+}
+
+static void testLaterRegionOnTop() {
+  HitIndex index;
+  hitIndexInit(index, SCREEN_W, SCREEN_H);
+  hitIndexClear(index, 1);
+  hitIndexAdd(index, 20, 100, SCREEN_W - 40, 50, 1, nullptr);  // Alarm card
+  hitIndexAdd(index, 280, 100, 40, 50, 2, nullptr);            // Toggle on top
+  CHECK_EQ(hitIndexFind(index, 300, 120)->tag, 2);
+  CHECK_EQ(hitIndexFind(index, 100, 120)->tag, 1);
+}
+
+static void testRegionSpanningCells() {
+  HitIndex index;
+  hitIndexInit(index, SCREEN_W, SCREEN_H);
+  hitIndexClear(index, 1);
+  hitIndexAdd(index, 0, 0, SCREEN_W, SCREEN_H, 3, nullptr);
+  for (int y = 0; y < SCREEN_H; y += 37) {
+    for (int x = 0; x < SCREEN_W; x += 41) {
+      const HitRegion* region = hitIndexFind(index, x, y);
+      CHECK(region != nullptr && region->tag == 3);
+    }
+  }
+  CHECK(hitIndexFind(index, SCREEN_W - 1, SCREEN_H - 1) != nullptr);
+  CHECK(hitIndexFind(index, SCREEN_W, 0) == nullptr);
+  CHECK(hitIndexFind(index, -1, 10) == nullptr);
+}
+
+static void testOffScreenClipped() {
+  HitIndex index;
+  hitIndexInit(index, SCREEN_W, SCREEN_H);
+  hitIndexClear(index, 1);
+  CHECK(!hitIndexAdd(index, -100, 10, 50, 50, 1, nullptr));      // Entirely off the left
+  CHECK(!hitIndexAdd(index, 10, SCREEN_H, 50, 50, 1, nullptr));  // Below the bottom
+  CHECK(!hitIndexAdd(index, 10, 10, 0, 50, 1, nullptr));         // Empty
+  CHECK_EQ(index.region_count, 0);
+  CHECK_EQ(index.dropped, 0);
+
+  // Partly off screen keeps its full rectangle for the containment test
+  CHECK(hitIndexAdd(index, -20, -20, 60, 60, 4, nullptr));
+  CHECK_EQ(hitIndexFind(index, 0, 0)->tag, 4);
+  CHECK(hitIndexFind(index, 40, 40) == nullptr);
+}
+
+static void testFullIndexCountsDrops() {
+  HitIndex index;
+  hitIndexInit(index, SCREEN_W, SCREEN_H);
+  hitIndexClear(index, 1);
+
+  // Stacked in one cell: only HIT_MAX_PER_CELL fit there
+  for (int i = 0; i < HIT_MAX_PER_CELL + 2; i++) hitIndexAdd(index, 2, 2, 10, 10, i, nullptr);
+  CHECK_EQ(index.dropped, 2);
+  CHECK_EQ(hitIndexFind(index, 5, 5)->tag, HIT_MAX_PER_CELL - 1);
+
+  // Past HIT_MAX_REGIONS registrations are refused outright
+  hitIndexClear(index, 1);
+  int added = 0;
+  for (int i = 0; i < HIT_MAX_REGIONS + 5; i++) {
+    int x = (i % 16) * 20, y = (i / 16) * 40;
+    if (hitIndexAdd(index, x, y, 20, 40, i, nullptr)) added++;
+  }
+  CHECK_EQ(added, HIT_MAX_REGIONS);
+  CHECK_EQ(index.dropped, 5);
+}
+
+static void testClearDropsLastFrame() {
+  HitIndex index;
+  hitIndexInit(index, SCREEN_W, SCREEN_H);
+  CHECK_EQ(index.owner, -1);
+  hitIndexClear(index, 1);
+  hitIndexAdd(index, 0, 0, 100, 100, 1, countCallback);
+  hitIndexClear(index, 2);
+  CHECK_EQ(index.owner, 2);
+  CHECK(hitIndexFind(index, 50, 50) == nullptr);
+}
+
+static void testCallbackKept() {
+  HitIndex index;
+  hitIndexInit(index, SCREEN_W, SCREEN_H);
+  hitIndexClear(index, 1);
+  hitIndexAdd(index, 20, 300, SCREEN_W - 40, 40, 0, countCallback);
+  const HitRegion* region = hitIndexFind(index, 100, 310);
+  CHECK(region != nullptr && region->callback == countCallback);
+  if (region && region->callback) region->callback();
+  CHECK_EQ(callback_runs, 1);
+}
+
+int main() {
+  RUN(testFindsRegion);
+  RUN(testLaterRegionOnTop);
+  RUN(testRegionSpanningCells);
+  RUN(testOffScreenClipped);
+  RUN(testFullIndexCountsDrops);
+  RUN(testClearDropsLastFrame);
+  RUN(testCallbackKept);
+  return testSummary();
+}
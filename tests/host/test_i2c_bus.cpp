@@ -0,0 +1,139 @@
+/*
+ * I2C Bus Manager Tests
+ * Register transfers, clock switching and the queue against i2c_mock
+ */
+
+#include "test.h"
+#include "i2c_bus.h"
+#include "i2c_mock.h"
+#include "i2c_trace.h"
+#include <string.h>
+
+static I2CMockDevice* imu;
+static I2CMockDevice* rtc;
+
+// The watch's shared bus: IMU at 400 kHz, RTC and PMIC at 100 kHz
+static void startBus() {
+  i2cMockReset();
+  imu = i2cMockAddDevice(I2C_BUS_SHARED, 0x6B);
+  rtc = i2cMockAddDevice(I2C_BUS_SHARED, 0x51);
+  i2cConfigureDevice(I2C_DEV_TOUCH, "touch", I2C_BUS_TOUCH, 0x38, 400000);
+  i2cConfigureDevice(I2C_DEV_IMU, "imu", I2C_BUS_SHARED, 0x6B, 400000);
+  i2cConfigureDevice(I2C_DEV_RTC, "rtc", I2C_BUS_SHARED, 0x51, 100000);
+  i2cConfigureDevice(I2C_DEV_PMIC, "pmic", I2C_BUS_SHARED, 0x34, 100000);
+  i2cTraceClear();
+  i2cTraceEnable(true);
+  CHECK(i2cBusStart(i2cMockBackend()));
+}
+
+static void testReadWrite() {
+  startBus();
+  uint8_t samples[6] = {1, 2, 3, 4, 5, 6};
+  memcpy(&imu->registers[0x35], samples, sizeof(samples));
+
+  uint8_t data[6] = {0};
+  CHECK(i2cReadRegs(I2C_DEV_IMU, 0x35, data, sizeof(data)));
+  CHECK(memcmp(data, samples, sizeof(samples)) == 0);
+
+  CHECK(i2cWriteReg(I2C_DEV_RTC, 0x04, 0x42));
+  CHECK_EQ(rtc->registers[0x04], 0x42);
+  CHECK_EQ(rtc->writes, 1);
+
+  I2CDeviceInfo info = i2cGetDeviceInfo(I2C_DEV_IMU);
+  CHECK_EQ(info.transactions, 1);
+  CHECK_EQ(info.bytes, 7);  // Register address plus six samples
+  CHECK(info.bus_time_us > 0);
+}
+
+static void testMissingDeviceCountsErrors() {
+  startBus();
+  uint8_t value;
+  CHECK(!i2cReadRegs(I2C_DEV_PMIC, 0x00, &value, 1));
+  CHECK(!i2cProbe(I2C_DEV_PMIC));
+  CHECK(i2cProbe(I2C_DEV_RTC));
+  CHECK_EQ(i2cGetDeviceInfo(I2C_DEV_PMIC).errors, 2);
+
+  CHECK_EQ(i2cTraceCount(), 3);
+  CHECK(i2cTraceGet(0).flags & I2C_TRACE_ERROR);
+  CHECK(i2cTraceGet(2).flags & I2C_TRACE_PROBE);
+}
+
+static void testClockSwitchesOnlyBetweenSpeeds() {
+  startBus();
+  uint8_t value;
+  i2cReadRegs(I2C_DEV_IMU, 0x00, &value, 1);   // Unknown -> 400k
+  i2cReadRegs(I2C_DEV_IMU, 0x01, &value, 1);
+  CHECK_EQ(i2cGetClockSwitches(), 1);
+  i2cReadRegs(I2C_DEV_RTC, 0x04, &value, 1);   // 400k -> 100k
+  i2cReadRegs(I2C_DEV_PMIC, 0x00, &value, 1);  // Same speed, no switch
+  CHECK_EQ(i2cGetClockSwitches(), 2);
+  i2cReadRegs(I2C_DEV_IMU, 0x00, &value, 1);
+  CHECK_EQ(i2cGetClockSwitches(), 3);
+
+  // A byte at 100 kHz costs four times as long as at 400 kHz
+  i2cResetStats();
+  uint8_t burst[16];
+  i2cReadRegs(I2C_DEV_IMU, 0x00, burst, sizeof(burst));
+  uint64_t fast = i2cGetDeviceInfo(I2C_DEV_IMU).bus_time_us;
+  i2cReadRegs(I2C_DEV_RTC, 0x00, burst, sizeof(burst));
+  uint64_t slow = i2cGetDeviceInfo(I2C_DEV_RTC).bus_time_us;
+  CHECK_NEAR((double)slow / fast, 4.0, 0.1);
+}
+
+static int completions = 0;
+static uint8_t completed_value = 0;
+
+static void onRead(const I2CTransaction& transaction, bool ok) {
+  if (ok) completed_value = transaction.data[0];
+  completions++;
+}
+
+static void testQueue() {
+  startBus();
+  imu->registers[0x2D] = 0x77;
+  completions = 0;
+
+  I2CTransaction read;
+  memset(&read, 0, sizeof(read));
+  read.device = I2C_DEV_IMU;
+  read.reg = 0x2D;
+  read.length = 1;
+  read.callback = onRead;
+  CHECK(i2cSubmit(read));
+  CHECK_EQ(completions, 0);  // Nothing runs until the bus task does
+  CHECK_EQ(i2cServiceQueue(8), 1);
+  CHECK_EQ(completions, 1);
+  CHECK_EQ(completed_value, 0x77);
+
+  // A full queue refuses instead of blocking
+  int accepted = 0;
+  for (int i = 0; i < I2C_QUEUE_LENGTH + 4; i++) {
+    if (i2cSubmit(read)) accepted++;
+  }
+  CHECK_EQ(accepted, I2C_QUEUE_LENGTH);
+  CHECK_EQ(i2cServiceQueue(4), 4);
+  CHECK_EQ(i2cServiceQueue(100), I2C_QUEUE_LENGTH - 4);
+
+  read.length = I2C_MAX_TRANSFER + 1;
+  CHECK(!i2cSubmit(read));
+}
+
+static void testFormatStats() {
+  startBus();
+  uint8_t value;
+  i2cReadRegs(I2C_DEV_RTC, 0x04, &value, 1);
+  char report[512];
+  int written = i2cFormatStats(report, sizeof(report));
+  CHECK(written > 0);
+  CHECK(strstr(report, "rtc") != nullptr);
+  CHECK(strstr(report, "clock switches: 1") != nullptr);
+}
+
+int main() {
+  RUN(testReadWrite);
+  RUN(testMissingDeviceCountsErrors);
+  RUN(testClockSwitchesOnlyBetweenSpeeds);
+  RUN(testQueue);
+  RUN(testFormatStats);
+  return testSummary();
+}
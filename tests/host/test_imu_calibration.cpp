@@ -0,0 +1,184 @@
+/*
+ * IMU Calibration Tests
+ * Still windows, gyro bias tracking, the six-face fit and save gating
+ */
+
+#include "test.h"
+#include "imu_calibration.h"
+#include <string.h>
+
+#define G ((int)IMU_ACCEL_LSB_PER_G)
+
+// One still window: constant readings, every other sample nudged by jitter
+static void stillWindow(IMUSample* samples, const int accel[3], const int gyro[3], int jitter = 0) {
+  for (int i = 0; i < IMU_STILL_WINDOW; i++) {
+    memset(&samples[i], 0, sizeof(samples[i]));
+    for (int axis = 0; axis < 3; axis++) {
+      samples[i].accel[axis] = (int16_t)(accel[axis] + (i & 1) * jitter);
+      samples[i].gyro[axis] = (int16_t)(gyro[axis] + (i & 1) * jitter);
+    }
+  }
+}
+
+static int trackWindow(IMUStillDetector& detector, IMUCalibration& calibration, const int accel[3],
+                       const int gyro[3], int jitter = 0) {
+  IMUSample samples[IMU_STILL_WINDOW];
+  stillWindow(samples, accel, gyro, jitter);
+  return imuCalibrationTrack(detector, calibration, samples, IMU_STILL_WINDOW);
+}
+
+// ==================== STILL WINDOWS ====================
+static void testStillDetection() {
+  IMUStillDetector detector;
+  IMUCalibration calibration;
+  imuStillInit(detector);
+  imuCalibrationDefaults(calibration);
+  const int flat[3] = {0, 0, G};
+  const int quiet[3] = {0, 0, 0};
+
+  // Nothing is decided until a window is complete
+  IMUSample samples[IMU_STILL_WINDOW];
+  stillWindow(samples, flat, quiet);
+  CHECK_EQ(imuCalibrationTrack(detector, calibration, samples, IMU_STILL_WINDOW - 1), 0);
+  CHECK_EQ(detector.still_windows, 0);
+  CHECK_EQ(imuCalibrationTrack(detector, calibration, samples, 1), IMU_CAL_CHANGED_GYRO);
+  CHECK_EQ(detector.still_windows, 1);
+
+  // Noise just inside both ranges is still
+  trackWindow(detector, calibration, flat, quiet, IMU_STILL_GYRO_RANGE < IMU_STILL_ACCEL_RANGE ?
+              IMU_STILL_GYRO_RANGE : IMU_STILL_ACCEL_RANGE);
+  CHECK_EQ(detector.still_windows, 2);
+  CHECK_EQ(detector.moving_windows, 0);
+
+  // Either sensor moving past its range spoils the window
+  IMUSample moving[IMU_STILL_WINDOW];
+  stillWindow(moving, flat, quiet);
+  moving[30].gyro[1] = IMU_STILL_GYRO_RANGE + 1;
+  CHECK_EQ(imuCalibrationTrack(detector, calibration, moving, IMU_STILL_WINDOW), 0);
+  stillWindow(moving, flat, quiet);
+  moving[10].accel[0] = -(IMU_STILL_ACCEL_RANGE + 1);
+  CHECK_EQ(imuCalibrationTrack(detector, calibration, moving, IMU_STILL_WINDOW), 0);
+  CHECK_EQ(detector.moving_windows, 2);
+  CHECK_EQ(detector.still_windows, 2);
+}
+
+// ==================== GYRO BIAS ====================
+static void testGyroBiasConverges() {
+  IMUStillDetector detector;
+  IMUCalibration calibration;
+  imuStillInit(detector);
+  imuCalibrationDefaults(calibration);
+  const int flat[3] = {0, 0, G};
+
+  // Half-LSB bias on y: alternating 40 and 41 averages to 40.5
+  const int bias[3] = {100, 40, -25};
+  for (int w = 0; w < 30; w++) trackWindow(detector, calibration, flat, bias, 1);
+  CHECK_NEAR(calibration.gyro_bias[0], 100.5 * 256, 16);
+  CHECK_NEAR(calibration.gyro_bias[1], 40.5 * 256, 16);
+  CHECK_NEAR(calibration.gyro_bias[2], -24.5 * 256, 16);
+
+  // Corrected samples come out near zero
+  IMUSample samples[IMU_STILL_WINDOW];
+  stillWindow(samples, flat, bias);
+  imuCalibrationApply(calibration, samples, IMU_STILL_WINDOW);
+  CHECK_NEAR(samples[0].gyro[0], 0, 1);
+  CHECK_NEAR(samples[0].gyro[1], 0, 1);
+  CHECK_NEAR(samples[0].gyro[2], 0, 1);
+
+  // A steady turn past the bias limit is rotation, not bias
+  int32_t before = calibration.gyro_bias[2];
+  const int turning[3] = {0, 0, IMU_GYRO_BIAS_LIMIT + 64};
+  CHECK_EQ(trackWindow(detector, calibration, flat, turning) & IMU_CAL_CHANGED_GYRO, 0);
+  CHECK_EQ(calibration.gyro_bias[2], before);
+  CHECK(imuCalibrationValid(calibration));
+}
+
+// ==================== SIX FACES ====================
+static void testSixFaceFit() {
+  IMUStillDetector detector;
+  IMUCalibration calibration;
+  imuStillInit(detector);
+  imuCalibrationDefaults(calibration);
+  const int quiet[3] = {0, 0, 0};
+
+  // A sensor with offsets and a scale error on every axis
+  const int offset[3] = {60, -40, 25};
+  const double scale[3] = {1.03, 0.98, 1.01};
+  int readings[IMU_FACE_COUNT][3];
+  for (int face = 0; face < IMU_FACE_COUNT; face++) {
+    int axis = face / 2;
+    int sign = face & 1 ? -1 : 1;
+    for (int a = 0; a < 3; a++) readings[face][a] = offset[a];
+    readings[face][axis] += (int)(sign * G * scale[axis]);
+  }
+
+  // A tilted pose is not a face
+  int tilted[3] = {readings[IMU_FACE_Z_UP][0] + IMU_FACE_MAX_CROSS + 100, offset[1], readings[IMU_FACE_Z_UP][2]};
+  trackWindow(detector, calibration, tilted, quiet);
+  CHECK_EQ(calibration.faces, 0);
+
+  // Five faces record readings, the sixth completes the fit
+  for (int face = 0; face < IMU_FACE_COUNT - 1; face++) {
+    CHECK_EQ(trackWindow(detector, calibration, readings[face], quiet) & IMU_CAL_CHANGED_ACCEL, 0);
+    CHECK(calibration.faces & (1 << face));
+  }
+  CHECK_EQ(calibration.accel_offset[0], 0);
+  int changed = trackWindow(detector, calibration, readings[IMU_FACE_Z_DOWN], quiet);
+  CHECK(changed & IMU_CAL_CHANGED_ACCEL);
+  CHECK_EQ(calibration.faces, (1 << IMU_FACE_COUNT) - 1);
+
+  for (int axis = 0; axis < 3; axis++) {
+    CHECK_NEAR(calibration.accel_offset[axis], offset[axis], 1);
+    CHECK_NEAR(calibration.accel_scale[axis], IMU_CAL_UNITY / scale[axis], 4);
+  }
+  CHECK(imuCalibrationValid(calibration));
+
+  // Every face now reads 1g along its axis and nothing across it
+  for (int face = 0; face < IMU_FACE_COUNT; face++) {
+    IMUSample samples[IMU_STILL_WINDOW];
+    stillWindow(samples, readings[face], quiet);
+    imuCalibrationApply(calibration, samples, 1);
+    int axis = face / 2;
+    for (int a = 0; a < 3; a++) {
+      CHECK_NEAR(samples[0].accel[a], a == axis ? (face & 1 ? -G : G) : 0, 4);
+    }
+  }
+
+  // Starting over forgets the faces but keeps the fit in use
+  imuCalibrationRestartFaces(calibration);
+  CHECK_EQ(calibration.faces, 0);
+  CHECK_NEAR(calibration.accel_offset[0], offset[0], 1);
+}
+
+// ==================== SAVING ====================
+static void testSaveGating() {
+  IMUCalibration calibration;
+  imuCalibrationDefaults(calibration);
+  int32_t saved[3] = {0, 0, 0};
+  uint32_t long_ago = IMU_CAL_SAVE_INTERVAL + 1;
+
+  // A new accel fit is saved at once
+  CHECK(imuCalibrationSaveDue(calibration, saved, IMU_CAL_CHANGED_ACCEL, 0));
+  CHECK(!imuCalibrationSaveDue(calibration, saved, 0, long_ago));
+
+  // Gyro bias within the drift allowance is not worth a write
+  calibration.gyro_bias[1] = IMU_CAL_SAVE_DRIFT;
+  CHECK(!imuCalibrationSaveDue(calibration, saved, IMU_CAL_CHANGED_GYRO, long_ago));
+
+  // Past it, but only once the interval has gone by
+  calibration.gyro_bias[1] = -(IMU_CAL_SAVE_DRIFT + 1);
+  CHECK(!imuCalibrationSaveDue(calibration, saved, IMU_CAL_CHANGED_GYRO, IMU_CAL_SAVE_INTERVAL));
+  CHECK(imuCalibrationSaveDue(calibration, saved, IMU_CAL_CHANGED_GYRO, long_ago));
+
+  // Drift counts from what was saved, not from zero
+  saved[1] = -IMU_CAL_SAVE_DRIFT;
+  CHECK(!imuCalibrationSaveDue(calibration, saved, IMU_CAL_CHANGED_GYRO, long_ago));
+}
+
+int main() {
+  RUN(testStillDetection);
+  RUN(testGyroBiasConverges);
+  RUN(testSixFaceFit);
+  RUN(testSaveGating);
+  return testSummary();
+}
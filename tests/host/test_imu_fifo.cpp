@@ -0,0 +1,168 @@
+/*
+ * IMU FIFO Tests
+ * Frame parsing, batch timestamps, the shared ring and a drain over i2c_mock
+ */
+
+#include "test.h"
+#include "imu_fifo.h"
+#include "i2c_bus.h"
+#include "i2c_mock.h"
+#include <string.h>
+
+static void putFrame(uint8_t* bytes, int16_t ax, int16_t ay, int16_t az, int16_t gx, int16_t gy, int16_t gz) {
+  int16_t values[6] = {ax, ay, az, gx, gy, gz};
+  for (int i = 0; i < 6; i++) {
+    bytes[i * 2] = (uint8_t)(values[i] & 0xFF);
+    bytes[i * 2 + 1] = (uint8_t)((uint16_t)values[i] >> 8);
+  }
+}
+
+// ==================== PARSING ====================
+static void testByteCount() {
+  CHECK_EQ(imuFifoByteCount(96, 0x00), 192);
+  CHECK_EQ(imuFifoByteCount(0x00, 0x01), 512);  // Top bits from FIFO_STATUS
+  CHECK_EQ(imuFifoByteCount(0x10, 0x20 | 0x02), 2 * (0x200 + 0x10));  // Overflow flag ignored
+}
+
+static void testParseFrames() {
+  uint8_t bytes[IMU_FIFO_FRAME_BYTES * 2 + 5];
+  putFrame(bytes, 8192, -8192, 0, 64, -64, 32767);
+  putFrame(bytes + IMU_FIFO_FRAME_BYTES, 1, 2, 3, 4, 5, -32768);
+  IMUSample samples[4];
+  // The trailing partial frame is not a sample
+  CHECK_EQ(imuFifoParse(bytes, sizeof(bytes), samples, 4), 2);
+  CHECK_EQ(samples[0].accel[0], 8192);
+  CHECK_EQ(samples[0].accel[1], -8192);
+  CHECK_EQ(samples[0].gyro[2], 32767);
+  CHECK_EQ(samples[1].gyro[2], -32768);
+  CHECK_EQ(imuFifoParse(bytes, sizeof(bytes), samples, 1), 1);
+}
+
+static void testTimestampsContinueTimeline() {
+  IMUSample batch[4];
+  // First batch: the newest sample lands on the drain time
+  imuFifoTimestamp(batch, 4, 0, false, 1000000, 20000);
+  CHECK_EQ(batch[3].timestamp_us, 1000000);
+  CHECK_EQ(batch[0].timestamp_us, 940000);
+
+  // Drained 3 ms late: still spaced by the period from the last batch
+  imuFifoTimestamp(batch, 4, 1000000, true, 1083000, 20000);
+  CHECK_EQ(batch[0].timestamp_us, 1020000);
+  CHECK_EQ(batch[3].timestamp_us, 1080000);
+
+  // After a long gap the timeline restarts at the drain
+  imuFifoTimestamp(batch, 4, 1080000, true, 5000000, 20000);
+  CHECK_EQ(batch[3].timestamp_us, 5000000);
+
+  // A drain earlier than predicted cannot go back in time either
+  imuFifoTimestamp(batch, 4, 5000000, true, 5050000, 20000);
+  CHECK_EQ(batch[3].timestamp_us, 5050000);
+}
+
+// ==================== RING ====================
+static void testRingCursorsIndependent() {
+  static IMUSampleRing ring;
+  imuRingInit(ring);
+  IMUSample latest;
+  CHECK(!imuRingLatest(ring, latest));
+
+  IMURingCursor fast, slow;
+  imuRingCursorInit(ring, fast);
+  imuRingCursorInit(ring, slow);
+
+  IMUSample sample = {};
+  for (int i = 0; i < 10; i++) {
+    sample.timestamp_us = i;
+    imuRingPush(ring, sample);
+  }
+  IMUSample out[16];
+  CHECK_EQ(imuRingRead(ring, fast, out, 4), 4);
+  CHECK_EQ(out[3].timestamp_us, 3);
+  CHECK_EQ(imuRingRead(ring, fast, out, 16), 6);
+  CHECK_EQ(imuRingRead(ring, slow, out, 16), 10);  // The fast reader took nothing from it
+  CHECK_EQ(imuRingRead(ring, fast, out, 16), 0);
+  CHECK(imuRingLatest(ring, latest));
+  CHECK_EQ(latest.timestamp_us, 9);
+
+  // A cursor that starts now skips history
+  IMURingCursor late;
+  imuRingCursorInit(ring, late);
+  CHECK_EQ(imuRingRead(ring, late, out, 16), 0);
+}
+
+static void testRingLappedReaderCountsDrops() {
+  static IMUSampleRing ring;
+  imuRingInit(ring);
+  IMURingCursor cursor;
+  imuRingCursorInit(ring, cursor);
+  IMUSample sample = {};
+  for (uint32_t i = 0; i < IMU_RING_SIZE + 40; i++) {
+    sample.timestamp_us = i;
+    imuRingPush(ring, sample);
+  }
+  IMUSample out[8];
+  CHECK_EQ(imuRingRead(ring, cursor, out, 8), 8);
+  CHECK_EQ(cursor.dropped, 40);
+  CHECK_EQ(out[0].timestamp_us, 40);  // Oldest sample still held
+}
+
+// ==================== DRAIN ====================
+static int filtered_batches = 0;
+static void countBatch(IMUSample* samples, int count) {
+  (void)samples;
+  filtered_batches += count > 0;
+}
+
+static void testDrainOverMock() {
+  i2cMockReset();
+  I2CMockDevice* imu = i2cMockAddDevice(I2C_BUS_SHARED, 0x6B);
+  imu->registers[QMI8658_STATUSINT] = QMI8658_STATUSINT_CMD_DONE;
+  imu->fixed_register = QMI8658_FIFO_DATA;  // FIFO_DATA pops without moving the pointer
+  imu->registers[QMI8658_FIFO_DATA] = 0x01;
+  i2cConfigureDevice(I2C_DEV_IMU, "imu", I2C_BUS_SHARED, 0x6B, 400000);
+  CHECK(i2cBusStart(i2cMockBackend()));
+
+  CHECK(imuFifoConfigure());
+  CHECK_EQ(imu->registers[QMI8658_FIFO_WTM_TH], IMU_FIFO_WATERMARK);
+  CHECK_EQ(imu->registers[QMI8658_CTRL7], 0x03);
+
+  // A watermark's worth of frames, in 16-bit words
+  imu->registers[QMI8658_FIFO_SMPL_CNT] = IMU_FIFO_WATERMARK * IMU_FIFO_FRAME_BYTES / 2;
+  imu->registers[QMI8658_FIFO_STATUS] = 0;
+  imuFifoResetStats();
+  imuFifoSetFilter(countBatch);
+
+  static IMUSampleRing ring;
+  imuRingInit(ring);
+  CHECK_EQ(imuFifoDrain(ring, 2000000), IMU_FIFO_WATERMARK);
+  CHECK_EQ(ring.written, IMU_FIFO_WATERMARK);
+  CHECK_EQ(filtered_batches, 1);
+  IMUSample latest;
+  CHECK(imuRingLatest(ring, latest));
+  CHECK_EQ(latest.timestamp_us, 2000000);
+  CHECK_EQ(latest.accel[0], 0x0101);
+  CHECK_EQ(imu->registers[QMI8658_FIFO_CTRL], IMU_FIFO_SIZE_CODE | 0x02);  // Back to streaming
+
+  const IMUFifoStats& stats = imuFifoGetStats();
+  CHECK_EQ(stats.batches, 1);
+  CHECK_EQ(stats.bytes, IMU_FIFO_WATERMARK * IMU_FIFO_FRAME_BYTES);
+
+  // Overflow is counted, a dead command handshake is an error
+  imu->registers[QMI8658_FIFO_STATUS] = QMI8658_FIFO_STATUS_OVERFLOW;
+  imuFifoDrain(ring, 2300000);
+  CHECK_EQ(imuFifoGetStats().overflows, 1);
+  imu->registers[QMI8658_STATUSINT] = 0;
+  CHECK_EQ(imuFifoDrain(ring, 2600000), 0);
+  CHECK_EQ(imuFifoGetStats().errors, 1);
+  imuFifoSetFilter(nullptr);
+}
+
+int main() {
+  RUN(testByteCount);
+  RUN(testParseFrames);
+  RUN(testTimestampsContinueTimeline);
+  RUN(testRingCursorsIndependent);
+  RUN(testRingLappedReaderCountsDrops);
+  RUN(testDrainOverMock);
+  return testSummary();
+}
@@ -0,0 +1,141 @@
+/*
+ * IMU Gesture Recognition Tests
+ * DTW and LB_Keogh properties, and gestures replayed through the engine
+ */
+
+#include "test.h"
+#include "imu_gestures.h"
+#include <string.h>
+
+static IMUGestureLibrary defaults;
+
+// Two raw samples per frame that fold back into exactly that frame
+static int framesToSamples(const IMUGestureFrame* frames, int count, IMUSample* samples) {
+  int n = 0;
+  for (int k = 0; k < count; k++) {
+    for (int i = 0; i < IMU_GESTURE_DECIMATE; i++, n++) {
+      IMUSample& sample = samples[n];
+      memset(&sample, 0, sizeof(sample));
+      for (int axis = 0; axis < 3; axis++) sample.gyro[axis] = frames[k][axis] * 8;
+      sample.accel[2] = (int16_t)(IMU_ACCEL_LSB_PER_G + frames[k][3] * 8);
+    }
+  }
+  return n;
+}
+
+// Quiet wrist, the gesture, quiet again; returns each recognition in order
+static int replay(IMUGestureEngine& engine, const IMUGestureFrame* shape, IMUGestureType* found, int max_found) {
+  static IMUGestureFrame stream[3 * IMU_GESTURE_LENGTH];
+  memset(stream, 0, sizeof(stream));
+  if (shape) memcpy(stream[IMU_GESTURE_LENGTH], shape, sizeof(IMUGestureFrame) * IMU_GESTURE_LENGTH);
+
+  static IMUSample samples[3 * IMU_GESTURE_LENGTH * IMU_GESTURE_DECIMATE];
+  int total = framesToSamples(stream, 3 * IMU_GESTURE_LENGTH, samples);
+  int count = 0;
+  for (int n = 0; n < total; n += IMU_FIFO_WATERMARK) {
+    IMUGestureType gesture = imuGestureProcess(engine, samples + n, IMU_FIFO_WATERMARK);
+    if (gesture != IMU_GESTURE_NONE && count < max_found) found[count++] = gesture;
+  }
+  return count;
+}
+
+static void testDTWProperties() {
+  const IMUGestureFrame* shake = defaults.frames[IMU_GESTURE_SHAKE][0];
+  const IMUGestureFrame* flick = defaults.frames[IMU_GESTURE_FLICK_IN][0];
+  CHECK_EQ(imuGestureDTW(shake, shake, 0x3FFFFFFF), 0);
+
+  // Two frames late is inside the band and costs far less than the raw offset
+  IMUGestureFrame late[IMU_GESTURE_LENGTH];
+  memset(late, 0, sizeof(late));
+  memcpy(late[2], shake, sizeof(IMUGestureFrame) * (IMU_GESTURE_LENGTH - 2));
+  int32_t warped = imuGestureDTW(late, shake, 0x3FFFFFFF);
+  int32_t straight = 0;
+  for (int i = 0; i < IMU_GESTURE_LENGTH; i++) {
+    for (int c = 0; c < IMU_GESTURE_CHANNELS; c++) straight += abs(late[i][c] - shake[i][c]);
+  }
+  CHECK(warped * 4 < straight);
+
+  // Early abandoning returns at least the limit once no path can beat it
+  int32_t full = imuGestureDTW(flick, shake, 0x3FFFFFFF);
+  CHECK(imuGestureDTW(flick, shake, full / 4) >= full / 4);
+}
+
+static void testLowerBoundNeverExceedsDTW() {
+  IMUGestureEngine* engine = new IMUGestureEngine;
+  imuGestureInit(*engine);
+  for (int g = 0; g < IMU_GESTURE_COUNT; g++) {
+    for (int q = 0; q < IMU_GESTURE_COUNT; q++) {
+      const IMUGestureFrame* query = defaults.frames[q][0];
+      int32_t bound = imuGestureLowerBound(query, engine->upper[g][0], engine->lower[g][0], 0x3FFFFFFF);
+      int32_t distance = imuGestureDTW(query, defaults.frames[g][0], 0x3FFFFFFF);
+      CHECK(bound <= distance);
+    }
+  }
+  delete engine;
+}
+
+static void testEachGestureFiresOnce() {
+  for (int g = 0; g < IMU_GESTURE_COUNT; g++) {
+    IMUGestureEngine* engine = new IMUGestureEngine;
+    imuGestureInit(*engine);
+    IMUGestureType found[4];
+    int count = replay(*engine, defaults.frames[g][0], found, 4);
+    CHECK_EQ(count, 1);
+    if (count > 0) CHECK_EQ(found[0], g);
+    CHECK_EQ(engine->stats.matches[g], 1);
+    delete engine;
+  }
+}
+
+static void testStillWristGated() {
+  IMUGestureEngine* engine = new IMUGestureEngine;
+  imuGestureInit(*engine);
+  IMUGestureType found[4];
+  CHECK_EQ(replay(*engine, nullptr, found, 4), 0);
+  CHECK(engine->stats.windows > 0);
+  CHECK_EQ(engine->stats.gated, engine->stats.windows);
+  CHECK_EQ(engine->stats.dtw_runs, 0);
+  delete engine;
+}
+
+static void testRecordingReplacesTemplate() {
+  IMUGestureEngine* engine = new IMUGestureEngine;
+  imuGestureInit(*engine);
+
+  // Record a flick in as the wearer's shake: afterwards it reads as a shake
+  imuGestureRecord(*engine, IMU_GESTURE_SHAKE);
+  IMUGestureType found[4];
+  CHECK_EQ(replay(*engine, defaults.frames[IMU_GESTURE_FLICK_IN][0], found, 4), 0);
+  CHECK_EQ(engine->recorded, IMU_GESTURE_SHAKE);
+  CHECK_EQ(engine->recording, IMU_GESTURE_NONE);
+  CHECK_EQ(engine->library.next[IMU_GESTURE_SHAKE], 1);
+  CHECK(imuGestureLibraryValid(engine->library));
+
+  int count = replay(*engine, defaults.frames[IMU_GESTURE_FLICK_IN][0], found, 4);
+  CHECK_EQ(count, 1);
+  if (count > 0) CHECK(found[0] == IMU_GESTURE_SHAKE || found[0] == IMU_GESTURE_FLICK_IN);
+  delete engine;
+}
+
+static void testLibraryValidation() {
+  IMUGestureLibrary library;
+  imuGestureDefaults(library);
+  CHECK(imuGestureLibraryValid(library));
+  library.version++;
+  CHECK(!imuGestureLibraryValid(library));
+  imuGestureDefaults(library);
+  library.used[IMU_GESTURE_SHAKE] = 0;
+  CHECK(!imuGestureLibraryValid(library));
+  CHECK(strcmp(imuGestureName(IMU_GESTURE_NONE), "none") == 0);
+}
+
+int main() {
+  imuGestureDefaults(defaults);
+  RUN(testDTWProperties);
+  RUN(testLowerBoundNeverExceedsDTW);
+  RUN(testEachGestureFiresOnce);
+  RUN(testStillWristGated);
+  RUN(testRecordingReplacesTemplate);
+  RUN(testLibraryValidation);
+  return testSummary();
+}
@@ -0,0 +1,171 @@
+/*
+ * IMU Motion Mode Tests
+ * Step counter reconciliation and the motion mode register sequence over i2c_mock
+ */
+
+#include "test.h"
+#include "imu_motion.h"
+#include "i2c_bus.h"
+#include "i2c_trace.h"
+#include "i2c_mock.h"
+#include <string.h>
+
+#define COUNTER_MAX ((1UL << IMU_STEP_COUNTER_BITS) - 1)
+
+static I2CMockDevice* imu;
+
+static void startImu() {
+  i2cMockReset();
+  imu = i2cMockAddDevice(I2C_BUS_SHARED, 0x6B);
+  imu->registers[QMI8658_STATUSINT] = QMI8658_STATUSINT_CMD_DONE;
+  i2cConfigureDevice(I2C_DEV_IMU, "imu", I2C_BUS_SHARED, 0x6B, 400000);
+  CHECK(i2cBusStart(i2cMockBackend()));
+  i2cTraceClear();
+}
+
+// Registers written since the last clear, in order, command handshakes included
+static int writtenRegisters(uint8_t* regs, int max_regs) {
+  int count = 0;
+  for (int i = 0; i < i2cTraceCount() && count < max_regs; i++) {
+    const I2CTraceRecord& record = i2cTraceGet(i);
+    if (record.flags & I2C_TRACE_WRITE) regs[count++] = record.reg;
+  }
+  return count;
+}
+
+// ==================== STEP SYNC ====================
+static void testCountsAndWraps() {
+  StepSync sync;
+  memset(&sync, 0, sizeof(sync));
+  CHECK_EQ(stepSyncUpdate(sync, 1000), 0);  // First reading is the baseline
+  CHECK_EQ(stepSyncUpdate(sync, 1050), 50);
+  CHECK_EQ(stepSyncUpdate(sync, 1050), 0);
+
+  // Across the 24-bit wrap
+  stepSyncBegin(sync, COUNTER_MAX - 15);
+  CHECK_EQ(stepSyncUpdate(sync, 0x10), 32);
+  CHECK_EQ(sync.wraps, 1);
+  CHECK_EQ(sync.resets, 0);
+
+  // Bits above the counter are not steps
+  CHECK_EQ(stepSyncUpdate(sync, 0x01000020), 0x10);
+  CHECK_EQ(sync.credited, 50 + 32 + 0x10);
+}
+
+static void testResetAndImplausibleJump() {
+  StepSync sync;
+  memset(&sync, 0, sizeof(sync));
+  stepSyncBegin(sync, 500000);
+
+  // The IMU reset and has counted 30 since: those 30 are real
+  CHECK_EQ(stepSyncUpdate(sync, 30), 30);
+  CHECK_EQ(sync.resets, 1);
+  CHECK_EQ(sync.wraps, 0);
+
+  // A glitch jumps far ahead: resync, credit nothing, count on from there
+  CHECK_EQ(stepSyncUpdate(sync, 30 + STEP_SYNC_MAX_DELTA + 1), 0);
+  CHECK_EQ(sync.resets, 2);
+  CHECK_EQ(stepSyncUpdate(sync, 30 + STEP_SYNC_MAX_DELTA + 11), 10);
+  CHECK_EQ(sync.credited, 40);
+}
+
+// ==================== DRIVER ====================
+static void testEnterSequence() {
+  startImu();
+  imu->registers[QMI8658_CTRL7] = 0x03;
+  CHECK(imuMotionEnter());
+
+  static const uint8_t expected[] = {
+    QMI8658_CTRL7, QMI8658_FIFO_CTRL, QMI8658_CTRL2,
+    QMI8658_CAL1_L, QMI8658_CTRL9, QMI8658_CTRL9,   // Pedometer, first half
+    QMI8658_CAL1_L, QMI8658_CTRL9, QMI8658_CTRL9,   // ...second half
+    QMI8658_CAL1_L, QMI8658_CTRL9, QMI8658_CTRL9,   // Wake-on-motion
+    QMI8658_CTRL8, QMI8658_CTRL7
+  };
+  uint8_t written[32];
+  int count = writtenRegisters(written, 32);
+  CHECK_EQ(count, (int)sizeof(expected));
+  CHECK(memcmp(written, expected, sizeof(expected)) == 0);
+
+  CHECK_EQ(imu->registers[QMI8658_CTRL2], 0x10 | IMU_MOTION_ODR_CODE);
+  CHECK_EQ(imu->registers[QMI8658_CTRL7], 0x01);  // Accel alone
+  CHECK_EQ(imu->registers[QMI8658_CTRL8], QMI8658_CTRL8_PEDO_EN);
+  CHECK_EQ(imu->registers[QMI8658_FIFO_CTRL], 0x00);
+  CHECK_EQ(imu->registers[QMI8658_CAL1_L], IMU_WOM_THRESHOLD_MG);  // Last parameters were WoM's
+}
+
+static void testExitRestoresStreaming() {
+  startImu();
+  CHECK(imuMotionEnter());
+  i2cTraceClear();
+  CHECK(imuMotionExit());
+
+  uint8_t written[32];
+  int count = writtenRegisters(written, 32);
+  CHECK(count >= 5);
+  CHECK_EQ(written[0], QMI8658_CTRL7);  // Sensors off before anything else
+  CHECK_EQ(written[1], QMI8658_CTRL8);
+  CHECK_EQ(written[2], QMI8658_CAL1_L);
+  CHECK_EQ(written[count - 1], QMI8658_CTRL7);  // Back on last
+
+  CHECK_EQ(imu->registers[QMI8658_CTRL8], 0x00);  // Pedometer off
+  for (int i = 0; i < 8; i++) CHECK_EQ(imu->registers[QMI8658_CAL1_L + i], 0);  // WoM threshold 0
+  CHECK_EQ(imu->registers[QMI8658_CTRL7], 0x03);
+  CHECK_EQ(imu->registers[QMI8658_FIFO_CTRL], IMU_FIFO_SIZE_CODE | 0x02);
+
+  // A dead command handshake is reported
+  imu->registers[QMI8658_STATUSINT] = 0;
+  CHECK(!imuMotionExit());
+}
+
+static void testReadStepCount() {
+  startImu();
+  imu->registers[QMI8658_STEP_CNT_LOW] = 0x34;
+  imu->registers[QMI8658_STEP_CNT_LOW + 1] = 0x12;
+  imu->registers[QMI8658_STEP_CNT_LOW + 2] = 0x01;
+  uint32_t count = 0;
+  CHECK(imuReadStepCount(count));
+  CHECK_EQ(count, 0x011234);
+
+  imu->present = false;
+  CHECK(!imuReadStepCount(count));
+}
+
+static void testWarmResumeLeavesMotionMode() {
+  startImu();
+  CHECK(imuMotionEnter());
+  imu->registers[QMI8658_STEP_CNT_LOW] = 0xE8;
+  imu->registers[QMI8658_STEP_CNT_LOW + 1] = 0x03;
+
+  // Deep sleep, then initializeIMU(): the FIFO is back, the pedometer and
+  // wake-on-motion are still on
+  CHECK(imuFifoConfigure());
+  CHECK_EQ(imu->registers[QMI8658_CTRL8], QMI8658_CTRL8_PEDO_EN);
+
+  i2cTraceClear();
+  uint32_t count = 0;
+  bool counted = false;
+  CHECK(imuMotionResume(count, counted));
+  CHECK(counted);
+  CHECK_EQ(count, 1000);
+
+  // The count is read while the pedometer still holds it
+  CHECK(i2cTraceCount() > 0);
+  CHECK(!(i2cTraceGet(0).flags & I2C_TRACE_WRITE));
+  CHECK_EQ(i2cTraceGet(0).reg, QMI8658_STEP_CNT_LOW);
+
+  CHECK_EQ(imu->registers[QMI8658_CTRL8], 0x00);
+  for (int i = 0; i < 8; i++) CHECK_EQ(imu->registers[QMI8658_CAL1_L + i], 0);
+  CHECK_EQ(imu->registers[QMI8658_CTRL7], 0x03);
+  CHECK_EQ(imu->registers[QMI8658_FIFO_CTRL], IMU_FIFO_SIZE_CODE | 0x02);
+}
+
+int main() {
+  RUN(testCountsAndWraps);
+  RUN(testResetAndImplausibleJump);
+  RUN(testEnterSequence);
+  RUN(testExitRestoresStreaming);
+  RUN(testReadStepCount);
+  RUN(testWarmResumeLeavesMotionMode);
+  return testSummary();
+}
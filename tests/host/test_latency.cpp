@@ -0,0 +1,90 @@
+/*
+ * Touch-to-Photon Latency Tests
+ * Scripted touches through the stage stamps, histograms and report
+ */
+
+#include "test.h"
+#include "latency.h"
+#include <string.h>
+
+static LatencyTracker tracker;
+
+static void touchThrough(int screen, uint32_t start, uint32_t recognize, uint32_t dispatch,
+                         uint32_t queue, uint32_t render) {
+  uint32_t now = start + recognize;
+  latencyTouch(tracker, screen, start, now);
+  latencyDispatched(tracker, now += dispatch);
+  latencyFrameStart(tracker, now += queue);
+  latencyPresented(tracker, now += render);
+}
+
+static void testStages() {
+  latencyReset(tracker);
+  touchThrough(SCREEN_QUESTS, 1000, 300, 700, 5000, 9000);
+  const LatencyHistogram* stages = tracker.stages[SCREEN_QUESTS];
+  CHECK_EQ(stages[LATENCY_STAGE_RECOGNIZE].sum_us, 300);
+  CHECK_EQ(stages[LATENCY_STAGE_DISPATCH].sum_us, 700);
+  CHECK_EQ(stages[LATENCY_STAGE_QUEUE].sum_us, 5000);
+  CHECK_EQ(stages[LATENCY_STAGE_RENDER].sum_us, 9000);
+  CHECK_EQ(stages[LATENCY_STAGE_TOTAL].sum_us, 15000);
+  CHECK(!tracker.pending);
+}
+
+static void testCoalescesUntilPresent() {
+  latencyReset(tracker);
+  latencyTouch(tracker, SCREEN_APP_GRID, 0, 100);
+  latencyTouch(tracker, SCREEN_APP_GRID, 5000, 5100);  // Shares the first stamp
+  latencyDispatched(tracker, 1000);
+  latencyDispatched(tracker, 6000);
+  latencyFrameStart(tracker, 8000);
+  latencyPresented(tracker, 20000);
+  const LatencyHistogram& total = tracker.stages[SCREEN_APP_GRID][LATENCY_STAGE_TOTAL];
+  CHECK_EQ(total.count, 1);
+  CHECK_EQ(total.sum_us, 20000);
+
+  // A present with no frame started for the touch records nothing
+  latencyTouch(tracker, SCREEN_APP_GRID, 30000, 30100);
+  latencyPresented(tracker, 31000);
+  CHECK_EQ(total.count, 1);
+  CHECK(tracker.pending);
+}
+
+static void testEveryScreenHasHistograms() {
+  // The screens added after the tracker must not fall off the end
+  latencyReset(tracker);
+  for (int screen = 0; screen < SCREEN_COUNT; screen++) {
+    touchThrough(screen, screen * 100000, 100, 100, 100, 100);
+    CHECK_EQ(tracker.stages[screen][LATENCY_STAGE_TOTAL].count, 1);
+  }
+  touchThrough(SCREEN_COUNT, 0, 100, 100, 100, 100);
+  touchThrough(-1, 0, 100, 100, 100, 100);
+  CHECK(!tracker.pending);
+
+  char report[512];
+  CHECK(latencyFormatReport(tracker, SCREEN_ENERGY, report, sizeof(report)) > 0);
+  CHECK(strstr(report, "1 touches") != NULL);
+  CHECK_EQ(latencyFormatReport(tracker, SCREEN_COUNT, report, sizeof(report)), 0);
+}
+
+static void testPercentiles() {
+  LatencyHistogram histogram;
+  memset(&histogram, 0, sizeof(histogram));
+  CHECK_EQ(latencyPercentile(histogram, 0.5f), 0);
+  for (int i = 0; i < 90; i++) latencyHistogramAdd(histogram, 10000);   // 12 ms bucket
+  for (int i = 0; i < 10; i++) latencyHistogramAdd(histogram, 45000);   // 50 ms bucket
+  CHECK_EQ(latencyPercentile(histogram, 0.50f), 12000);
+  CHECK_EQ(latencyPercentile(histogram, 0.95f), 45000);  // Capped at the max seen
+  CHECK_EQ(histogram.max_us, 45000);
+
+  latencyHistogramAdd(histogram, 500000);  // Open-ended last bucket
+  CHECK_EQ(histogram.buckets[LATENCY_BUCKETS - 1], 1);
+  CHECK_EQ(latencyPercentile(histogram, 1.0f), 500000);
+}
+
+int main() {
+  RUN(testStages);
+  RUN(testCoalescesUntilPresent);
+  RUN(testEveryScreenHasHistograms);
+  RUN(testPercentiles);
+  return testSummary();
+}
\ No newline at end of file
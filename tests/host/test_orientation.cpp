@@ -0,0 +1,246 @@
+/*
+ * Orientation Tests
+ * Synthetic wrist traces through the Mahony filter and the wrist detector
+ *
+ * Each trace is the forearm's roll about the watch's x axis over time:
+ * 0 degrees is the screen facing up, 90 is the arm hanging with 12 o'clock
+ * up. Samples are quantized like the FIFO's and fed the way
+ * updateOrientation() feeds them. The cost per sample is printed on every
+ * run.
+ */
+
+#include "test.h"
+#include "orientation.h"
+#include "imu_fifo.h"
+#include <chrono>
+#include <vector>
+
+#define SAMPLE_RATE_HZ (1000000.0 / IMU_SAMPLE_PERIOD_US)
+#define PI 3.14159265358979
+
+struct WristTrace {
+  const char* name;
+  double seconds;
+  double (*roll)(double t);         // Degrees
+  double (*bounce)(double t);       // Vertical acceleration beyond 1g
+  float gyro_bias[3];               // dps
+  double accel_noise_g;
+  double gyro_noise_dps;
+  uint32_t raises, lowers;          // Expected
+};
+
+struct ReplayResult {
+  uint32_t raises, lowers;
+  uint32_t samples;
+  double elapsed_ns;
+  float max_error;                  // Largest |up - true up| once settled
+};
+
+// Deterministic noise, uniform in [-1, 1]
+static uint32_t noise_state;
+
+static double noise() {
+  noise_state = noise_state * 1103515245u + 12345u;
+  return ((noise_state >> 8) & 0xFFFF) / 32767.5 - 1.0;
+}
+
+static double smoothStep(double t, double start, double length) {
+  if (t <= start) return 0;
+  if (t >= start + length) return 1;
+  double x = (t - start) / length;
+  return x * x * (3 - 2 * x);
+}
+
+// ==================== TRACES ====================
+static double hanging(double) { return 90; }
+static double faceUp(double) { return 0; }
+static double still(double) { return 0; }
+
+// Arm at the side, then a glance: up in half a second and held
+static double raiseAt4(double t) { return 90 - 90 * smoothStep(t, 4.0, 0.5); }
+static double raiseAt20(double t) { return 90 - 90 * smoothStep(t, 20.0, 0.5); }
+
+// Reading, then the arm drops back to the side
+static double lowerAt4(double t) { return 90 * smoothStep(t, 4.0, 0.5); }
+
+// Arm swing while walking, never near face up
+static double walkingSwing(double t) { return 90 + 25 * sin(2 * PI * 0.9 * t); }
+static double walkingBounce(double t) { return 0.25 * sin(2 * PI * 1.8 * t); }
+
+// Turning the wrist over at 9 dps, far too slowly for a glance
+static double slowTilt(double t) { return t < 2.0 ? 90 : t < 12.0 ? 90 - 9 * (t - 2.0) : 0; }
+
+// Lying face up, knocked by typing on the same desk
+static double deskKnocks(double t) {
+  double phase = fmod(t, 0.7);
+  return phase < 0.03 ? 0.9 * sin(PI * phase / 0.03) : 0;
+}
+
+// Quick half turns towards the screen and back, every two seconds
+static double fidget(double t) {
+  double phase = fmod(t, 2.0);
+  return phase < 0.4 ? 90 - 45 * sin(PI * phase / 0.4) : 90;
+}
+
+static const WristTrace traces[] = {
+  // name          s   roll          bounce         gyro bias         accel  gyro  raise lower
+  {"noise",       20, hanging,      still,         {0, 0, 0},        0.03,  2.0,  0, 0},
+  {"gyro_bias",   25, raiseAt20,    still,         {3, -2, 1.5},     0.01,  0.5,  1, 0},
+  {"raise",       8,  raiseAt4,     still,         {0, 0, 0},        0.01,  0.5,  1, 0},
+  {"lower",       8,  lowerAt4,     still,         {0, 0, 0},        0.01,  0.5,  0, 1},
+  {"walking",     30, walkingSwing, walkingBounce, {0.5, 0, 0},      0.05,  3.0,  0, 0},
+  {"slow_tilt",   15, slowTilt,     still,         {0, 0, 0},        0.01,  0.5,  0, 0},
+  {"desk",        20, faceUp,       deskKnocks,    {0, 0, 0},        0.01,  0.5,  0, 0},
+  {"fidget",      20, fidget,       still,         {0, 0, 0},        0.02,  1.0,  0, 0},
+};
+
+static int16_t quantize(double value, double lsb) {
+  double raw = value * lsb;
+  if (raw > 32767) raw = 32767;
+  if (raw < -32768) raw = -32768;
+  return (int16_t)lround(raw);
+}
+
+// What the IMU reports at sample n: the true up vector as specific force,
+// and the roll rate about x
+static IMUSample traceSample(const WristTrace& trace, int n) {
+  double dt = 1.0 / SAMPLE_RATE_HZ;
+  double t = n * dt;
+  double roll = trace.roll(t) * PI / 180;
+  double rate = (trace.roll(t + dt / 2) - trace.roll(t - dt / 2)) / dt;
+  double g = 1.0 + trace.bounce(t);
+
+  IMUSample sample = {};
+  sample.timestamp_us = (uint32_t)(n * (double)IMU_SAMPLE_PERIOD_US);
+  double up[3] = {0, sin(roll), cos(roll)};
+  double gyro[3] = {rate, 0, 0};
+  for (int axis = 0; axis < 3; axis++) {
+    sample.accel[axis] = quantize(g * up[axis] + trace.accel_noise_g * noise(), IMU_ACCEL_LSB_PER_G);
+    sample.gyro[axis] = quantize(gyro[axis] + trace.gyro_bias[axis] + trace.gyro_noise_dps * noise(),
+                                 IMU_GYRO_LSB_PER_DPS);
+  }
+  return sample;
+}
+
+static ReplayResult replay(const WristTrace& trace) {
+  MahonyFilter fusion;
+  WristDetector wrist;
+  mahonyInit(fusion, MAHONY_KP, MAHONY_KI);
+  wristDetectorInit(wrist);
+  noise_state = 1;
+
+  int total = (int)(trace.seconds * SAMPLE_RATE_HZ);
+  std::vector<IMUSample> samples(total);
+  for (int n = 0; n < total; n++) samples[n] = traceSample(trace, n);
+  std::vector<float> ups(3 * total);
+  std::vector<uint8_t> events(total);
+
+  // As updateOrientation() does, timed alone
+  auto start = std::chrono::steady_clock::now();
+  for (int n = 0; n < total; n++) {
+    const IMUSample& s = samples[n];
+    float accel[3], gyro[3];
+    for (int axis = 0; axis < 3; axis++) {
+      accel[axis] = s.accel[axis] / IMU_ACCEL_LSB_PER_G;
+      gyro[axis] = s.gyro[axis] / IMU_GYRO_LSB_PER_DPS;
+    }
+    mahonyUpdate(fusion, gyro, accel, IMU_SAMPLE_PERIOD_US / 1e6f);
+    float* up = &ups[3 * n];
+    mahonyGravity(fusion, up);
+    float rate = sqrtf(gyro[0] * gyro[0] + gyro[1] * gyro[1] + gyro[2] * gyro[2]);
+    events[n] = wristDetectorUpdate(wrist, up, rate, s.timestamp_us / 1000);
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  ReplayResult result = {};
+  result.samples = total;
+  result.elapsed_ns = std::chrono::duration<double, std::nano>(elapsed).count();
+  for (int n = 0; n < total; n++) {
+    if (events[n] == WRIST_RAISE) result.raises++;
+    if (events[n] == WRIST_LOWER) result.lowers++;
+
+    // Against the true pose once past the start, in still stretches only
+    double t = n / SAMPLE_RATE_HZ;
+    if (t < 2.0 || fabs(trace.roll(t + 0.5) - trace.roll(t - 0.5)) > 1e-9 || trace.bounce(t) != 0) continue;
+    double roll = trace.roll(t) * PI / 180;
+    const float* up = &ups[3 * n];
+    double dy = up[1] - sin(roll), dz = up[2] - cos(roll);
+    float error = (float)sqrt(up[0] * up[0] + dy * dy + dz * dz);
+    if (error > result.max_error) result.max_error = error;
+  }
+  return result;
+}
+
+static void testTraces() {
+  double total_ns = 0;
+  uint32_t total_samples = 0;
+  for (size_t i = 0; i < sizeof(traces) / sizeof(traces[0]); i++) {
+    const WristTrace& trace = traces[i];
+    ReplayResult result = replay(trace);
+    if (result.raises != trace.raises || result.lowers != trace.lowers) {
+      fprintf(stderr, "%s: %u raises, %u lowers\n", trace.name, result.raises, result.lowers);
+    }
+    CHECK_EQ(result.raises, trace.raises);
+    CHECK_EQ(result.lowers, trace.lowers);
+    total_ns += result.elapsed_ns;
+    total_samples += result.samples;
+  }
+  printf("  fusion + wrist detector: %.0f ns/sample over %u samples\n", total_ns / total_samples,
+         total_samples);
+}
+
+static void testFusionTracksPose() {
+  // Held poses settle on the accelerometer's gravity
+  for (size_t i = 0; i < sizeof(traces) / sizeof(traces[0]); i++) {
+    const WristTrace& trace = traces[i];
+    if (trace.bounce != still) continue;
+    ReplayResult result = replay(trace);
+    if (result.max_error >= 0.1f) fprintf(stderr, "%s: up off by %.3f\n", trace.name, result.max_error);
+    CHECK(result.max_error < 0.1f);
+  }
+}
+
+static void testGyroBiasLearned() {
+  // Hanging still with a biased gyro: the integral term takes the bias out
+  MahonyFilter fusion;
+  mahonyInit(fusion, MAHONY_KP, MAHONY_KI);
+  const float bias[3] = {3, -2, 1.5f};
+  const float accel[3] = {0, 1, 0};
+  float dt = IMU_SAMPLE_PERIOD_US / 1e6f;
+  for (int n = 0; n < 600 * SAMPLE_RATE_HZ; n++) mahonyUpdate(fusion, bias, accel, dt);
+
+  // Only the tilt axes are observable from gravity, yaw about "up" (y) is not
+  CHECK_NEAR(fusion.integral[0], -bias[0] * PI / 180, 0.005);
+  CHECK_NEAR(fusion.integral[2], -bias[2] * PI / 180, 0.005);
+  float up[3];
+  mahonyGravity(fusion, up);
+  CHECK_NEAR(up[1], 1.0, 0.01);
+}
+
+static void testArmedAfterSleep() {
+  // Woken by motion with the arm already down: a raise straight away counts
+  WristDetector wrist;
+  wristDetectorInit(wrist);
+  wristDetectorArm(wrist);
+  const float down[3] = {0, 1, 0};
+  const float up[3] = {0, 0, 1};
+  CHECK_EQ(wristDetectorUpdate(wrist, down, 0, 1000), WRIST_NONE);
+  CHECK_EQ(wristDetectorUpdate(wrist, up, 0, 1100), WRIST_NONE);
+  CHECK_EQ(wristDetectorUpdate(wrist, up, 0, 1200), WRIST_NONE);
+  CHECK_EQ(wristDetectorUpdate(wrist, up, 0, 1400), WRIST_RAISE);
+
+  // Without the arming the same pose has to be held first
+  wristDetectorInit(wrist);
+  CHECK_EQ(wristDetectorUpdate(wrist, down, 0, 1000), WRIST_NONE);
+  CHECK_EQ(wristDetectorUpdate(wrist, up, 0, 1100), WRIST_NONE);
+  CHECK_EQ(wristDetectorUpdate(wrist, up, 0, 1200), WRIST_NONE);
+  CHECK_EQ(wristDetectorUpdate(wrist, up, 0, 1400), WRIST_NONE);
+}
+
+int main() {
+  RUN(testTraces);
+  RUN(testFusionTracksPose);
+  RUN(testGyroBiasLearned);
+  RUN(testArmedAfterSleep);
+  return testSummary();
+}
@@ -0,0 +1,114 @@
+/*
+ * Pedometer Tests
+ * Synthetic walks, runs and arm gestures through the integer filter chain
+ */
+
+#include "test.h"
+#include "pedometer.h"
+
+#define SAMPLE_RATE_HZ (1000000.0 / IMU_SAMPLE_PERIOD_US)
+#define PI 3.14159265358979
+
+static const PedometerProfile profile = {175, 70};
+
+// Vertical bounce of a gait: one impact per step, optional stride sway
+static IMUSample gaitSample(int n, double step_hz, double amplitude_g, double stride_g) {
+  double t = n / SAMPLE_RATE_HZ;
+  double g = 1.0 + amplitude_g * sin(2 * PI * step_hz * t) + stride_g * sin(PI * step_hz * t);
+  IMUSample sample = {};
+  sample.timestamp_us = (uint32_t)(n * IMU_SAMPLE_PERIOD_US);
+  sample.accel[2] = (int16_t)(g * IMU_ACCEL_LSB_PER_G);
+  return sample;
+}
+
+// Feeds samples in FIFO-sized batches, like the sensor task
+static void walk(Pedometer& pedometer, double seconds, double step_hz, double amplitude_g, double stride_g,
+                 int start = 0) {
+  int total = (int)(seconds * SAMPLE_RATE_HZ);
+  IMUSample batch[IMU_FIFO_WATERMARK];
+  for (int n = 0; n < total; n += IMU_FIFO_WATERMARK) {
+    int count = total - n < IMU_FIFO_WATERMARK ? total - n : IMU_FIFO_WATERMARK;
+    for (int i = 0; i < count; i++) batch[i] = gaitSample(start + n + i, step_hz, amplitude_g, stride_g);
+    pedometerProcess(pedometer, batch, count);
+  }
+}
+
+static void testWalkCountsSteps() {
+  Pedometer pedometer;
+  pedometerInit(pedometer, profile);
+  walk(pedometer, 60, 1.8, 0.25, 0);  // 108 spm for a minute
+  CHECK_NEAR(pedometer.steps, 108, 5);
+  CHECK_NEAR(pedometer.cadence_spm, 108, 4);
+  CHECK(pedometer.periodic);
+  // Early steps were credited at the resting stride, the rest at 108 spm
+  CHECK(pedometer.distance_m > pedometer.steps * 0.6f);
+  CHECK(pedometer.distance_m <= pedometer.steps * pedometerStepLength(pedometer));
+  CHECK(pedometer.energy_kcal > 2 && pedometer.energy_kcal < 8);
+}
+
+static void testRunCountsSteps() {
+  Pedometer pedometer;
+  pedometerInit(pedometer, profile);
+  walk(pedometer, 30, 2.8, 0.8, 0);  // 168 spm
+  CHECK_NEAR(pedometer.steps, 84, 5);
+  CHECK_NEAR(pedometer.cadence_spm, 168, 6);
+  CHECK(pedometerStepLength(pedometer) > 1.0f);  // Running strides are longer
+}
+
+static void testStrideSwayFoldsToSteps() {
+  Pedometer pedometer;
+  pedometerInit(pedometer, profile);
+  // Arm swing once per stride, as strong as the step impacts
+  walk(pedometer, 60, 2.0, 0.2, 0.2);
+  CHECK_NEAR(pedometer.cadence_spm, 120, 5);
+  CHECK_NEAR(pedometer.steps, 120, 8);
+}
+
+static void testStillWristCountsNothing() {
+  Pedometer pedometer;
+  pedometerInit(pedometer, profile);
+  walk(pedometer, 30, 1.8, 0.005, 0);  // Sensor noise level
+  CHECK_EQ(pedometer.steps, 0);
+  CHECK(!pedometer.periodic);
+}
+
+static void testArmGesturesRejected() {
+  Pedometer pedometer;
+  pedometerInit(pedometer, profile);
+  // A few isolated flicks seconds apart: candidates, never a gait
+  IMUSample batch[IMU_FIFO_WATERMARK];
+  int n = 0;
+  for (int second = 0; second < 20; second++) {
+    for (int block = 0; block < 4; block++) {
+      for (int i = 0; i < IMU_FIFO_WATERMARK; i++, n++) {
+        batch[i] = gaitSample(n, 0, 0, 0);
+        int phase = n % 180;
+        if (phase >= 10 && phase < 18) batch[i].accel[2] += (int16_t)(0.6 * IMU_ACCEL_LSB_PER_G);
+      }
+      pedometerProcess(pedometer, batch, IMU_FIFO_WATERMARK);
+    }
+  }
+  CHECK_EQ(pedometer.steps, 0);
+  CHECK(pedometer.rejected_steps > 0);
+}
+
+static void testAddStepsAndReset() {
+  Pedometer pedometer;
+  pedometerInit(pedometer, profile);
+  pedometerAddSteps(pedometer, 100);
+  CHECK_EQ(pedometer.steps, 100);
+  CHECK(pedometer.distance_m > 50);
+  pedometerResetTotals(pedometer);
+  CHECK_EQ(pedometer.steps, 0);
+  CHECK_EQ(pedometer.distance_m, 0);
+}
+
+int main() {
+  RUN(testWalkCountsSteps);
+  RUN(testRunCountsSteps);
+  RUN(testStrideSwayFoldsToSteps);
+  RUN(testStillWristCountsNothing);
+  RUN(testArmGesturesRejected);
+  RUN(testAddStepsAndReset);
+  return testSummary();
+}
@@ -0,0 +1,160 @@
+/*
+ * Register Shadow Cache Tests
+ * Staleness policies, burst refills and write-through against i2c_mock
+ */
+
+#include "test.h"
+#include "reg_cache.h"
+#include "i2c_mock.h"
+#include <string.h>
+#include <thread>
+
+#define PMIC_FIRST_REG 0x00
+#define PMIC_REG_COUNT 0x40
+
+static I2CMockDevice* pmic;
+static RegCacheEntry pmic_entries[PMIC_REG_COUNT];
+static RegCache pmic_cache;
+
+static void startCache() {
+  i2cMockReset();
+  pmic = i2cMockAddDevice(I2C_BUS_SHARED, 0x34);
+  i2cConfigureDevice(I2C_DEV_PMIC, "pmic", I2C_BUS_SHARED, 0x34, 100000);
+  CHECK(i2cBusStart(i2cMockBackend()));
+  regCacheInit(pmic_cache, "pmic", I2C_DEV_PMIC, PMIC_FIRST_REG, pmic_entries, PMIC_REG_COUNT);
+  regCacheResetStats();
+}
+
+static void testVolatileAlwaysReads() {
+  startCache();
+  uint8_t value;
+  pmic->registers[0x20] = 1;
+  CHECK(regCacheRead(pmic_cache, 0x20, &value, 1, 0));
+  pmic->registers[0x20] = 2;
+  CHECK(regCacheRead(pmic_cache, 0x20, &value, 1, 0));
+  CHECK_EQ(value, 2);
+  CHECK_EQ(pmic->reads, 2);
+  CHECK_EQ(pmic_cache.hits, 0);
+}
+
+static void testAgedRegisterExpires() {
+  startCache();
+  regCacheSetPolicy(pmic_cache, 0x34, 2, 1000);  // Battery voltage, 1 s
+  uint8_t volts[2];
+  pmic->registers[0x34] = 0x0E;
+  pmic->registers[0x35] = 0x10;
+  CHECK(regCacheRead(pmic_cache, 0x34, volts, 2, 100));
+  pmic->registers[0x35] = 0x20;
+  CHECK(regCacheRead(pmic_cache, 0x34, volts, 2, 1099));
+  CHECK_EQ(volts[1], 0x10);  // Still fresh
+  CHECK_EQ(pmic_cache.hits, 1);
+  CHECK(regCacheRead(pmic_cache, 0x34, volts, 2, 1100));
+  CHECK_EQ(volts[1], 0x20);
+  CHECK_EQ(pmic->reads, 2);
+}
+
+static void testForeverUntilInvalidated() {
+  startCache();
+  regCacheSetPolicy(pmic_cache, 0x00, 4, REG_AGE_FOREVER);
+  uint8_t status[4];
+  pmic->registers[0x01] = 0xAA;
+  CHECK(regCacheRead(pmic_cache, 0x00, status, 4, 0));
+  pmic->registers[0x01] = 0xBB;
+  CHECK(regCacheRead(pmic_cache, 0x00, status, 4, 3600000));
+  CHECK_EQ(status[1], 0xAA);
+
+  // The interrupt line flags it, the next read refills
+  regCacheInvalidateFromISR(pmic_cache);
+  CHECK(regCacheRead(pmic_cache, 0x00, status, 4, 3600001));
+  CHECK_EQ(status[1], 0xBB);
+  CHECK(!pmic_cache.invalidate_pending);
+}
+
+static void testStaleSpanIsOneBurst() {
+  startCache();
+  regCacheSetPolicy(pmic_cache, 0x10, 8, REG_AGE_FOREVER);
+  regCacheSetPolicy(pmic_cache, 0x12, 1, REG_AGE_VOLATILE);
+  regCacheSetPolicy(pmic_cache, 0x15, 1, REG_AGE_VOLATILE);
+  uint8_t block[8];
+  CHECK(regCacheRead(pmic_cache, 0x10, block, 8, 0));
+  CHECK_EQ(pmic_cache.registers_read, 8);
+
+  // Only 0x12..0x15 are stale: one burst of four, fresh ones in between re-read
+  CHECK(regCacheRead(pmic_cache, 0x10, block, 8, 10));
+  CHECK_EQ(pmic->reads, 2);
+  CHECK_EQ(pmic_cache.registers_read, 12);
+}
+
+static void testWriteThrough() {
+  startCache();
+  regCacheSetPolicy(pmic_cache, 0x18, 1, REG_AGE_FOREVER);
+  CHECK(regCacheWriteReg(pmic_cache, 0x18, 0x5A, 0));
+  CHECK_EQ(pmic->registers[0x18], 0x5A);
+  uint8_t value;
+  CHECK(regCacheRead(pmic_cache, 0x18, &value, 1, 5));
+  CHECK_EQ(value, 0x5A);
+  CHECK_EQ(pmic->reads, 0);  // Served from the write
+
+  // A failed write drops the shadow instead of trusting it
+  pmic->present = false;
+  CHECK(!regCacheWriteReg(pmic_cache, 0x18, 0x11, 10));
+  pmic->present = true;
+  CHECK(regCacheRead(pmic_cache, 0x18, &value, 1, 20));
+  CHECK_EQ(value, 0x5A);
+  CHECK_EQ(pmic->reads, 1);
+}
+
+static void testOutsideWindowGoesToBus() {
+  startCache();
+  pmic->registers[0x90] = 0x33;
+  uint8_t value;
+  CHECK(regCacheRead(pmic_cache, 0x90, &value, 1, 0));
+  CHECK_EQ(value, 0x33);
+  CHECK(!regCacheRead(pmic_cache, 0x10, &value, 0, 0));
+  CHECK_EQ(pmic_cache.misses, 1);
+}
+
+// The sensor task and the UI both read the RTC: every read sees one whole write
+#define STRESS_ROUNDS 20000
+
+static void testThreadsNeverTear() {
+  startCache();
+  uint8_t time_regs[7] = {};
+  CHECK(regCacheWrite(pmic_cache, 0x04, time_regs, sizeof(time_regs), 0));
+
+  int torn[2] = {0, 0};
+  auto reader = [&torn](int id) {
+    for (int round = 0; round < STRESS_ROUNDS; round++) {
+      uint8_t regs[7];
+      if (!regCacheRead(pmic_cache, 0x04, regs, sizeof(regs), round)) continue;
+      for (int i = 1; i < 7; i++) {
+        if (regs[i] != regs[0]) {
+          torn[id]++;
+          break;
+        }
+      }
+    }
+  };
+  std::thread sensor_task(reader, 0), ui(reader, 1);
+  for (int round = 1; round <= STRESS_ROUNDS; round++) {
+    memset(time_regs, round & 0xFF, sizeof(time_regs));
+    regCacheWrite(pmic_cache, 0x04, time_regs, sizeof(time_regs), round);
+  }
+  sensor_task.join();
+  ui.join();
+
+  CHECK_EQ(torn[0] + torn[1], 0);
+  CHECK_EQ(pmic_cache.hits + pmic_cache.misses, 2 * STRESS_ROUNDS);  // No lost counts
+  CHECK_EQ(pmic->registers[0x0A], STRESS_ROUNDS & 0xFF);
+}
+
+int main() {
+  RUN(testVolatileAlwaysReads);
+  RUN(testAgedRegisterExpires);
+  RUN(testForeverUntilInvalidated);
+  RUN(testStaleSpanIsOneBurst);
+  RUN(testWriteThrough);
+  RUN(testOutsideWindowGoesToBus);
+  RUN(testThreadsNeverTear);
+  return testSummary();
+}
@@ -0,0 +1,118 @@
+/*
+ * Warm Resume Tests
+ * Sealing, corruption and ageing with the block handled as raw bytes
+ */
+
+#include "test.h"
+#include "resume.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SAVED_MINUTE (20000 * 1440 + 1380)   // 23:00 on some day
+
+// RTC slow memory as the next boot finds it
+static uint8_t rtc_memory[sizeof(ResumeState)];
+
+static void fillState(ResumeState& state) {
+  memset(&state, 0, sizeof(state));
+  state.warm_boots = 3;
+  state.system.screen = 1;
+  state.system.brightness = 180;
+  state.system.steps_today = 8421;
+  state.steps.daily_steps = 8421;
+  state.steps.distance_m = 6315.5f;
+  state.steps.hardware_count = 1234;
+  state.steps.hardware_valid = true;
+  state.quests.count = 2;
+  state.quests.daily[1].current_progress = 40;
+  state.quests.daily[1].age_ms = 3600000;
+  state.media.current_track = 7;
+  resumeSeal(state, SAVED_MINUTE);
+}
+
+static void testSealSurvivesByteCopy() {
+  ResumeState saved;
+  fillState(saved);
+  CHECK(resumeValid(saved));
+  CHECK_EQ(saved.magic, RESUME_MAGIC);
+  CHECK_EQ(saved.size, sizeof(ResumeState));
+
+  memcpy(rtc_memory, &saved, sizeof(saved));
+  ResumeState woken;
+  memcpy(&woken, rtc_memory, sizeof(woken));
+  CHECK(resumeValid(woken));
+  CHECK_EQ(woken.steps.hardware_count, 1234);
+  CHECK_NEAR(woken.steps.distance_m, 6315.5, 0.001);
+  CHECK_EQ(woken.quests.daily[1].current_progress, 40);
+  CHECK_EQ(resumeChecksum(woken), woken.crc);
+}
+
+static void testEveryBitFlipIsCaught() {
+  ResumeState saved;
+  fillState(saved);
+  memcpy(rtc_memory, &saved, sizeof(saved));
+
+  int accepted = 0;
+  for (size_t bit = 0; bit < sizeof(rtc_memory) * 8; bit++) {
+    rtc_memory[bit / 8] ^= 1 << (bit % 8);
+    ResumeState woken;
+    memcpy(&woken, rtc_memory, sizeof(woken));
+    if (resumeValid(woken)) accepted++;
+    rtc_memory[bit / 8] ^= 1 << (bit % 8);
+  }
+  CHECK_EQ(accepted, 0);
+}
+
+static void testPowerLossAndStaleBuilds() {
+  // Memory left random by a power cycle
+  srand(1);
+  int accepted = 0;
+  for (int round = 0; round < 1000; round++) {
+    for (size_t i = 0; i < sizeof(rtc_memory); i++) rtc_memory[i] = (uint8_t)rand();
+    ResumeState woken;
+    memcpy(&woken, rtc_memory, sizeof(woken));
+    if (resumeValid(woken)) accepted++;
+  }
+  CHECK_EQ(accepted, 0);
+
+  // A block from another build, resealed with its own CRC, still fails
+  ResumeState state;
+  fillState(state);
+  state.version = RESUME_VERSION + 1;
+  state.crc = resumeChecksum(state);
+  CHECK(!resumeValid(state));
+  fillState(state);
+  state.size = sizeof(ResumeState) - 4;
+  state.crc = resumeChecksum(state);
+  CHECK(!resumeValid(state));
+
+  // Used once: a later reset boots cold
+  fillState(state);
+  resumeInvalidate(state);
+  CHECK(!resumeValid(state));
+}
+
+static void testAgeing() {
+  ResumeState state;
+  fillState(state);
+  CHECK_EQ(resumeAsleepMs(state, SAVED_MINUTE + 45), 45 * 60000);
+  CHECK_EQ(resumeAsleepMs(state, SAVED_MINUTE - 10), 0);  // Clock set back
+  CHECK_EQ(resumeAsleepMs(state, SAVED_MINUTE + 200000), 0xFFFFFFFFUL);
+
+  // 23:00 to 23:59 is today, 00:01 is tomorrow and starts the counters over
+  CHECK(resumeSameDay(state, SAVED_MINUTE + 59));
+  CHECK(!resumeSameDay(state, SAVED_MINUTE + 61));
+
+  uint32_t age = resumeAge(state.quests.daily[1].age_ms, resumeAsleepMs(state, SAVED_MINUTE + 30));
+  CHECK_EQ(age, 3600000 + 30 * 60000);
+  CHECK_EQ(resumeAge(0xFFFFFF00UL, 0x200), 0xFFFFFFFFUL);
+}
+
+int main() {
+  RUN(testSealSurvivesByteCopy);
+  RUN(testEveryBitFlipIsCaught);
+  RUN(testPowerLossAndStaleBuilds);
+  RUN(testAgeing);
+  return testSummary();
+}
@@ -0,0 +1,125 @@
+/*
+ * Loop Scheduler Tests
+ * The main loop replayed on a virtual clock: sleeps, wakes and lateness
+ */
+
+#include "test.h"
+#include "scheduler.h"
+
+#define MAX_SLEEP_MS 60000
+
+static const uint32_t periods[DEADLINE_COUNT] = {1000, 0, 200, 0, 30000, 0};
+
+struct VirtualLoop {
+  LoopScheduler scheduler;
+  uint32_t now;
+  uint32_t awake_ms;
+  uint32_t worst_late_ms;
+  uint32_t runs[DEADLINE_COUNT];
+};
+
+static void startLoop(VirtualLoop& loop, uint32_t now) {
+  schedulerInit(loop.scheduler);
+  loop.now = now;
+  loop.awake_ms = loop.worst_late_ms = 0;
+  for (int deadline = 0; deadline < DEADLINE_COUNT; deadline++) {
+    loop.runs[deadline] = 0;
+    if (periods[deadline]) schedulerArm(loop.scheduler, deadline, now + periods[deadline]);
+  }
+}
+
+// One pass: run what is due, then sleep; an interrupt at wake_at cuts the sleep short
+static void pass(VirtualLoop& loop, uint32_t wake_at = 0) {
+  for (int deadline = 0; deadline < DEADLINE_COUNT; deadline++) {
+    if (!schedulerDue(loop.scheduler, deadline, loop.now)) continue;
+    uint32_t late = loop.now - loop.scheduler.due_ms[deadline];
+    if (late > loop.worst_late_ms) loop.worst_late_ms = late;
+    loop.runs[deadline]++;
+    if (periods[deadline]) schedulerArm(loop.scheduler, deadline, loop.scheduler.due_ms[deadline] + periods[deadline]);
+    else schedulerDisarm(loop.scheduler, deadline);
+  }
+  loop.now += 1;  // The pass itself
+  loop.awake_ms += 1;
+
+  SleepPlan plan = schedulerPlanSleep(loop.scheduler, loop.now, MAX_SLEEP_MS);
+  if (plan.sleep_ms == 0) return;
+  uint32_t slept = plan.sleep_ms;
+  if (wake_at && wake_at - loop.now < slept) slept = wake_at - loop.now;
+  loop.now += slept;
+  schedulerNoteWake(loop.scheduler, plan, slept);
+}
+
+static void testIdleWatchfaceSleeps() {
+  VirtualLoop loop;
+  startLoop(loop, 0);
+  while (loop.now <= 60000) pass(loop);
+
+  CHECK_NEAR(loop.runs[DEADLINE_FRAME], 60, 1);
+  CHECK_NEAR(loop.runs[DEADLINE_SENSORS], 300, 1);
+  CHECK_EQ(loop.runs[DEADLINE_POWER], 2);
+  CHECK(loop.worst_late_ms <= 1);
+  // Asleep nearly all the time, every wake was for a deadline
+  CHECK(loop.scheduler.stats.slept_ms * 100 / loop.now >= 90);
+  CHECK_EQ(loop.scheduler.stats.early_wakes, 0);
+  CHECK(loop.scheduler.stats.woken_by[DEADLINE_SENSORS] > loop.scheduler.stats.woken_by[DEADLINE_FRAME]);
+}
+
+static void testInterruptEndsSleepEarly() {
+  VirtualLoop loop;
+  startLoop(loop, 0);
+  loop.now = 200;
+  pass(loop, 250);  // Sensor cycle, then a finger down mid-sleep
+  CHECK_EQ(loop.runs[DEADLINE_SENSORS], 1);
+  CHECK_EQ(loop.now, 250);
+  CHECK_EQ(loop.scheduler.stats.early_wakes, 1);
+
+  // A one-off deadline runs once, on time, then only the periodic ones stay
+  schedulerArm(loop.scheduler, DEADLINE_TIME, 270);
+  while (!loop.runs[DEADLINE_TIME] && loop.now < 400) pass(loop);
+  CHECK_EQ(loop.runs[DEADLINE_TIME], 1);
+  CHECK(loop.worst_late_ms <= 1);
+  CHECK(!schedulerArmed(loop.scheduler, DEADLINE_TIME));
+}
+
+static void testShortGapIdles() {
+  LoopScheduler scheduler;
+  schedulerInit(scheduler);
+  schedulerArm(scheduler, DEADLINE_ANIMATION, 103);
+  SleepPlan plan = schedulerPlanSleep(scheduler, 100, MAX_SLEEP_MS);
+  CHECK_EQ(plan.sleep_ms, 0);
+  CHECK_EQ(plan.deadline, DEADLINE_ANIMATION);
+  CHECK_EQ(scheduler.stats.idles, 1);
+
+  // Overdue: no sleep, and not counted as an idle gap either
+  plan = schedulerPlanSleep(scheduler, 110, MAX_SLEEP_MS);
+  CHECK_EQ(plan.sleep_ms, 0);
+  CHECK_EQ(scheduler.stats.idles, 1);
+
+  // Nothing armed: bounded by max_ms
+  schedulerDisarm(scheduler, DEADLINE_ANIMATION);
+  plan = schedulerPlanSleep(scheduler, 110, 500);
+  CHECK_EQ(plan.deadline, -1);
+  CHECK_EQ(plan.sleep_ms, 500 - SCHEDULER_WAKE_MARGIN_MS);
+}
+
+static void testAcrossMillisWrap() {
+  VirtualLoop loop;
+  startLoop(loop, 0xFFFFFFFFu - 5000);
+  uint32_t start = loop.now;
+  while (loop.now - start < 20000) pass(loop);
+
+  CHECK(loop.now < start);  // Wrapped
+  CHECK_NEAR(loop.runs[DEADLINE_FRAME], 20, 1);
+  CHECK_NEAR(loop.runs[DEADLINE_SENSORS], 100, 1);
+  CHECK(loop.worst_late_ms <= 1);
+  CHECK(schedulerDue(loop.scheduler, DEADLINE_FRAME, loop.scheduler.due_ms[DEADLINE_FRAME]));
+  CHECK(!schedulerDue(loop.scheduler, DEADLINE_FRAME, loop.scheduler.due_ms[DEADLINE_FRAME] - 1));
+}
+
+int main() {
+  RUN(testIdleWatchfaceSleeps);
+  RUN(testInterruptEndsSleepEarly);
+  RUN(testShortGapIdles);
+  RUN(testAcrossMillisWrap);
+  return testSummary();
+}
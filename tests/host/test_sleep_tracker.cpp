@@ -0,0 +1,280 @@
+/*
+ * Sleep Tracker Tests
+ * Movement counts, Cole-Kripke scoring, Webster rescoring and a recorded night
+ */
+
+#include "test.h"
+#include "sleep_tracker.h"
+#include <string.h>
+
+#define EPOCH_SAMPLES (60 * SLEEP_WINDOW_SAMPLES)
+
+// One minute lying still on the back, with a jolt in the first `moved` seconds
+static void epochSamples(IMUSample* samples, int moved) {
+  memset(samples, 0, sizeof(IMUSample) * EPOCH_SAMPLES);
+  for (int i = 0; i < EPOCH_SAMPLES; i++) {
+    samples[i].accel[2] = 8192;
+    if (i % SLEEP_WINDOW_SAMPLES == 10 && i / SLEEP_WINDOW_SAMPLES < moved) samples[i].accel[0] = 400;
+  }
+}
+
+static void addEpoch(SleepTracker& tracker, int moved, bool awake = false) {
+  static IMUSample samples[EPOCH_SAMPLES];
+  epochSamples(samples, moved);
+  sleepTrackerAddSamples(tracker, samples, EPOCH_SAMPLES);
+  sleepTrackerEndEpoch(tracker, awake);
+}
+
+// Night from a pattern, 'S' asleep and anything else awake
+static int fromPattern(uint8_t* asleep, const char* pattern) {
+  memset(asleep, 0, SLEEP_MAX_EPOCHS / 8);
+  int epochs = strlen(pattern);
+  for (int epoch = 0; epoch < epochs; epoch++) {
+    if (pattern[epoch] == 'S') asleep[epoch >> 3] |= 1 << (epoch & 7);
+  }
+  return epochs;
+}
+
+static bool patternMatches(const uint8_t* asleep, const char* expected) {
+  int epochs = strlen(expected);
+  for (int epoch = 0; epoch < epochs; epoch++) {
+    bool bit = asleep[epoch >> 3] & (1 << (epoch & 7));
+    if (bit != (expected[epoch] == 'S')) {
+      fprintf(stderr, "epoch %d: %s, expected %s\n", epoch, bit ? "asleep" : "awake", expected);
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool replayNight(const char* name, SleepTracker& tracker) {
+  char path[128];
+  snprintf(path, sizeof(path), "traces/%s", name);
+  FILE* file = fopen(path, "r");
+  if (!file) {
+    fprintf(stderr, "%s: missing\n", path);
+    return false;
+  }
+
+  char line[128];
+  while (fgets(line, sizeof(line), file)) {
+    int epochs, moved;
+    char word[8];
+    if (line[0] == '#') continue;
+    if (sscanf(line, "%d %d", &epochs, &moved) == 2) {
+      for (int i = 0; i < epochs; i++) addEpoch(tracker, moved);
+    } else if (sscanf(line, "%d %7s", &epochs, word) == 2 && strcmp(word, "awake") == 0) {
+      for (int i = 0; i < epochs; i++) addEpoch(tracker, 0, true);
+    }
+  }
+  fclose(file);
+  return true;
+}
+
+// ==================== COUNTS ====================
+static void testActivityCounts() {
+  SleepTracker tracker;
+  sleepTrackerBegin(tracker, 0);
+
+  // One count per second with any movement, however many samples moved in it
+  addEpoch(tracker, 0);
+  addEpoch(tracker, 17);
+  addEpoch(tracker, 60);
+  CHECK_EQ(tracker.counts[0], 0);
+  CHECK_EQ(tracker.counts[1], 17);
+  CHECK_EQ(tracker.counts[2], 60);
+  CHECK_EQ(tracker.total_count, 77);
+
+  // A jolt under the dead band is breathing, not movement
+  static IMUSample samples[EPOCH_SAMPLES];
+  epochSamples(samples, 0);
+  for (int i = 0; i < EPOCH_SAMPLES; i += 7) samples[i].accel[1] = SLEEP_MOVE_THRESHOLD - 10;
+  sleepTrackerAddSamples(tracker, samples, EPOCH_SAMPLES);
+  sleepTrackerEndEpoch(tracker, false);
+  CHECK_EQ(tracker.counts[3], 0);
+
+  // Rolling over slowly moves the baseline along with it
+  for (int i = 0; i < EPOCH_SAMPLES; i++) samples[i].accel[0] = (int16_t)(i * 2);
+  sleepTrackerAddSamples(tracker, samples, EPOCH_SAMPLES);
+  sleepTrackerEndEpoch(tracker, false);
+  CHECK_EQ(tracker.counts[4], 0);
+
+  // The screen on is a full minute of movement whatever the IMU saw
+  addEpoch(tracker, 0, true);
+  CHECK_EQ(tracker.counts[5], SLEEP_COUNT_AWAKE);
+  CHECK_EQ(tracker.night.summary.epochs, 6);
+}
+
+// ==================== SCORING ====================
+// Scores epoch 4 of a still night with the given counts around it
+static bool scoredAsleep(const uint16_t counts[SLEEP_CK_WINDOW]) {
+  SleepTracker tracker;
+  sleepTrackerBegin(tracker, 0);
+  for (int epoch = 0; epoch < SLEEP_CK_WINDOW; epoch++) {
+    tracker.epoch_count = counts[epoch];
+    sleepTrackerEndEpoch(tracker, false);
+  }
+  CHECK_EQ(tracker.scored, SLEEP_CK_WINDOW - SLEEP_CK_LAG);
+  return sleepNightAsleep(tracker.night, 4);
+}
+
+static void testColeKripkeThreshold() {
+  // Weighted sum just under, at and over 1600: asleep only below it
+  const uint16_t under[SLEEP_CK_WINDOW] = {10, 9, 0, 0, 0, 0, 0};    // 106*10 + 54*9 = 1546
+  const uint16_t at[SLEEP_CK_WINDOW] = {10, 10, 0, 0, 0, 0, 0};      // 1600
+  CHECK(scoredAsleep(under));
+  CHECK(!scoredAsleep(at));
+
+  // The epoch itself weighs most: 6 seconds still sleep, 7 do not
+  const uint16_t six[SLEEP_CK_WINDOW] = {0, 0, 0, 0, 6, 0, 0};       // 1380
+  const uint16_t seven[SLEEP_CK_WINDOW] = {0, 0, 0, 0, 7, 0, 0};     // 1610
+  CHECK(scoredAsleep(six));
+  CHECK(!scoredAsleep(seven));
+
+  // The two epochs after count too, which is why scores lag two minutes
+  const uint16_t after[SLEEP_CK_WINDOW] = {0, 0, 0, 0, 0, 12, 12};   // 74*12 + 67*12 = 1692
+  CHECK(!scoredAsleep(after));
+
+  // Finishing scores the last two with nothing after them
+  SleepTracker tracker;
+  sleepTrackerBegin(tracker, 0);
+  for (int epoch = 0; epoch < SLEEP_MIN_EPOCHS; epoch++) addEpoch(tracker, epoch < SLEEP_MIN_EPOCHS - 1 ? 1 : 7);
+  CHECK_EQ(tracker.scored, SLEEP_MIN_EPOCHS - SLEEP_CK_LAG);
+  SleepNight night;
+  CHECK(sleepTrackerFinish(tracker, night));
+  CHECK_EQ(tracker.scored, SLEEP_MIN_EPOCHS);
+  CHECK(sleepNightAsleep(night, SLEEP_MIN_EPOCHS - 2));  // 76 + 230 + 74 + 7*67 = 849
+  CHECK(!sleepNightAsleep(night, SLEEP_MIN_EPOCHS - 1));  // 7*230 + 4 + 54 + 58 + 76 = 1802
+}
+
+// ==================== RESCORING ====================
+static void checkRescore(const char* pattern, const char* expected) {
+  uint8_t asleep[SLEEP_MAX_EPOCHS / 8];
+  int epochs = fromPattern(asleep, pattern);
+  sleepRescore(asleep, epochs);
+  CHECK(patternMatches(asleep, expected));
+}
+
+static void testWebsterRules() {
+  // a-c: the first minutes after 4, 10 and 15 minutes awake, and not after 3
+  checkRescore("WWWSSSSSSSSSSSS", "WWWSSSSSSSSSSSS");
+  checkRescore("WWWWSSSSSSSSSSS", "WWWWWSSSSSSSSSS");
+  checkRescore("WWWWWWWWWSSSSSSSSSSS", "WWWWWWWWWWSSSSSSSSSS");
+  checkRescore("WWWWWWWWWWSSSSSSSSSSS", "WWWWWWWWWWWWWSSSSSSSS");
+  checkRescore("WWWWWWWWWWWWWWSSSSSSSSSSS", "WWWWWWWWWWWWWWWWWSSSSSSSS");
+  checkRescore("WWWWWWWWWWWWWWWSSSSSSSSSSS", "WWWWWWWWWWWWWWWWWWWSSSSSSS");
+
+  // d: six minutes or less between two 10 minute wakes is wake, seven is not
+  checkRescore("WWWWWWWWWWSSSSSSWWWWWWWWWW", "WWWWWWWWWWWWWWWWWWWWWWWWWW");
+  checkRescore("WWWWWWWWWWSSSSSSSWWWWWWWWWW", "WWWWWWWWWWWWWSSSSWWWWWWWWWW");
+  checkRescore("WWWWWWWWWWSSSSSSWWWWWWWWW", "WWWWWWWWWWWWWSSSWWWWWWWWW");
+
+  // e: ten minutes or less between two 20 minute wakes, eleven is not
+  checkRescore("WWWWWWWWWWWWWWWWWWWWSSSSSSSSSSWWWWWWWWWWWWWWWWWWWW",
+               "WWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW");
+  checkRescore("WWWWWWWWWWWWWWWWWWWWSSSSSSSSSSSWWWWWWWWWWWWWWWWWWWW",
+               "WWWWWWWWWWWWWWWWWWWWWWWWSSSSSSSWWWWWWWWWWWWWWWWWWWW");
+
+  // Sleep from the first epoch has no wake before it; rules read the
+  // original scores, so a run rescored to wake does not lengthen the next wake
+  checkRescore("SSSSWWWSSSWWWSSSSSSSSSS", "SSSSWWWSSSWWWSSSSSSSSSS");
+  checkRescore("WWWWSWWSSSSS", "WWWWWWWSSSSS");
+}
+
+// ==================== SUMMARY ====================
+static void testSummaryFields() {
+  SleepNight night;
+  memset(&night, 0, sizeof(night));
+  night.version = SLEEP_NIGHT_VERSION;
+
+  // 10 awake, 100 asleep, 5 awake, 200 asleep, 2 awake, 50 asleep, 20 awake
+  static char pattern[400];
+  int n = 0;
+  const int runs[] = {10, 100, 5, 200, 2, 50, 20};
+  for (int run = 0; run < 7; run++) {
+    for (int i = 0; i < runs[run]; i++) pattern[n++] = run & 1 ? 'S' : 'W';
+  }
+  pattern[n] = 0;
+  night.summary.epochs = fromPattern(night.asleep, pattern);
+
+  sleepSummarize(night);
+  CHECK_EQ(night.summary.epochs, 387);
+  CHECK_EQ(night.summary.onset_epoch, 10);
+  CHECK_EQ(night.summary.final_wake_epoch, 367);
+  CHECK_EQ(night.summary.asleep_minutes, 350);
+  CHECK_EQ(night.summary.waso_minutes, 7);
+  CHECK_EQ(night.summary.awakenings, 2);
+  CHECK_EQ(night.summary.efficiency, 350 * 100 / 367);
+  CHECK(sleepNightValid(night));
+
+  // Never asleep: everything zero, still a valid night
+  night.summary.epochs = fromPattern(night.asleep, "WWWWWWWWWW");
+  sleepSummarize(night);
+  CHECK_EQ(night.summary.asleep_minutes, 0);
+  CHECK_EQ(night.summary.final_wake_epoch, 0);
+  CHECK_EQ(night.summary.efficiency, 0);
+  CHECK(sleepNightValid(night));
+}
+
+// ==================== NIGHTS ====================
+static void testRecordedNight() {
+  SleepTracker tracker;
+  sleepTrackerBegin(tracker, 12345);
+  CHECK(replayNight("night.trace", tracker));
+  SleepNight night;
+  CHECK(sleepTrackerFinish(tracker, night));
+  const SleepSummary& summary = night.summary;
+  CHECK(sleepNightValid(night));
+  CHECK_EQ(summary.start_minute, 12345);
+  CHECK_EQ(summary.epochs, 451);
+
+  // Settling scores asleep from epoch 22, once 160 * 8 is under the
+  // threshold; after 22 minutes of wake Webster takes the first 4 back
+  CHECK_EQ(summary.onset_epoch, 26);
+
+  // The alarm's screen-on minute at 446 wakes the two epochs before it
+  CHECK_EQ(summary.final_wake_epoch, 444);
+
+  // Turning over is too little to wake. The quarter hour up scores awake
+  // from 230 to 248, plus 4 rescored minutes after it: one awakening
+  CHECK(sleepNightAsleep(night, 110));
+  CHECK(sleepNightAsleep(night, 229));
+  CHECK(!sleepNightAsleep(night, 230));
+  CHECK(!sleepNightAsleep(night, 252));
+  CHECK(sleepNightAsleep(night, 253));
+  CHECK_EQ(summary.awakenings, 1);
+  CHECK_EQ(summary.waso_minutes, 23);
+  CHECK_EQ(summary.asleep_minutes, 444 - 26 - 23);
+  CHECK_EQ(summary.efficiency, 395 * 100 / 444);
+}
+
+static void testNightstandRejected() {
+  // Eight hours without a single movement is a watch off the wrist
+  SleepTracker tracker;
+  SleepNight night;
+  sleepTrackerBegin(tracker, 0);
+  for (int epoch = 0; epoch < 480; epoch++) addEpoch(tracker, 0);
+  CHECK_EQ(tracker.total_count, 0);
+  CHECK(!sleepTrackerFinish(tracker, night));
+
+  // Neither is a nap shorter than the minimum kept
+  sleepTrackerBegin(tracker, 0);
+  for (int epoch = 0; epoch < SLEEP_MIN_EPOCHS - 1; epoch++) addEpoch(tracker, 1);
+  CHECK(!sleepTrackerFinish(tracker, night));
+
+  // One real movement is enough
+  sleepTrackerBegin(tracker, 0);
+  for (int epoch = 0; epoch < 480; epoch++) addEpoch(tracker, epoch == 200 ? 3 : 0);
+  CHECK(sleepTrackerFinish(tracker, night));
+  CHECK_EQ(night.summary.asleep_minutes, 480);
+}
+
+int main() {
+  RUN(testActivityCounts);
+  RUN(testColeKripkeThreshold);
+  RUN(testWebsterRules);
+  RUN(testSummaryFields);
+  RUN(testRecordedNight);
+  RUN(testNightstandRejected);
+  return testSummary();
+}
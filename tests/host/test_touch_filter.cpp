@@ -0,0 +1,106 @@
+/*
+ * Touch Filter Tests
+ * Jitter, lag and prediction on synthetic finger paths
+ */
+
+#include "test.h"
+#include "touch_filter.h"
+
+static const TouchFilterConfig still_config = {1.0f, 0.03f, 1.0f, 0.0f};
+static const TouchFilterConfig list_config = {1.0f, 0.05f, 1.0f, 16.0f};
+
+// Repeatable +/- jitter without pulling in rand()
+static float jitter(int step, float amplitude) {
+  static const float pattern[] = {0.6f, -1.0f, 0.2f, 0.9f, -0.4f, -0.7f, 1.0f, -0.3f};
+  return pattern[step % 8] * amplitude;
+}
+
+static void testFirstSampleTakenAsIs() {
+  TouchFilter filter;
+  touchFilterInit(filter, still_config);
+  float x, y;
+  touchFilterUpdate(filter, 120, 340, 1000, x, y);
+  CHECK_EQ(x, 120);
+  CHECK_EQ(y, 340);
+  CHECK(filter.initialized);
+}
+
+static void testStillFingerSmoothsJitter() {
+  TouchFilter filter;
+  touchFilterInit(filter, still_config);
+  float x, y, worst = 0;
+  for (int step = 0; step < 100; step++) {
+    touchFilterUpdate(filter, 200 + jitter(step, 3), 200 + jitter(step + 3, 3), step * 10, x, y);
+    if (step > 10 && fabsf(x - 200) > worst) worst = fabsf(x - 200);
+  }
+  CHECK(worst < 1.0f);  // 3 px of raw jitter stays under a pixel
+}
+
+static void testFastMotionKeepsUp() {
+  TouchFilter filter;
+  touchFilterInit(filter, still_config);
+  float x = 0, y;
+  // 1 px/ms sweep: beta opens the cutoff so the lag stays small
+  for (int step = 0; step <= 30; step++) touchFilterUpdate(filter, step * 10, 100, step * 10, x, y);
+  CHECK(300 - x < 40);
+  CHECK_NEAR(y, 100, 0.001);
+}
+
+static void testRepeatedTimestampIgnored() {
+  TouchFilter filter;
+  touchFilterInit(filter, still_config);
+  float x, y;
+  touchFilterUpdate(filter, 100, 100, 50, x, y);
+  touchFilterUpdate(filter, 180, 100, 50, x, y);  // dt of zero would divide by it
+  CHECK_EQ(x, 100);
+}
+
+static void testPredictionLeadsAndCaps() {
+  TouchFilter filter;
+  touchFilterInit(filter, list_config);
+  float x = 0, y, px, py;
+  for (int step = 0; step <= 20; step++) touchFilterUpdate(filter, 100, step * 5, step * 10, x, y);
+  touchFilterPredict(filter, px, py);
+  CHECK(py > y);                                        // Ahead of the smoothed point
+  CHECK(py - y <= 16.0f * 0.5f + 0.5f);                 // At most predict_ms of 0.5 px/ms
+  CHECK_NEAR(px, 100, 0.001);
+
+  // A very fast flick is clamped to a fingertip of lead
+  for (int step = 21; step <= 30; step++) touchFilterUpdate(filter, 100, step * 200, step * 10, x, y);
+  touchFilterPredict(filter, px, py);
+  CHECK_NEAR(py - y, TOUCH_FILTER_MAX_PREDICT_PX, 0.01);
+}
+
+static void testStillConfigDoesNotPredict() {
+  TouchFilter filter;
+  touchFilterInit(filter, still_config);
+  float x = 0, y, px, py;
+  for (int step = 0; step <= 20; step++) touchFilterUpdate(filter, step * 5, 100, step * 10, x, y);
+  touchFilterPredict(filter, px, py);
+  CHECK_EQ(px, x);
+  CHECK_EQ(py, y);
+}
+
+static void testResetStartsOver() {
+  TouchFilter filter;
+  touchFilterInit(filter, list_config);
+  float x, y;
+  touchFilterUpdate(filter, 10, 10, 0, x, y);
+  touchFilterUpdate(filter, 50, 10, 10, x, y);
+  touchFilterReset(filter);
+  CHECK(!filter.initialized);
+  touchFilterUpdate(filter, 300, 300, 20, x, y);
+  CHECK_EQ(x, 300);
+  CHECK_EQ(filter.x.velocity, 0);
+}
+
+int main() {
+  RUN(testFirstSampleTakenAsIs);
+  RUN(testStillFingerSmoothsJitter);
+  RUN(testFastMotionKeepsUp);
+  RUN(testRepeatedTimestampIgnored);
+  RUN(testPredictionLeadsAndCaps);
+  RUN(testStillConfigDoesNotPredict);
+  RUN(testResetStartsOver);
+  return testSummary();
+}
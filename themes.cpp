@@ -39,6 +39,13 @@ ThemeColors yugo_wakfu_theme = {
 
 ThemeColors* current_theme = &luffy_gear5_theme;
 
+// Dark variant: the faces keep their colours but drop the lit backgrounds
+static bool theme_dark = false;
+
+static uint16_t backdrop(uint16_t light, uint16_t dark) {
+  return theme_dark ? dark : light;
+}
+
 void initializeThemes() {
   current_theme = &luffy_gear5_theme;
 }
@@ -61,11 +68,19 @@ ThemeColors* getCurrentTheme() {
   return current_theme;
 }
 
+void setThemeDark(bool dark) {
+  theme_dark = dark;
+}
+
+bool isThemeDark() {
+  return theme_dark;
+}
+
 void drawLuffyWatchFace() {
   clearDisplay();
   
   // Background gradient (black to cream)
-  drawGradient(0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT, COLOR_BLACK, LUFFY_CREAM, false);
+  drawGradient(0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT, COLOR_BLACK, backdrop(LUFFY_CREAM, LUFFY_SHADOW), false);
   
   // Main time display
   time_t now = time(nullptr);
@@ -113,7 +128,7 @@ void drawJinwooWatchFace() {
   clearDisplay();
   
   // Dark background with purple gradient
-  drawGradient(0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT, COLOR_BLACK, JINWOO_DARK, true);
+  if (!theme_dark) drawGradient(0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT, COLOR_BLACK, JINWOO_DARK, true);
   
   // Time display
   time_t now = time(nullptr);
@@ -149,7 +164,7 @@ void drawYugoWatchFace() {
   clearDisplay();
   
   // Energy portal background
-  drawGradient(0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT, COLOR_BLACK, YUGO_BLUE, false);
+  drawGradient(0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT, COLOR_BLACK, backdrop(YUGO_BLUE, 0x000A), false);
   
   // Time display
   time_t now = time(nullptr);
@@ -20,6 +20,8 @@ extern ThemeColors* current_theme;
 void initializeThemes();
 void setTheme(ThemeType theme);
 ThemeColors* getCurrentTheme();
+void setThemeDark(bool dark);    // Darker backgrounds, for the display limiter
+bool isThemeDark();
 
 // Theme-specific watch faces
 void drawLuffyWatchFace();
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+"""Convert an I2C trace dump from the watch's Serial log to Chrome trace JSON.
+
+Capture the Serial output after sending 't' to the watch, then run:
+
+    python3 tools/i2c_trace_to_chrome.py serial.log -o i2c_trace.json
+
+Open the result in chrome://tracing or https://ui.perfetto.dev. Each
+device gets its own track on its bus, and each transfer shows as a slice
+labelled with its register, direction and the subsystem that issued it.
+"""
+
+import argparse
+import csv
+import json
+import sys
+
+# Matches I2CBusId / the device table in i2c_bus.cpp
+DEVICE_BUS = {"touch": "Wire (touch)", "imu": "Wire1 (shared)",
+              "rtc": "Wire1 (shared)", "pmic": "Wire1 (shared)"}
+
+FLAG_WRITE = 0x01
+FLAG_ERROR = 0x02
+FLAG_PROBE = 0x04
+
+
+def read_dumps(lines):
+    """Yield the CSV rows of every I2C_TRACE_BEGIN..END block."""
+    inside = False
+    for line in lines:
+        line = line.strip()
+        if line.startswith("I2C_TRACE_BEGIN"):
+            inside = True
+            continue
+        if line.startswith("I2C_TRACE_END"):
+            inside = False
+            continue
+        if inside and line and not line.startswith("start_us"):
+            yield line
+
+
+def to_events(rows):
+    events = []
+    last_start = None
+    wrap_offset = 0
+    for row in csv.reader(rows):
+        if len(row) != 8:
+            continue
+        start_us, duration_us, device, address, reg, length, caller, flags = row
+        start = int(start_us) + wrap_offset
+        # micros() wraps every ~71 minutes
+        if last_start is not None and start < last_start - (1 << 31):
+            wrap_offset += 1 << 32
+            start += 1 << 32
+        last_start = start
+
+        flags = int(flags)
+        if flags & FLAG_PROBE:
+            name = "probe"
+        else:
+            direction = "write" if flags & FLAG_WRITE else "read"
+            name = "%s %s x%s" % (direction, reg, length)
+        if flags & FLAG_ERROR:
+            name += " (NAK)"
+
+        events.append({
+            "name": name,
+            "cat": caller,
+            "ph": "X",
+            "ts": start,
+            "dur": max(int(duration_us), 1),
+            "pid": DEVICE_BUS.get(device, "i2c"),
+            "tid": "%s %s" % (device, address),
+            "args": {"register": reg, "bytes": int(length),
+                     "caller": caller, "flags": flags},
+        })
+    return events
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("log", nargs="?", help="Serial log (default: stdin)")
+    parser.add_argument("-o", "--output", help="Output JSON (default: stdout)")
+    args = parser.parse_args()
+
+    source = open(args.log, errors="replace") if args.log else sys.stdin
+    with source:
+        events = to_events(read_dumps(source))
+
+    trace = {"traceEvents": events, "displayTimeUnit": "ms"}
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(trace, f)
+    else:
+        json.dump(trace, sys.stdout)
+    print("%d transfers converted" % len(events), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,235 @@
+#!/usr/bin/env python3
+"""Train the watch's activity decision tree from labelled IMU captures.
+
+Stream raw samples from the watch by sending 'i' over Serial, record one
+activity per capture, then train and write the tree header:
+
+    python3 tools/train_activity.py walking:walk.log running:run.log \\
+        stationary:desk.log cycling:bike.log other:chores.log \\
+        --output activity_tree.h
+
+Windows are cut and featurized exactly like activity.cpp (same integer
+math, same Goertzel table), so the thresholds carry over unchanged. Each
+capture is split into contiguous blocks and every fourth block is held
+out; the report shows held-out accuracy and the confusion matrix.
+"""
+
+import argparse
+import math
+import sys
+
+# Mirrors activity.h / activity.cpp
+WINDOW = 168
+HOP = 56
+GYRO_LSB_PER_DPS = 64
+GOERTZEL_COEFF = [32717, 32652, 32562, 32447, 32306, 32140, 31948, 31731,
+                  31490, 31223, 30932, 30617, 30278, 29915, 29529]
+FEATURES = ["FEATURE_MAGNITUDE_VARIANCE", "FEATURE_AXIS_ENERGY",
+            "FEATURE_DOMINANT_FREQ", "FEATURE_PERIODICITY", "FEATURE_GYRO_MEAN"]
+CLASSES = ["stationary", "walking", "running", "cycling", "other"]
+
+
+def cdiv(a, b):
+    """C integer division, truncating toward zero."""
+    q = abs(a) // abs(b)
+    return q if (a >= 0) == (b >= 0) else -q
+
+
+def vector_length(x, y, z):
+    return math.isqrt(x * x + y * y + z * z)
+
+
+def extract_features(window):
+    count = len(window)
+    magnitude = []
+    axis_sum = [0, 0, 0]
+    axis_square = [0, 0, 0]
+    gyro_sum = 0
+    for ax, ay, az, gx, gy, gz in window:
+        magnitude.append(vector_length(ax, ay, az) >> 3)
+        for axis, value in enumerate((ax, ay, az)):
+            a = value >> 3
+            axis_sum[axis] += a
+            axis_square[axis] += a * a
+        gyro_sum += vector_length(gx, gy, gz)
+
+    mean = sum(magnitude) // count
+    magnitude = [m - mean for m in magnitude]
+    variance_sum = sum(m * m for m in magnitude)
+
+    axis_energy = 0
+    for axis in range(3):
+        axis_mean = cdiv(axis_sum[axis], count)
+        axis_energy += axis_square[axis] // count - axis_mean * axis_mean
+
+    best_bin, best_power = 0, 0
+    for b, coeff in enumerate(GOERTZEL_COEFF):
+        s1 = s2 = 0
+        for m in magnitude:
+            s1, s2 = m + ((coeff * s1) >> 14) - s2, s1
+        power = s1 * s1 + s2 * s2 - ((coeff * s1) >> 14) * s2
+        if power > best_power:
+            best_bin, best_power = b, power
+
+    periodicity = best_power * 200 // (count * variance_sum) if variance_sum > 0 else 0
+    return [variance_sum // count, axis_energy, 50 + 25 * best_bin,
+            min(periodicity, 100), gyro_sum // count // GYRO_LSB_PER_DPS]
+
+
+def read_capture(path):
+    samples = []
+    with open(path, errors="replace") as f:
+        for line in f:
+            parts = line.strip().split(",")
+            if len(parts) == 8 and parts[0] == "imu":
+                samples.append(tuple(int(v) for v in parts[2:]))
+    return samples
+
+
+def windows_of(samples):
+    for end in range(WINDOW, len(samples) + 1, HOP):
+        yield samples[end - WINDOW:end]
+
+
+# ==================== CART ====================
+def gini(labels):
+    total = len(labels)
+    if total == 0:
+        return 0.0
+    counts = {}
+    for label in labels:
+        counts[label] = counts.get(label, 0) + 1
+    return 1.0 - sum((c / total) ** 2 for c in counts.values())
+
+
+def majority(labels):
+    return max(set(labels), key=labels.count)
+
+
+def best_split(rows, labels, min_leaf):
+    best = None
+    parent = gini(labels)
+    for feature in range(len(FEATURES)):
+        values = sorted(set(row[feature] for row in rows))
+        for low, high in zip(values, values[1:]):
+            threshold = (low + high + 1) // 2
+            left = [l for r, l in zip(rows, labels) if r[feature] < threshold]
+            right = [l for r, l in zip(rows, labels) if r[feature] >= threshold]
+            if len(left) < min_leaf or len(right) < min_leaf:
+                continue
+            score = (len(left) * gini(left) + len(right) * gini(right)) / len(labels)
+            if parent - score > 1e-9 and (best is None or score < best[0]):
+                best = (score, feature, threshold)
+    return best
+
+
+def build_tree(rows, labels, depth, max_depth, min_leaf, nodes):
+    index = len(nodes)
+    nodes.append(None)
+    split = None if depth >= max_depth or len(set(labels)) == 1 else best_split(rows, labels, min_leaf)
+    if split is None:
+        nodes[index] = (-1, majority(labels), 0, 0)
+        return index
+    _, feature, threshold = split
+    left = [(r, l) for r, l in zip(rows, labels) if r[feature] < threshold]
+    right = [(r, l) for r, l in zip(rows, labels) if r[feature] >= threshold]
+    left_index = build_tree([r for r, _ in left], [l for _, l in left], depth + 1, max_depth, min_leaf, nodes)
+    right_index = build_tree([r for r, _ in right], [l for _, l in right], depth + 1, max_depth, min_leaf, nodes)
+    nodes[index] = (feature, threshold, left_index, right_index)
+    return index
+
+
+def classify(nodes, features):
+    node = 0
+    while nodes[node][0] >= 0:
+        feature, threshold, left, right = nodes[node]
+        node = left if features[feature] < threshold else right
+    return nodes[node][1]
+
+
+def write_header(nodes, path, sources):
+    lines = [
+        "/*",
+        " * Activity Decision Tree",
+        " * Regenerate with: python3 tools/train_activity.py --output activity_tree.h ...",
+        " *",
+        " * Trained on: " + ", ".join(sources),
+        " */",
+        "",
+        "#ifndef ACTIVITY_TREE_H",
+        "#define ACTIVITY_TREE_H",
+        "",
+        '#include "activity.h"',
+        "",
+        "static constexpr ActivityTreeNode ACTIVITY_TREE[] = {",
+    ]
+    for i, (feature, threshold, left, right) in enumerate(nodes):
+        if feature < 0:
+            entry = "{-1, ACTIVITY_%s, 0, 0}," % threshold.upper()
+        else:
+            entry = "{%s, %d, %d, %d}," % (FEATURES[feature], threshold, left, right)
+        lines.append("  %-45s  // %d" % (entry, i))
+    lines += ["};", "", "#endif // ACTIVITY_TREE_H"]
+    with open(path, "w") as f:
+        f.write("\n".join(lines))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("captures", nargs="+", help="label:path pairs, label in " + "/".join(CLASSES))
+    parser.add_argument("--output", help="Tree header to write (default: report only)")
+    parser.add_argument("--max-depth", type=int, default=4)
+    parser.add_argument("--min-leaf", type=int, default=5)
+    parser.add_argument("--block", type=int, default=10, help="Windows per train/test block")
+    parser.add_argument("--features-csv", help="Also dump every window's features")
+    args = parser.parse_args()
+
+    train_rows, train_labels, test_rows, test_labels = [], [], [], []
+    all_rows = []
+    for capture in args.captures:
+        label, _, path = capture.partition(":")
+        if label not in CLASSES or not path:
+            parser.error("bad capture '%s', expected label:path" % capture)
+        samples = read_capture(path)
+        features = [extract_features(w) for w in windows_of(samples)]
+        print("%-10s %6d samples %5d windows  %s" % (label, len(samples), len(features), path), file=sys.stderr)
+        for i, row in enumerate(features):
+            all_rows.append((label, row))
+            if (i // args.block) % 4 == 3:
+                test_rows.append(row)
+                test_labels.append(label)
+            else:
+                train_rows.append(row)
+                train_labels.append(label)
+
+    if not train_rows:
+        parser.error("no windows found, were the captures streamed with 'i'?")
+
+    if args.features_csv:
+        with open(args.features_csv, "w") as f:
+            f.write("label," + ",".join(FEATURES) + "\n")
+            for label, row in all_rows:
+                f.write(label + "," + ",".join(str(v) for v in row) + "\n")
+
+    nodes = []
+    build_tree(train_rows, train_labels, 0, args.max_depth, args.min_leaf, nodes)
+
+    if test_rows:
+        confusion = {a: {b: 0 for b in CLASSES} for a in CLASSES}
+        for row, label in zip(test_rows, test_labels):
+            confusion[label][classify(nodes, row)] += 1
+        correct = sum(confusion[c][c] for c in CLASSES)
+        print("held-out accuracy: %.1f%% (%d/%d windows)" %
+              (100.0 * correct / len(test_rows), correct, len(test_rows)))
+        print("%-10s " % "true\\pred" + " ".join("%10s" % c for c in CLASSES))
+        for a in CLASSES:
+            print("%-10s " % a + " ".join("%10d" % confusion[a][b] for b in CLASSES))
+
+    print("%d nodes" % len(nodes))
+    if args.output:
+        write_header(nodes, args.output, [c.partition(":")[2] for c in args.captures])
+        print("wrote %s" % args.output)
+
+
+if __name__ == "__main__":
+    main()
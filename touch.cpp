@@ -5,6 +5,10 @@
 
 #include "touch.h"
 #include "config.h"
+#include "gestures.h"
+#include "touch_filter.h"
+#include "i2c_bus.h"
+#include "i2c_trace.h"
 
 // Touch calibration data
 struct TouchCalibration {
@@ -18,15 +22,53 @@ static int last_touch_x = -1;
 static int last_touch_y = -1;
 static unsigned long touch_start_time = 0;
 static bool touch_pressed = false;
-static int digital_crown_value = 0;
+
+// FT3168 register map
+#define FT3168_REG_TD_STATUS 0x02   // Touch count, followed by point records
+#define FT3168_POINT_SIZE 6         // XH, XL, YH, YL, weight, area
+
+// Contacts, gesture engine and pinch, plus the digital crown scroller
+static TouchSession touch_session;
+static KineticScroller crown_scroller;
+
+// Position smoothing for the primary finger
+static TouchFilter touch_filter;
+static float predicted_x = 0;
+static float predicted_y = 0;
+
+// Per-screen filter tuning: lists and panning get prediction to hide
+// the frame of render latency, pages that only take taps and swipes just
+// smooth jitter. A new screen must pick a row here to build.
+#define FILTER_STILL {1.0f, 0.03f, 1.0f, 0.0f}
+#define FILTER_LIST {1.0f, 0.05f, 1.0f, 16.0f}
+#define FILTER_PAN {0.8f, 0.05f, 1.0f, 24.0f}
+
+static const TouchFilterConfig screen_filter_configs[] = {
+  FILTER_STILL,   // SCREEN_SPLASH
+  FILTER_STILL,   // SCREEN_WATCHFACE
+  FILTER_LIST,    // SCREEN_APP_GRID
+  FILTER_LIST,    // SCREEN_MUSIC
+  FILTER_LIST,    // SCREEN_NOTES
+  FILTER_LIST,    // SCREEN_QUESTS
+  FILTER_STILL,   // SCREEN_SETTINGS
+  FILTER_PAN,     // SCREEN_PDF_READER
+  FILTER_LIST,    // SCREEN_FILE_BROWSER
+  FILTER_STILL,   // SCREEN_SLEEP
+  FILTER_STILL,   // SCREEN_CHARGING
+  FILTER_STILL,   // SCREEN_ACTIVITY, pages by swipe
+  FILTER_STILL,   // SCREEN_SLEEP_REPORT
+  FILTER_STILL    // SCREEN_ENERGY
+};
+static_assert(ARRAY_SIZE(screen_filter_configs) == SCREEN_COUNT, "every screen needs touch filter tuning");
+
+static const TouchFilterConfig& getScreenFilterConfig(ScreenType screen) {
+  if (screen < 0 || screen >= SCREEN_COUNT) return screen_filter_configs[SCREEN_WATCHFACE];
+  return screen_filter_configs[screen];
+}
 
 bool initializeTouch() {
   Serial.println("Initializing touch controller...");
   
-  // Initialize I2C for touch controller
-  Wire1.begin(TOUCH_SDA, TOUCH_SCL);
-  Wire1.setClock(400000); // 400kHz
-  
   // Reset touch controller
   pinMode(TOUCH_RST, OUTPUT);
   digitalWrite(TOUCH_RST, LOW);
@@ -40,9 +82,14 @@ bool initializeTouch() {
   // Load touch calibration
   loadTouchCalibration();
   
+  // Reset gesture recognition (crown is unbounded)
+  touchSessionReset(touch_session);
+  touchFilterInit(touch_filter, getScreenFilterConfig(SCREEN_WATCHFACE));
+  scrollerInit(crown_scroller, -1e6, 1e6);
+  crown_scroller.position = 0;
+  
   // Test touch controller communication
-  Wire1.beginTransmission(0x38); // FT3168 I2C address
-  if (Wire1.endTransmission() != 0) {
+  if (!i2cProbe(I2C_DEV_TOUCH)) {
     Serial.println("Touch controller not found!");
     return false;
   }
@@ -51,117 +98,176 @@ bool initializeTouch() {
   return true;
 }
 
-TouchGesture handleTouchInput() {
-  TouchGesture gesture = {TOUCH_NONE, 0, 0, 0, 0, 0, 0, millis(), 0, false};
+static TouchGesture toTouchGesture(const GestureEventData& event) {
+  TouchGesture gesture = {TOUCH_NONE, 0, 0, 0, 0, 0, 0, event.timestamp, event.duration, 0, 0, 1.0f, 0, 0, 0, false};
+  
+  switch (event.type) {
+    case GESTURE_PRESS:      gesture.event = TOUCH_PRESS; break;
+    case GESTURE_DRAG:       gesture.event = TOUCH_MOVE; break;
+    case GESTURE_RELEASE:    gesture.event = TOUCH_RELEASE; break;
+    case GESTURE_TAP:        gesture.event = TOUCH_TAP; break;
+    case GESTURE_DOUBLE_TAP: gesture.event = TOUCH_DOUBLE_TAP; break;
+    case GESTURE_LONG_PRESS: gesture.event = TOUCH_LONG_PRESS; break;
+    case GESTURE_PINCH:      gesture.event = TOUCH_PINCH; break;
+    case GESTURE_ROTATE:     gesture.event = TOUCH_ROTATE; break;
+    case GESTURE_FLING:
+      // A fling is reported as a swipe in its dominant direction
+      if (fabsf(event.vx) > fabsf(event.vy)) {
+        gesture.event = (event.vx > 0) ? TOUCH_SWIPE_RIGHT : TOUCH_SWIPE_LEFT;
+      } else {
+        gesture.event = (event.vy > 0) ? TOUCH_SWIPE_DOWN : TOUCH_SWIPE_UP;
+      }
+      break;
+    default:
+      return gesture;
+  }
   
+  gesture.x = event.x;
+  gesture.y = event.y;
+  gesture.start_x = event.start_x;
+  gesture.start_y = event.start_y;
+  if (event.type == GESTURE_DRAG) {
+    // Moves report the step since the previous sample
+    gesture.start_x = event.x - event.dx;
+    gesture.start_y = event.y - event.dy;
+  }
+  gesture.end_x = event.x;
+  gesture.end_y = event.y;
+  gesture.velocity_x = event.vx * 1000.0f;
+  gesture.velocity_y = event.vy * 1000.0f;
+  gesture.scale = event.scale;
+  gesture.rotation = event.rotation;
+  gesture.is_valid = true;
+  return gesture;
+}
+
+static GestureEventData releaseAllPoints(unsigned long now) {
+  touch_filter.initialized = false;
+  return touchSessionRelease(touch_session, now);
+}
+
+static GestureEventData readTouchSample(unsigned long now) {
   // Check if touch interrupt is active
   if (digitalRead(TOUCH_INT) == HIGH) {
-    return gesture; // No touch detected
+    // No finger on the panel: finish any touch or pinch in progress
+    return releaseAllPoints(now);
   }
   
-  // Read touch data from FT3168
-  Wire1.beginTransmission(0x38);
-  Wire1.write(0x00); // Status register
-  Wire1.endTransmission();
-  
-  Wire1.requestFrom(0x38, 6);
-  if (Wire1.available() < 6) {
-    return gesture;
+  // Read status plus both touch point records from FT3168 in one burst
+  uint8_t data[1 + FT3168_POINT_SIZE * GESTURE_MAX_POINTS];
+  if (!i2cReadRegs(I2C_DEV_TOUCH, FT3168_REG_TD_STATUS, data, sizeof(data))) {
+    return gestureTick(touch_session.tracker, now);
   }
   
-  uint8_t status = Wire1.read();
-  uint8_t touch_count = status & 0x0F;
+  int touch_count = data[0] & 0x0F;
+  if (touch_count > GESTURE_MAX_POINTS) touch_count = GESTURE_MAX_POINTS;
   
   if (touch_count == 0) {
-    // Touch released
-    if (touch_pressed) {
-      touch_pressed = false;
-      unsigned long touch_duration = millis() - touch_start_time;
-      
-      gesture.event = TOUCH_RELEASE;
-      gesture.x = last_touch_x;
-      gesture.y = last_touch_y;
-      gesture.start_x = last_touch_x;
-      gesture.start_y = last_touch_y;
-      gesture.end_x = last_touch_x;
-      gesture.end_y = last_touch_y;
-      gesture.duration = touch_duration;
-      gesture.is_valid = true;
-      
-      // Determine gesture type based on duration
-      if (touch_duration > 800) {
-        gesture.event = TOUCH_LONG_PRESS;
-      } else if (touch_duration < 200) {
-        gesture.event = TOUCH_TAP;
-      }
-    }
-    return gesture;
+    return releaseAllPoints(now);
+  }
+  
+  // Parse touch point records: XH[7:6]=event, YH[7:4]=touch ID
+  TouchPoint raw_points[GESTURE_MAX_POINTS];
+  for (int i = 0; i < touch_count; i++) {
+    const uint8_t* record = &data[1 + i * FT3168_POINT_SIZE];
+    int raw_x = ((record[0] & 0x0F) << 8) | record[1];
+    int raw_y = ((record[2] & 0x0F) << 8) | record[3];
+    
+    // Apply calibration
+    int touch_x = map(raw_x, touch_cal.min_x, touch_cal.max_x, 0, DISPLAY_WIDTH);
+    int touch_y = map(raw_y, touch_cal.min_y, touch_cal.max_y, 0, DISPLAY_HEIGHT);
+    
+    // Constrain to display bounds
+    raw_points[i].x = constrain(touch_x, 0, DISPLAY_WIDTH - 1);
+    raw_points[i].y = constrain(touch_y, 0, DISPLAY_HEIGHT - 1);
+    raw_points[i].hw_id = (record[2] >> 4) & 0x0F;
+    raw_points[i].id = -1;
   }
   
-  // Read touch coordinates
-  uint8_t x_high = Wire1.read();
-  uint8_t x_low = Wire1.read();
-  uint8_t y_high = Wire1.read();
-  uint8_t y_low = Wire1.read();
-  uint8_t pressure = Wire1.read();
+  GestureEventData event;
+  if (!touchSessionContacts(touch_session, raw_points, touch_count, now, event)) {
+    // Two fingers, or one left over from them: no smoothing for the pinch
+    touch_filter.initialized = false;
+    return event;
+  }
   
-  int raw_x = ((x_high & 0x0F) << 8) | x_low;
-  int raw_y = ((y_high & 0x0F) << 8) | y_low;
+  // Smooth the primary finger, retuned for the screen on each new touch
+  if (!touch_filter.initialized) {
+    touchFilterInit(touch_filter, getScreenFilterConfig(system_state.current_screen));
+  }
+  float filtered_x, filtered_y;
+  const TouchPoint& primary = touch_session.points[0];
+  touchFilterUpdate(touch_filter, primary.x, primary.y, now, filtered_x, filtered_y);
   
-  // Apply calibration
-  int touch_x = map(raw_x, touch_cal.min_x, touch_cal.max_x, 0, DISPLAY_WIDTH);
-  int touch_y = map(raw_y, touch_cal.min_y, touch_cal.max_y, 0, DISPLAY_HEIGHT);
+  event = gestureTouchDown(touch_session.tracker, (int)(filtered_x + 0.5f), (int)(filtered_y + 0.5f), now);
+  if (event.type == GESTURE_NONE) {
+    // Still inside the touch slop: only timeouts can fire
+    event = gestureTick(touch_session.tracker, now);
+  }
+  return event;
+}
+
+TouchGesture handleTouchInput() {
+  unsigned long now = millis();
+  unsigned long sample_us = micros(); // Latency stamp for this raw sample
+  I2CCaller previous_caller = i2cTraceSetCaller(I2C_CALLER_TOUCH);
+  GestureEventData event = readTouchSample(now);
+  i2cTraceSetCaller(previous_caller);
   
-  // Constrain to display bounds
-  touch_x = constrain(touch_x, 0, DISPLAY_WIDTH - 1);
-  touch_y = constrain(touch_y, 0, DISPLAY_HEIGHT - 1);
+  switch (event.type) {
+    case GESTURE_PRESS:
+      touch_pressed = true;
+      touch_start_time = now;
+      scrollerBeginDrag(crown_scroller, now);
+      break;
+    case GESTURE_DRAG:
+      // Digital crown follows vertical drags
+      scrollerDrag(crown_scroller, event.dy);
+      break;
+    case GESTURE_PINCH:
+    case GESTURE_ROTATE:
+      // Two fingers are not a crown gesture
+      scrollerRelease(crown_scroller, 0, now);
+      break;
+    case GESTURE_FLING:
+    case GESTURE_RELEASE:
+    case GESTURE_TAP:
+    case GESTURE_DOUBLE_TAP:
+      touch_pressed = false;
+      // Crown keeps coasting with the finger's release velocity
+      scrollerRelease(crown_scroller, event.vy, now);
+      break;
+    default:
+      break;
+  }
   
-  if (!touch_pressed) {
-    // New touch started
-    touch_pressed = true;
-    touch_start_time = millis();
-    last_touch_x = touch_x;
-    last_touch_y = touch_y;
-    
-    gesture.event = TOUCH_PRESS;
-    gesture.x = touch_x;
-    gesture.y = touch_y;
-    gesture.start_x = touch_x;
-    gesture.start_y = touch_y;
-    gesture.is_valid = true;
-  } else {
-    // Touch moved
-    int dx = touch_x - last_touch_x;
-    int dy = touch_y - last_touch_y;
-    
-    if (abs(dx) > 5 || abs(dy) > 5) {
-      gesture.event = TOUCH_MOVE;
-      gesture.x = touch_x;
-      gesture.y = touch_y;
-      gesture.start_x = last_touch_x;
-      gesture.start_y = last_touch_y;
-      gesture.end_x = touch_x;
-      gesture.end_y = touch_y;
-      gesture.is_valid = true;
-      
-      // Update digital crown simulation for vertical scrolling
-      digital_crown_value += dy;
-      
-      // Check for swipe gestures
-      unsigned long touch_duration = millis() - touch_start_time;
-      if (touch_duration > 100 && touch_duration < 500) {
-        if (abs(dx) > abs(dy) && abs(dx) > 50) {
-          gesture.event = (dx > 0) ? TOUCH_SWIPE_RIGHT : TOUCH_SWIPE_LEFT;
-        } else if (abs(dy) > abs(dx) && abs(dy) > 50) {
-          gesture.event = (dy > 0) ? TOUCH_SWIPE_DOWN : TOUCH_SWIPE_UP;
-        }
-      }
-      
-      last_touch_x = touch_x;
-      last_touch_y = touch_y;
-    }
+  if (event.type != GESTURE_NONE) {
+    last_touch_x = event.x;
+    last_touch_y = event.y;
   }
   
+  scrollerUpdate(crown_scroller, now);
+  
+  TouchGesture gesture = toTouchGesture(event);
+  if (event.type == GESTURE_PRESS) {
+    predicted_x = event.x;
+    predicted_y = event.y;
+  } else if (event.type == GESTURE_DRAG && touch_filter.config.predict_ms > 0) {
+    // Moves lead the finger; steps chain from the last predicted point
+    // so consumers summing deltas still land on the finger
+    float lead_x, lead_y;
+    touchFilterPredict(touch_filter, lead_x, lead_y);
+    lead_x = constrain(lead_x, 0, DISPLAY_WIDTH - 1);
+    lead_y = constrain(lead_y, 0, DISPLAY_HEIGHT - 1);
+    gesture.start_x = (int)(predicted_x + 0.5f);
+    gesture.start_y = (int)(predicted_y + 0.5f);
+    gesture.x = gesture.end_x = (int)(lead_x + 0.5f);
+    gesture.y = gesture.end_y = (int)(lead_y + 0.5f);
+    predicted_x = lead_x;
+    predicted_y = lead_y;
+  }
+  gesture.sample_us = sample_us;
+  gesture.recognized_us = micros();
   return gesture;
 }
 
@@ -169,11 +275,52 @@ bool isTouchPressed() {
   return touch_pressed;
 }
 
+int getTouchPointCount() {
+  return touch_session.count;
+}
+
 void getTouchPosition(int& x, int& y) {
   x = last_touch_x;
   y = last_touch_y;
 }
 
+TouchGesture touchGestureFromIMU(IMUGestureType gesture) {
+  // Flicks scroll like a swipe across the middle of the screen, a shake
+  // backs out of the screen, a double wrist tap lands in the centre
+  const int cx = DISPLAY_WIDTH / 2, cy = DISPLAY_HEIGHT / 2, reach = 100;
+  const float speed = 1000.0f;  // px/s, a brisk fling
+  TouchGesture result = {TOUCH_NONE, cx, cy, cx, cy, cx, cy, millis(), 0, 0, 0, 1.0f, 0, 0, 0, false};
+  
+  switch (gesture) {
+    case IMU_GESTURE_FLICK_IN:
+      result.event = TOUCH_SWIPE_UP;
+      result.start_y = cy + reach;
+      result.end_y = cy - reach;
+      result.velocity_y = -speed;
+      break;
+    case IMU_GESTURE_FLICK_OUT:
+      result.event = TOUCH_SWIPE_DOWN;
+      result.start_y = cy - reach;
+      result.end_y = cy + reach;
+      result.velocity_y = speed;
+      break;
+    case IMU_GESTURE_DOUBLE_TAP:
+      result.event = TOUCH_DOUBLE_TAP;
+      break;
+    case IMU_GESTURE_SHAKE:
+      result.event = TOUCH_BACK;
+      break;
+    default:
+      return result;
+  }
+  
+  result.x = result.end_x;
+  result.y = result.end_y;
+  result.sample_us = result.recognized_us = micros();
+  result.is_valid = true;
+  return result;
+}
+
 TouchEvent recognizeGesture(int start_x, int start_y, int end_x, int end_y, unsigned long duration) {
   int dx = end_x - start_x;
   int dy = end_y - start_y;
@@ -238,9 +385,11 @@ void loadTouchCalibration() {
 }
 
 int getDigitalCrownValue() {
-  return digital_crown_value;
+  return (int)crown_scroller.position;
 }
 
 void resetDigitalCrown() {
-  digital_crown_value = 0;
+  crown_scroller.position = 0;
+  crown_scroller.velocity = 0;
+  crown_scroller.animating = false;
 }
\ No newline at end of file
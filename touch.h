@@ -8,6 +8,7 @@
 
 #include "config.h"
 #include <Wire.h>
+#include "imu_gestures.h"
 
 // Touch event types
 enum TouchEvent {
@@ -21,7 +22,10 @@ enum TouchEvent {
   TOUCH_SWIPE_RIGHT,
   TOUCH_TAP,
   TOUCH_DOUBLE_TAP,
-  TOUCH_LONG_PRESS
+  TOUCH_LONG_PRESS,
+  TOUCH_PINCH,
+  TOUCH_ROTATE,
+  TOUCH_BACK          // Leave the current screen, from a wrist shake
 };
 
 // Touch gesture structure
@@ -32,6 +36,11 @@ struct TouchGesture {
   int end_x, end_y;
   unsigned long timestamp;
   unsigned long duration;
+  float velocity_x, velocity_y; // px/s, set on drags and swipes
+  float scale;                  // Pinch span relative to its start
+  float rotation;               // Pinch rotation in degrees
+  unsigned long sample_us;      // micros() when the raw sample was read
+  unsigned long recognized_us;  // micros() when the gesture was recognized
   bool is_valid;
 };
 
@@ -42,6 +51,10 @@ bool initializeTouch();
 TouchGesture handleTouchInput();
 bool isTouchPressed();
 void getTouchPosition(int& x, int& y);
+int getTouchPointCount();
+
+// Wrist gestures from the IMU, dressed as the touch events they stand for
+TouchGesture touchGestureFromIMU(IMUGestureType gesture);
 
 // Gesture recognition
 TouchEvent recognizeGesture(int start_x, int start_y, int end_x, int end_y, unsigned long duration);
@@ -0,0 +1,77 @@
+/*
+ * Touch Position Filter Implementation
+ * 1-euro filter per axis plus linear prediction
+ */
+
+#include "touch_filter.h"
+#include <math.h>
+
+#define TOUCH_FILTER_PI 3.14159265f
+
+// Smoothing factor of a first-order low-pass for a cutoff and time step
+static float lowPassAlpha(float cutoff, float dt) {
+  float tau = 1.0f / (2.0f * TOUCH_FILTER_PI * cutoff);
+  return 1.0f / (1.0f + tau / dt);
+}
+
+static void filterAxis(TouchFilterAxis& axis, const TouchFilterConfig& config, float raw, float dt) {
+  // Speed from raw steps, smoothed with its own fixed cutoff. Using the
+  // filtered value here would fold the filter lag into the speed and make
+  // prediction overshoot.
+  float raw_velocity = (raw - axis.last_raw) / dt;
+  axis.last_raw = raw;
+  float d_alpha = lowPassAlpha(config.d_cutoff, dt);
+  axis.velocity += d_alpha * (raw_velocity - axis.velocity);
+
+  // Faster motion opens the cutoff to cut lag
+  float cutoff = config.min_cutoff + config.beta * fabsf(axis.velocity);
+  float alpha = lowPassAlpha(cutoff, dt);
+  axis.value += alpha * (raw - axis.value);
+}
+
+void touchFilterInit(TouchFilter& filter, const TouchFilterConfig& config) {
+  filter.config = config;
+  touchFilterReset(filter);
+}
+
+void touchFilterReset(TouchFilter& filter) {
+  filter.x.value = filter.x.velocity = filter.x.last_raw = 0;
+  filter.y.value = filter.y.velocity = filter.y.last_raw = 0;
+  filter.last_time = 0;
+  filter.initialized = false;
+}
+
+void touchFilterUpdate(TouchFilter& filter, float raw_x, float raw_y, unsigned long now,
+                       float& out_x, float& out_y) {
+  if (!filter.initialized) {
+    // First contact is taken as-is
+    filter.x.value = filter.x.last_raw = raw_x;
+    filter.y.value = filter.y.last_raw = raw_y;
+    filter.x.velocity = filter.y.velocity = 0;
+    filter.last_time = now;
+    filter.initialized = true;
+  } else if (now != filter.last_time) {
+    float dt = (now - filter.last_time) / 1000.0f;
+    filterAxis(filter.x, filter.config, raw_x, dt);
+    filterAxis(filter.y, filter.config, raw_y, dt);
+    filter.last_time = now;
+  }
+
+  out_x = filter.x.value;
+  out_y = filter.y.value;
+}
+
+void touchFilterPredict(const TouchFilter& filter, float& out_x, float& out_y) {
+  float lead_x = filter.x.velocity * filter.config.predict_ms / 1000.0f;
+  float lead_y = filter.y.velocity * filter.config.predict_ms / 1000.0f;
+
+  // Never extrapolate further than a fingertip
+  float lead = sqrtf(lead_x * lead_x + lead_y * lead_y);
+  if (lead > TOUCH_FILTER_MAX_PREDICT_PX) {
+    lead_x *= TOUCH_FILTER_MAX_PREDICT_PX / lead;
+    lead_y *= TOUCH_FILTER_MAX_PREDICT_PX / lead;
+  }
+
+  out_x = filter.x.value + lead_x;
+  out_y = filter.y.value + lead_y;
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+/*
+ * Touch Position Filter for ESP32-S3 Watch
+ * Adaptive 1-euro smoothing with short-horizon motion prediction
+ *
+ * Slow fingers get a low cutoff so jitter disappears, fast fingers raise
+ * the cutoff so the filter adds almost no lag. The filtered velocity also
+ * extrapolates the position a few milliseconds ahead to hide render
+ * latency. Pure math on timestamps, so noisy traces can be replayed on host.
+ */
+
+#ifndef TOUCH_FILTER_H
+#define TOUCH_FILTER_H
+
+#include <stdint.h>
+
+// Filter tuning, one set per screen
+struct TouchFilterConfig {
+  float min_cutoff;   // Hz, cutoff when the finger is still
+  float beta;         // Cutoff increase per px/s of speed
+  float d_cutoff;     // Hz, cutoff for the speed estimate
+  float predict_ms;   // Prediction horizon, 0 disables prediction
+};
+
+// One filtered axis
+struct TouchFilterAxis {
+  float value;
+  float velocity;     // px/s, low-passed
+  float last_raw;
+};
+
+struct TouchFilter {
+  TouchFilterConfig config;
+  TouchFilterAxis x, y;
+  unsigned long last_time;
+  bool initialized;
+};
+
+#define TOUCH_FILTER_MAX_PREDICT_PX 40  // Cap on prediction distance
+
+// Filter management
+void touchFilterInit(TouchFilter& filter, const TouchFilterConfig& config);
+void touchFilterReset(TouchFilter& filter);
+
+// Feed a raw sample, returns the smoothed position
+void touchFilterUpdate(TouchFilter& filter, float raw_x, float raw_y, unsigned long now,
+                       float& out_x, float& out_y);
+
+// Smoothed position extrapolated by the configured horizon
+void touchFilterPredict(const TouchFilter& filter, float& out_x, float& out_y);
+
+#endif // TOUCH_FILTER_H
\ No newline at end of file
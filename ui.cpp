@@ -7,16 +7,26 @@
 #include "display.h"
 #include "themes.h"
 #include "apps.h"
+#include "quests.h"
+#include "gestures.h"
 
 // UI state variables
 static ScreenType current_ui_screen = SCREEN_WATCHFACE;
 static bool loading_spinner_active = false;
 static String loading_message = "";
 
+// Kinetic scroller shared by list screens (only one list is visible at a time)
+static KineticScroller list_scroller;
+
+// Touch regions of the frame currently on screen
+static HitIndex ui_hit_index;
+
 void initializeUI() {
   Serial.println("Initializing UI system...");
   current_ui_screen = SCREEN_WATCHFACE;
   loading_spinner_active = false;
+  scrollerInit(list_scroller, 0, 0);
+  hitIndexInit(ui_hit_index, DISPLAY_WIDTH, DISPLAY_HEIGHT);
   Serial.println("UI system initialized");
 }
 
@@ -58,6 +68,15 @@ void drawCurrentScreen() {
     case SCREEN_CHARGING:
       showChargingAnimation();
       break;
+    case SCREEN_ACTIVITY:
+      drawActivityHistory();
+      break;
+    case SCREEN_SLEEP_REPORT:
+      drawSleepReport();
+      break;
+    case SCREEN_ENERGY:
+      drawEnergyReport();
+      break;
     default:
       drawWatchFace();
       break;
@@ -75,6 +94,7 @@ void drawButton(UIComponent& button) {
   
   fillRoundRect(button.x, button.y, button.width, button.height, 6, bg_color);
   drawRoundRect(button.x, button.y, button.width, button.height, 6, border_color);
+  addHitComponent(button);
   
   // Center text
   int text_x = button.x + (button.width - getTextWidth(button.text.c_str(), 1)) / 2;
@@ -135,6 +155,9 @@ void drawToggle(UIComponent& toggle) {
 }
 
 void handleUITouch(TouchGesture& gesture) {
+  // Components drawn with a callback act on their own
+  if (gesture.event == TOUCH_TAP && dispatchHitCallback(gesture)) return;
+  
   // Delegate touch handling based on current screen
   switch (current_ui_screen) {
     case SCREEN_APP_GRID:
@@ -144,11 +167,23 @@ void handleUITouch(TouchGesture& gesture) {
       handleMusicTouch(gesture);
       break;
     case SCREEN_QUESTS:
-      // Quest screen touch handling would go here
+      handleQuestTouch(gesture);
       break;
     case SCREEN_SETTINGS:
       handleSettingsTouch(gesture);
       break;
+    case SCREEN_PDF_READER:
+      handlePDFReaderTouch(gesture);
+      break;
+    case SCREEN_ACTIVITY:
+      handleActivityHistoryTouch(gesture);
+      break;
+    case SCREEN_SLEEP_REPORT:
+      handleSleepReportTouch(gesture);
+      break;
+    case SCREEN_ENERGY:
+      handleEnergyReportTouch(gesture);
+      break;
     default:
       break;
   }
@@ -167,6 +202,42 @@ void handleButtonPress(UIComponent& button) {
   }
 }
 
+// ==================== HIT TESTING ====================
+// Regions belong to the screen and app they were drawn for, so a tap that
+// lands before the next frame after a screen change hits nothing stale
+static int hitOwnerKey() {
+  return ((int)system_state.current_screen << 8) | (int)system_state.current_app;
+}
+
+void beginHitFrame() {
+  if (ui_hit_index.dropped > 0) {
+    Serial.println("Hit index full, dropped " + String(ui_hit_index.dropped) + " regions");
+  }
+  hitIndexClear(ui_hit_index, hitOwnerKey());
+}
+
+void addHitRegion(int x, int y, int width, int height, int tag, void (*callback)(void)) {
+  hitIndexAdd(ui_hit_index, x, y, width, height, tag, callback);
+}
+
+void addHitComponent(UIComponent& component) {
+  if (!component.visible || !component.enabled) return;
+  addHitRegion(component.x, component.y, component.width, component.height,
+               (int)component.type, component.callback);
+}
+
+const HitRegion* findHitRegion(TouchGesture& gesture) {
+  if (ui_hit_index.owner != hitOwnerKey()) return nullptr;
+  return hitIndexFind(ui_hit_index, gesture.x, gesture.y);
+}
+
+bool dispatchHitCallback(TouchGesture& gesture) {
+  const HitRegion* region = findHitRegion(gesture);
+  if (region == nullptr || region->callback == nullptr) return false;
+  region->callback();
+  return true;
+}
+
 void animateScreenTransition(ScreenType from, ScreenType to) {
   // Simple slide transition
   slideTransition(1, 300); // Slide left
@@ -251,6 +322,46 @@ void drawListItem(int x, int y, int width, const char* title, const char* subtit
   drawText(">", x + width - 20, y + 20, color, 1);
 }
 
+void handleListScroll(TouchGesture& gesture, int& scroll_offset) {
+  switch (gesture.event) {
+    case TOUCH_PRESS:
+      // Catch the list, stopping any fling in progress
+      list_scroller.position = scroll_offset;
+      scrollerBeginDrag(list_scroller, gesture.timestamp);
+      break;
+    case TOUCH_MOVE:
+      // Content follows the finger: dragging up moves further down the list
+      scrollerDrag(list_scroller, -(gesture.end_y - gesture.start_y));
+      break;
+    case TOUCH_RELEASE:
+    case TOUCH_TAP:
+    case TOUCH_SWIPE_UP:
+    case TOUCH_SWIPE_DOWN:
+    case TOUCH_SWIPE_LEFT:
+    case TOUCH_SWIPE_RIGHT:
+      scrollerRelease(list_scroller, -gesture.velocity_y / 1000.0f, gesture.timestamp);
+      break;
+    default:
+      break;
+  }
+  
+  scroll_offset = (int)list_scroller.position;
+}
+
+void setListScrollRange(int max_offset) {
+  scrollerSetBounds(list_scroller, 0, max_offset);
+}
+
+bool isListScrolling() {
+  return list_scroller.dragging || list_scroller.animating;
+}
+
+bool updateListScroll(int& scroll_offset) {
+  bool animating = scrollerUpdate(list_scroller, millis());
+  scroll_offset = (int)list_scroller.position;
+  return animating;
+}
+
 void showAlert(const char* title, const char* message) {
   ThemeColors* theme = getCurrentTheme();
   
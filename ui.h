@@ -8,6 +8,7 @@
 
 #include "config.h"
 #include "touch.h"
+#include "hit_index.h"
 
 // UI Component types
 enum UIComponentType {
@@ -60,6 +61,13 @@ void handleUITouch(TouchGesture& gesture);
 bool isTouchInComponent(TouchGesture& gesture, UIComponent& component);
 void handleButtonPress(UIComponent& button);
 
+// Hit testing against regions registered by the last drawn frame
+void beginHitFrame();
+void addHitRegion(int x, int y, int width, int height, int tag, void (*callback)(void) = nullptr);
+void addHitComponent(UIComponent& component);
+const HitRegion* findHitRegion(TouchGesture& gesture);
+bool dispatchHitCallback(TouchGesture& gesture);
+
 // Animation system
 void animateScreenTransition(ScreenType from, ScreenType to);
 void animateButtonPress(UIComponent& button);
@@ -74,6 +82,9 @@ void drawNotificationDot(int x, int y, uint16_t color);
 // List view components
 void drawListItem(int x, int y, int width, const char* title, const char* subtitle, uint16_t color);
 void handleListScroll(TouchGesture& gesture, int& scroll_offset);
+void setListScrollRange(int max_offset);
+bool updateListScroll(int& scroll_offset);
+bool isListScrolling();
 
 // Modal dialogs
 void showAlert(const char* title, const char* message);
@@ -0,0 +1,136 @@
+/*
+ * Multi-Resolution Zoom Cache Implementation
+ * Box-filtered RGB565 levels with fixed-point nearest sampling
+ */
+
+#include "zoom_cache.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#define ZOOM_CACHE_ALLOC(size) ps_malloc(size) // Levels live in PSRAM
+#else
+#define ZOOM_CACHE_ALLOC(size) malloc(size)
+#endif
+
+static inline uint16_t swapPixelBytes(uint16_t pixel) {
+  return (pixel >> 8) | (pixel << 8);
+}
+
+// Average a 2x2 block of RGB565 pixels per channel
+static uint16_t averagePixels(uint16_t a, uint16_t b, uint16_t c, uint16_t d) {
+  uint16_t r = (((a >> 11) & 0x1F) + ((b >> 11) & 0x1F) + ((c >> 11) & 0x1F) + ((d >> 11) & 0x1F) + 2) >> 2;
+  uint16_t g = (((a >> 5) & 0x3F) + ((b >> 5) & 0x3F) + ((c >> 5) & 0x3F) + ((d >> 5) & 0x3F) + 2) >> 2;
+  uint16_t bl = ((a & 0x1F) + (b & 0x1F) + (c & 0x1F) + (d & 0x1F) + 2) >> 2;
+  return (r << 11) | (g << 5) | bl;
+}
+
+void zoomCacheInit(ZoomCache& cache) {
+  memset(&cache, 0, sizeof(cache));
+}
+
+bool zoomCacheBuild(ZoomCache& cache, const uint16_t* master, int width, int height,
+                    float master_scale, int level_count, bool byte_swapped) {
+  zoomCacheFree(cache);
+  if (!master || width <= 0 || height <= 0 || master_scale <= 0) return false;
+  if (level_count > ZOOM_CACHE_MAX_LEVELS) level_count = ZOOM_CACHE_MAX_LEVELS;
+  if (level_count < 1) level_count = 1;
+
+  cache.byte_swapped = byte_swapped;
+  cache.content_width = (int)(width / master_scale);
+  cache.content_height = (int)(height / master_scale);
+
+  // Level 0 is a straight copy of the master render
+  size_t bytes = (size_t)width * height * sizeof(uint16_t);
+  uint16_t* pixels = (uint16_t*)ZOOM_CACHE_ALLOC(bytes);
+  if (!pixels) return false;
+  memcpy(pixels, master, bytes);
+
+  cache.levels[0].pixels = pixels;
+  cache.levels[0].width = width;
+  cache.levels[0].height = height;
+  cache.levels[0].scale = master_scale;
+  cache.level_count = 1;
+
+  // Each further level halves the previous one with a 2x2 box filter
+  for (int level = 1; level < level_count; level++) {
+    const ZoomCacheLevel& src = cache.levels[level - 1];
+    int w = src.width / 2;
+    int h = src.height / 2;
+    if (w < 1 || h < 1) break;
+
+    uint16_t* dst = (uint16_t*)ZOOM_CACHE_ALLOC((size_t)w * h * sizeof(uint16_t));
+    if (!dst) break; // Keep the levels we already have
+
+    for (int y = 0; y < h; y++) {
+      const uint16_t* row0 = src.pixels + (2 * y) * src.width;
+      const uint16_t* row1 = row0 + src.width;
+      for (int x = 0; x < w; x++) {
+        uint16_t a = row0[2 * x], b = row0[2 * x + 1];
+        uint16_t c = row1[2 * x], d = row1[2 * x + 1];
+        if (byte_swapped) {
+          a = swapPixelBytes(a); b = swapPixelBytes(b);
+          c = swapPixelBytes(c); d = swapPixelBytes(d);
+        }
+        uint16_t avg = averagePixels(a, b, c, d);
+        dst[y * w + x] = byte_swapped ? swapPixelBytes(avg) : avg;
+      }
+    }
+
+    cache.levels[level].pixels = dst;
+    cache.levels[level].width = w;
+    cache.levels[level].height = h;
+    cache.levels[level].scale = src.scale / 2;
+    cache.level_count++;
+  }
+
+  return true;
+}
+
+void zoomCacheFree(ZoomCache& cache) {
+  for (int i = 0; i < cache.level_count; i++) {
+    free(cache.levels[i].pixels);
+  }
+  zoomCacheInit(cache);
+}
+
+int zoomCacheSelectLevel(const ZoomCache& cache, float zoom) {
+  // Smallest level that still has a source pixel per screen pixel
+  int selected = 0;
+  for (int i = 0; i < cache.level_count; i++) {
+    if (cache.levels[i].scale >= zoom) {
+      selected = i;
+    }
+  }
+  return selected;
+}
+
+void zoomCacheSampleRow(const ZoomCache& cache, int level, float zoom,
+                        float origin_x, float origin_y, int row,
+                        uint16_t* out, int out_width, uint16_t fill) {
+  if (cache.byte_swapped) fill = swapPixelBytes(fill);
+
+  if (level < 0 || level >= cache.level_count || zoom <= 0) {
+    for (int i = 0; i < out_width; i++) out[i] = fill;
+    return;
+  }
+
+  const ZoomCacheLevel& src = cache.levels[level];
+  int src_y = (int)((origin_y + row / zoom) * src.scale);
+  if (src_y < 0 || src_y >= src.height) {
+    for (int i = 0; i < out_width; i++) out[i] = fill;
+    return;
+  }
+
+  // Step through the source row in 16.16 fixed point
+  const uint16_t* src_row = src.pixels + src_y * src.width;
+  int32_t fx = (int32_t)(origin_x * src.scale * 65536.0f);
+  int32_t step = (int32_t)(src.scale / zoom * 65536.0f);
+
+  for (int i = 0; i < out_width; i++) {
+    int src_x = fx >> 16;
+    out[i] = (fx >= 0 && src_x < src.width) ? src_row[src_x] : fill;
+    fx += step;
+  }
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+/*
+ * Multi-Resolution Zoom Cache for ESP32-S3 Watch
+ * Pre-scaled RGB565 levels so zoomed frames never re-render content
+ *
+ * Content is rendered once at its highest detail, then box-filtered into
+ * half-size levels. A zoomed view samples the smallest level that still
+ * has at least one source pixel per screen pixel. No Arduino
+ * dependencies beyond the allocator, so the sampling math runs on host.
+ */
+
+#ifndef ZOOM_CACHE_H
+#define ZOOM_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define ZOOM_CACHE_MAX_LEVELS 4
+
+// One pre-scaled copy of the content
+struct ZoomCacheLevel {
+  uint16_t* pixels;
+  int width, height;
+  float scale;          // Level pixels per content pixel at zoom 1.0
+};
+
+// Pyramid of pre-scaled copies, level 0 is the most detailed
+struct ZoomCache {
+  ZoomCacheLevel levels[ZOOM_CACHE_MAX_LEVELS];
+  int level_count;
+  int content_width, content_height;  // Content size at zoom 1.0
+  bool byte_swapped;                  // Pixels stored in TFT_eSprite byte order
+};
+
+// Cache management
+void zoomCacheInit(ZoomCache& cache);
+bool zoomCacheBuild(ZoomCache& cache, const uint16_t* master, int width, int height,
+                    float master_scale, int level_count, bool byte_swapped);
+void zoomCacheFree(ZoomCache& cache);
+
+// Sampling
+int zoomCacheSelectLevel(const ZoomCache& cache, float zoom);
+void zoomCacheSampleRow(const ZoomCache& cache, int level, float zoom,
+                        float origin_x, float origin_y, int row,
+                        uint16_t* out, int out_width, uint16_t fill);
+
+#endif // ZOOM_CACHE_H
\ No newline at end of file